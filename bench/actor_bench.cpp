@@ -0,0 +1,95 @@
+//
+// QuicFlow-CPP - SerializedObject Benchmarks
+//
+// 여러 생산자 스레드가 actor 1개에 작업을 넣을 때의 enqueue + drain 비용
+//
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "core/executor.hpp"
+#include "core/serialized_object.hpp"
+#include "core/serialized_predefined.hpp"
+
+namespace quicflow {
+namespace bench {
+
+namespace {
+
+// 받은 값을 더하기만 하는 actor (작업 자체 비용을 0 에 가깝게)
+class CounterActor : public core::SerializedObject {
+public:
+  DECLARE_ASYNC_FUNCTION(Add, uint64_t value)
+
+public:
+  uint64_t processed() const { return processed_.load(std::memory_order_acquire); }
+  uint64_t sum() const { return sum_; }
+
+private:
+  uint64_t sum_ = 0;
+  std::atomic<uint64_t> processed_{0};
+};
+
+DEFINE_ASYNC_FUNCTION(CounterActor, Add, uint64_t value) {
+  sum_ += value;
+  // actor 안에서만 쓰므로 fetch_add 대신 store (측정 대상에 원자적 RMW 를 더하지 않는다)
+  processed_.store(processed_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+// inline: 호출한 생산자 스레드가 드레인 (MsQuic worker 에서 쓰는 기본 모드)
+// executor: 항상 큐에 넣고 Executor worker 가 드레인 (FanoutShard 모드)
+void RunProducers(State& state, uint32_t producers, bool useExecutor) {
+  auto actor = std::make_shared<CounterActor>();
+  if (useExecutor) {
+    actor->SetExecutor(&core::Executor::GetInstance());
+  }
+
+  const uint64_t total = state.iterations();
+  std::atomic<bool> go{false};
+  std::vector<std::thread> threads;
+  threads.reserve(producers);
+  for (uint32_t p = 0; p < producers; ++p) {
+    uint64_t begin = total * p / producers;
+    uint64_t end = total * (p + 1) / producers;
+    threads.emplace_back([&actor, &go, begin, end] {
+      while (go.load(std::memory_order_acquire) == false) {
+        std::this_thread::yield();
+      }
+      for (uint64_t i = begin; i < end; ++i) {
+        actor->AddAsync(i);
+      }
+    });
+  }
+
+  state.StartTimer();
+  go.store(true, std::memory_order_release);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  // inline 모드는 마지막 생산자가 드레인까지 마치고 돌아오므로 바로 끝난다.
+  while (actor->processed() < total) {
+    std::this_thread::yield();
+  }
+  state.StopTimer();
+
+  DoNotOptimize(actor->sum());
+  state.SetItemsPerIteration(1);
+}
+
+}  // namespace
+
+void RegisterActorBenchmarks(Registry& registry) {
+  for (bool useExecutor : {false, true}) {
+    for (uint32_t producers : {1u, 2u, 4u, 8u, 16u, 32u, 64u}) {
+      std::string name = std::string("actor/enqueue_drain/mode=") + (useExecutor ? "executor" : "inline") +
+                         "/producers=" + std::to_string(producers);
+      registry.Add(name, [producers, useExecutor](State& state) { RunProducers(state, producers, useExecutor); });
+    }
+  }
+}
+
+}  // namespace bench
+}  // namespace quicflow
@@ -0,0 +1,162 @@
+//
+// QuicFlow-CPP - quicflow_bench
+//
+// 사용 예:
+//   quicflow_bench --output=before.json
+//   quicflow_bench --filter=framing/parse --min_time_ms=500 --repetitions=9
+//
+// 같은 머신에서 커밋마다 결과 파일을 만들고 diff (또는 scripts/bench_compare.py) 로 비교한다.
+//
+
+#include <charconv>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <string_view>
+
+#include "benchmark.hpp"
+#include "common/logger.hpp"
+
+using namespace quicflow::bench;
+
+namespace {
+
+struct Options {
+  RunOptions Run;
+  std::string Output;  // 비어 있으면 stdout
+  bool List = false;
+};
+
+template <typename T>
+bool ParseUnsigned(std::string_view text, T& out) {
+  uint64_t value = 0;
+  auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+  if (result.ec != std::errc() || result.ptr != text.data() + text.size()
+    || value > std::numeric_limits<T>::max()) {
+    return false;
+  }
+  out = (T)value;
+  return true;
+}
+
+struct Option {
+  std::string_view Key;
+  std::string_view Help;
+  bool (*Parse)(std::string_view value, Options& out);
+};
+
+const Option kOptions[] = {
+    {"filter", "run only benchmarks whose name contains this text (default all)",
+     [](std::string_view v, Options& o) { o.Run.Filter = v; return true; }},
+    {"min_time_ms", "minimum measured time per repetition (default 200)",
+     [](std::string_view v, Options& o) { return ParseUnsigned(v, o.Run.MinTimeMs) && o.Run.MinTimeMs > 0; }},
+    {"repetitions", "repetitions per benchmark, median is reported (default 5)",
+     [](std::string_view v, Options& o) { return ParseUnsigned(v, o.Run.Repetitions) && o.Run.Repetitions > 0; }},
+    {"output", "JSON result file (default stdout)",
+     [](std::string_view v, Options& o) { o.Output = v; return true; }},
+    {"list", "print benchmark names and exit (true | false)",
+     [](std::string_view v, Options& o) {
+       if (v == "true" || v == "1") { o.List = true; return true; }
+       if (v == "false" || v == "0") { o.List = false; return true; }
+       return false;
+     }},
+};
+
+void PrintUsage(const char* program) {
+  std::cout << "Usage: " << program << " [--key=value ...]\n"
+            << "  Runs in-process microbenchmarks (framing, codec, actor, manager, logger) and writes\n"
+            << "  JSON with a fixed key order so results from two commits can be diffed.\n\n";
+  for (const auto& option : kOptions) {
+    std::cout << "  --" << option.Key << "  " << option.Help << "\n";
+  }
+  std::cout << std::flush;
+}
+
+bool ParseArguments(int argc, char** argv, Options& out, std::string& error) {
+  for (int i = 1; i < argc; ++i) {
+    std::string_view argument = argv[i];
+    if (argument == "--list") {
+      out.List = true;
+      continue;
+    }
+    size_t equals = argument.find('=');
+    if (argument.starts_with("--") == false || equals == std::string_view::npos) {
+      error = "expected --key=value: " + std::string(argument);
+      return false;
+    }
+    std::string_view key = argument.substr(2, equals - 2);
+    std::string_view value = argument.substr(equals + 1);
+
+    bool found = false;
+    for (const auto& option : kOptions) {
+      if (option.Key == key) {
+        found = true;
+        if (option.Parse(value, out) == false) {
+          error = "invalid value for --" + std::string(key) + ": " + std::string(value);
+          return false;
+        }
+        break;
+      }
+    }
+    if (found == false) {
+      error = "unknown option: --" + std::string(key);
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  for (int i = 1; i < argc; ++i) {
+    std::string_view argument = argv[i];
+    if (argument == "--help" || argument == "-h") {
+      PrintUsage(argv[0]);
+      return 0;
+    }
+  }
+
+  Options options;
+  std::string error;
+  if (ParseArguments(argc, argv, options, error) == false) {
+    std::fprintf(stderr, "quicflow_bench: %s (see --help)\n", error.c_str());
+    return 2;
+  }
+
+  Registry registry;
+  RegisterFramingBenchmarks(registry);
+  RegisterCodecBenchmarks(registry);
+  RegisterActorBenchmarks(registry);
+  RegisterManagerBenchmarks(registry);
+  RegisterLoggerBenchmarks(registry);
+  RegisterClusterBenchmarks(registry);
+
+  if (options.List) {
+    for (const Benchmark& benchmark : registry.benchmarks()) {
+      if (benchmark.Name.find(options.Run.Filter) != std::string::npos) {
+        std::cout << benchmark.Name << "\n";
+      }
+    }
+    std::cout << std::flush;
+    return 0;
+  }
+
+  std::vector<Result> results = Runner::Run(registry, options.Run);
+  std::string text = Runner::RenderJson(results, options.Run);
+  common::Logger::Shutdown();
+
+  if (options.Output.empty()) {
+    std::cout << text << std::flush;
+    return 0;
+  }
+  std::ofstream file(options.Output, std::ios::trunc);
+  file << text;
+  if (file.good() == false) {
+    std::fprintf(stderr, "quicflow_bench: cannot write %s\n", options.Output.c_str());
+    return 1;
+  }
+  return 0;
+}
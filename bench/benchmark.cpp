@@ -0,0 +1,156 @@
+//
+// QuicFlow-CPP - Microbenchmark Harness
+//
+
+#include "benchmark.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+
+#include <nlohmann/json.hpp>
+
+namespace quicflow {
+namespace bench {
+
+namespace {
+
+constexpr uint64_t kMaxIterations = 1000ull * 1000 * 1000;
+
+// diff 가 측정 잡음에 묻히지 않도록 유효 숫자 4자리로 자른다.
+double Round(double value) {
+  if (value == 0 || std::isfinite(value) == false) {
+    return 0;
+  }
+  double scale = std::pow(10.0, 3 - std::floor(std::log10(std::fabs(value))));
+  return std::round(value * scale) / scale;
+}
+
+}  // namespace
+
+double Runner::RunOnce(const Benchmark& benchmark, uint64_t iterations, State& state) {
+  state = State(iterations);
+  auto start = std::chrono::steady_clock::now();
+  benchmark.Run(state);
+  auto total = std::chrono::steady_clock::now() - start;
+  auto elapsed = state.timed_ ? state.elapsed_ : total;
+  return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+}
+
+std::vector<Result> Runner::Run(const Registry& registry, const RunOptions& options) {
+  std::vector<Result> results;
+  const double minTimeNs = (double)options.MinTimeMs * 1e6;
+
+  for (const auto& benchmark : registry.benchmarks()) {
+    if (options.Filter.empty() == false && benchmark.Name.find(options.Filter) == std::string::npos) {
+      continue;
+    }
+    std::fprintf(stderr, "%-64s", benchmark.Name.c_str());
+    std::fflush(stderr);
+
+    Result result;
+    result.Name = benchmark.Name;
+    State state(1);
+
+    // 1. 반복 수 보정: MinTimeMs 를 넘을 때까지 늘린다.
+    uint64_t iterations = benchmark.FixedIterations != 0 ? benchmark.FixedIterations : 1;
+    if (benchmark.FixedIterations == 0) {
+      while (true) {
+        double elapsedNs = RunOnce(benchmark, iterations, state);
+        if (state.error_.empty() == false || elapsedNs >= minTimeNs || iterations >= kMaxIterations) {
+          break;
+        }
+        double factor = elapsedNs > 0 ? minTimeNs / elapsedNs * 1.2 : 100.0;
+        iterations = std::min(kMaxIterations, (uint64_t)((double)iterations * std::clamp(factor, 2.0, 100.0)));
+      }
+    }
+
+    // 2. 같은 반복 수로 Repetitions 번
+    struct Sample {
+      double nsPerOp;
+      State state;
+    };
+    std::vector<Sample> samples;
+    for (uint32_t i = 0; i < std::max(options.Repetitions, 1u) && state.error_.empty(); ++i) {
+      double elapsedNs = RunOnce(benchmark, iterations, state);
+      samples.push_back({elapsedNs / (double)iterations, state});
+    }
+
+    if (state.error_.empty() == false || samples.empty()) {
+      result.Error = state.error_;
+      std::fprintf(stderr, "  skipped: %s\n", result.Error.c_str());
+      results.push_back(std::move(result));
+      continue;
+    }
+
+    std::sort(samples.begin(), samples.end(), [](const Sample& a, const Sample& b) { return a.nsPerOp < b.nsPerOp; });
+    const Sample& median = samples[samples.size() / 2];
+    result.Iterations = iterations;
+    result.NsPerOp = median.nsPerOp;
+    result.NsPerOpMin = samples.front().nsPerOp;
+    result.NsPerOpMax = samples.back().nsPerOp;
+    if (median.nsPerOp > 0) {
+      result.ItemsPerSecond = median.state.items_per_iteration_ * 1e9 / median.nsPerOp;
+      result.BytesPerSecond = median.state.bytes_per_iteration_ * 1e9 / median.nsPerOp;
+    }
+    result.Counters = median.state.counters_;
+    std::fprintf(stderr, "%14.1f ns/op  (%llu iterations)\n", result.NsPerOp, (unsigned long long)iterations);
+    results.push_back(std::move(result));
+  }
+  return results;
+}
+
+std::string Runner::RenderJson(const std::vector<Result>& results, const RunOptions& options) {
+  nlohmann::ordered_json root;
+  root["schema"] = 1;
+  nlohmann::ordered_json context;
+#if defined(__clang__)
+  context["compiler"] = "clang " __clang_version__;
+#elif defined(__GNUC__)
+  context["compiler"] = "gcc " __VERSION__;
+#endif
+#if defined(NDEBUG)
+  context["build"] = "release";
+#else
+  context["build"] = "debug";
+#endif
+  context["hardware_threads"] = std::thread::hardware_concurrency();
+  context["min_time_ms"] = options.MinTimeMs;
+  context["repetitions"] = options.Repetitions;
+  root["context"] = context;
+
+  nlohmann::ordered_json benchmarks = nlohmann::ordered_json::array();
+  for (const auto& result : results) {
+    nlohmann::ordered_json entry;
+    entry["name"] = result.Name;
+    if (result.Error.empty() == false) {
+      entry["error"] = result.Error;
+      benchmarks.push_back(entry);
+      continue;
+    }
+    entry["iterations"] = result.Iterations;
+    entry["ns_per_op"] = Round(result.NsPerOp);
+    entry["ns_per_op_min"] = Round(result.NsPerOpMin);
+    entry["ns_per_op_max"] = Round(result.NsPerOpMax);
+    if (result.ItemsPerSecond > 0) {
+      entry["items_per_sec"] = Round(result.ItemsPerSecond);
+    }
+    if (result.BytesPerSecond > 0) {
+      entry["bytes_per_sec"] = Round(result.BytesPerSecond);
+    }
+    if (result.Counters.empty() == false) {
+      nlohmann::ordered_json counters;
+      for (const auto& [name, value] : result.Counters) {
+        counters[name] = Round(value);
+      }
+      entry["counters"] = counters;
+    }
+    benchmarks.push_back(entry);
+  }
+  root["benchmarks"] = benchmarks;
+  return root.dump(2) + "\n";
+}
+
+}  // namespace bench
+}  // namespace quicflow
@@ -0,0 +1,135 @@
+//
+// QuicFlow-CPP - Microbenchmark Harness
+//
+
+#ifndef QUICFLOWCPP_BENCHMARK_HPP
+#define QUICFLOWCPP_BENCHMARK_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace quicflow {
+namespace bench {
+
+// 컴파일러가 값을 계산하지 않고 지우지 못하게 한다.
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline void ClobberMemory() {
+  asm volatile("" : : : "memory");
+}
+
+// 벤치마크 함수 1회 실행의 상태
+// 함수는 iterations() 번 작업을 하고, 준비 작업을 빼려면 StartTimer/StopTimer 로 측정 구간을 감싼다.
+// (부르지 않으면 함수 전체 시간을 잰다)
+class State {
+public:
+  explicit State(uint64_t iterations) : iterations_(iterations) {}
+
+  uint64_t iterations() const { return iterations_; }
+
+  void StartTimer() {
+    timed_ = true;
+    start_ = std::chrono::steady_clock::now();
+  }
+  void StopTimer() { elapsed_ += std::chrono::steady_clock::now() - start_; }
+
+  template <typename Body>
+  void Measure(Body&& body) {
+    StartTimer();
+    for (uint64_t i = 0; i < iterations_; ++i) {
+      body();
+    }
+    StopTimer();
+  }
+
+  // 반복 1회당 처리한 항목/바이트 수 (fan-out 수신자 수, 메시지 크기 등). 처리량 계산에 쓴다.
+  void SetItemsPerIteration(double items) { items_per_iteration_ = items; }
+  void SetBytesPerIteration(double bytes) { bytes_per_iteration_ = bytes; }
+  // 추가 지표 (지연 백분위 등). 이름 순으로 출력된다.
+  void SetCounter(const std::string& name, double value) { counters_[name] = value; }
+  // 이 환경에서 실행할 수 없을 때 (결과에 error 로 남는다)
+  void SkipWithError(std::string message) { error_ = std::move(message); }
+
+private:
+  friend class Runner;
+
+  uint64_t iterations_;
+  bool timed_ = false;
+  std::chrono::steady_clock::time_point start_;
+  std::chrono::steady_clock::duration elapsed_{0};
+  double items_per_iteration_ = 0;
+  double bytes_per_iteration_ = 0;
+  std::map<std::string, double> counters_;
+  std::string error_;
+};
+
+struct Benchmark {
+  std::string Name;  // "group/case/param=value" (출력 순서 = 등록 순서)
+  std::function<void(State&)> Run;
+  uint64_t FixedIterations = 0;  // 0 이면 MinTimeMs 를 채우도록 반복 수를 정한다
+};
+
+class Registry {
+public:
+  void Add(std::string name, std::function<void(State&)> run, uint64_t fixedIterations = 0) {
+    benchmarks_.push_back({std::move(name), std::move(run), fixedIterations});
+  }
+  const std::vector<Benchmark>& benchmarks() const { return benchmarks_; }
+
+private:
+  std::vector<Benchmark> benchmarks_;
+};
+
+struct RunOptions {
+  std::string Filter;          // 이름에 이 문자열이 들어간 것만 (비어 있으면 전부)
+  uint32_t MinTimeMs = 200;    // 반복 1번의 최소 측정 시간
+  uint32_t Repetitions = 5;    // 같은 반복 수로 몇 번 잴지 (중앙값을 보고)
+};
+
+struct Result {
+  std::string Name;
+  uint64_t Iterations = 0;
+  double NsPerOp = 0;  // 반복들의 중앙값
+  double NsPerOpMin = 0;
+  double NsPerOpMax = 0;
+  double ItemsPerSecond = 0;
+  double BytesPerSecond = 0;
+  std::map<std::string, double> Counters;  // 중앙값 반복의 지표
+  std::string Error;
+};
+
+// 반복 수 보정 + Repetitions 번 측정 (진행 상황은 stderr)
+// Why: 한 번만 재면 스케줄링/주파수 변화가 그대로 결과에 남아 커밋 간 비교가 흔들린다.
+//      반복마다 같은 반복 수를 쓰고 중앙값을 보고하며, 최소/최대로 흔들림 폭을 함께 남긴다.
+class Runner {
+public:
+  Runner() = delete;
+
+  static std::vector<Result> Run(const Registry& registry, const RunOptions& options);
+
+  // 커밋 간 diff 가 가능하도록 등록 순서와 key 순서를 고정하고, 실행 시각 등 매번 바뀌는 값은 넣지 않는다.
+  static std::string RenderJson(const std::vector<Result>& results, const RunOptions& options);
+
+private:
+  static double RunOnce(const Benchmark& benchmark, uint64_t iterations, State& state);
+};
+
+// 영역별 등록 함수 (bench/*_bench.cpp)
+void RegisterFramingBenchmarks(Registry& registry);
+void RegisterCodecBenchmarks(Registry& registry);
+void RegisterActorBenchmarks(Registry& registry);
+void RegisterManagerBenchmarks(Registry& registry);
+void RegisterLoggerBenchmarks(Registry& registry);
+void RegisterClusterBenchmarks(Registry& registry);
+
+}  // namespace bench
+}  // namespace quicflow
+
+#endif  // QUICFLOWCPP_BENCHMARK_HPP
@@ -0,0 +1,210 @@
+//
+// QuicFlow-CPP - Cluster Transport Benchmarks
+//
+// 같은 호스트의 두 노드 사이 전송 계층 비교: 공유 메모리 ring vs Unix datagram (UDS) vs UDP loopback
+// 한 프로세스 안에 transport 두 개를 만들어 서로를 peer 로 등록한다. (수신은 각 transport 의 수신 스레드)
+//
+
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "cluster/cluster_transport.hpp"
+#include "loadgen/latency_histogram.hpp"
+
+namespace quicflow {
+namespace bench {
+
+using cluster::ClusterBuffer;
+using cluster::ClusterTransport;
+
+namespace {
+
+// 인코딩된 채팅 프레임 + 버스 헤더 정도의 크기
+constexpr size_t kMessageBytes = 256;
+// 이 시간 동안 진전이 없으면 메시지가 유실된 것으로 본다.
+constexpr std::chrono::seconds kStallTimeout{1};
+
+uint64_t NowNs() {
+  return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 서로를 peer 0 으로 가진 두 노드. b 가 받은 메시지를 a 로 되돌려 보내게 할 수 있다.
+class TransportPair {
+public:
+  // kind: "shm" | "unix" | "udp"
+  bool Start(const std::string& kind, bool echo, std::string& error) {
+    const std::string suffix = std::to_string(getpid());
+    std::string addressA;
+    std::string addressB;
+    if (kind == "shm") {
+      addressA = "shm://qfba-" + suffix;
+      addressB = "shm://qfbb-" + suffix;
+    } else if (kind == "unix") {
+      addressA = "unix:///tmp/quicflow-bench-a-" + suffix + ".sock";
+      addressB = "unix:///tmp/quicflow-bench-b-" + suffix + ".sock";
+    } else {
+      addressA = "udp://127.0.0.1:47901";
+      addressB = "udp://127.0.0.1:47902";
+    }
+
+    a_ = ClusterTransport::Create(addressA);
+    b_ = ClusterTransport::Create(addressB);
+    if (a_ == nullptr || b_ == nullptr || a_->AddPeer(addressB) != 0 || b_->AddPeer(addressA) != 0) {
+      error = "cannot create " + kind + " transport";
+      return false;
+    }
+    if (a_->Start([this](int, const uint8_t*, size_t) { received_a_.fetch_add(1, std::memory_order_release); })
+      == false) {
+      error = "cannot listen on " + addressA;
+      return false;
+    }
+    if (b_->Start([this, echo](int, const uint8_t* data, size_t length) {
+          received_b_.fetch_add(1, std::memory_order_release);
+          if (echo) {
+            ClusterBuffer buffer{data, length};
+            b_->SendTo(0, &buffer, 1);
+          }
+        }) == false) {
+      error = "cannot listen on " + addressB;
+      return false;
+    }
+    return true;
+  }
+
+  ~TransportPair() {
+    if (a_ != nullptr) {
+      a_->Stop();
+    }
+    if (b_ != nullptr) {
+      b_->Stop();
+    }
+  }
+
+  ClusterTransport& a() { return *a_; }
+  uint64_t received_a() const { return received_a_.load(std::memory_order_acquire); }
+  uint64_t received_b() const { return received_b_.load(std::memory_order_acquire); }
+
+private:
+  std::unique_ptr<ClusterTransport> a_;
+  std::unique_ptr<ClusterTransport> b_;
+  std::atomic<uint64_t> received_a_{0};
+  std::atomic<uint64_t> received_b_{0};
+};
+
+// counter 가 target 에 닿을 때까지 기다린다. 진전 없이 kStallTimeout 이 지나면 false
+template <typename Counter>
+bool WaitFor(Counter&& counter, uint64_t target) {
+  uint64_t last = counter();
+  auto lastProgress = std::chrono::steady_clock::now();
+  while (true) {
+    uint64_t current = counter();
+    if (current >= target) {
+      return true;
+    }
+    if (current != last) {
+      last = current;
+      lastProgress = std::chrono::steady_clock::now();
+    } else if (std::chrono::steady_clock::now() - lastProgress > kStallTimeout) {
+      return false;
+    }
+    std::this_thread::yield();
+  }
+}
+
+// 왕복 1회: a -> b -> a
+void RunRoundTrip(State& state, const std::string& kind) {
+  TransportPair pair;
+  std::string error;
+  if (pair.Start(kind, true, error) == false) {
+    state.SkipWithError(error);
+    return;
+  }
+  std::vector<uint8_t> payload(kMessageBytes, 0x5A);
+  ClusterBuffer buffer{payload.data(), payload.size()};
+  tools::LatencyHistogram latency;
+  bool lost = false;
+
+  state.Measure([&] {
+    if (lost) {
+      return;
+    }
+    uint64_t expected = pair.received_a() + 1;
+    uint64_t start = NowNs();
+    if (pair.a().SendTo(0, &buffer, 1) == false || WaitFor([&] { return pair.received_a(); }, expected) == false) {
+      lost = true;
+      return;
+    }
+    latency.Record(NowNs() - start);
+  });
+  if (lost) {
+    state.SkipWithError("message lost or send failed");
+    return;
+  }
+
+  auto summary = latency.Summarize();
+  state.SetCounter("rtt_p50_ns", (double)summary.p50);
+  state.SetCounter("rtt_p99_ns", (double)summary.p99);
+  state.SetCounter("rtt_p999_ns", (double)summary.p999);
+  state.SetItemsPerIteration(1);
+  state.SetBytesPerIteration((double)kMessageBytes);
+}
+
+// 한 방향 처리량: 수신하지 못한 메시지를 window 개까지만 두고 계속 보낸다.
+// Why: UDP/UDS 는 수신 버퍼가 차면 조용히 버리므로, 무제한으로 보내면 전송 방식이 아니라 유실을 재게 된다.
+void RunThroughput(State& state, const std::string& kind, uint64_t window) {
+  TransportPair pair;
+  std::string error;
+  if (pair.Start(kind, false, error) == false) {
+    state.SkipWithError(error);
+    return;
+  }
+  std::vector<uint8_t> payload(kMessageBytes, 0x5A);
+  ClusterBuffer buffer{payload.data(), payload.size()};
+  const uint64_t base = pair.received_b();
+  uint64_t sent = 0;
+  uint64_t sendFailures = 0;
+
+  state.StartTimer();
+  bool delivered = true;
+  for (uint64_t i = 0; i < state.iterations() && delivered; ++i) {
+    delivered = WaitFor([&] { return pair.received_b() - base + window; }, sent + 1);
+    while (delivered && pair.a().SendTo(0, &buffer, 1) == false) {
+      ++sendFailures;  // ring 이 가득 참 / 소켓 버퍼 부족: 잠시 양보 후 다시
+      std::this_thread::yield();
+    }
+    ++sent;
+  }
+  delivered = delivered && WaitFor([&] { return pair.received_b() - base; }, sent);
+  state.StopTimer();
+
+  if (delivered == false) {
+    state.SkipWithError("message lost");
+    return;
+  }
+  state.SetCounter("send_retries", (double)sendFailures);
+  state.SetItemsPerIteration(1);
+  state.SetBytesPerIteration((double)kMessageBytes);
+}
+
+}  // namespace
+
+void RegisterClusterBenchmarks(Registry& registry) {
+  for (const char* kind : {"shm", "unix", "udp"}) {
+    const std::string transport = kind;
+    registry.Add("cluster/round_trip/transport=" + transport,
+                 [transport](State& state) { RunRoundTrip(state, transport); });
+    registry.Add("cluster/throughput/transport=" + transport + "/window=64",
+                 [transport](State& state) { RunThroughput(state, transport, 64); });
+  }
+}
+
+}  // namespace bench
+}  // namespace quicflow
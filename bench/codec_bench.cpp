@@ -0,0 +1,114 @@
+//
+// QuicFlow-CPP - ChatProtocol Codec Benchmarks
+//
+// 직접 인코더/on-demand 디코더와 nlohmann 경로 비교
+//
+
+#include <string>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "network/chat_protocol_decoder.hpp"
+#include "network/chat_protocol_encoder.hpp"
+#include "network/quic_protocol.hpp"
+
+namespace quicflow {
+namespace bench {
+
+using network::ChatProtocolDecoder;
+using network::ChatProtocolEncoder;
+using network::ChatProtocolView;
+
+namespace {
+
+struct Payload {
+  std::string Name;
+  ChatProtocol Message;
+};
+
+// escape 가 없는 ASCII 와, escape/멀티바이트 UTF-8 이 섞인 본문
+std::vector<Payload> MakePayloads() {
+  std::vector<Payload> payloads;
+  for (size_t length : {32u, 512u, 4096u}) {
+    ChatProtocol message;
+    message.Type = kChatTypeChat;
+    message.MessageId = 987654;
+    message.UserID = "user-000042";
+    message.Timestamp = 1767225600;
+    message.Room = "room-7";
+
+    message.Message = std::string(length, 'a');
+    payloads.push_back({"ascii" + std::to_string(length), message});
+
+    std::string mixed;
+    while (mixed.size() < length) {
+      mixed += "hi \"there\"\n\xEC\x95\x88\xEB\x85\x95 \\o/ ";
+    }
+    message.Message = mixed;
+    payloads.push_back({"escaped" + std::to_string(length), message});
+  }
+  return payloads;
+}
+
+}  // namespace
+
+void RegisterCodecBenchmarks(Registry& registry) {
+  for (const Payload& payload : MakePayloads()) {
+    const std::string suffix = "/payload=" + payload.Name;
+    const ChatProtocol message = payload.Message;
+
+    registry.Add("codec/encode/direct" + suffix, [message](State& state) {
+      uint32_t size = 0;
+      ChatProtocolEncoder::EncodedSize(message, size);
+      std::vector<uint8_t> out(size);
+      state.Measure([&] {
+        uint32_t length = 0;
+        ChatProtocolEncoder::EncodedSize(message, length);
+        uint8_t* end = ChatProtocolEncoder::Encode(message, out.data());
+        DoNotOptimize(end);
+      });
+      state.SetBytesPerIteration((double)size);
+    });
+
+    registry.Add("codec/encode/nlohmann" + suffix, [message](State& state) {
+      size_t size = json(message).dump().size();
+      state.Measure([&] {
+        std::string out = json(message).dump();
+        DoNotOptimize(out.data());
+      });
+      state.SetBytesPerIteration((double)size);
+    });
+
+    // 디코딩 입력은 서버가 보내는 것과 같은 바이트 (Room/MessageId 포함)
+    uint32_t size = 0;
+    ChatProtocolEncoder::EncodedSize(message, size);
+    std::string encoded(size, '\0');
+    ChatProtocolEncoder::Encode(message, reinterpret_cast<uint8_t*>(encoded.data()));
+
+    registry.Add("codec/decode/direct" + suffix, [encoded](State& state) {
+      std::string scratch;
+      state.Measure([&] {
+        ChatProtocolView view;
+        auto result = ChatProtocolDecoder::Decode(encoded, view, scratch);
+        DoNotOptimize(result);
+        DoNotOptimize(view);
+      });
+      state.SetBytesPerIteration((double)encoded.size());
+    });
+
+    // 디코더 이전 경로 (ConnectionManager 의 Fallback 과 같음)
+    registry.Add("codec/decode/nlohmann" + suffix, [encoded](State& state) {
+      state.Measure([&] {
+        json tree = json::parse(encoded);
+        ChatProtocol decoded = tree.get<ChatProtocol>();
+        std::string room = tree.value("Room", "");
+        DoNotOptimize(decoded.Message.data());
+        DoNotOptimize(room.data());
+      });
+      state.SetBytesPerIteration((double)encoded.size());
+    });
+  }
+}
+
+}  // namespace bench
+}  // namespace quicflow
@@ -0,0 +1,164 @@
+//
+// QuicFlow-CPP - Framing Benchmarks
+//
+// 수신 프레임 파싱(QuicBufferReader)과 송신 프레임 작성(SendJsonMessage 경로, 직접 인코딩)
+//
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "network/chat_protocol_encoder.hpp"
+#include "network/outbound_frame.hpp"
+#include "network/quic_buffer_reader.hpp"
+#include "network/quic_protocol.hpp"
+
+namespace quicflow {
+namespace bench {
+
+using network::ChatProtocolEncoder;
+using network::FrameRef;
+using network::OutboundFrame;
+
+namespace {
+
+// RECEIVE 이벤트 1번에 들어오는 QUIC_BUFFER 배열 모양
+// MsQuic 은 수신 순서대로 여러 버퍼에 나눠 주므로 헤더가 버퍼 경계에 걸칠 수 있다.
+enum class ChainShape {
+  Single,       // 버퍼 1개
+  SplitHeader,  // 헤더 2 + 2 바이트, 본문 1개
+  ByteHeader,   // 헤더 1 바이트씩 4개, 본문 1개
+  Chunks4,      // 프레임 전체를 4등분
+  Chunks16,     // 프레임 전체를 16등분
+};
+
+const char* ShapeName(ChainShape shape) {
+  switch (shape) {
+    case ChainShape::Single: return "single";
+    case ChainShape::SplitHeader: return "split_header";
+    case ChainShape::ByteHeader: return "byte_header";
+    case ChainShape::Chunks4: return "chunks4";
+    case ChainShape::Chunks16: return "chunks16";
+  }
+  return "unknown";
+}
+
+std::vector<QUIC_BUFFER> BuildChain(std::vector<uint8_t>& frame, ChainShape shape) {
+  auto piece = [&frame](size_t offset, size_t length) {
+    QUIC_BUFFER buffer{};
+    buffer.Length = (uint32_t)length;
+    buffer.Buffer = frame.data() + offset;
+    return buffer;
+  };
+
+  std::vector<QUIC_BUFFER> chain;
+  switch (shape) {
+    case ChainShape::Single:
+      chain.push_back(piece(0, frame.size()));
+      break;
+    case ChainShape::SplitHeader:
+      chain.push_back(piece(0, 2));
+      chain.push_back(piece(2, 2));
+      chain.push_back(piece(4, frame.size() - 4));
+      break;
+    case ChainShape::ByteHeader:
+      for (size_t i = 0; i < 4; ++i) {
+        chain.push_back(piece(i, 1));
+      }
+      chain.push_back(piece(4, frame.size() - 4));
+      break;
+    case ChainShape::Chunks4:
+    case ChainShape::Chunks16: {
+      size_t count = shape == ChainShape::Chunks4 ? 4 : 16;
+      size_t offset = 0;
+      for (size_t i = 0; i < count; ++i) {
+        size_t end = frame.size() * (i + 1) / count;
+        chain.push_back(piece(offset, end - offset));
+        offset = end;
+      }
+      break;
+    }
+  }
+  return chain;
+}
+
+ChatProtocol MakeMessage(size_t textLength) {
+  ChatProtocol message;
+  message.Type = kChatTypeChat;
+  message.MessageId = 123456;
+  message.UserID = "user-000042";
+  message.Message = std::string(textLength, 'a');
+  message.Timestamp = 1767225600;
+  message.Room = "room-7";
+  return message;
+}
+
+}  // namespace
+
+void RegisterFramingBenchmarks(Registry& registry) {
+  // 1. QuicBufferReader::TryParseStringMessage
+  for (uint32_t bodySize : {64u, 1024u, 16384u}) {
+    for (ChainShape shape : {ChainShape::Single, ChainShape::SplitHeader, ChainShape::ByteHeader, ChainShape::Chunks4,
+                             ChainShape::Chunks16}) {
+      std::string name = "framing/parse/body=" + std::to_string(bodySize) + "/chain=" + ShapeName(shape);
+      registry.Add(name, [bodySize, shape](State& state) {
+        std::vector<uint8_t> frame(OutboundFrame::kHeaderSize + bodySize, 'x');
+        frame[0] = (uint8_t)(bodySize & 0xFF);
+        frame[1] = (uint8_t)((bodySize >> 8) & 0xFF);
+        frame[2] = (uint8_t)((bodySize >> 16) & 0xFF);
+        frame[3] = (uint8_t)((bodySize >> 24) & 0xFF);
+        std::vector<QUIC_BUFFER> chain = BuildChain(frame, shape);
+
+        // 서버와 같이 메시지마다 새 문자열에 받는다. (OnChatStreamReceived)
+        state.Measure([&] {
+          std::string output;
+          bool parsed = QuicBufferReader::TryParseStringMessage(chain.data(), (uint32_t)chain.size(), output);
+          DoNotOptimize(parsed);
+          DoNotOptimize(output.data());
+        });
+        state.SetBytesPerIteration((double)frame.size());
+      });
+    }
+  }
+
+  // 2. 송신 프레임 작성
+  for (size_t textLength : {32u, 512u, 4096u}) {
+    std::string suffix = "/text=" + std::to_string(textLength);
+
+    // SendJsonMessage: 이미 직렬화된 JSON 을 풀 프레임에 복사
+    registry.Add("framing/build/copy_json" + suffix, [textLength](State& state) {
+      const std::string body = json(MakeMessage(textLength)).dump();
+      state.Measure([&] {
+        FrameRef frame(OutboundFrame::Create((uint32_t)body.size()));
+        std::memcpy(frame->body(), body.data(), body.size());
+        DoNotOptimize(frame.get());
+      });
+      state.SetBytesPerIteration((double)(body.size() + OutboundFrame::kHeaderSize));
+    });
+
+    // 방 fan-out / SendChatMessage: 구조체를 풀 프레임에 바로 인코딩
+    registry.Add("framing/build/encode_direct" + suffix, [textLength](State& state) {
+      const ChatProtocol message = MakeMessage(textLength);
+      state.Measure([&] {
+        FrameRef frame = ChatProtocolEncoder::EncodeFrame(message);
+        DoNotOptimize(frame.get());
+      });
+    });
+
+    // 직접 인코더 이전 경로: json 트리 -> dump() -> 프레임 복사
+    registry.Add("framing/build/nlohmann_dump" + suffix, [textLength](State& state) {
+      const ChatProtocol message = MakeMessage(textLength);
+      state.Measure([&] {
+        json tree = message;
+        std::string body = tree.dump();
+        FrameRef frame(OutboundFrame::Create((uint32_t)body.size()));
+        std::memcpy(frame->body(), body.data(), body.size());
+        DoNotOptimize(frame.get());
+      });
+    });
+  }
+}
+
+}  // namespace bench
+}  // namespace quicflow
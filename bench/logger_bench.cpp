@@ -0,0 +1,116 @@
+//
+// QuicFlow-CPP - Logger Contention Benchmarks
+//
+// 여러 스레드가 동시에 로그를 남길 때 호출 1번의 지연 (호출 스레드가 얼마나 붙잡히는지)
+//
+
+#include <atomic>
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "common/logger.hpp"
+#include "loadgen/latency_histogram.hpp"
+
+namespace quicflow {
+namespace bench {
+
+namespace {
+
+// 비동기 ring 로거 이전 방식: 호출 스레드에서 포맷 + 전역 mutex + endl(flush)
+class MutexLogger {
+public:
+  MutexLogger() : out_("/dev/null") {}
+
+  template <typename... Args>
+  void Log(std::format_string<Args...> fmt, Args&&... args) {
+    std::string message = std::vformat(fmt.get(), std::make_format_args(args...));
+    std::lock_guard lock(mutex_);
+    out_ << "[LOG] " << message << std::endl;
+  }
+
+private:
+  std::mutex mutex_;
+  std::ofstream out_;
+};
+
+uint64_t NowNs() {
+  return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 호출 전후 시각 차이 (steady_clock 읽기 비용이 포함된다)
+template <typename LogCall>
+void RunContention(State& state, uint32_t threads, LogCall&& logCall) {
+  tools::LatencyHistogram latency;
+  const uint64_t total = state.iterations();
+  std::atomic<bool> go{false};
+  std::vector<std::thread> workers;
+  for (uint32_t t = 0; t < threads; ++t) {
+    uint64_t count = total * (t + 1) / threads - total * t / threads;
+    workers.emplace_back([&, t, count] {
+      while (go.load(std::memory_order_acquire) == false) {
+        std::this_thread::yield();
+      }
+      for (uint64_t i = 0; i < count; ++i) {
+        uint64_t start = NowNs();
+        logCall(t, i);
+        latency.Record(NowNs() - start);
+      }
+    });
+  }
+
+  state.StartTimer();
+  go.store(true, std::memory_order_release);
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  state.StopTimer();
+
+  auto summary = latency.Summarize();
+  state.SetCounter("call_p50_ns", (double)summary.p50);
+  state.SetCounter("call_p99_ns", (double)summary.p99);
+  state.SetCounter("call_p999_ns", (double)summary.p999);
+  state.SetCounter("call_max_ns", (double)summary.max);
+  state.SetItemsPerIteration(1);
+}
+
+}  // namespace
+
+void RegisterLoggerBenchmarks(Registry& registry) {
+  for (uint32_t threads : {1u, 8u, 32u}) {
+    const std::string suffix = "/threads=" + std::to_string(threads);
+
+    registry.Add("logger/contention/impl=mutex" + suffix, [threads](State& state) {
+      static MutexLogger logger;
+      RunContention(state, threads, [](uint32_t thread, uint64_t i) {
+        logger.Log("bench message thread={} seq={} value={}", thread, i, 3.25);
+      });
+    });
+
+    registry.Add("logger/contention/impl=ring" + suffix, [threads](State& state) {
+      if constexpr (common::Logger::Compiled(common::LogLevel::Info) == false) {
+        state.SkipWithError("info level compiled out (QUICFLOW_LOG_LEVEL)");
+        return;
+      }
+      // 출력 비용은 백그라운드 스레드 몫이므로 파일만 버린다.
+      static const bool redirected = common::Logger::SetFile("/dev/null");
+      DoNotOptimize(redirected);
+      uint64_t droppedBefore = common::Logger::dropped();
+      RunContention(state, threads, [](uint32_t thread, uint64_t i) {
+        QF_LOG_INFO(General, "bench message thread={} seq={} value={}", thread, i, 3.25);
+      });
+      // ring 이 가득 차면 기다리지 않고 버리므로 버린 수도 함께 본다.
+      common::Logger::Flush();
+      state.SetCounter("dropped", (double)(common::Logger::dropped() - droppedBefore));
+    });
+  }
+}
+
+}  // namespace bench
+}  // namespace quicflow
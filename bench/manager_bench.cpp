@@ -0,0 +1,390 @@
+//
+// QuicFlow-CPP - Connection / Room Manager Benchmarks
+//
+// ConnectionManager 수신 -> 방 fan-out, 큰 방의 병렬 fan-out, connection 레지스트리 조회/경합, 방 기록 append/read
+//
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "common/logger.hpp"
+#include "core/executor.hpp"
+#include "core/latency_trace.hpp"
+#include "loadgen/latency_histogram.hpp"
+#include "manager/connection_manager.hpp"
+#include "manager/connection_registry.hpp"
+#include "manager/fanout_shard.hpp"
+#include "manager/history_store.hpp"
+#include "manager/room.hpp"
+#include "manager/room_manager.hpp"
+#include "network/chat_protocol_encoder.hpp"
+#include "network/quic_connection.hpp"
+#include "network/quic_protocol.hpp"
+
+namespace quicflow {
+namespace bench {
+
+using manager::ConnectionManager;
+using manager::ConnectionRegistry;
+using manager::HistoryStore;
+using manager::RoomManager;
+using network::QuicConnection;
+
+namespace {
+
+constexpr uint32_t kAllLogCategories = (1u << (uint32_t)common::LogCategory::kCount) - 1;
+
+// MsQuic 없이 만든 connection 들 (HQUIC 자리에는 keys_ 원소의 주소를 쓴다)
+// stream 이 없으므로 DeliverFrame 은 송신 대기열에 넣기 직전에 돌아온다.
+class Connections {
+public:
+  explicit Connections(size_t count) : keys_(count) {
+    connections_.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+      connections_.push_back(std::make_shared<QuicConnection>(key(i)));
+    }
+  }
+
+  HQUIC key(size_t index) { return reinterpret_cast<HQUIC>(&keys_[index]); }
+  const std::shared_ptr<QuicConnection>& operator[](size_t index) const { return connections_[index]; }
+  size_t size() const { return connections_.size(); }
+
+private:
+  std::vector<uint64_t> keys_;
+  std::vector<std::shared_ptr<QuicConnection>> connections_;
+};
+
+// 수신 메시지 1개 -> 디코딩 -> 방 actor (순번, 인코딩 1회, 기록) -> 멤버 전원의 DeliverFrame
+// Why: 방이 kParallelFanoutThreshold 보다 작으면 모든 actor 가 호출 스레드에서 바로 실행되므로
+//      OnReceiveChatMessage 가 돌아온 시점에 fan-out 이 끝나 있다. (병렬 shard 모드는 manager/parallel_fanout)
+void RunFanout(State& state, size_t members) {
+  // 송신 stream 이 없는 connection 마다 남는 오류 로그는 측정에서 뺀다.
+  common::Logger::SetCategories(kAllLogCategories & ~(1u << (uint32_t)common::LogCategory::Connection));
+  const auto previousLimit = manager::Room::publish_limit();
+  manager::Room::SetPublishLimit({});
+
+  Connections connections(members);
+  {
+    ConnectionManager connectionManager;
+    for (size_t i = 0; i < connections.size(); ++i) {
+      connectionManager.OnNewConnection(connections[i]);  // 기본 방(lobby) 참여
+    }
+
+    ChatProtocol message;
+    message.Type = kChatTypeChat;
+    message.UserID = "user-000001";
+    message.Message = std::string(64, 'a');
+    message.Timestamp = 1767225600;
+    std::string body = json(message).dump();
+
+    state.Measure([&] {
+      std::string received = body;  // 서버는 메시지마다 새로 받은 문자열을 넘긴다
+      connectionManager.OnReceiveChatMessage(connections[0], received);
+    });
+    state.SetItemsPerIteration((double)members);
+
+    // 방이 비면 목록에서 빠지므로 다음 실행은 새 lobby 에서 시작한다.
+    for (size_t i = 0; i < connections.size(); ++i) {
+      RoomManager::GetInstance().LeaveAll(connections.key(i));
+    }
+  }
+
+  manager::Room::SetPublishLimit(previousLimit);
+  common::Logger::SetCategories(kAllLogCategories);
+}
+
+// 조회 스레드 readers 개가 Find 하는 동안 스레드 1개가 Insert/Erase 를 계속한다.
+void RunRegistryFind(State& state, uint32_t readers, bool churn) {
+  constexpr size_t kEntries = 10000;
+  Connections connections(kEntries + 1024);
+  ConnectionRegistry registry;
+  for (size_t i = 0; i < kEntries; ++i) {
+    registry.Insert(connections.key(i), connections[i]);
+  }
+
+  std::atomic<bool> go{false};
+  std::atomic<bool> stop{false};
+  std::thread writer;
+  if (churn) {
+    writer = std::thread([&] {
+      size_t next = 0;
+      while (stop.load(std::memory_order_relaxed) == false) {
+        size_t index = kEntries + (next++ % 1024);
+        registry.Insert(connections.key(index), connections[index]);
+        registry.Erase(connections.key(index));
+      }
+    });
+  }
+
+  const uint64_t total = state.iterations();
+  std::vector<std::thread> threads;
+  for (uint32_t r = 0; r < readers; ++r) {
+    uint64_t count = total * (r + 1) / readers - total * r / readers;
+    threads.emplace_back([&, r, count] {
+      std::mt19937 random(r + 1);
+      std::uniform_int_distribution<size_t> pick(0, kEntries - 1);
+      while (go.load(std::memory_order_acquire) == false) {
+        std::this_thread::yield();
+      }
+      for (uint64_t i = 0; i < count; ++i) {
+        DoNotOptimize(registry.Find(connections.key(pick(random))));
+      }
+    });
+  }
+
+  state.StartTimer();
+  go.store(true, std::memory_order_release);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  state.StopTimer();
+
+  stop.store(true);
+  if (writer.joinable()) {
+    writer.join();
+  }
+  state.SetItemsPerIteration(1);
+}
+
+network::FrameRef MakeHistoryFrame(uint64_t id) {
+  ChatProtocol message;
+  message.Type = kChatTypeChat;
+  message.MessageId = id;
+  message.UserID = "user-000001";
+  message.Message = std::string(128, 'a');
+  message.Timestamp = 1767225600;
+  message.Room = "bench";
+  return network::ChatProtocolEncoder::EncodeFrame(message);
+}
+
+// 연결/종료 스레드 connectors 개가 Insert/Erase 를 반복하는 동안 broadcaster 개가 전체 순회(ForEach)를 한다.
+// measureBroadcast 이면 반복 1회 = 전체 순회 1번, 아니면 Insert + Erase 1쌍. 다른 쪽 처리량은 counter 로 남긴다.
+void RunRegistryContention(State& state, uint32_t connectors, uint32_t broadcasters, bool measureBroadcast) {
+  constexpr size_t kEntries = 10000;
+  constexpr size_t kKeysPerConnector = 256;
+  Connections connections(kEntries + connectors * kKeysPerConnector);
+  ConnectionRegistry registry;
+  for (size_t i = 0; i < kEntries; ++i) {
+    registry.Insert(connections.key(i), connections[i]);
+  }
+
+  auto connect = [&](uint32_t connector, uint64_t i) {
+    size_t index = kEntries + connector * kKeysPerConnector + i % kKeysPerConnector;
+    registry.Insert(connections.key(index), connections[index]);
+    registry.Erase(connections.key(index));
+  };
+  auto broadcast = [&] {
+    size_t visited = 0;
+    registry.ForEach([&](const std::shared_ptr<QuicConnection>&) { ++visited; });
+    DoNotOptimize(visited);
+  };
+
+  std::atomic<bool> go{false};
+  std::atomic<bool> stop{false};
+  std::atomic<uint64_t> backgroundOps{0};
+  const uint32_t measured = measureBroadcast ? broadcasters : connectors;
+  const uint32_t background = measureBroadcast ? connectors : broadcasters;
+  const uint64_t total = state.iterations();
+
+  std::vector<std::thread> backgroundThreads;
+  for (uint32_t t = 0; t < background; ++t) {
+    backgroundThreads.emplace_back([&, t] {
+      uint64_t ops = 0;
+      while (stop.load(std::memory_order_relaxed) == false) {
+        if (measureBroadcast) {
+          connect(t, ops);
+        } else {
+          broadcast();
+        }
+        ++ops;
+      }
+      backgroundOps.fetch_add(ops, std::memory_order_relaxed);
+    });
+  }
+
+  std::vector<std::thread> threads;
+  for (uint32_t t = 0; t < measured; ++t) {
+    uint64_t count = total * (t + 1) / measured - total * t / measured;
+    threads.emplace_back([&, t, count] {
+      while (go.load(std::memory_order_acquire) == false) {
+        std::this_thread::yield();
+      }
+      for (uint64_t i = 0; i < count; ++i) {
+        if (measureBroadcast) {
+          broadcast();
+        } else {
+          connect(t, i);
+        }
+      }
+    });
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  state.StartTimer();
+  go.store(true, std::memory_order_release);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  state.StopTimer();
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  stop.store(true);
+  for (auto& thread : backgroundThreads) {
+    thread.join();
+  }
+  state.SetItemsPerIteration(1);
+  state.SetCounter(measureBroadcast ? "connect_close_per_second" : "broadcasts_per_second",
+                   seconds > 0 ? (double)backgroundOps.load() / seconds : 0);
+}
+
+// 병렬 fan-out shard 의 대기열 끝 표시. 앞에 넣은 Deliver 가 모두 실행된 뒤에 실행된다.
+class MarkedShard : public manager::FanoutShard {
+public:
+  void Mark(std::atomic<size_t>* remaining) { remaining->fetch_sub(1, std::memory_order_release); }
+};
+
+uint64_t NowNs() {
+  return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 큰 방 fan-out: 메시지 1개를 넣은 시점부터 마지막 수신자의 DeliverFrame 이 실행될 때까지 (time-to-last-recipient)
+// threads == 0 은 방 actor 스레드 하나가 멤버 전원에게 보내는 직렬 기준선.
+// Why: Room 은 전역 Executor 에 shard 를 붙이므로 스레드 수를 바꿔 가며 잴 수 없다.
+//      Room::EnableParallelFanout / ShardOf 와 같은 방식으로 shard 를 만들고 나눠서 벤치마크 전용 Executor 에 붙인다.
+// connection 에 stream 이 없으므로 수신자 1명의 비용은 송신 대기열에 넣기 직전까지다. (manager/fanout 과 같음)
+void RunParallelFanout(State& state, size_t members, size_t threads) {
+  if (threads > std::max(1u, std::thread::hardware_concurrency())) {
+    state.SkipWithError("more executor threads than hardware threads");
+    return;
+  }
+  common::Logger::SetCategories(kAllLogCategories & ~(1u << (uint32_t)common::LogCategory::Connection));
+
+  Connections connections(members);
+  network::FrameRef frame = MakeHistoryFrame(1);
+  tools::LatencyHistogram latency;
+  uint64_t sequence = 0;
+
+  if (threads == 0) {
+    state.Measure([&] {
+      uint64_t start = NowNs();
+      network::RoomPosition position{1, ++sequence};
+      for (size_t i = 0; i < connections.size(); ++i) {
+        connections[i]->DeliverFrameAsync(frame, core::MessageTrace{}, position);
+      }
+      latency.Record(NowNs() - start);
+    });
+  } else {
+    core::Executor executor(threads);
+    const size_t shardCount = std::clamp<size_t>(threads, 1, manager::Room::kMaxFanoutShards);
+    std::vector<std::shared_ptr<MarkedShard>> shards;
+    for (size_t i = 0; i < shardCount; ++i) {
+      auto shard = std::make_shared<MarkedShard>();
+      shard->SetExecutor(&executor);
+      shards.push_back(std::move(shard));
+    }
+    auto waitForShards = [&] {
+      std::atomic<size_t> remaining{shards.size()};
+      for (const auto& shard : shards) {
+        shard->SerializeAsync(&MarkedShard::Mark, &remaining);
+      }
+      while (remaining.load(std::memory_order_acquire) != 0) {
+        std::this_thread::yield();
+      }
+    };
+
+    for (size_t i = 0; i < connections.size(); ++i) {
+      uint64_t hash = (uint64_t)(uintptr_t)connections.key(i) * 0x9E3779B97F4A7C15ull;
+      shards[(hash >> 32) % shards.size()]->AddAsync(connections[i]);
+    }
+    waitForShards();
+
+    state.Measure([&] {
+      uint64_t start = NowNs();
+      network::RoomPosition position{1, ++sequence};
+      for (const auto& shard : shards) {
+        shard->DeliverAsync(frame, core::MessageTrace{}, position);
+      }
+      waitForShards();
+      latency.Record(NowNs() - start);
+    });
+    state.SetCounter("shards", (double)shardCount);
+  }
+
+  auto summary = latency.Summarize();
+  state.SetCounter("last_recipient_p50_ns", (double)summary.p50);
+  state.SetCounter("last_recipient_p99_ns", (double)summary.p99);
+  state.SetItemsPerIteration((double)members);
+  common::Logger::SetCategories(kAllLogCategories);
+}
+
+}  // namespace
+
+void RegisterManagerBenchmarks(Registry& registry) {
+  for (size_t members : {1u, 16u, 256u, 1024u, 4000u}) {
+    registry.Add("manager/fanout/members=" + std::to_string(members),
+                 [members](State& state) { RunFanout(state, members); });
+  }
+
+  // 병렬 모드는 kParallelFanoutThreshold(4096) 이상인 방에서만 켜진다.
+  for (size_t members : {8192u, 65536u}) {
+    for (size_t threads : {0u, 1u, 2u, 4u, 8u, 16u}) {
+      registry.Add("manager/parallel_fanout/members=" + std::to_string(members) + "/threads=" + std::to_string(threads),
+                   [members, threads](State& state) { RunParallelFanout(state, members, threads); });
+    }
+  }
+
+  for (bool churn : {false, true}) {
+    for (uint32_t readers : {1u, 4u, 16u}) {
+      registry.Add("manager/registry_find/readers=" + std::to_string(readers) + (churn ? "/churn=on" : "/churn=off"),
+                   [readers, churn](State& state) { RunRegistryFind(state, readers, churn); });
+    }
+  }
+
+  // accept/close 와 broadcast 순회가 서로를 막지 않는지 (양쪽 처리량을 함께 본다)
+  for (auto [connectors, broadcasters] : {std::pair{1u, 1u}, std::pair{4u, 4u}, std::pair{8u, 1u}, std::pair{1u, 8u}}) {
+    const std::string suffix = "/connectors=" + std::to_string(connectors) + "/broadcasters=" + std::to_string(broadcasters);
+    registry.Add("manager/registry_contention/measure=broadcast" + suffix, [connectors, broadcasters](State& state) {
+      RunRegistryContention(state, connectors, broadcasters, true);
+    });
+    registry.Add("manager/registry_contention/measure=connect_close" + suffix, [connectors, broadcasters](State& state) {
+      RunRegistryContention(state, connectors, broadcasters, false);
+    });
+  }
+
+  // 메모리 ring 을 넘는 구간부터는 segment spill 비용이 포함된다. (read 2000 개도 segment 를 거친다)
+  registry.Add("manager/history/append", [](State& state) {
+    HistoryStore history("bench-append");
+    network::FrameRef frame = MakeHistoryFrame(1);
+    uint64_t id = 0;
+    state.Measure([&] { history.Append(++id, frame); });
+  });
+
+  for (size_t count : {50u, 2000u}) {
+    registry.Add("manager/history/read_recent/count=" + std::to_string(count), [count](State& state) {
+      HistoryStore history("bench-read");
+      for (uint64_t id = 1; id <= HistoryStore::kRingCapacity * 4; ++id) {
+        history.Append(id, MakeHistoryFrame(id));
+      }
+      std::vector<network::FrameRef> frames;
+      frames.reserve(count);
+      state.Measure([&] {
+        frames.clear();
+        history.ReadFrom(history.last_id() - count + 1, count, frames);
+        DoNotOptimize(frames.data());
+      });
+      state.SetItemsPerIteration((double)count);
+    });
+  }
+}
+
+}  // namespace bench
+}  // namespace quicflow
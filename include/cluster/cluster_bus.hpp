@@ -0,0 +1,139 @@
+//
+// QuicFlow-CPP - Cluster Pub/Sub Bus
+//
+
+#ifndef QUICFLOWCPP_CLUSTER_BUS_HPP
+#define QUICFLOWCPP_CLUSTER_BUS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "cluster/cluster_transport.hpp"
+#include "common/singleton.hpp"
+#include "network/outbound_frame.hpp"
+
+namespace quicflow {
+namespace cluster {
+
+// 클러스터 설정: 이 노드의 번호/주소와 상대 노드 목록
+struct ClusterConfig {
+  uint16_t NodeId = 0;
+  std::string ListenAddress;  // 예: udp://127.0.0.1:7001
+  struct Peer {
+    uint16_t NodeId;
+    std::string Address;
+  };
+  std::vector<Peer> Peers;
+};
+
+// 여러 서버 인스턴스의 같은 이름 방을 이어주는 pub/sub 버스
+// Why: 한 프로세스가 확장 한계다. 다른 인스턴스에 접속한 유저끼리도 같은 방에서 대화할 수 있게
+//      로컬 방에서 인코딩된 프레임을 "그 방에 관심 있는 원격 노드마다 1번" 보낸다.
+//      (원격 유저마다가 아님. 받은 노드가 자기 로컬 멤버에게 fan-out)
+//
+// 관심(interest) 관리:
+//   - 로컬에 방이 생기거나 없어지면 AnnounceRoom 으로 Subscribe / Unsubscribe 를 모든 노드에 알린다.
+//   - 전송은 유실될 수 있으므로 Tick 에서 주기적으로 구독 목록을 다시 알리고,
+//     관심 없는 방의 Publish 를 받으면 Unsubscribe 로 답해서 스스로 복구한다.
+//
+// 보낸 쪽 확인: 헤더의 origin 은 전송 계층이 확인한 보낸 peer 와 같아야 한다. (다르면 버림)
+//
+// 순번/기록: 원격 프레임은 받은 방에서 로컬 MessageId/Epoch 를 새로 받아 다시 인코딩되고
+//            로컬 기록에도 들어간다. (Resume 은 노드마다 자기 순번으로 동작, 다시 Publish 하지는 않음)
+class ClusterBus : public Common::Singleton<ClusterBus> {
+public:
+  ClusterBus();
+  ~ClusterBus() override;
+
+  bool Start(const ClusterConfig& config);
+  void Stop();
+  bool enabled() const { return enabled_.load(std::memory_order_acquire); }
+  uint16_t node_id() const { return node_id_; }
+
+  // 로컬 방 생성/제거 뒤 RoomManager 가 자기 락을 푼 다음 호출한다.
+  // 지금 방이 있는지 RoomManager 에서 다시 확인해서 달라졌으면 Subscribe / Unsubscribe 를 보낸다.
+  // Why: 공지를 RoomManager 락 안에서 보내면 모든 Join/Leave 가 전송을 기다린다. 락 밖에서 사건(생성/제거)을
+  //      그대로 보내면 같은 방의 생성/제거 공지가 스레드 사이에서 뒤바뀔 수 있으므로, 현재 상태를 공지한다.
+  void AnnounceRoom(std::string_view room);
+
+  // 로컬 방에서 발행된 프레임을 관심 있는 원격 노드로 보낸다. (Room actor 에서 호출)
+  // 클러스터가 꺼져 있거나 관심 있는 원격 방이 하나도 없으면 락 없이 돌아간다.
+  void Publish(std::string_view room, const network::FrameRef& frame);
+
+  // 주기 작업 (구독 재공지)
+  void Tick();
+
+  uint64_t published_messages() const { return published_messages_.load(std::memory_order_relaxed); }
+  uint64_t received_messages() const { return received_messages_.load(std::memory_order_relaxed); }
+  uint64_t dropped_messages() const { return dropped_messages_.load(std::memory_order_relaxed); }
+
+  static constexpr std::chrono::seconds kAnnounceInterval{5};
+  // 관심 노드 집합을 bitmask 로 보관하므로 상대 노드 수 상한
+  static constexpr size_t kMaxPeers = 64;
+
+private:
+  enum class MessageType : uint8_t {
+    Hello = 1,        // 시작 알림. 받은 노드는 자기 구독 목록을 답한다.
+    Subscribe = 2,
+    Unsubscribe = 3,
+    Publish = 4,      // payload = 송신 프레임 (헤더 포함)
+  };
+
+  // [Wire] magic(4) version(1) type(1) origin(2) roomLength(2) room(...) payload(...)  (Little Endian)
+  static constexpr uint32_t kMagic = 0x42434651;  // "QFCB"
+  static constexpr uint8_t kVersion = 1;
+  static constexpr size_t kHeaderSize = 10;
+
+  // sender: 전송 계층이 확인한 peer 번호 (ClusterTransport::ReceiveHandler)
+  void OnReceive(int sender, const uint8_t* data, size_t length);
+  // peer < 0 이면 모든 노드에게
+  void SendControl(MessageType type, std::string_view room, int peer);
+  void AnnounceSubscriptions(int peer);
+  size_t WriteHeader(uint8_t* out, MessageType type, std::string_view room) const;
+  int PeerOfNode(uint16_t nodeId) const;
+
+  // string_view 로 찾을 때 std::string 을 만들지 않도록 (heterogeneous lookup)
+  struct StringHash {
+    using is_transparent = void;
+    size_t operator()(std::string_view text) const noexcept { return std::hash<std::string_view>{}(text); }
+  };
+
+  std::unique_ptr<ClusterTransport> transport_;
+  std::atomic<bool> enabled_{false};
+  uint16_t node_id_ = 0;
+  // 송신 중(shared) / Stop(unique). Stop 이 transport 를 닫기 전에 송신을 모두 끝내게 한다.
+  std::shared_mutex send_mutex_;
+
+  // Start 이후 변경되지 않음
+  std::vector<uint16_t> peer_nodes_;  // peer 번호 -> node id
+
+  // 방 이름 -> 관심 있는 peer bitmask
+  // Publish 는 읽기만 하므로 shared_lock (여러 Room actor 가 동시에 찾는다)
+  mutable std::shared_mutex mutex_;
+  std::unordered_map<std::string, uint64_t, StringHash, std::equal_to<>> remote_interest_;
+  // remote_interest_.size() (mutex_ 안에서 갱신). 0 이면 Publish 가 락 없이 돌아간다.
+  std::atomic<size_t> interested_rooms_{0};
+  std::unordered_set<std::string, StringHash, std::equal_to<>> local_rooms_;
+  // AnnounceRoom 의 "상태 확인 -> local_rooms_ 갱신 -> 전송" 을 직렬화해서 공지 순서가 상태 순서와 같게 한다.
+  std::mutex announce_mutex_;
+  std::chrono::steady_clock::time_point last_announce_;
+
+  std::atomic<uint64_t> published_messages_{0};
+  std::atomic<uint64_t> received_messages_{0};
+  std::atomic<uint64_t> dropped_messages_{0};
+};
+
+}  // namespace cluster
+}  // namespace quicflow
+
+#endif  // QUICFLOWCPP_CLUSTER_BUS_HPP
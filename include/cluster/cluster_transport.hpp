@@ -0,0 +1,61 @@
+//
+// QuicFlow-CPP - Cluster Transport Interface
+//
+
+#ifndef QUICFLOWCPP_CLUSTER_TRANSPORT_HPP
+#define QUICFLOWCPP_CLUSTER_TRANSPORT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace quicflow {
+namespace cluster {
+
+// 전송할 버퍼 조각 (헤더 + 프레임을 복사 없이 한 메시지로 보내기 위한 gather 목록)
+struct ClusterBuffer {
+  const uint8_t* data;
+  size_t length;
+};
+
+// 노드 간 메시지 전송 계층
+// Why: 클러스터 버스는 "어떤 노드에 무엇을 보낼지"만 결정하고, 실제 전송 방식
+//      (로컬 UDP/UDS, 공유 메모리, 외부 브로커 등)은 구현체를 바꿔 끼울 수 있게 한다.
+//
+// 메시지 경계가 유지되어야 하며(datagram 의미), 유실은 허용된다. (버스가 재공지로 복구)
+// 주소로 보낸 쪽을 알 수 있는 전송은 설정된 peer 가 아닌 곳에서 온 메시지를 handler 에 넘기지 않는다.
+class ClusterTransport {
+public:
+  // 수신 콜백. 전송 계층의 수신 스레드에서 호출되며 data 는 호출 동안만 유효하다.
+  // peer 는 전송 계층이 확인한 보낸 쪽 (AddPeer 번호). 확인할 수 없는 전송이면 kUnattributedPeer
+  using ReceiveHandler = std::function<void(int peer, const uint8_t* data, size_t length)>;
+
+  // 보낸 쪽을 주소로 가릴 수 없는 전송 (shm: 접근 권한으로만 제한)
+  static constexpr int kUnattributedPeer = -1;
+
+  virtual ~ClusterTransport() = default;
+
+  virtual bool Start(ReceiveHandler handler) = 0;
+  virtual void Stop() = 0;
+
+  // 상대 노드 등록. 이후 SendTo 에 쓸 번호를 돌려준다 (실패 시 -1)
+  virtual int AddPeer(const std::string& address) = 0;
+
+  // buffers 를 이어 붙인 메시지 1개를 peer 에게 전송
+  virtual bool SendTo(int peer, const ClusterBuffer* buffers, size_t count) = 0;
+
+  // 메시지 1개의 최대 크기
+  virtual size_t max_message_size() const = 0;
+
+  // 주소 형식에 맞는 구현체 생성
+  //   udp://127.0.0.1:7001, unix:///tmp/quicflow-node1.sock  -> DatagramTransport
+  //   shm://node1                                          -> ShmTransport (같은 호스트)
+  static std::unique_ptr<ClusterTransport> Create(const std::string& listenAddress);
+};
+
+}  // namespace cluster
+}  // namespace quicflow
+
+#endif  // QUICFLOWCPP_CLUSTER_TRANSPORT_HPP
@@ -0,0 +1,69 @@
+//
+// QuicFlow-CPP - Datagram Cluster Transport (UDP / Unix domain socket)
+//
+
+#ifndef QUICFLOWCPP_DATAGRAM_TRANSPORT_HPP
+#define QUICFLOWCPP_DATAGRAM_TRANSPORT_HPP
+
+#include <sys/socket.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cluster/cluster_transport.hpp"
+
+namespace quicflow {
+namespace cluster {
+
+// datagram 소켓 기반 전송 계층
+// Why: 같은 머신에서 여러 인스턴스를 띄워 클러스터를 시험할 수 있는 가장 단순한 구현.
+//      udp:// 는 다른 머신으로도 그대로 쓸 수 있고, unix:// 는 같은 머신에서 더 빠르다.
+//
+// 송신은 호출한 스레드에서 sendmsg 로 바로 보내고 (gather, 복사 없음),
+// 수신은 전용 스레드 1개가 poll + recvfrom 으로 받아 handler 를 호출한다.
+// 보낸 주소가 설정된 peer 주소(= 그 노드의 listen 주소)와 다르면 버린다.
+// (peer 는 listen 소켓으로 보내므로 보낸 주소가 listen 주소와 같다. 0.0.0.0 대신 실제 주소로 bind 할 것)
+class DatagramTransport : public ClusterTransport {
+public:
+  explicit DatagramTransport(std::string listenAddress);
+  ~DatagramTransport() override;
+
+  bool Start(ReceiveHandler handler) override;
+  void Stop() override;
+  int AddPeer(const std::string& address) override;
+  bool SendTo(int peer, const ClusterBuffer* buffers, size_t count) override;
+  size_t max_message_size() const override;
+
+  static constexpr int kReceiveBufferBytes = 4 * 1024 * 1024;
+  static constexpr int kPollTimeoutMs = 100;
+
+private:
+  struct Endpoint {
+    sockaddr_storage address{};
+    socklen_t length = 0;
+  };
+
+  // "udp://host:port" 또는 "unix:///path" 를 해석
+  static bool ParseAddress(const std::string& text, Endpoint& out, int& family);
+  // 보낸 주소와 같은 peer 번호. 없으면 -1
+  int PeerOfAddress(const sockaddr_storage& address, socklen_t length) const;
+  void ReceiveLoop();
+
+  std::string listen_address_;
+  int family_ = 0;
+  int socket_ = -1;
+  std::string unix_path_;  // unix:// 일 때 종료 시 지울 경로
+
+  std::vector<Endpoint> peers_;
+  ReceiveHandler handler_;
+  std::atomic<bool> running_{false};
+  std::thread receive_thread_;
+  uint64_t rejected_datagrams_ = 0;  // 수신 스레드 전용
+};
+
+}  // namespace cluster
+}  // namespace quicflow
+
+#endif  // QUICFLOWCPP_DATAGRAM_TRANSPORT_HPP
@@ -0,0 +1,100 @@
+//
+// QuicFlow-CPP - Shared Memory Ring Cluster Transport
+//
+
+#ifndef QUICFLOWCPP_SHM_TRANSPORT_HPP
+#define QUICFLOWCPP_SHM_TRANSPORT_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cluster/cluster_transport.hpp"
+
+namespace quicflow {
+namespace cluster {
+
+struct ShmRingHeader;
+
+// 같은 호스트의 서버 프로세스끼리 공유 메모리 ring 으로 메시지를 주고받는 전송 계층
+// Why: NUMA 노드마다 프로세스를 하나씩 띄우면 노드 간 fan-out 이 소켓을 거치면서
+//      메시지마다 syscall 과 커널 복사가 생긴다. 공유 메모리에 바로 쓰고 바로 읽는다.
+//
+// 구조:
+//   - 노드마다 자기 수신 ring 1개를 POSIX shm (shm_open, "/quicflow-<name>") 에 만든다.
+//   - 다른 노드들은 그 ring 을 매핑해서 직접 쓴다 (multi-producer, single-consumer).
+//     producer 는 write_head 를 CAS 로 예약하고 본문을 쓴 뒤 길이 word 를 release 로 기록(commit)한다.
+//   - consumer 는 ring 안의 메시지를 복사하지 않고 그대로 handler 에 넘긴다.
+//     (ClusterBus 가 로컬 멤버가 공유할 송신 프레임으로 1번만 복사)
+//   - 깨우기: Linux 는 공유 futex, 그 외(macOS)는 짧게 spin 후 점점 길게 잠드는 polling.
+//
+//   - 상대 재시작 감지: 정상 종료는 alive == 0 으로 바로 알 수 있지만, 죽은 consumer 는 alive 를 지우지 못한다.
+//     producer 는 kRecheckInterval 마다 shm 이름을 다시 열어 inode 를 비교하고, 다르면 새 ring 으로 바꾼다.
+//     (매핑을 잡고 있는 동안 이전 inode 는 재사용되지 않는다)
+//
+// 제약: producer 가 예약 후 commit 전에 죽으면 ring 이 그 자리에서 멈춘다. (같은 호스트 배포 전제)
+class ShmTransport : public ClusterTransport {
+public:
+  explicit ShmTransport(std::string listenAddress);
+  ~ShmTransport() override;
+
+  bool Start(ReceiveHandler handler) override;
+  void Stop() override;
+  int AddPeer(const std::string& address) override;
+  bool SendTo(int peer, const ClusterBuffer* buffers, size_t count) override;
+  size_t max_message_size() const override { return kRingCapacity / 4; }
+
+  static constexpr uint64_t kRingCapacity = 8 * 1024 * 1024;  // 2의 거듭제곱
+  static constexpr uint32_t kWaitTimeoutMs = 100;
+  static constexpr std::chrono::milliseconds kRecheckInterval{1000};
+
+private:
+  struct Peer {
+    std::string name;                           // shm 객체 이름
+    std::atomic<ShmRingHeader*> ring{nullptr};  // 송신 fast path (락 없음)
+    std::mutex mutex;                           // 매핑 (재)연결 보호
+    uint64_t inode = 0;                         // 지금 매핑의 shm inode (mutex)
+    std::atomic<int64_t> next_check{0};         // 다음 inode 확인 시각 (steady_clock ms)
+    // 상대가 재시작해서 버린 매핑. 다른 스레드가 아직 쓰고 있을 수 있으므로 Stop 에서 해제한다.
+    std::vector<ShmRingHeader*> retired;
+  };
+
+  // "shm://name" -> "/quicflow-name"
+  static bool ParseAddress(const std::string& address, std::string& outName);
+  // inode: 매핑한 shm 객체의 inode (nullptr 이면 무시)
+  static ShmRingHeader* Map(const std::string& name, bool create, uint64_t* inode = nullptr);
+  // shm 이름이 지금 가리키는 inode. 없으면 0
+  static uint64_t CurrentInode(const std::string& name);
+  static void Unmap(ShmRingHeader* ring);
+  // 상대 ring 이 아직 없거나 재시작되었으면 다시 연다.
+  ShmRingHeader* AcquirePeerRing(Peer& peer);
+  // 상대가 없어진 매핑을 송신에서 빼고 retired 로 옮긴다. (peer.mutex)
+  static void RetirePeerRing(Peer& peer);
+  void ReceiveLoop();
+  // 쌓인 메시지를 모두 처리하고 처리한 개수를 돌려준다.
+  size_t Drain();
+  void WaitForData();
+  bool HasData() const;
+
+  std::string listen_address_;
+  std::string local_name_;
+  ShmRingHeader* local_ = nullptr;
+  std::vector<std::unique_ptr<Peer>> peers_;
+  ReceiveHandler handler_;
+  std::atomic<bool> running_{false};
+  // SendTo 실행 중인 스레드 수. Stop 은 이것이 0 이 된 뒤에 상대 ring 을 해제한다.
+  std::atomic<uint32_t> active_senders_{0};
+  std::thread receive_thread_;
+  uint64_t read_tail_ = 0;       // consumer 전용
+  uint32_t idle_sleep_us_ = 0;   // futex 가 없는 플랫폼의 polling 간격
+};
+
+}  // namespace cluster
+}  // namespace quicflow
+
+#endif  // QUICFLOWCPP_SHM_TRANSPORT_HPP
@@ -5,11 +5,29 @@
 #ifndef QUICFLOWCPP_LOGGER_HPP
 #define QUICFLOWCPP_LOGGER_HPP
 
-#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
 #include <string>
-#include <mutex>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
 #include <format> // C++20 필수 (없으면 fmt 라이브러리 사용 권장)
 
+// 컴파일되는 최소 로그 레벨 (0 Trace, 1 Debug, 2 Info, 3 Warning, 4 Error, 5 Off)
+// 이보다 낮은 레벨의 QF_LOG_* 는 인자 평가까지 포함해서 코드가 생성되지 않는다.
+#ifndef QUICFLOW_LOG_LEVEL
+#ifdef _DEBUG
+#define QUICFLOW_LOG_LEVEL 0
+#else
+#define QUICFLOW_LOG_LEVEL 2
+#endif
+#endif
+
 namespace common {
 // [색상 코드] 콘솔 가독성을 위해 ANSI Color 사용
 #define COLOR_RESET   "\033[0m"
@@ -17,17 +35,46 @@ namespace common {
 #define COLOR_WARN    "\033[33m" // 노란색
 #define COLOR_ERROR   "\033[31m" // 빨간색
 
+enum class LogLevel : uint8_t { Trace, Debug, Info, Warning, Error, Off };
+
+// 로그 분류. 실행 중 분류별로 켜고 끌 수 있다. (--log.categories)
+enum class LogCategory : uint8_t {
+  General,
+  Server,      // QuicServer, listener, admission
+  Connection,  // connection 이벤트
+  Stream,      // 스트림 송수신, framing
+  Manager,     // ConnectionManager
+  Room,        // Room, RoomManager
+  History,
+  Cluster,
+  Core,        // executor, actor, event loop
+  Config,      // 설정, 인증서, MsQuic 초기화
+  kCount,
+};
+
+// 비동기 로거
+// Why: 호출하는 스레드에서 std::format + 전역 mutex + flush 를 하면 로그 한 줄마다 모든 스레드가 줄을 선다.
+//
+// 호출 스레드는 포맷 문자열 포인터(= ID, 리터럴이라 수명이 프로그램 전체)와 인자 원본 바이트만
+// 스레드별 lock-free ring(SPSC)에 복사한다. 백그라운드 스레드가 ring 들을 모아서 시간순으로
+// 포맷하고 한 번에 쓴다. ring 이 가득 차면 기다리지 않고 버린다. (버린 개수는 나중에 경고로 남긴다)
+//
+// 인자: 산술/enum/포인터 등 trivially copyable 타입은 그대로, 문자열(std::string, string_view,
+//       const char*)은 kMaxStringBytes 까지 복사한다.
 class Logger {
 public:
   // 인스턴스 생성 금지 (Static Class)
   Logger() = delete;
 
+  // 메시지별 로그는 아래 QF_LOG_* 매크로를 쓴다. (레벨/분류 지정, 컴파일 시 제거)
+  // Log / Warning / Error 는 General 분류로 남긴다.
+
   // =========================================================
   // 1. Log (일반 정보)
   // =========================================================
   template<typename... Args>
   static void Log(std::format_string<Args...> fmt, Args&&... args) {
-    Output(Level::Info, fmt, std::forward<Args>(args)...);
+    Output<LogLevel::Info>(LogCategory::General, fmt, std::forward<Args>(args)...);
   }
 
   // =========================================================
@@ -35,7 +82,7 @@ public:
   // =========================================================
   template<typename... Args>
   static void Warning(std::format_string<Args...> fmt, Args&&... args) {
-    Output(Level::Warning, fmt, std::forward<Args>(args)...);
+    Output<LogLevel::Warning>(LogCategory::General, fmt, std::forward<Args>(args)...);
   }
 
   // =========================================================
@@ -43,49 +90,257 @@ public:
   // =========================================================
   template<typename... Args>
   static void Error(std::format_string<Args...> fmt, Args&&... args) {
-    Output(Level::Error, fmt, std::forward<Args>(args)...);
+    Output<LogLevel::Error>(LogCategory::General, fmt, std::forward<Args>(args)...);
+  }
+
+  // QF_LOG_* 에서 사용. Enabled 를 먼저 확인해야 한다.
+  template<typename... Args>
+  static void Write(LogLevel level, LogCategory category, std::format_string<Args...> fmt, Args&&... args) {
+    Record(level, category, fmt, std::forward<Args>(args)...);
+  }
+
+  static constexpr LogLevel kCompiledLevel = (LogLevel)QUICFLOW_LOG_LEVEL;
+  static constexpr bool Compiled(LogLevel level) {
+    return level >= kCompiledLevel && level != LogLevel::Off;
+  }
+  static bool Enabled(LogLevel level, LogCategory category) {
+    return level >= min_level_.load(std::memory_order_relaxed)
+      && (category_mask_.load(std::memory_order_relaxed) & (1u << (uint32_t)category)) != 0;
   }
 
+  // 실행 중 최소 레벨 / 켜진 분류 (컴파일된 레벨보다 낮출 수는 없다)
+  static void SetLevel(LogLevel level) { min_level_.store(std::max(level, kCompiledLevel), std::memory_order_relaxed); }
+  static void SetCategories(uint32_t mask) { category_mask_.store(mask, std::memory_order_relaxed); }
+  static bool ParseLevel(std::string_view text, LogLevel& out);
+  static bool ParseCategory(std::string_view text, LogCategory& out);
+  static const char* CategoryName(LogCategory category);
+
+  // 로그 파일 경로 (비어 있으면 콘솔). 시작 시 설정
+  static bool SetFile(const std::string& path);
+  // 호출 전에 기록된 로그가 모두 쓰일 때까지 기다린다.
+  static void Flush();
+  // 남은 로그를 쓰고 백그라운드 스레드를 끝낸다. (atexit 에도 등록된다)
+  static void Shutdown();
+
+  // 버려진 레코드 수 (ring 가득 참)
+  static uint64_t dropped();
+
+  static constexpr size_t kRingBytes = 256 * 1024;  // 스레드당
+  static constexpr size_t kMaxStringBytes = 1024;
+
 private:
-  enum class Level { Info, Warning, Error };
-  static std::mutex _mutex; // Thread-Safe를 위한 뮤텍스
+  using Level = LogLevel;
+
+  // 인자 원본 바이트를 문자열로 포맷한다. (레코드마다 템플릿 인스턴스 포인터를 저장)
+  using FormatFn = void (*)(std::string_view format, const uint8_t* args, std::string& out);
+
+  struct RecordHeader {
+    uint32_t size;          // 헤더 포함, 8 바이트 단위
+    Level level;
+    LogCategory category;
+    uint32_t format_size;
+    const char* format;
+    FormatFn formatter;     // nullptr 이면 ring 끝을 채우는 padding
+    int64_t timestamp_ns;   // steady_clock
+  };
+
+  // 호출 스레드의 ring 에 size 바이트를 예약한다. 공간이 없으면 nullptr
+  static uint8_t* Reserve(size_t size);
+  static void Commit();
+
+  // 문자열은 길이 + 바이트로, 나머지는 값 그대로 저장한다.
+  template <typename T>
+  static constexpr bool kIsString = std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>
+    || std::is_same_v<T, const char*> || std::is_same_v<T, char*>;
+
+  template <typename T>
+  using Stored = std::conditional_t<kIsString<std::decay_t<T>>, std::string_view, std::decay_t<T>>;
+
+  template <typename T>
+  static std::string_view ToView(const T& value) {
+    if constexpr (std::is_pointer_v<T>) {
+      if (value == nullptr) {
+        return "(null)";
+      }
+    }
+    return std::string_view(value);
+  }
+
+  template <typename T>
+  static size_t ArgSize(const T& value) {
+    if constexpr (kIsString<T>) {
+      return sizeof(uint32_t) + std::min(ToView(value).size(), kMaxStringBytes);
+    } else {
+      static_assert(std::is_trivially_copyable_v<T>, "Logger arguments must be strings or trivially copyable");
+      return sizeof(T);
+    }
+  }
+
+  template <typename T>
+  static uint8_t* WriteArg(uint8_t* cursor, const T& value) {
+    if constexpr (kIsString<T>) {
+      std::string_view text = ToView(value);
+      uint32_t length = (uint32_t)std::min(text.size(), kMaxStringBytes);
+      std::memcpy(cursor, &length, sizeof(length));
+      std::memcpy(cursor + sizeof(length), text.data(), length);
+      return cursor + sizeof(length) + length;
+    } else {
+      std::memcpy(cursor, &value, sizeof(T));
+      return cursor + sizeof(T);
+    }
+  }
+
+  template <typename T>
+  static T ReadArg(const uint8_t*& cursor) {
+    if constexpr (std::is_same_v<T, std::string_view>) {
+      uint32_t length;
+      std::memcpy(&length, cursor, sizeof(length));
+      std::string_view text((const char*)cursor + sizeof(length), length);
+      cursor += sizeof(length) + length;
+      return text;
+    } else {
+      T value;
+      std::memcpy(&value, cursor, sizeof(T));
+      cursor += sizeof(T);
+      return value;
+    }
+  }
+
+  template <typename... Values>
+  static void FormatArgs(std::string_view format, [[maybe_unused]] const uint8_t* args, std::string& out) {
+    // 중괄호 초기화는 왼쪽부터 평가되므로 기록한 순서대로 읽힌다.
+    std::tuple<Values...> values{ReadArg<Values>(args)...};
+    std::apply([&](const auto&... value) {
+      std::vformat_to(std::back_inserter(out), format, std::make_format_args(value...));
+    }, values);
+  }
 
   // 실제 출력을 담당하는 내부 함수
+  template<LogLevel level, typename... Args>
+  static void Output(LogCategory category, std::format_string<Args...> fmt, Args&&... args) {
+    if constexpr (Compiled(level)) {
+      if (Enabled(level, category)) {
+        Record(level, category, fmt, std::forward<Args>(args)...);
+      }
+    }
+  }
+
   template<typename... Args>
-  static void Output(Level level, std::format_string<Args...> fmt, Args&&... args) {
+  static void Record(Level level, LogCategory category, std::format_string<Args...> fmt, Args&&... args) {
 
-    // 1. 메시지 포맷팅 (C++20 std::format)
-    // 여기서 인자들을 문자열로 변환합니다.
-    std::string message = std::format(fmt, std::forward<Args>(args)...);
+    size_t size = sizeof(RecordHeader);
+    ((size += ArgSize<std::decay_t<Args>>(args)), ...);
+    size = (size + 7) & ~size_t(7);
 
-#ifdef _DEBUG
-    // -----------------------------------------------------
-    // [DEBUG 모드] : 콘솔 출력 (Thread-Safe)
-    // -----------------------------------------------------
-    std::lock_guard<std::mutex> lock(_mutex);
-
-    switch (level) {
-      case Level::Info:
-        std::cout << COLOR_INFO << "[LOG] " << message << COLOR_RESET << std::endl;
-        break;
-      case Level::Warning:
-        std::cout << COLOR_WARN << "[WARN] " << message << COLOR_RESET << std::endl;
-        break;
-      case Level::Error:
-        std::cerr << COLOR_ERROR << "[ERR] " << message << COLOR_RESET << std::endl;
-        break;
+    uint8_t* record = Reserve(size);
+    if (record == nullptr) {
+      return;
     }
-#else
-    // -----------------------------------------------------
-    // [RELEASE 모드] : 파일 로그 or 무시
-    // -----------------------------------------------------
-    // 성능을 위해 콘솔 출력은 제거하고, 파일에 쓰거나
-    // 심각한 에러(Error 레벨)만 남기는 로직을 여기에 작성합니다.
-    if (level == Level::Error) {
-      // TODO: WriteToFile("error.log", message);
+
+    RecordHeader header{};
+    header.size = (uint32_t)size;
+    header.level = level;
+    header.category = category;
+    header.format_size = (uint32_t)fmt.get().size();
+    header.format = fmt.get().data();
+    header.formatter = &FormatArgs<Stored<Args>...>;
+    header.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+    std::memcpy(record, &header, sizeof(header));
+
+    [[maybe_unused]] uint8_t* cursor = record + sizeof(RecordHeader);
+    ((cursor = WriteArg<std::decay_t<Args>>(cursor, args)), ...);
+    Commit();
+  }
+
+  static inline std::atomic<LogLevel> min_level_{kCompiledLevel};
+  static inline std::atomic<uint32_t> category_mask_{~0u};
+
+  friend class LoggerBackend;
+};
+
+// 호출 위치마다 n 번에 1 번만 통과
+class LogSampler {
+public:
+  bool Sample(uint32_t n) { return n <= 1 || count_.fetch_add(1, std::memory_order_relaxed) % n == 0; }
+
+private:
+  std::atomic<uint64_t> count_{0};
+};
+
+// 호출 위치마다 초당 perSecond 번까지 통과. 막힌 횟수는 다음 1초 구간의 첫 통과 때 suppressed 로 돌려준다.
+class LogRateLimiter {
+public:
+  bool Allow(uint32_t perSecond, uint32_t& suppressed) {
+    int64_t now = std::chrono::duration_cast<std::chrono::seconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+    int64_t window = window_.load(std::memory_order_relaxed);
+    if (now != window && window_.compare_exchange_strong(window, now, std::memory_order_relaxed)) {
+      count_.store(0, std::memory_order_relaxed);
+      suppressed = suppressed_.exchange(0, std::memory_order_relaxed);
     }
-#endif
+    if (count_.fetch_add(1, std::memory_order_relaxed) < perSecond) {
+      return true;
+    }
+    suppressed_.fetch_add(1, std::memory_order_relaxed);
+    return false;
   }
+
+private:
+  std::atomic<int64_t> window_{0};
+  std::atomic<uint32_t> count_{0};
+  std::atomic<uint32_t> suppressed_{0};
 };
 }
+
+// =========================================================
+// 로그 매크로
+//   QF_LOG_INFO(Server, "listening on {}", port);
+//   QF_LOG_EVERY_N(Debug, Stream, 1000, "received {} bytes", size);      // 1000 번에 1 번
+//   QF_LOG_RATE_LIMITED(Warning, Room, 10, "publish from non-member {}", key);  // 초당 10 번까지
+// 레벨이 QUICFLOW_LOG_LEVEL 보다 낮으면 if constexpr 로 통째로 빠진다. (인자도 평가하지 않음)
+// =========================================================
+#define QF_LOG(level, category, ...)                                                                  \
+  do {                                                                                                \
+    if constexpr (::common::Logger::Compiled(::common::LogLevel::level)) {                            \
+      if (::common::Logger::Enabled(::common::LogLevel::level, ::common::LogCategory::category)) {    \
+        ::common::Logger::Write(::common::LogLevel::level, ::common::LogCategory::category, __VA_ARGS__); \
+      }                                                                                               \
+    }                                                                                                 \
+  } while (0)
+
+#define QF_LOG_TRACE(category, ...) QF_LOG(Trace, category, __VA_ARGS__)
+#define QF_LOG_DEBUG(category, ...) QF_LOG(Debug, category, __VA_ARGS__)
+#define QF_LOG_INFO(category, ...) QF_LOG(Info, category, __VA_ARGS__)
+#define QF_LOG_WARN(category, ...) QF_LOG(Warning, category, __VA_ARGS__)
+#define QF_LOG_ERROR(category, ...) QF_LOG(Error, category, __VA_ARGS__)
+
+#define QF_LOG_EVERY_N(level, category, n, ...)                                                       \
+  do {                                                                                                \
+    if constexpr (::common::Logger::Compiled(::common::LogLevel::level)) {                            \
+      static ::common::LogSampler quicflowLogSampler;                                                 \
+      if (::common::Logger::Enabled(::common::LogLevel::level, ::common::LogCategory::category)       \
+        && quicflowLogSampler.Sample(n)) {                                                            \
+        ::common::Logger::Write(::common::LogLevel::level, ::common::LogCategory::category, __VA_ARGS__); \
+      }                                                                                               \
+    }                                                                                                 \
+  } while (0)
+
+#define QF_LOG_RATE_LIMITED(level, category, perSecond, ...)                                          \
+  do {                                                                                                \
+    if constexpr (::common::Logger::Compiled(::common::LogLevel::level)) {                            \
+      static ::common::LogRateLimiter quicflowLogLimiter;                                             \
+      uint32_t quicflowSuppressed = 0;                                                                \
+      if (::common::Logger::Enabled(::common::LogLevel::level, ::common::LogCategory::category)       \
+        && quicflowLogLimiter.Allow(perSecond, quicflowSuppressed)) {                                 \
+        if (quicflowSuppressed != 0) {                                                                \
+          ::common::Logger::Write(::common::LogLevel::level, ::common::LogCategory::category,         \
+                                  "{} similar messages suppressed ({}:{})", quicflowSuppressed,        \
+                                  __FILE__, __LINE__);                                                \
+        }                                                                                             \
+        ::common::Logger::Write(::common::LogLevel::level, ::common::LogCategory::category, __VA_ARGS__); \
+      }                                                                                               \
+    }                                                                                                 \
+  } while (0)
+
 #endif  // QUICFLOWCPP_LOGGER_HPP
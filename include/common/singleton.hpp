@@ -2,6 +2,8 @@
 // Created by 최진성 on 25. 12. 19..
 //
 
+#ifndef QUICFLOWCPP_SINGLETON_HPP
+#define QUICFLOWCPP_SINGLETON_HPP
 
 namespace Common {
   template <typename T>
@@ -21,3 +23,4 @@ namespace Common {
   };
 }
 
+#endif  // QUICFLOWCPP_SINGLETON_HPP
@@ -0,0 +1,165 @@
+//
+// QuicFlow-CPP - Server Runtime Configuration
+//
+
+#ifndef QUICFLOWCPP_SERVER_CONFIG_HPP
+#define QUICFLOWCPP_SERVER_CONFIG_HPP
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "cluster/cluster_bus.hpp"
+#include "common/logger.hpp"
+#include "core/admin_server.hpp"
+#include "core/latency_trace.hpp"
+#include "core/token_bucket.hpp"
+#include "manager/history_store.hpp"
+#include "network/admission_controller.hpp"
+#include "network/connection_stats.hpp"
+#include "network/flight_recorder.hpp"
+#include "network/quic_connection.hpp"
+
+namespace quicflow {
+namespace config {
+
+// QUIC_SETTINGS 로 넘어가는 값들
+// Why: 비어 있는(optional) 항목은 IsSet 을 켜지 않아서 MsQuic 기본값을 그대로 쓴다.
+//      기존에 하드코딩되어 있던 값(idle timeout, keep-alive, 양방향 스트림 수)만 기본값을 채워둔다.
+struct QuicTunables {
+  std::optional<uint64_t> IdleTimeoutMs = 60 * 60 * 1000;  // 1 hour
+  std::optional<uint32_t> KeepAliveIntervalMs = 30 * 1000;
+  std::optional<uint16_t> PeerBidiStreamCount = 100;
+  std::optional<uint16_t> PeerUnidiStreamCount;
+  // flow-control window: 스트림 하나 / connection 전체 수신 윈도우 (bytes)
+  std::optional<uint32_t> StreamRecvWindow;
+  std::optional<uint32_t> ConnFlowControlWindow;
+  // MsQuic worker 가 connection 하나를 한 번 드레인할 때 처리하는 operation 수
+  // (작으면 connection 간 공정성/지연, 크면 처리량)
+  std::optional<uint8_t> MaxOperationsPerDrain;
+  std::optional<uint32_t> MaxWorkerQueueDelayUs;
+  std::optional<bool> PacingEnabled;
+  std::optional<bool> SendBufferingEnabled;
+  std::optional<bool> DatagramReceiveEnabled;
+  std::optional<uint32_t> InitialWindowPackets;
+  std::optional<uint32_t> MaxAckDelayMs;
+};
+
+// registration(실행 프로필) + configuration 한 쌍과 그 쌍이 받는 ALPN 목록
+// Why: 대용량 전송(history 동기화, 첨부)이 채팅과 같은 MsQuic worker 를 나눠 쓰면
+//      채팅 지연이 같이 늘어난다. ALPN 별로 registration 을 나눠서 worker 를 분리한다.
+struct ProfileConfig {
+  std::string Name;
+  std::vector<std::string> Alpns;
+  QUIC_EXECUTION_PROFILE ExecutionProfile = QUIC_EXECUTION_PROFILE_LOW_LATENCY;
+  QuicTunables Quic;
+};
+
+// main 스레드 이벤트 루프가 돌리는 주기 작업
+struct HousekeepingConfig {
+  uint32_t AdmissionIntervalUs = 100 * 1000;  // 부하 단계 갱신 (connection 폭주에 반응하는 속도)
+  uint32_t ReclaimIntervalMs = 1000;          // Epoch 회수
+  uint32_t PoolTrimIntervalMs = 60 * 1000;
+  uint64_t PoolTrimBytes = 64ull * 1024 * 1024;  // BufferPool 캐시가 이보다 크면 비운다
+};
+
+// 지표 파일 스냅샷 (Prometheus 를 쓰지 않는 환경, 장애 후 확인용)
+struct MetricsConfig {
+  std::string SnapshotFile;             // 비어 있으면 쓰지 않는다
+  uint32_t SnapshotIntervalMs = 10 * 1000;
+};
+
+// 서버 전체 설정
+// 우선순위: 기본값 < 설정 파일(--config=path) < 환경 변수(QUICFLOW_*) < 명령행(--key=value)
+//
+// 설정 파일은 JSON 이고, 명령행 키는 JSON 경로를 '.' 으로 이은 것이다.
+//   { "quic": { "stream_recv_window": 262144 } }  ==  --quic.stream_recv_window=262144
+// 배열(alpn, cluster.peers)은 명령행에서 ',' 로 구분한다.
+//
+// 최상위 alpn / execution_profile / quic.* 는 기본 프로필("default")이다.
+// 추가 프로필은 "profile.<name>.*" 로 정의한다. (quic.* 는 기본 프로필을 상속하지 않는다)
+//   { "profile": { "bulk": { "alpn": ["quicflow-bulk"], "execution_profile": "max_throughput",
+//                            "quic": { "stream_recv_window": 4194304 } } } }
+struct ServerConfig {
+  // 재시작해야 바뀌는 항목
+  uint16_t Port = 4433;
+  // shard-per-port: QuicServer 를 Shards 개 띄워서 Port, Port+1, ... 에 하나씩 listen 한다.
+  // shard 마다 registration / ConnectionManager 가 따로 있고 방은 프로세스 전체에서 공유한다.
+  uint16_t Shards = 1;
+  std::vector<std::string> Alpns{"h3", "quicflow"};
+  std::string CertificateFile = "certificate/server.cert";
+  std::string KeyFile = "certificate/server.key";
+  QUIC_EXECUTION_PROFILE ExecutionProfile = QUIC_EXECUTION_PROFILE_LOW_LATENCY;
+  std::vector<ProfileConfig> Profiles;  // 기본 프로필 외의 추가 프로필
+  size_t ExecutorThreads = 0;   // 0 이면 하드웨어 스레드 수
+  std::string HistoryDirectory; // 비어 있으면 HistoryStore 기본값
+  uint64_t HistorySegmentBudgetMb = manager::HistoryStore::kDefaultSegmentBudget / (1024 * 1024);
+  std::string LogFile;          // 비어 있으면 콘솔
+  common::LogLevel LogLevel = common::Logger::kCompiledLevel;
+  uint32_t LogCategories = ~0u;  // LogCategory 비트
+  cluster::ClusterConfig Cluster;  // ListenAddress 가 비어 있으면 단일 노드
+  // 송수신 제한은 MsQuic/actor 스레드가 락 없이 읽으므로 시작 시에만 바꾼다.
+  network::OutboundLimits Outbound;
+  network::InboundLimits Inbound;
+  core::TokenBucketConfig RoomPublishLimit{1000, 2000};
+  network::AdmissionLimits Admission;
+  HousekeepingConfig Housekeeping;
+  core::AdminConfig Admin;  // /metrics 등 운영용 HTTP endpoint
+  MetricsConfig Metrics;
+  core::LatencyTraceConfig Trace;  // 메시지 단계별 지연 추적
+  network::ConnectionStatsConfig QuicStats;  // MsQuic connection 통계 수집
+  network::FlightRecorderConfig FlightRecorder;  // connection 별 최근 이벤트 ring
+
+  // 실행 중 다시 읽어서(SIGHUP) 바로 적용되는 항목
+  QuicTunables Quic;  // configuration 에 SetParam. 이후 새로 들어오는 connection 부터 적용 (프로필별 quic.* 도 동일)
+  uint32_t MaxMessageSize = 1024 * 1024;
+
+  // 다시 읽을 때 사용하는 설정 파일 경로와 명령행 인자
+  std::string SourcePath;
+  std::vector<std::string> CommandLine;
+};
+
+class ServerConfigLoader {
+public:
+  ServerConfigLoader() = delete;
+
+  // 명령행을 해석해서 out 을 채운다. 실패하면 error 에 이유를 남기고 false.
+  // --help 는 usage 를 출력하고 false (error 는 비어 있음)
+  static bool Load(int argc, char** argv, ServerConfig& out, std::string& error);
+  // 이전 Load 와 같은 설정 파일/명령행으로 다시 읽는다.
+  static bool Reload(const ServerConfig& current, ServerConfig& out, std::string& error);
+
+  // "key=value" 하나를 적용한다. key 는 설정 파일의 JSON 경로 ("quic.pacing_enabled")
+  static bool ApplyOption(std::string_view key, std::string_view value, ServerConfig& out, std::string& error);
+
+  // 프로세스 전역 설정(송수신 제한, 메시지 크기 등)에 반영한다. QUIC_SETTINGS 는 QuicServer 가 적용한다.
+  // 재시작이 필요한 항목은 startup 이 true 일 때만 적용한다.
+  static void Apply(const ServerConfig& config, bool startup);
+
+  // 기본 프로필을 맨 앞에 두고 추가 프로필을 이어 붙인 목록
+  static std::vector<ProfileConfig> ResolveProfiles(const ServerConfig& config);
+
+  static constexpr std::string_view kDefaultProfileName = "default";
+
+  // 비어 있는 항목은 IsSet 을 켜지 않는다. defaults 를 주면 그 값으로 채우고 IsSet 을 켠다.
+  // Why: configuration 의 SetParam 은 IsSet 인 항목만 덮어쓰므로, 실행 중 "default" 로 되돌린 항목은
+  //      MsQuic 기본값(전역 설정)을 명시적으로 넣어야 이전 값이 남지 않는다.
+  static void FillQuicSettings(const QuicTunables& tunables, QUIC_SETTINGS& settings,
+                               const QUIC_SETTINGS* defaults = nullptr);
+  static void PrintUsage(const char* program);
+
+private:
+  static bool LoadFile(const std::string& path, ServerConfig& out, std::string& error);
+  static void LoadEnvironment(ServerConfig& out);
+  static bool LoadArguments(const std::vector<std::string>& arguments, ServerConfig& out, std::string& error);
+  static bool ApplyProfileOption(std::string_view key, std::string_view value, ServerConfig& out, std::string& error);
+  // 프로필끼리 ALPN 이 겹치면 안 된다. (같은 포트의 listener 를 ALPN 으로 구분하므로)
+  static bool Validate(const ServerConfig& config, std::string& error);
+};
+
+}  // namespace config
+}  // namespace quicflow
+
+#endif  // QUICFLOWCPP_SERVER_CONFIG_HPP
@@ -0,0 +1,76 @@
+//
+// QuicFlow-CPP - Local Admin HTTP Endpoint
+//
+
+#ifndef QUICFLOWCPP_ADMIN_SERVER_HPP
+#define QUICFLOWCPP_ADMIN_SERVER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace quicflow {
+namespace core {
+
+struct AdminConfig {
+  uint16_t Port = 0;                       // 0 이면 띄우지 않는다
+  std::string BindAddress = "127.0.0.1";   // 외부에 열지 않도록 기본은 loopback
+};
+
+// 운영용 HTTP/1.0 endpoint (Prometheus scrape, 상태 확인)
+// Why: 지표를 보려고 서버 프로세스에 디버거를 붙이거나 로그를 뒤지지 않는다.
+//      요청이 드물고 작으므로 전용 스레드 하나가 요청을 하나씩 처리한다. (keep-alive 없음)
+//
+//   admin.Handle("/metrics", "text/plain; version=0.0.4", [](std::string_view query) { ... });
+//
+// GET 만 받는다. 응답 본문은 handler 가 돌려준 문자열 그대로다. handler 는 admin 스레드에서 실행된다.
+class AdminServer {
+public:
+  using Handler = std::function<std::string(std::string_view query)>;
+
+  AdminServer() = default;
+  ~AdminServer();
+
+  AdminServer(const AdminServer&) = delete;
+  AdminServer& operator=(const AdminServer&) = delete;
+
+  // Start 전후 언제든 등록할 수 있다.
+  void Handle(std::string path, std::string contentType, Handler handler);
+
+  bool Start(const AdminConfig& config);
+  void Stop();
+
+  bool is_running() const { return thread_.joinable(); }
+
+  static constexpr size_t kMaxRequestBytes = 8 * 1024;
+  // 요청을 다 보내지 않는 클라이언트가 다른 요청을 막지 않도록
+  static constexpr int kReceiveTimeoutMs = 1000;
+  // Stop 을 확인하는 주기
+  static constexpr int kPollTimeoutMs = 200;
+
+private:
+  struct Route {
+    std::string content_type;
+    Handler handler;
+  };
+
+  void AcceptLoop();
+  void Serve(int client);
+
+  int listen_fd_ = -1;
+  std::atomic<bool> running_{false};
+  std::thread thread_;
+
+  std::mutex routes_mutex_;
+  std::map<std::string, Route, std::less<>> routes_;
+};
+
+}  // namespace core
+}  // namespace quicflow
+
+#endif  // QUICFLOWCPP_ADMIN_SERVER_HPP
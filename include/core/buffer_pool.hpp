@@ -0,0 +1,44 @@
+//
+// QuicFlow-CPP - Send Buffer Pool
+//
+
+#ifndef QUICFLOWCPP_BUFFER_POOL_HPP
+#define QUICFLOWCPP_BUFFER_POOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace quicflow {
+namespace core {
+
+// 송신 버퍼 재사용 풀 (Static Class)
+// Why: 메시지마다 new/delete 를 하면 브로드캐스트 버스트에서 할당기가 병목이 된다.
+//      버퍼는 actor 스레드에서 할당되고 MsQuic 스레드(SEND_COMPLETE)에서 반납되므로
+//      size class 별 lock-free 큐에 보관한다.
+//
+// Size class: 256B, 512B, ... 64KB (2의 거듭제곱). 그보다 크면 풀을 거치지 않는다.
+class BufferPool {
+public:
+  BufferPool() = delete;
+
+  // size 이상의 버퍼를 돌려준다. 실제 크기는 capacity 로 전달되며 Free 에 그대로 넘겨야 한다.
+  static uint8_t* Allocate(size_t size, size_t& capacity);
+  static void Free(uint8_t* buffer, size_t capacity) noexcept;
+
+  // 캐시된 버퍼를 모두 해제한다 (housekeeping 용)
+  static size_t Trim() noexcept;
+
+  // 현재 풀에 보관 중인 바이트
+  static size_t cached_bytes() noexcept;
+
+  static constexpr size_t kMinClassSize = 256;
+  static constexpr size_t kMaxClassSize = 64 * 1024;
+  static constexpr size_t kClassCount = 9;
+  // size class 하나가 보관할 최대 버퍼 수
+  static constexpr size_t kMaxCachedPerClass = 4096;
+};
+
+}  // namespace core
+}  // namespace quicflow
+
+#endif  // QUICFLOWCPP_BUFFER_POOL_HPP
@@ -0,0 +1,57 @@
+//
+// QuicFlow-CPP - Epoch Based Reclamation
+//
+
+#ifndef QUICFLOWCPP_EPOCH_HPP
+#define QUICFLOWCPP_EPOCH_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace quicflow {
+namespace core {
+
+// Epoch 기반 메모리 회수 (RCU 스타일, Static Class)
+// Why: 읽기가 압도적으로 많은 구조(예: 브로드캐스트용 connection snapshot)는
+//      읽는 쪽이 락 없이 포인터를 따라가고, 쓰는 쪽은 새 버전을 발행한 뒤
+//      옛 버전을 "아무도 안 볼 때" 지우면 된다.
+//
+// 사용법:
+//   {
+//     Epoch::Guard guard;              // 읽기 구간 시작 (중첩 가능)
+//     auto* snapshot = ptr.load();     // guard 안에서 읽은 포인터는 guard 동안 유효
+//     ...
+//   }
+//   // writer: 새 포인터를 store 한 뒤 옛 포인터를 Retire
+//   Epoch::Retire(old, [](void* p) { delete static_cast<Snapshot*>(p); });
+class Epoch {
+public:
+  Epoch() = delete;
+
+  class Guard {
+  public:
+    Guard();
+    ~Guard();
+    Guard(const Guard&) = delete;
+    Guard& operator=(const Guard&) = delete;
+  };
+
+  using Deleter = void (*)(void*);
+
+  // ptr 은 이미 어떤 공유 포인터에서도 도달할 수 없어야 한다.
+  static void Retire(void* ptr, Deleter deleter);
+
+  // epoch 를 진행시키고 안전해진 객체를 해제한다. 해제한 개수를 돌려준다.
+  static size_t Reclaim();
+
+  // 회수 대기 중인 객체 수
+  static size_t pending() noexcept;
+
+  // 동시에 읽기 구간에 들어갈 수 있는 스레드 슬롯 수 (넘으면 느린 경로 사용)
+  static constexpr size_t kMaxReaderSlots = 512;
+};
+
+}  // namespace core
+}  // namespace quicflow
+
+#endif  // QUICFLOWCPP_EPOCH_HPP
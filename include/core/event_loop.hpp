@@ -0,0 +1,101 @@
+//
+// QuicFlow-CPP - Main Thread Event Loop
+//
+
+#ifndef QUICFLOWCPP_EVENT_LOOP_HPP
+#define QUICFLOWCPP_EVENT_LOOP_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace quicflow {
+namespace core {
+
+// main 스레드가 도는 이벤트 루프 (시그널 / 주기 작업 / 다른 스레드에서 넘긴 작업)
+// Why: housekeeping(부하 측정, 클러스터 재공지, 메모리 회수 등)을 MsQuic 스레드나
+//      1초 sleep 루프가 아니라 한 곳에서 정해진 주기로 돌린다. 시그널도 handler 안이 아니라
+//      루프 스레드에서 일반 코드로 처리한다.
+//
+// 구현:
+//   - Linux: epoll + eventfd(깨우기) + signalfd(시그널) + timerfd(다음 타이머, ns 해상도)
+//   - macOS: kqueue + EVFILT_USER(깨우기) + EVFILT_SIGNAL + kevent timeout(ns 해상도)
+//
+// 스레드: Run / WatchSignal / Schedule 은 루프 스레드(main)에서만, Post / Stop 은 어디서나 호출 가능
+class EventLoop {
+public:
+  using Clock = std::chrono::steady_clock;
+  using Callback = std::function<void()>;
+
+  EventLoop();
+  ~EventLoop();
+
+  EventLoop(const EventLoop&) = delete;
+  EventLoop& operator=(const EventLoop&) = delete;
+
+  // 생성자에서 epoll/kqueue, eventfd, timerfd 를 모두 만들고 등록했는지
+  bool is_valid() const { return valid_; }
+
+  // 시그널을 루프에서 받는다.
+  // Linux 에서는 시그널을 block 해서 signalfd 로 받으므로 다른 스레드가 생기기 전에 호출해야 한다.
+  // (새 스레드는 block mask 를 물려받는다)
+  bool WatchSignal(int signo, Callback callback);
+
+  // 주기 작업 등록. 첫 실행은 interval 뒤. 실행이 밀려서 주기를 넘기면 밀린 횟수만큼 몰아서 돌지 않고 건너뛴다.
+  void Schedule(std::string name, std::chrono::microseconds interval, Callback callback);
+
+  // 루프 스레드에서 실행할 작업 (thread-safe)
+  void Post(Callback task);
+
+  // Stop 이 호출될 때까지 실행. Run 보다 먼저 호출된 Stop 도 유효하다. (바로 돌아옴, 다시 돌릴 수 없음)
+  void Run();
+  // thread-safe. 실행 중인 콜백이 끝난 뒤 Run 이 돌아온다.
+  void Stop();
+
+  // 주기 작업이 예정 시각보다 늦게 시작된 최대 시간 (타이머 해상도 / 루프 지연 확인용)
+  // thread-safe (admin 스레드의 지표 콜백에서 읽는다)
+  std::chrono::microseconds max_timer_lateness() const {
+    return std::chrono::microseconds(max_lateness_us_.load(std::memory_order_relaxed));
+  }
+
+private:
+  struct Timer {
+    std::string name;
+    std::chrono::microseconds interval;
+    Clock::time_point deadline;
+    Callback callback;
+  };
+
+  void Wakeup();
+  // 다음 타이머까지 (또는 이벤트가 올 때까지) 기다렸다가 이벤트를 처리한다.
+  void WaitAndDispatch();
+  void RunDueTimers();
+  void RunPosted();
+  void ArmTimer(Clock::time_point deadline);
+
+  int poll_fd_ = -1;    // epoll / kqueue
+  int wakeup_fd_ = -1;  // eventfd (Linux)
+  int signal_fd_ = -1;  // signalfd (Linux)
+  int timer_fd_ = -1;   // timerfd (Linux)
+
+  bool valid_ = false;
+  // 생성 시 true. Stop 만 false 로 바꾼다. (Run 이 다시 켜면 Run 전의 Stop 을 잃어버린다)
+  std::atomic<bool> running_{true};
+  std::unordered_map<int, Callback> signal_callbacks_;
+  std::vector<Timer> timers_;
+  // 루프 스레드만 쓰고 다른 스레드는 읽기만 한다. (us)
+  std::atomic<int64_t> max_lateness_us_{0};
+
+  std::mutex posted_mutex_;
+  std::vector<Callback> posted_;
+};
+
+}  // namespace core
+}  // namespace quicflow
+
+#endif  // QUICFLOWCPP_EVENT_LOOP_HPP
@@ -0,0 +1,68 @@
+//
+// QuicFlow-CPP - Worker Thread Executor
+//
+
+#ifndef QUICFLOWCPP_EXECUTOR_HPP
+#define QUICFLOWCPP_EXECUTOR_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "common/singleton.hpp"
+#include "core/concurrentqueue.h"
+
+namespace quicflow {
+namespace core {
+
+// 고정 크기 worker 스레드 풀
+// Why: SerializedObject 는 기본적으로 호출한 스레드(MsQuic worker)에서 바로 실행된다.
+//      큰 방의 fan-out 처럼 여러 코어에 나눠야 하는 작업은 이 풀에 붙은 actor 로 보낸다.
+//      (SerializedObject::SetExecutor 참고)
+class Executor : public Common::Singleton<Executor> {
+public:
+  // threadCount == 0 이면 하드웨어 스레드 수를 사용한다.
+  explicit Executor(size_t threadCount = 0);
+  ~Executor() override;
+
+  void Post(std::function<void()> task);
+
+  // worker 를 멈추고 join 한다. 큐에 남은 작업(실행 중에 새로 넣은 작업 포함)은 모두 실행한 뒤 끝난다.
+  // 서버 종료 시 MsQuic 을 닫은 뒤 호출한다. 이후 Post 한 작업은 실행되지 않는다. (여러 번 호출해도 된다)
+  void Shutdown();
+
+  // GetInstance 로 만들어질 때 사용할 스레드 수 (0 이면 하드웨어 스레드 수). 첫 사용 전에 호출해야 한다.
+  static void SetThreadCount(size_t threadCount) { configured_thread_count_ = threadCount; }
+
+  size_t thread_count() const { return workers_.size(); }
+  size_t queue_size_approx() const { return queue_.size_approx(); }
+
+  // 큐 지연(lag) 측정: 측정용 작업을 하나 넣고 실행될 때까지 걸린 시간을 기록한다.
+  // 이전 측정 작업이 아직 실행되지 않았으면 새로 넣지 않는다. (주기적으로 호출)
+  void ProbeLag();
+  // 마지막으로 측정된 lag 과 아직 실행되지 않은 측정 작업의 대기 시간 중 큰 값 (us)
+  uint64_t lag_us() const;
+
+private:
+  void WorkerLoop();
+
+  moodycamel::ConcurrentQueue<std::function<void()>> queue_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  bool stop_ = false;
+  std::vector<std::thread> workers_;
+
+  // 측정 작업을 넣은 시각 (0 이면 대기 중인 측정 작업 없음)
+  std::atomic<uint64_t> probe_posted_us_{0};
+  std::atomic<uint64_t> last_lag_us_{0};
+
+  static inline size_t configured_thread_count_ = 0;
+};
+
+}  // namespace core
+}  // namespace quicflow
+
+#endif  // QUICFLOWCPP_EXECUTOR_HPP
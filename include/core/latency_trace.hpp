@@ -0,0 +1,97 @@
+//
+// QuicFlow-CPP - Message Latency Tracing
+//
+
+#ifndef QUICFLOWCPP_LATENCY_TRACE_HPP
+#define QUICFLOWCPP_LATENCY_TRACE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace quicflow {
+namespace core {
+
+struct LatencyTraceConfig {
+  bool Enabled = true;        // 단계별 시각 기록 + 히스토그램
+  uint32_t SampleEvery = 0;   // N 개 메시지마다 1 개를 파일에 전체 기록 (0 = 끔)
+  std::string File;           // 전체 기록 파일 (SampleEvery 가 0 이 아니면 필요)
+  uint64_t MaxFileBytes = 256ull * 1024 * 1024;  // 넘으면 더 쓰지 않는다
+};
+
+// 수신 메시지 1개가 파이프라인을 지나며 찍는 시각 (LatencyTrace::Now, ns). 0 = 찍지 않음
+// 수신 → 방 fan-out 까지는 메시지와 함께 값으로 넘어가고, 이후에는 수신자 connection 의
+// 송신 대기열 항목에 복사되어 StreamSend / SEND_COMPLETE 까지 따라간다.
+struct MessageTrace {
+  uint64_t id = 0;           // 0 이 아니면 파일에 전체 기록하는 표본
+  uint64_t received = 0;     // ServerChatCallback RECEIVE (MsQuic worker)
+  uint64_t actor_start = 0;  // connection actor 에서 처리 시작
+  uint64_t decoded = 0;      // ChatProtocol 디코딩 완료
+  uint64_t fanout = 0;       // 방 actor 에서 인코딩 후 수신자에게 넘기기 직전
+
+  bool active() const { return received != 0; }
+};
+
+// 단계별 지연 히스토그램 + 표본 메시지의 전체 기록
+// Why: 패킷 도착부터 broadcast 가 나가기까지 어느 구간(actor 대기, 디코딩, 방 actor, 송신 대기열,
+//      ACK)에서 시간이 걸리는지 평균이 아니라 분포로 본다.
+//
+// 히스토그램 (quicflow_message_stage_latency_ns{stage=...}):
+//   receive_to_actor, actor_to_decoded, decoded_to_fanout  — 메시지당 1번
+//   fanout_to_send, send_to_complete, end_to_end           — 수신자당 1번 (end_to_end = 수신 ~ SEND_COMPLETE)
+//
+// 전체 기록 파일은 고정 크기 레코드(TraceRecord)의 나열이다. scripts/trace_to_chrome.py 로
+// Chrome trace(JSON) 로 바꿔서 chrome://tracing 이나 Perfetto 에서 본다.
+class LatencyTrace {
+public:
+  LatencyTrace() = delete;
+
+  // 서버 시작 시 1번 (파일 열기 실패 시 false, 히스토그램은 그대로 동작)
+  static bool Configure(const LatencyTraceConfig& config);
+  // 파일을 flush 하고 닫는다. (종료 시)
+  static void Close();
+
+  static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+  // 꺼져 있으면 0 (이후 단계도 모두 건너뛴다)
+  static uint64_t Stamp() { return enabled() ? Now() : 0; }
+  static uint64_t Now() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  // actor 에서 처리를 시작할 때. 수신 시각이 없으면 비활성 trace 를 돌려준다.
+  static MessageTrace Begin(uint64_t received);
+  // 방 actor 에서 fan-out 직전 (trace.fanout 이 채워진 뒤). 메시지당 단계를 기록한다.
+  static void RecordFanout(const MessageTrace& trace, const void* sender);
+  // 수신자 connection 에서 StreamSend 한 직후 (프레임마다)
+  static void RecordSend(const MessageTrace& trace, uint64_t sent);
+  // SEND_COMPLETE (프레임마다)
+  static void RecordComplete(const MessageTrace& trace, uint64_t sent, uint64_t completed, const void* recipient);
+
+  // 파일 레코드 (little-endian, 64 bytes). 파일 앞에는 kFileMagic 8 bytes
+  enum class RecordType : uint8_t { Message = 1, Delivery = 2 };
+  struct TraceRecord {
+    uint8_t type;
+    uint8_t reserved[7];
+    uint64_t id;
+    uint64_t connection;  // Message: 보낸 connection, Delivery: 받는 connection
+    uint64_t stamps[5];   // Message: received, actor_start, decoded, fanout, 0
+                          // Delivery: received, fanout, sent, completed, 0
+  };
+  static_assert(sizeof(TraceRecord) == 64);
+  static constexpr char kFileMagic[8] = {'Q', 'F', 'T', 'R', 'A', 'C', 'E', '1'};
+
+private:
+  static void Write(const TraceRecord& record);
+
+  static inline std::atomic<bool> enabled_{false};
+  static inline uint32_t sample_every_ = 0;
+  static inline std::atomic<uint64_t> sequence_{0};
+};
+
+}  // namespace core
+}  // namespace quicflow
+
+#endif  // QUICFLOWCPP_LATENCY_TRACE_HPP
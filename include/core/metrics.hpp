@@ -0,0 +1,159 @@
+//
+// QuicFlow-CPP - In-process Metrics
+//
+
+#ifndef QUICFLOWCPP_METRICS_HPP
+#define QUICFLOWCPP_METRICS_HPP
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace quicflow {
+namespace core {
+
+// 카운터/히스토그램을 나누는 조각 수
+// Why: 메시지마다 여러 스레드(MsQuic worker, executor)가 같은 cache line 에 fetch_add 하면
+//      그 줄을 서로 뺏느라 느려진다. 스레드마다 다른 조각에 더하고 읽을 때 합친다.
+constexpr size_t kMetricShards = 16;
+
+size_t AssignMetricShard();
+
+// 현재 스레드의 조각 번호 (처음 호출할 때 순서대로 배정)
+inline size_t MetricShardIndex() {
+  thread_local const size_t index = AssignMetricShard();
+  return index;
+}
+
+// 단조 증가 카운터
+class Counter {
+public:
+  void Increment(uint64_t n = 1) {
+    shards_[MetricShardIndex()].value.fetch_add(n, std::memory_order_relaxed);
+  }
+  uint64_t value() const;
+
+private:
+  struct alignas(64) Shard {
+    std::atomic<uint64_t> value{0};
+  };
+  std::array<Shard, kMetricShards> shards_;
+};
+
+// 현재 값 (연결 수 등). 자주 바뀌지 않으므로 나누지 않는다.
+class Gauge {
+public:
+  void Set(int64_t value) { value_.store(value, std::memory_order_relaxed); }
+  void Add(int64_t delta) { value_.fetch_add(delta, std::memory_order_relaxed); }
+  int64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+  std::atomic<int64_t> value_{0};
+};
+
+// Histogram 을 한 시점에 합친 값
+struct HistogramSnapshot {
+  std::vector<uint64_t> Buckets;
+  uint64_t Count = 0;
+  uint64_t Sum = 0;
+
+  // q (0~1) 분위수. 해당 bucket 의 가운데 값 (오차는 bucket 폭의 절반, 12.5% 이내)
+  uint64_t Percentile(double q) const;
+  // 가장 큰 값이 들어간 bucket 의 상한
+  uint64_t Max() const;
+};
+
+// 로그-선형(log-linear) bucket 히스토그램 (HDR histogram 과 같은 방식)
+// 2 의 거듭제곱 구간 하나를 kSubBuckets 개로 균등 분할한다. 0 ~ 2^64 전체를 상대 오차 1/kSubBuckets 로 담는다.
+// Record 는 bucket 번호 계산(clz 1번) + relaxed fetch_add 3번이다.
+class Histogram {
+public:
+  static constexpr uint32_t kSubBucketBits = 3;
+  static constexpr uint32_t kSubBuckets = 1u << kSubBucketBits;
+  static constexpr size_t kBucketCount = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+  void Record(uint64_t value) {
+    auto& shard = shards_[MetricShardIndex()];
+    shard.buckets[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    shard.count.fetch_add(1, std::memory_order_relaxed);
+    shard.sum.fetch_add(value, std::memory_order_relaxed);
+  }
+
+  HistogramSnapshot Snapshot() const;
+
+  static constexpr size_t BucketIndex(uint64_t value) {
+    if (value < kSubBuckets) {
+      return (size_t)value;
+    }
+    uint32_t shift = (uint32_t)std::bit_width(value) - 1 - kSubBucketBits;
+    return (size_t)(shift + 1) * kSubBuckets + (size_t)((value >> shift) & (kSubBuckets - 1));
+  }
+  // bucket 의 [하한, 상한) 중 하한
+  static constexpr uint64_t BucketLowerBound(size_t index) {
+    if (index < kSubBuckets) {
+      return index;
+    }
+    uint32_t shift = (uint32_t)(index / kSubBuckets) - 1;
+    return (uint64_t)(kSubBuckets + index % kSubBuckets) << shift;
+  }
+  // 포함되는 가장 큰 값
+  static constexpr uint64_t BucketUpperBound(size_t index) {
+    return index + 1 < kBucketCount ? BucketLowerBound(index + 1) - 1 : UINT64_MAX;
+  }
+
+private:
+  struct alignas(64) Shard {
+    std::array<std::atomic<uint64_t>, kBucketCount> buckets{};
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> sum{0};
+  };
+  // 조각 하나가 4KB 정도이므로 힙에 둔다.
+  std::unique_ptr<Shard[]> shards_{new Shard[kMetricShards]};
+};
+
+// 프로세스 전역 지표 목록 + Prometheus text / JSON 출력
+// Why: 이름으로 한 번만 찾아서 참조를 들고 있고, 기록할 때는 registry 를 거치지 않는다.
+//
+//   // .cpp 의 익명 namespace (정적 초기화 순서와 무관: registry 는 처음 쓸 때 만든다)
+//   core::Counter& messages_received = core::Metrics::GetCounter("quicflow_messages_received_total", "...");
+//   messages_received.Increment();
+//
+// 이름은 Prometheus 규칙(snake_case, 카운터는 _total, 단위 접미사)을 따른다.
+// labels 는 Prometheus 형식 그대로 넘긴다. (예: "reason=\"rate\"")
+// 이미 있는 (이름, labels) 로 다시 부르면 같은 객체를 돌려준다. 등록된 지표는 프로세스가 끝날 때까지 남는다.
+class Metrics {
+public:
+  Metrics() = delete;
+
+  enum class Type : uint8_t { Counter, Gauge, Histogram };
+
+  static Counter& GetCounter(std::string_view name, std::string_view help, std::string_view labels = {});
+  static Gauge& GetGauge(std::string_view name, std::string_view help, std::string_view labels = {});
+  static Histogram& GetHistogram(std::string_view name, std::string_view help, std::string_view labels = {});
+
+  // 읽을 때 값을 계산하는 지표 (이미 다른 곳에서 세고 있는 값, 인스턴스별 값)
+  // owner 가 사라지기 전에 RemoveCallbacks(owner) 를 불러야 한다. (읽는 중이면 끝날 때까지 기다린다)
+  // read 는 registry 락을 잡은 채 호출되므로 안에서 Metrics 를 다시 부르면 안 된다.
+  static void AddCallback(const void* owner, Type type, std::string_view name, std::string_view help,
+                          std::string_view labels, std::function<double()> read);
+  static void RemoveCallbacks(const void* owner);
+
+  // Prometheus text exposition format (0.0.4)
+  static std::string RenderPrometheus();
+  // 사람이 보거나 diff 하기 쉬운 JSON (히스토그램은 count / sum / 분위수)
+  static std::string RenderJson();
+  // 임시 파일에 쓴 뒤 rename 한다. (읽는 쪽이 반쯤 쓰인 파일을 보지 않도록)
+  static bool WriteSnapshot(const std::string& path);
+};
+
+}  // namespace core
+}  // namespace quicflow
+
+#endif  // QUICFLOWCPP_METRICS_HPP
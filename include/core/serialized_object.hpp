@@ -10,6 +10,7 @@
 namespace quicflow {
 namespace core {
 class SerializedTask;
+class Executor;
 
 class SerializedObject : public std::enable_shared_from_this<SerializedObject>{
 public:
@@ -20,6 +21,11 @@ public:
   long Enqueue(std::shared_ptr<SerializedTask> task);
   std::shared_ptr<SerializedTask> Dequeue();
 
+  // 실행 스레드 지정. 지정하면 호출한 스레드에서 바로 실행하지 않고 executor worker 에서 드레인한다.
+  // Why: 큰 방의 fan-out 처럼 호출자(송신자 actor)를 붙잡지 않고 여러 코어로 나눠야 하는 작업용.
+  //      작업을 넣기 전에 한 번만 설정할 것.
+  void SetExecutor(Executor* executor) { executor_ = executor; }
+
   //template<typename Func, typename... Args>
   //void SerializeAsync(Func func, Args&&... args) ;
   template<typename TargetClass, typename... FuncArgs, typename... Args>
@@ -33,12 +39,21 @@ public:
     Serialize(serializedTask);
   }
 
+protected:
+  // 큐에 쌓인 작업을 모두 처리한 직후(소유권을 놓기 전) 호출된다.
+  // Why: 드레인 단위로 모아둔 작업(예: 송신 버퍼 flush)을 마무리할 지점이 필요하다.
+  virtual void OnDrained() {}
+
+  // 현재 처리 중인 작업 이외에 대기 중인 작업이 있는지 여부
+  bool HasPendingTasks() const { return count_.load() > 1; }
+
 private:
   moodycamel::ConcurrentQueue<std::shared_ptr<SerializedTask>> queue_;
 
   std::atomic<long> count_;
   std::atomic<long> isRunning_;
   bool isDestory_;
+  Executor* executor_ = nullptr;
 
 };
 
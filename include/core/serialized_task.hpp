@@ -21,7 +21,7 @@ public:
   SerializedTask(std::shared_ptr<SerializedObject> thisObject, Task task) {
     thisObject_ = thisObject;
     func_ = task;
-    Logger::Log("SerializedTask Created");
+    QF_LOG_TRACE(Core, "SerializedTask created");
   }
 
   void Process() {
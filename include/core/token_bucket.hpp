@@ -0,0 +1,100 @@
+//
+// QuicFlow-CPP - Token Bucket Rate Limiter
+//
+
+#ifndef QUICFLOWCPP_TOKEN_BUCKET_HPP
+#define QUICFLOWCPP_TOKEN_BUCKET_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <ctime>
+
+#if defined(__APPLE__)
+#include <time.h>
+#endif
+
+namespace quicflow {
+namespace core {
+
+// 저비용 단조 시계 (ms 단위, Static Class)
+// Why: 수신 메시지마다 steady_clock 을 읽을 필요는 없다. 커널이 tick 단위로 갱신해 둔 값을 읽는다.
+//      (Linux: CLOCK_MONOTONIC_COARSE, macOS: CLOCK_MONOTONIC_RAW_APPROX)
+class CoarseClock {
+public:
+  CoarseClock() = delete;
+
+  static uint64_t NowMs() noexcept {
+#if defined(__APPLE__)
+    return clock_gettime_nsec_np(CLOCK_MONOTONIC_RAW_APPROX) / 1000000;
+#elif defined(CLOCK_MONOTONIC_COARSE)
+    timespec now{};
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &now);
+    return (uint64_t)now.tv_sec * 1000 + (uint64_t)now.tv_nsec / 1000000;
+#else
+    timespec now{};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000 + (uint64_t)now.tv_nsec / 1000000;
+#endif
+  }
+};
+
+// 토큰 버킷 설정. RatePerSecond == 0 이면 제한 없음
+struct TokenBucketConfig {
+  uint32_t RatePerSecond = 0;
+  uint32_t Burst = 0;
+};
+
+// 소유자 상태 안에 그대로 들어가는 토큰 버킷 (16 bytes)
+// 타이머 없이 TryConsume 할 때 지난 시간만큼 한꺼번에 채운다.
+// 동기화하지 않으므로 소유한 actor 안에서만 사용할 것.
+class TokenBucket {
+public:
+  bool TryConsume(const TokenBucketConfig& config, uint64_t nowMs, uint32_t cost = 1) noexcept {
+    if (config.RatePerSecond == 0) {
+      return true;
+    }
+    Refill(config, nowMs);
+
+    int64_t needed = (int64_t)cost * kScale;
+    if (milli_tokens_ < needed) {
+      return false;
+    }
+    milli_tokens_ -= needed;
+    return true;
+  }
+
+  // 벌점: 토큰을 빚(음수)으로 만들어 그만큼 더 오래 막는다.
+  // 빚은 Burst 만큼까지만 쌓인다. (계속 보내도 막히는 시간은 최대 (Burst + 1) / RatePerSecond 초)
+  void Penalize(const TokenBucketConfig& config, uint32_t tokens) noexcept {
+    int64_t floor = -(int64_t)std::max<uint32_t>(config.Burst, 1) * kScale;
+    milli_tokens_ = std::max(floor, milli_tokens_ - (int64_t)tokens * kScale);
+  }
+
+private:
+  // 1 token = 1000 milli-token. RatePerSecond 개/초 == RatePerSecond milli-token/ms
+  static constexpr int64_t kScale = 1000;
+
+  void Refill(const TokenBucketConfig& config, uint64_t nowMs) noexcept {
+    int64_t capacity = (int64_t)std::max<uint32_t>(config.Burst, 1) * kScale;
+    if (last_refill_ms_ == 0) {
+      // 첫 사용: 가득 찬 상태로 시작
+      milli_tokens_ = capacity;
+      last_refill_ms_ = nowMs;
+      return;
+    }
+    if (nowMs <= last_refill_ms_) {
+      return;
+    }
+    int64_t elapsed = (int64_t)(nowMs - last_refill_ms_);
+    last_refill_ms_ = nowMs;
+    milli_tokens_ = std::min(capacity, milli_tokens_ + elapsed * (int64_t)config.RatePerSecond);
+  }
+
+  int64_t milli_tokens_ = 0;
+  uint64_t last_refill_ms_ = 0;
+};
+
+}  // namespace core
+}  // namespace quicflow
+
+#endif  // QUICFLOWCPP_TOKEN_BUCKET_HPP
@@ -5,10 +5,13 @@
 #ifndef QUICFLOWCPP_CONNECTION_MANAGER_HPP
 #define QUICFLOWCPP_CONNECTION_MANAGER_HPP
 
-#include <unordered_map>
 #include <msquic.h>
 #include <memory>
 #include <functional>
+#include <utility>
+
+#include "core/latency_trace.hpp"
+#include "manager/connection_registry.hpp"
 
 namespace quicflow {
 
@@ -18,19 +21,38 @@ class QuicConnection;
 }
 
 namespace manager {
-#include "common/singleton.hpp"
 
-class ConnectionManager : public Common::Singleton<ConnectionManager> {
+// QuicServer 1개(= listener shard 1개)가 소유하는 connection 관리자
+// Why: 전역 singleton 이면 한 프로세스에 서버를 여러 개 띄울 수 없다. (shard-per-port, 벤치마크)
+//      방(RoomManager)은 프로세스 전체에서 공유하므로 다른 shard 의 유저와도 같은 방에서 대화한다.
+class ConnectionManager {
 public:
   ConnectionManager();
 
+  ConnectionManager(const ConnectionManager&) = delete;
+  ConnectionManager& operator=(const ConnectionManager&) = delete;
+
   void OnNewConnection(std::shared_ptr<network::QuicConnection>);
   void OnCloseConnection(std::shared_ptr<network::QuicConnection>);
 
-  void OnReceiveChatMessage(std::shared_ptr<network::QuicConnection>, std::string& strMessage);
+  // trace: 수신 ~ actor 시작까지 찍힌 지연 추적 (디코딩 후 방으로 넘긴다)
+  void OnReceiveChatMessage(std::shared_ptr<network::QuicConnection>, std::string& strMessage,
+                            core::MessageTrace trace = {});
+
+  size_t connection_count() const { return connection_map_.size(); }
+
+  // 등록된 connection (없으면 nullptr)
+  std::shared_ptr<network::QuicConnection> FindConnection(HQUIC key) const { return connection_map_.Find(key); }
+
+  // 등록된 모든 connection 에 대해 func(const std::shared_ptr<QuicConnection>&) (snapshot 순회)
+  template <typename Func>
+  void ForEachConnection(Func&& func) const {
+    connection_map_.ForEach(std::forward<Func>(func));
+  }
 
 private:
-  std::unordered_map<HQUIC, std::shared_ptr<network::QuicConnection>> connection_map_;
+  // 여러 스레드에서 동시에 접근하므로 sharded + snapshot 레지스트리 사용
+  ConnectionRegistry connection_map_;
 
 };
 
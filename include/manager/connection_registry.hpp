@@ -0,0 +1,103 @@
+//
+// QuicFlow-CPP - Sharded Connection Registry
+//
+
+#ifndef QUICFLOWCPP_CONNECTION_REGISTRY_HPP
+#define QUICFLOWCPP_CONNECTION_REGISTRY_HPP
+
+#include <msquic.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "core/epoch.hpp"
+
+namespace quicflow {
+
+namespace network {
+class QuicConnection;
+}
+
+namespace manager {
+
+// HQUIC -> QuicConnection 동시성 레지스트리
+// Why: 접속/종료는 MsQuic listener/connection 콜백 스레드에서, 브로드캐스트 순회는
+//      임의의 actor 스레드에서 일어난다. 쓰기는 shard 별 mutex 로 직렬화하고,
+//      읽기는 shard 마다 발행된 불변 snapshot 을 epoch guard 아래서 락 없이 읽는다.
+//      -> 브로드캐스트가 accept/close 를 막지 않고, accept/close 도 브로드캐스트를 막지 않는다.
+class ConnectionRegistry {
+public:
+  struct Entry {
+    HQUIC key;
+    std::shared_ptr<network::QuicConnection> connection;
+  };
+
+  // 불변 snapshot: key 로 정렬된 연속 배열 (순회는 cache friendly, 조회는 이진 탐색)
+  struct Snapshot {
+    std::vector<Entry> entries;
+  };
+
+  explicit ConnectionRegistry(size_t shardCount = kDefaultShardCount);
+  ~ConnectionRegistry();
+
+  ConnectionRegistry(const ConnectionRegistry&) = delete;
+  ConnectionRegistry& operator=(const ConnectionRegistry&) = delete;
+
+  // 등록. 같은 key 가 이미 있으면 교체하고 이전 connection 을 돌려준다.
+  std::shared_ptr<network::QuicConnection> Insert(HQUIC key, std::shared_ptr<network::QuicConnection> connection);
+  // 제거. 제거된 connection 을 돌려준다 (없으면 nullptr).
+  std::shared_ptr<network::QuicConnection> Erase(HQUIC key);
+
+  bool Contains(HQUIC key) const;
+  std::shared_ptr<network::QuicConnection> Find(HQUIC key) const;
+
+  size_t size() const noexcept { return size_.load(std::memory_order_relaxed); }
+  size_t shard_count() const noexcept { return shards_.size(); }
+
+  // 모든 connection 에 대해 func(const std::shared_ptr<QuicConnection>&) 호출
+  // 순회 도중 추가/제거는 이번 순회에 반영되지 않을 수 있다 (snapshot 의미).
+  template <typename Func>
+  void ForEach(Func&& func) const {
+    core::Epoch::Guard guard;
+    for (auto& shard : shards_) {
+      const Snapshot* snapshot = shard->current.load(std::memory_order_seq_cst);
+      for (const auto& entry : snapshot->entries) {
+        func(entry.connection);
+      }
+    }
+  }
+
+  // 특정 shard 만 순회 (여러 스레드가 나눠서 fan-out 할 때 사용)
+  template <typename Func>
+  void ForEachInShard(size_t shardIndex, Func&& func) const {
+    core::Epoch::Guard guard;
+    const Snapshot* snapshot = shards_[shardIndex]->current.load(std::memory_order_seq_cst);
+    for (const auto& entry : snapshot->entries) {
+      func(entry.connection);
+    }
+  }
+
+  static constexpr size_t kDefaultShardCount = 16;
+
+private:
+  struct alignas(64) Shard {
+    std::mutex write_mutex;
+    std::atomic<const Snapshot*> current;
+  };
+
+  size_t ShardIndex(HQUIC key) const noexcept;
+  // write_mutex 를 잡은 상태에서 새 snapshot 발행 + 옛 snapshot retire
+  static void Publish(Shard& shard, Snapshot* next);
+
+  std::vector<std::unique_ptr<Shard>> shards_;
+  std::atomic<size_t> size_{0};
+};
+
+}  // namespace manager
+}  // namespace quicflow
+
+#endif  // QUICFLOWCPP_CONNECTION_REGISTRY_HPP
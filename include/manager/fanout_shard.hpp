@@ -0,0 +1,45 @@
+//
+// QuicFlow-CPP - Room Fan-out Shard
+//
+
+#ifndef QUICFLOWCPP_FANOUT_SHARD_HPP
+#define QUICFLOWCPP_FANOUT_SHARD_HPP
+
+#include <msquic.h>
+
+#include <memory>
+
+#include "core/latency_trace.hpp"
+#include "core/serialized_object.hpp"
+#include "core/serialized_predefined.hpp"
+#include "manager/member_set.hpp"
+#include "network/outbound_frame.hpp"
+#include "network/quic_connection.hpp"
+
+namespace quicflow {
+namespace manager {
+
+using namespace quicflow::core;
+
+// 큰 방의 멤버 일부를 맡아서 fan-out 하는 중계 actor
+// Why: 수만 명 방에서 한 스레드가 전원에게 보내면 수 ms 가 걸리고 그동안 방 actor 가 막힌다.
+//      방은 멤버를 key 해시로 고정된 shard 에 나눠 두고, 메시지마다 shard 에 프레임만 넘긴다.
+//      shard 는 Executor worker 에서 병렬로 실행된다.
+//
+// 순서: 한 멤버는 항상 같은 shard 에 속하고 shard 는 직렬화되므로 수신자별 순서가 유지된다.
+class FanoutShard : public SerializedObject {
+public:
+  FanoutShard() = default;
+
+  DECLARE_ASYNC_FUNCTION(Add, std::shared_ptr<network::QuicConnection> connection)
+  DECLARE_ASYNC_FUNCTION(Remove, HQUIC key)
+  DECLARE_ASYNC_FUNCTION(Deliver, network::FrameRef frame, core::MessageTrace trace, network::RoomPosition position)
+
+private:
+  MemberSet members_;
+};
+
+}  // namespace manager
+}  // namespace quicflow
+
+#endif  // QUICFLOWCPP_FANOUT_SHARD_HPP
@@ -0,0 +1,112 @@
+//
+// QuicFlow-CPP - Room Message History
+//
+
+#ifndef QUICFLOWCPP_HISTORY_STORE_HPP
+#define QUICFLOWCPP_HISTORY_STORE_HPP
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "network/outbound_frame.hpp"
+
+namespace quicflow {
+namespace manager {
+
+class HistorySegment;
+
+// 방 1개의 append-only 메시지 기록
+// Why: 재접속한 유저에게 놓친 메시지를 보내려면 기록이 필요하지만, JSON 문자열을 힙 vector 로
+//      쌓으면 메모리도 크고 보낼 때 다시 직렬화해야 한다. 이미 인코딩된 송신 프레임을 그대로 보관한다.
+//
+// 구조:
+//   - 최근 kRingCapacity 개: 메모리 ring 에 FrameRef 로 보관 (다시 보낼 때 참조만 늘림)
+//     ring 은 kMinRingCapacity 에서 시작해 메시지가 쌓일 때 두 배씩 늘린다. (조용한 방은 작게 유지)
+//   - 그보다 오래된 것: mmap 된 segment 파일에 프레임 바이트(헤더 포함)를 그대로 이어 쓰고
+//     message id -> (segment, offset) 인덱스를 유지. 읽을 때는 segment 메모리를 가리키는
+//     borrowed 프레임을 돌려주므로 복사/재직렬화가 없다.
+//   - segment 는 최대 kMaxSegments 개까지 유지하고 가장 오래된 것부터 버린다.
+//   - 모든 방의 segment 매핑과 ring(slot 배열 + 보관 중인 프레임 바이트) 합계를 SetSegmentBudget 으로 제한한다.
+//     ring 은 budget 이 모자라면 더 늘리지 않고 지금 크기에서 spill 한다. segment 는 budget 을 넘거나
+//     spill 에 실패하면 segment 쪽 기록을 통째로 버려서 보관 구간 [first_id, last_id] 에 빈 번호가 생기지 않게 한다.
+//     (보관 중인 프레임 바이트는 ring 크기로 이미 제한되므로 budget 을 넘어도 센다. 그만큼 segment 가 양보한다)
+//
+// 동기화하지 않으므로 소유한 Room actor 안에서만 사용할 것.
+class HistoryStore {
+public:
+  explicit HistoryStore(std::string roomName);
+  ~HistoryStore();
+
+  HistoryStore(const HistoryStore&) = delete;
+  HistoryStore& operator=(const HistoryStore&) = delete;
+
+  // messageId 는 단조 증가해야 한다.
+  void Append(uint64_t messageId, network::FrameRef frame);
+
+  // messageId >= fromId 인 프레임을 오래된 순으로 최대 maxCount 개 out 에 추가한다.
+  // 추가한 개수를 돌려준다.
+  size_t ReadFrom(uint64_t fromId, size_t maxCount, std::vector<network::FrameRef>& out) const;
+
+  // 보관 중인 가장 오래된/최신 message id (비어있으면 0)
+  uint64_t first_id() const;
+  uint64_t last_id() const { return last_id_; }
+  bool empty() const { return ring_count_ == 0; }
+
+  // segment 파일을 만들 디렉터리 (기본값: 시스템 임시 디렉터리/quicflow-history)
+  static void SetDirectory(std::string directory);
+  // 프로세스 전체 기록 메모리 상한 (bytes, segment 매핑 + ring). 이미 만든 segment / ring 에는 영향이 없다.
+  static void SetSegmentBudget(uint64_t bytes);
+  static uint64_t mapped_segment_bytes();
+  // 모든 방의 ring 이 쓰는 바이트 (slot 배열 + 보관 중인 프레임)
+  static uint64_t ring_bytes();
+
+  static constexpr size_t kRingCapacity = 1024;  // 2의 거듭제곱
+  static constexpr size_t kMinRingCapacity = 16;  // 2의 거듭제곱
+  static constexpr uint32_t kSegmentSize = 4 * 1024 * 1024;
+  static constexpr size_t kMaxSegments = 8;
+  static constexpr uint64_t kDefaultSegmentBudget = 512ull * 1024 * 1024;
+
+private:
+  struct RingSlot {
+    uint64_t id = 0;
+    network::FrameRef frame;
+  };
+
+  struct IndexEntry {
+    uint64_t id;
+    uint32_t segment;  // segments_ 의 절대 번호 (first_segment_ 기준)
+    uint32_t offset;
+    uint32_t length;
+  };
+
+  // 실패하면 false (호출한 쪽이 segment 기록을 버린다)
+  bool Spill(uint64_t messageId, const network::FrameRef& frame);
+  // ring 을 두 배로 늘린다. 상한이거나 budget 이 모자라면 false
+  bool GrowRing();
+  // ring 의 가장 오래된 slot 을 segment 로 내보내고 비운다.
+  void EvictOldest();
+  void DropSegments();
+  bool OpenSegment();
+  void DropOldestSegment();
+
+  std::string room_name_;
+
+  std::vector<RingSlot> ring_;  // 크기는 0 또는 2의 거듭제곱
+  size_t ring_head_ = 0;  // 가장 오래된 slot
+  size_t ring_count_ = 0;
+  // budget 에 잡아 둔 이 방 ring 의 바이트 (slot 배열 + 프레임)
+  uint64_t ring_bytes_ = 0;
+  uint64_t last_id_ = 0;
+
+  std::deque<std::shared_ptr<HistorySegment>> segments_;
+  uint32_t first_segment_ = 0;  // segments_.front() 의 절대 번호
+  std::deque<IndexEntry> index_;
+};
+
+}  // namespace manager
+}  // namespace quicflow
+
+#endif  // QUICFLOWCPP_HISTORY_STORE_HPP
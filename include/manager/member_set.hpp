@@ -0,0 +1,73 @@
+//
+// QuicFlow-CPP - Dense Member Set
+//
+
+#ifndef QUICFLOWCPP_MEMBER_SET_HPP
+#define QUICFLOWCPP_MEMBER_SET_HPP
+
+#include <msquic.h>
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace quicflow {
+
+namespace network {
+class QuicConnection;
+}
+
+namespace manager {
+
+// fan-out 대상 멤버 집합
+// 멤버는 연속 배열(dense)로 보관해서 fan-out 순회가 cache friendly 하고,
+// key -> index 맵으로 O(1) 제거(swap-remove)를 한다.
+// 동기화하지 않으므로 소유한 actor 안에서만 사용할 것.
+class MemberSet {
+public:
+  struct Member {
+    HQUIC key;
+    std::shared_ptr<network::QuicConnection> connection;
+  };
+
+  bool Add(HQUIC key, std::shared_ptr<network::QuicConnection> connection) {
+    if (index_.contains(key)) {
+      return false;
+    }
+    index_.emplace(key, (uint32_t)members_.size());
+    members_.push_back(Member{key, std::move(connection)});
+    return true;
+  }
+
+  bool Remove(HQUIC key) {
+    auto found = index_.find(key);
+    if (found == index_.end()) {
+      return false;
+    }
+
+    // swap-remove: 마지막 멤버를 빈 자리로 옮긴다.
+    uint32_t position = found->second;
+    index_.erase(found);
+    if (position != members_.size() - 1) {
+      members_[position] = std::move(members_.back());
+      index_[members_[position].key] = position;
+    }
+    members_.pop_back();
+    return true;
+  }
+
+  bool Contains(HQUIC key) const { return index_.contains(key); }
+  size_t size() const { return members_.size(); }
+
+  const std::vector<Member>& members() const { return members_; }
+
+private:
+  std::vector<Member> members_;
+  std::unordered_map<HQUIC, uint32_t> index_;
+};
+
+}  // namespace manager
+}  // namespace quicflow
+
+#endif  // QUICFLOWCPP_MEMBER_SET_HPP
@@ -0,0 +1,124 @@
+//
+// QuicFlow-CPP - Chat Room
+//
+
+#ifndef QUICFLOWCPP_ROOM_HPP
+#define QUICFLOWCPP_ROOM_HPP
+
+#include <msquic.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/latency_trace.hpp"
+#include "core/serialized_object.hpp"
+#include "core/serialized_predefined.hpp"
+#include "core/token_bucket.hpp"
+#include "manager/history_store.hpp"
+#include "manager/member_set.hpp"
+#include "network/quic_protocol.hpp"
+
+namespace quicflow {
+
+namespace network {
+class QuicConnection;
+}
+
+namespace manager {
+
+using namespace quicflow::core;
+class FanoutShard;
+
+// 모든 connection 이 접속 시 자동으로 들어가는 기본 방
+// (Room key 없이 보낸 기존 클라이언트의 메시지는 이 방으로 간다)
+constexpr const char* kDefaultRoomName = "lobby";
+
+// 채팅 방 1개 = actor 1개
+// Why: 방의 멤버 목록 변경과 fan-out 을 같은 actor 에서 직렬화하면 락이 필요 없고,
+//      방 단위로 메시지 순서가 보장된다.
+//
+// 멤버 수가 kParallelFanoutThreshold 이상이 되면 멤버를 FanoutShard 들에 나눠서
+// fan-out 을 Executor worker 들에서 병렬로 처리한다. (한 번 나누면 방이 사라질 때까지 유지)
+// Why: 작은 방으로 되돌아갈 때 shard 에 남은 전송과 직접 전송의 순서가 뒤섞이지 않도록.
+class Room : public SerializedObject {
+public:
+  // 참여 시 기록을 얼마나 다시 보낼지
+  enum class JoinReplay {
+    None,    // 실시간 메시지만 (접속 시 자동 참여)
+    Recent,  // 최근 kJoinReplayMessages 개
+    After,   // lastSeenId 이후 놓친 구간만 (재접속 Resume). 구간이 기록에 없거나 Epoch 가 다르면 Resync 신호
+  };
+
+  explicit Room(std::string name);
+
+  const std::string& name() const { return name_; }
+  // 방 incarnation. Room 객체마다 다르고, 같은 이름의 방이 다시 만들어지거나 서버가 재시작해도 겹치지 않는다.
+  // Why: 마지막 멤버가 나가면 방이 지워지고 순번이 1부터 다시 시작하므로, 순번만으로는
+  //      클라이언트가 본 메시지가 지금 방의 것인지 알 수 없다. 순번이 붙는 모든 프레임에 함께 보낸다.
+  uint64_t epoch() const { return epoch_; }
+
+  // 이미 멤버여도 replay 는 수행한다. (같은 connection 의 Resume)
+  // lastSeenId / lastSeenEpoch 는 JoinReplay::After 에서만 사용한다.
+  DECLARE_ASYNC_FUNCTION(Join, std::shared_ptr<network::QuicConnection> connection, JoinReplay replay, uint64_t lastSeenId,
+                         uint64_t lastSeenEpoch)
+  DECLARE_ASYNC_FUNCTION(Leave, HQUIC key)
+  // sender 가 방 멤버일 때만 모든 멤버에게 전달 (한 번만 직렬화)
+  // 방 순번(MessageId)은 여기서만 부여된다. (방 actor 가 유일한 순번 부여 지점)
+  // Typing 은 순번 / 기록 없이 conflation key 를 붙여 전달한다.
+  DECLARE_ASYNC_FUNCTION(Publish, HQUIC sender, ChatProtocol message, core::MessageTrace trace)
+  // 다른 클러스터 노드에서 온 프레임을 로컬 멤버에게 전달 (다시 전파하지 않음)
+  // 원래 노드의 MessageId/Epoch 는 이 방의 순번과 섞일 수 없으므로 로컬 순번을 새로 붙여 다시 인코딩하고 기록한다.
+  DECLARE_ASYNC_FUNCTION(DeliverRemote, network::FrameRef frame)
+
+  // actor 밖에서 읽는 대략적인 멤버 수 (모니터링 용)
+  size_t member_count_hint() const { return member_count_hint_.load(std::memory_order_relaxed); }
+  bool parallel_fanout() const { return !shards_.empty(); }
+  uint64_t throttled_messages() const { return throttled_messages_.load(std::memory_order_relaxed); }
+  uint64_t rejected_remote_messages() const { return rejected_remote_messages_.load(std::memory_order_relaxed); }
+
+  // 방 단위 발행 제한 (여러 유저가 함께 방을 범람시키는 경우). 서버 시작 시 설정
+  static void SetPublishLimit(const TokenBucketConfig& limit) { publish_limit_ = limit; }
+  static const TokenBucketConfig& publish_limit() { return publish_limit_; }
+
+  static constexpr size_t kParallelFanoutThreshold = 4096;
+  static constexpr size_t kMaxFanoutShards = 64;
+  // 방에 들어온 유저에게 다시 보내주는 최근 메시지 수
+  static constexpr size_t kJoinReplayMessages = 50;
+  // Resume 으로 한 번에 다시 보내는 최대 메시지 수. 더 많이 놓쳤으면 Resync
+  static constexpr size_t kMaxResumeMessages = 5000;
+
+private:
+  // 순번을 붙여 인코딩하고 기록에 넣는다. 인코딩에 실패하면 순번을 소비하지 않고 빈 프레임을 돌려준다.
+  network::FrameRef Sequence(ChatProtocol& message);
+  // 순번 없이 인코딩하고 (방, 보낸 사람) 단위 conflation key 를 붙인다. 기록에는 넣지 않는다. (Typing)
+  network::FrameRef EncodeTransient(ChatProtocol& message);
+  void FanOut(const network::FrameRef& frame, const core::MessageTrace& trace, uint64_t sequence);
+  void EnableParallelFanout();
+  FanoutShard& ShardOf(HQUIC key);
+  void ReplayHistory(const std::shared_ptr<network::QuicConnection>& connection, JoinReplay replay, uint64_t lastSeenId,
+                     uint64_t lastSeenEpoch);
+  void SendResync(const std::shared_ptr<network::QuicConnection>& connection);
+
+  static inline TokenBucketConfig publish_limit_{1000, 2000};
+
+  std::string name_;
+  uint64_t epoch_;
+  // 멤버 여부 확인용 전체 목록 (shard 모드에서도 유지)
+  MemberSet members_;
+  std::vector<std::shared_ptr<FanoutShard>> shards_;
+  // 전송한 프레임 기록 (재접속 시 다시 직렬화하지 않고 그대로 보낸다)
+  HistoryStore history_;
+  // 마지막으로 부여한 방 순번
+  uint64_t last_sequence_ = 0;
+  std::atomic<size_t> member_count_hint_{0};
+  // 발행 제한 (actor 전용, 카운터만 밖에서 읽음)
+  TokenBucket publish_bucket_;
+  std::atomic<uint64_t> throttled_messages_{0};
+  std::atomic<uint64_t> rejected_remote_messages_{0};
+};
+
+}  // namespace manager
+}  // namespace quicflow
+
+#endif  // QUICFLOWCPP_ROOM_HPP
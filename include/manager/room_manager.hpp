@@ -0,0 +1,79 @@
+//
+// QuicFlow-CPP - Room Manager
+//
+
+#ifndef QUICFLOWCPP_ROOM_MANAGER_HPP
+#define QUICFLOWCPP_ROOM_MANAGER_HPP
+
+#include <msquic.h>
+
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "common/singleton.hpp"
+#include "manager/room.hpp"
+#include "network/quic_protocol.hpp"
+
+namespace quicflow {
+
+namespace network {
+class QuicConnection;
+}
+
+namespace manager {
+
+// 방 목록과 유저별 참여 방 목록을 관리
+// Why: 모든 메시지를 프로세스 전체에 브로드캐스트하면 메시지당 O(N) 이다.
+//      방 단위로 구독자에게만 전달한다. 방 자체의 멤버 목록은 Room actor 가 가지고,
+//      여기서는 "어떤 방이 있는지"와 "유저가 어떤 방에 있는지"만 관리한다.
+class RoomManager : public Common::Singleton<RoomManager> {
+public:
+  RoomManager();
+
+  // 방에 참여 (없으면 생성). 이미 참여 중이면 false
+  bool Join(const std::shared_ptr<network::QuicConnection>& connection, std::string_view roomName,
+            Room::JoinReplay replay = Room::JoinReplay::Recent);
+  // 재접속: lastSeenId 이후 놓친 메시지만 받는다. 방에 없으면 참여도 함께 한다.
+  // lastSeenEpoch 가 지금 방의 Epoch 와 다르면 (방이 다시 만들어짐) Resync 를 받는다.
+  bool Resume(const std::shared_ptr<network::QuicConnection>& connection, std::string_view roomName, uint64_t lastSeenId,
+              uint64_t lastSeenEpoch);
+  // 방에서 나감. 참여 중이 아니면 false. 마지막 멤버가 나가면 방을 목록에서 제거한다.
+  bool Leave(HQUIC key, std::string_view roomName);
+  // 접속 종료 시 모든 방에서 나감
+  void LeaveAll(HQUIC key);
+
+  // roomName 방에 메시지 전달 (sender 가 멤버가 아니면 버려진다)
+  bool Publish(HQUIC sender, std::string_view roomName, ChatProtocol message, core::MessageTrace trace = {});
+
+  std::shared_ptr<Room> FindRoom(std::string_view roomName) const;
+  std::vector<std::string> RoomsOf(HQUIC key) const;
+  size_t room_count() const;
+
+  // 방 이름 길이 / 유저당 방 수 제한 (클라이언트가 임의로 방을 만들 수 있으므로)
+  static constexpr size_t kMaxRoomNameLength = 64;
+  static constexpr size_t kMaxRoomsPerUser = 32;
+
+private:
+  // 참여 처리 후 Room 을 돌려준다. 실패하면(종료 중인 connection 포함) nullptr, 이미 참여 중이면 alreadyJoined = true
+  std::shared_ptr<Room> AddMembership(const network::QuicConnection& connection, std::string_view roomName,
+                                      bool& alreadyJoined);
+
+  struct RoomEntry {
+    std::shared_ptr<Room> room;
+    size_t members = 0;
+  };
+
+  // 방 목록과 유저별 방 목록은 같은 락으로 보호해서 Join/Leave 와 방 제거가 경합하지 않게 한다.
+  mutable std::shared_mutex mutex_;
+  std::unordered_map<std::string, RoomEntry> rooms_;
+  std::unordered_map<HQUIC, std::vector<std::string>> user_rooms_;
+};
+
+}  // namespace manager
+}  // namespace quicflow
+
+#endif  // QUICFLOWCPP_ROOM_MANAGER_HPP
@@ -0,0 +1,118 @@
+//
+// QuicFlow-CPP - Connection Admission Control
+//
+
+#ifndef QUICFLOWCPP_ADMISSION_CONTROLLER_HPP
+#define QUICFLOWCPP_ADMISSION_CONTROLLER_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+#include "core/token_bucket.hpp"
+extern "C" {
+#include <msquic.h>
+}
+
+namespace quicflow {
+
+namespace manager {
+class ConnectionManager;
+}
+
+namespace network {
+
+// 새 connection 수용 한도. 0 인 항목은 사용하지 않는다.
+struct AdmissionLimits {
+  uint32_t MaxConnections = 0;      // 이 서버(shard)의 connection 수
+  uint32_t MaxHandshakes = 0;       // 수락했지만 아직 handshake 가 끝나지 않은 connection 수
+  uint32_t MaxExecutorLagMs = 0;    // Executor 큐 지연
+  uint64_t MaxMemoryBytes = 0;      // 프로세스 RSS
+  // 부하 신호가 한도의 이 비율(%)을 넘으면 Throttled 단계: ThrottledAcceptRate 로만 수락
+  uint32_t ThrottlePercent = 80;
+  core::TokenBucketConfig ThrottledAcceptRate{200, 400};
+  // Throttled 이상일 때 MsQuic 이 모든 새 handshake 에 stateless retry 를 보내게 한다.
+  // (주소 검증을 한 번 거치므로 1 RTT 늦춰지고, 위조 주소의 폭주는 여기서 걸러진다)
+  bool StatelessRetry = false;
+};
+
+enum class AdmissionLevel : uint8_t {
+  Normal,      // 모두 수락 (개별 한도만 검사)
+  Throttled,   // 정해진 속도로만 수락
+  Overloaded,  // 모두 거절
+};
+
+enum class AdmissionReject : uint8_t {
+  Connections,  // MaxConnections 초과
+  Handshakes,   // MaxHandshakes 초과
+  Overloaded,   // Overloaded 단계
+  Rate,         // Throttled 단계의 수락 속도 초과
+  kCount,
+};
+
+// QUIC_LISTENER_EVENT_NEW_CONNECTION 에서 새 connection 을 받을지 결정한다.
+// Why: 점검 후 로그인 폭주 때 모두 받아들이면 handshake 처리와 actor executor 가 동시에
+//      밀려서 이미 접속한 유저의 채팅 지연까지 늘어난다.
+//
+// 개별 한도(connection 수, 진행 중 handshake 수)는 매 요청마다 바로 검사하고,
+// 부하 단계는 Update() 가 주기적으로 신호(executor lag, 메모리, 위의 두 값)를 읽어서 정한다.
+// 단계를 내릴 때는 신호가 임계값보다 kHysteresisPercent 만큼 더 내려가야 한다. (단계 진동 방지)
+class AdmissionController {
+public:
+  explicit AdmissionController(const manager::ConnectionManager& connections);
+
+  AdmissionController(const AdmissionController&) = delete;
+  AdmissionController& operator=(const AdmissionController&) = delete;
+
+  // NEW_CONNECTION 에서 호출 (여러 MsQuic worker 에서 동시에 호출된다).
+  // true 를 돌려주면 진행 중 handshake 로 집계되므로 OnHandshakeFinished 를 1번 호출해야 한다.
+  bool TryAdmit();
+  void OnHandshakeFinished();
+
+  // 주기적으로 호출 (main loop)
+  void Update();
+
+  AdmissionLevel level() const { return level_.load(std::memory_order_relaxed); }
+  uint32_t handshakes_in_flight() const { return handshakes_.load(std::memory_order_relaxed); }
+  uint64_t accepted() const { return accepted_.load(std::memory_order_relaxed); }
+  uint64_t rejected(AdmissionReject reason) const {
+    return rejected_[(size_t)reason].load(std::memory_order_relaxed);
+  }
+  // 마지막 Update 에서 가장 높았던 신호의 한도 대비 비율 (%)
+  uint32_t pressure_percent() const { return pressure_percent_.load(std::memory_order_relaxed); }
+
+  // 모든 서버에 적용되는 한도 (서버 시작 시 설정)
+  static void SetLimits(const AdmissionLimits& limits) { limits_ = limits; }
+  static const AdmissionLimits& limits() { return limits_; }
+
+  // MsQuic 전역 stateless retry 를 켜고 끈다. (상태가 바뀔 때만 SetParam)
+  static void SetStatelessRetry(const QUIC_API_TABLE* api, bool enable);
+  static uint64_t ResidentMemoryBytes();
+
+  static constexpr uint32_t kHysteresisPercent = 10;
+  // stateless retry 를 끌 때 되돌리는 MsQuic 기본값 (QUIC_DEFAULT_RETRY_MEMORY_LIMIT)
+  static constexpr uint16_t kDefaultRetryMemoryPercent = 65;
+
+private:
+  bool Reject(AdmissionReject reason);
+
+  const manager::ConnectionManager& connections_;
+  std::atomic<AdmissionLevel> level_{AdmissionLevel::Normal};
+  std::atomic<uint32_t> handshakes_{0};
+  std::atomic<uint32_t> pressure_percent_{0};
+  std::atomic<uint64_t> accepted_{0};
+  std::array<std::atomic<uint64_t>, (size_t)AdmissionReject::kCount> rejected_{};
+
+  // Throttled 단계에서만 사용 (드문 경로라 락으로 보호)
+  std::mutex bucket_mutex_;
+  core::TokenBucket accept_bucket_;
+
+  static inline AdmissionLimits limits_{};
+  static inline std::atomic<bool> stateless_retry_{false};
+};
+
+}  // namespace network
+}  // namespace quicflow
+
+#endif  // QUICFLOWCPP_ADMISSION_CONTROLLER_HPP
@@ -0,0 +1,53 @@
+//
+// QuicFlow-CPP - ChatProtocol On-Demand JSON Decoder
+//
+
+#ifndef QUICFLOWCPP_CHAT_PROTOCOL_DECODER_HPP
+#define QUICFLOWCPP_CHAT_PROTOCOL_DECODER_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace quicflow {
+namespace network {
+
+// 수신한 ChatProtocol 의 필드 view
+// 문자열 필드는 수신 버퍼(입력 문자열)를 직접 가리키며, escape 가 포함된 필드만
+// Decode 에 넘긴 scratch 버퍼에 풀어쓴 결과를 가리킨다.
+// -> 입력 문자열과 scratch 가 살아있는 동안만 유효하다.
+struct ChatProtocolView {
+  std::string_view Type;
+  uint64_t MessageId = 0;  // 선택 필드 (없거나 정수가 아니면 0)
+  std::string_view UserID;
+  std::string_view Message;
+  int64_t Timestamp = 0;
+  std::string_view Room;  // 선택 필드 (없으면 빈 view)
+  uint64_t Epoch = 0;      // 선택 필드 (없거나 정수가 아니면 0)
+};
+
+// ChatProtocol 전용 on-demand JSON 디코더 (Static Class)
+// Why: json::parse + get<ChatProtocol>() 은 필드 4개를 읽기 위해 DOM 과 std::string 을
+//      여러 개 만든다. 필요한 key 만 찾아서 view 로 돌려주고 나머지 값은 검증만 하고 건너뛴다.
+//      - 문자열 본문 스캔과 UTF-8 검증은 json_simd 의 SSE2/NEON 경로를 사용한다.
+//      - 입력 검증은 nlohmann 과 같은 수준으로 엄격하다 (잘못된 JSON/UTF-8 은 Invalid).
+class ChatProtocolDecoder {
+public:
+  ChatProtocolDecoder() = delete;
+
+  enum class Result {
+    Ok,
+    Invalid,   // JSON 형식 오류, 필수 필드 누락, 타입 불일치
+    Fallback,  // 이 디코더가 다루지 않는 형식 (예: 실수형 Timestamp) -> nlohmann 경로로 처리
+  };
+
+  static Result Decode(std::string_view json, ChatProtocolView& out, std::string& scratch);
+
+  // 중첩 깊이 제한 (모르는 key 의 값 안에서 재귀 폭주 방지)
+  static constexpr int kMaxDepth = 64;
+};
+
+}  // namespace network
+}  // namespace quicflow
+
+#endif  // QUICFLOWCPP_CHAT_PROTOCOL_DECODER_HPP
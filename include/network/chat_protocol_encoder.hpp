@@ -0,0 +1,52 @@
+//
+// QuicFlow-CPP - ChatProtocol JSON Encoder
+//
+
+#ifndef QUICFLOWCPP_CHAT_PROTOCOL_ENCODER_HPP
+#define QUICFLOWCPP_CHAT_PROTOCOL_ENCODER_HPP
+
+#include <cstdint>
+#include <string_view>
+
+#include "network/outbound_frame.hpp"
+#include "network/quic_protocol.hpp"
+
+namespace quicflow {
+namespace network {
+
+// ChatProtocol 전용 JSON 인코더 (Static Class)
+// Why: nlohmann::json 트리 생성 -> dump() 문자열 -> 송신 버퍼 복사 과정에서
+//      메시지마다 여러 번 할당/복사가 일어난다. 구조체 필드를 송신 프레임에 바로 쓴다.
+//
+// 출력은 nlohmann::json(ChatProtocol).dump() 와 바이트 단위로 동일하다.
+//   - key 는 사전순 (nlohmann 기본 object 가 std::map)
+//   - 문자열 escape 규칙과 \u00xx 소문자 hex 도 동일
+//   - 잘못된 UTF-8 은 nlohmann 이 type_error(316) 를 던지는 대신 false 를 돌려준다.
+//   - 단, MessageId 가 0 이 아니면 "MessageId", Room 이 비어있지 않으면 "Room" 확장 key 가
+//     추가된다 (nlohmann 매크로에는 없음).
+class ChatProtocolEncoder {
+public:
+  ChatProtocolEncoder() = delete;
+
+  // JSON 본문 길이 계산 (실제로 쓰지는 않음). 잘못된 UTF-8 이면 false
+  static bool EncodedSize(const ChatProtocol& protocol, uint32_t& outSize);
+
+  // out 에 JSON 본문을 쓰고 끝 위치를 돌려준다. EncodedSize 가 성공한 값에만 사용할 것.
+  static uint8_t* Encode(const ChatProtocol& protocol, uint8_t* out);
+
+  // 헤더(4byte) + JSON 본문으로 된 송신 프레임을 풀에서 할당해 바로 작성한다.
+  // 실패 시 빈 FrameRef 를 돌려준다.
+  static FrameRef EncodeFrame(const ChatProtocol& protocol);
+
+private:
+  // escape 후 길이 (따옴표 제외). 잘못된 UTF-8 이면 false
+  static bool EscapedLength(std::string_view value, uint32_t& outLength);
+  static uint8_t* WriteEscaped(std::string_view value, uint8_t* out);
+  static uint32_t IntegerLength(int64_t value);
+  static uint8_t* WriteInteger(int64_t value, uint8_t* out);
+};
+
+}  // namespace network
+}  // namespace quicflow
+
+#endif  // QUICFLOWCPP_CHAT_PROTOCOL_ENCODER_HPP
@@ -0,0 +1,118 @@
+//
+// QuicFlow-CPP - MsQuic Connection Statistics Sampler
+//
+
+#ifndef QUICFLOWCPP_CONNECTION_STATS_HPP
+#define QUICFLOWCPP_CONNECTION_STATS_HPP
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+extern "C" {
+#include <msquic.h>
+}
+
+namespace quicflow {
+namespace network {
+
+class QuicServer;
+
+struct ConnectionStatsConfig {
+  uint32_t IntervalMs = 10 * 1000;  // 0 이면 수집하지 않는다
+  // outlier: RTT 가 OutlierRttMs 이상이면서 이번 회차 중앙값의 OutlierRttFactor 배 이상
+  uint32_t OutlierRttMs = 300;
+  uint32_t OutlierRttFactor = 4;
+  // outlier: 지난 회차 이후 보낸 패킷 중 손실(%)이 이 값 이상 (MinPacketsForLoss 개 이상 보냈을 때만)
+  uint32_t OutlierLossPercent = 10;
+  uint32_t MinPacketsForLoss = 50;
+};
+
+// MsQuic 통계(QUIC_PARAM_CONN_STATISTICS_V2, QUIC_PARAM_GLOBAL_PERF_COUNTERS)를 주기적으로 읽어서
+// 분포를 지표로 남기고, 망 상태가 나쁜 connection 을 골라낸다.
+// Why: 서버 쪽 지연(latency trace)이 늘었을 때 모바일 망(RTT, 손실) 때문인지 서버 때문인지 구분한다.
+//
+// 전용 스레드에서 돈다. GetParam 은 connection 의 MsQuic worker 에 요청을 넣고 결과를 기다리므로
+// connection actor 와 이벤트 루프는 막지 않는다. (대신 한 회차가 connection 수에 비례해서 걸린다)
+//
+// 지표:
+//   quicflow_quic_conn_rtt_us, _min_rtt_us, _cwnd_bytes, _loss_permille, _inflight_bytes (히스토그램, 회차마다 connection 당 1번)
+//   quicflow_quic_conn_rtt_last_us{quantile=...}, quicflow_quic_conn_loss_rate_last_percent (지난 회차 값)
+//   quicflow_quic_sent_packets_total, _lost_packets_total, _congestion_events_total (회차 사이 증가분의 합)
+//   quicflow_msquic_*  (전역 perf counter)
+//
+// outlier 는 Warning 로그(초당 제한)와 /connections/outliers (RenderOutliersJson) 로 본다.
+class ConnectionStatsSampler {
+public:
+  ConnectionStatsSampler() = default;
+  ~ConnectionStatsSampler();
+
+  ConnectionStatsSampler(const ConnectionStatsSampler&) = delete;
+  ConnectionStatsSampler& operator=(const ConnectionStatsSampler&) = delete;
+
+  // servers 는 Stop 까지 살아 있어야 한다. IntervalMs 가 0 이면 false
+  bool Start(std::vector<QuicServer*> servers, const ConnectionStatsConfig& config);
+  // 진행 중인 회차가 끝날 때까지 기다린다. (QuicServer::Stop 전에 호출)
+  void Stop();
+
+  // 지난 회차의 outlier 목록 (JSON)
+  std::string RenderOutliersJson() const;
+
+  // 회차마다 outlier 를 로그로 남기는 최대 개수 (나머지는 /connections/outliers 로 본다)
+  static constexpr size_t kMaxOutliersLogged = 10;
+
+private:
+  // 회차 사이 증가분 계산용 (MsQuic 통계는 connection 이 생긴 뒤 누적값)
+  struct Previous {
+    uint64_t correlation_id = 0;
+    uint64_t sent_packets = 0;
+    uint64_t lost_packets = 0;
+    uint32_t congestion_events = 0;
+  };
+
+  struct Outlier {
+    HQUIC connection = nullptr;
+    uint64_t correlation_id = 0;
+    std::string profile;
+    uint32_t rtt_us = 0;
+    uint32_t min_rtt_us = 0;
+    uint32_t cwnd_bytes = 0;
+    uint64_t inflight_bytes = 0;
+    uint32_t loss_permille = 0;
+    const char* reason = "";
+  };
+
+  void Run();
+  void SampleConnections();
+  void SamplePerfCounters();
+  void RegisterMetrics();
+
+  std::vector<QuicServer*> servers_;
+  ConnectionStatsConfig config_;
+
+  std::thread thread_;
+  std::mutex stop_mutex_;
+  std::condition_variable stop_condition_;
+  bool stopping_ = false;
+
+  // 샘플러 스레드 전용
+  std::unordered_map<const void*, Previous> previous_;
+
+  mutable std::mutex outliers_mutex_;
+  std::vector<Outlier> outliers_;
+  int64_t outliers_sampled_at_ms_ = 0;
+
+  // 전역 perf counter (샘플러 스레드가 쓰고 지표 callback 이 읽는다)
+  std::array<std::atomic<int64_t>, QUIC_PERF_COUNTER_MAX> perf_counters_{};
+};
+
+}  // namespace network
+}  // namespace quicflow
+
+#endif  // QUICFLOWCPP_CONNECTION_STATS_HPP
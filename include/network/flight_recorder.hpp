@@ -0,0 +1,111 @@
+//
+// QuicFlow-CPP - Per-connection Flight Recorder
+//
+
+#ifndef QUICFLOWCPP_FLIGHT_RECORDER_HPP
+#define QUICFLOWCPP_FLIGHT_RECORDER_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace quicflow {
+namespace network {
+
+struct FlightRecorderConfig {
+  bool Enabled = true;             // connection 당 kCapacity * 16 bytes
+  uint32_t MaxDumpsPerSecond = 5;  // 자동 덤프(로그) 상한. 대량 끊김 때 로그가 덤프로 덮이지 않도록
+};
+
+// connection 1개의 최근 이벤트를 고정 크기 ring 에 남긴다.
+// Why: 유저가 렉/끊김을 신고했을 때 전역 로그(켜져 있다면)에서 그 connection 만 찾아내기 어렵다.
+//      항상 켜 두고, 이상 종료(transport shutdown, 느린 소비자) 때나 admin 요청 때만 꺼내 본다.
+//
+// 기록은 MsQuic 콜백 스레드와 actor 스레드에서 동시에 일어난다. slot 은 fetch_add 로 잡고
+// relaxed store 2번으로 채운다. (락 없음, 이벤트당 수 ns) 덤프는 기록과 동시에 읽을 수 있으며
+// 그 순간 덮어쓰이는 slot 하나는 앞뒤가 맞지 않을 수 있다. (진단용이므로 허용)
+class FlightRecorder {
+public:
+  enum class Event : uint8_t {
+    Connected,           //
+    PeerShutdown,        // value: error code (하위 32 bit)
+    TransportShutdown,   // value: status
+    ShutdownComplete,    //
+    StreamStarted,       //
+    StreamClosed,        //
+    StreamReceive,       // value: bytes, aux: buffer count        (MsQuic 스레드)
+    MessageReceived,     // value: body bytes                      (actor)
+    ParseFailed,         // value: buffer count
+    Throttled,           // value: 연속 초과 수
+    FrameQueued,         // value: frame bytes, aux: 대기열 프레임 수
+    Flush,               // value: bytes, aux: frames
+    SendBlocked,         // value: inflight bytes, aux: 대기열 프레임 수
+    SendFailed,          // value: status
+    SendComplete,        // value: bytes, aux: canceled             (MsQuic 스레드)
+    FramesDropped,       // value: dropped frames, aux: 대기열 프레임 수
+    SlowConsumerKick,    // value: inflight bytes, aux: 대기열 프레임 수
+    RateLimitKick,       // value: throttled messages
+    kCount,
+  };
+
+  static constexpr size_t kCapacity = 64;
+  static_assert((kCapacity & (kCapacity - 1)) == 0);
+
+  void Record(Event event, uint32_t value = 0, uint32_t aux = 0) noexcept {
+    uint64_t index = head_.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = slots_[index & (kCapacity - 1)];
+    slot.ticks.store(Ticks(), std::memory_order_relaxed);
+    slot.data.store(((uint64_t)event << 56) | ((uint64_t)(aux & 0xFFFFFF) << 32) | value, std::memory_order_relaxed);
+  }
+
+  // 오래된 것부터 한 줄에 하나씩 (마지막 이벤트 기준 상대 시각)
+  std::string Render() const;
+
+  // 서버 시작 시 1번
+  static void Configure(const FlightRecorderConfig& config);
+  static bool enabled() { return enabled_; }
+
+  // 자동 덤프 1회를 허용할지 (초당 MaxDumpsPerSecond)
+  static bool TryAcquireDump();
+
+  static std::string_view EventName(Event event);
+
+private:
+  struct Slot {
+    std::atomic<uint64_t> ticks{0};
+    std::atomic<uint64_t> data{0};  // event(8) | aux(24) | value(32)
+  };
+
+  // 싼 단조 카운터. x86-64: TSC, arm64: 가상 카운터, 그 외: steady_clock ns
+  // (ns 변환은 덤프할 때만 한다)
+  static uint64_t Ticks() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#elif defined(__aarch64__)
+    uint64_t value;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+    return value;
+#else
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+  }
+  static double NanosPerTick();
+
+  std::atomic<uint64_t> head_{0};
+  std::array<Slot, kCapacity> slots_;
+
+  static inline bool enabled_ = true;
+  static inline uint32_t max_dumps_per_second_ = 5;
+  // 보정 기준점 (Configure 시각)
+  static inline uint64_t origin_ticks_ = 0;
+  static inline uint64_t origin_ns_ = 0;
+};
+
+}  // namespace network
+}  // namespace quicflow
+
+#endif  // QUICFLOWCPP_FLIGHT_RECORDER_HPP
@@ -0,0 +1,138 @@
+//
+// QuicFlow-CPP - Outbound Frame
+//
+
+#ifndef QUICFLOWCPP_OUTBOUND_FRAME_HPP
+#define QUICFLOWCPP_OUTBOUND_FRAME_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include "core/buffer_pool.hpp"
+
+namespace quicflow {
+namespace network {
+
+// 전송 대기 중인 프레임 1개 (Header 4byte + Body)
+// Why: 같은 프레임을 여러 Connection 에 보내거나, 여러 프레임을 하나의 StreamSend 로
+//      묶어서 보낼 수 있도록 참조 카운트를 가진다. 마지막 참조가 풀리는 시점
+//      (보통 SEND_COMPLETE) 에 메모리가 해제된다.
+//      프레임 객체와 데이터는 BufferPool 의 블록 하나에 같이 들어간다 (할당 1회).
+class OutboundFrame {
+public:
+  // bodyLength 만큼의 본문 공간을 가진 프레임 생성 (ref count = 1)
+  static OutboundFrame* Create(uint32_t bodyLength) {
+    size_t capacity = 0;
+    uint8_t* block = core::BufferPool::Allocate(sizeof(OutboundFrame) + kHeaderSize + bodyLength, capacity);
+    return new (block) OutboundFrame(bodyLength, capacity);
+  }
+
+  // 이미 헤더까지 작성된 외부 메모리(data, length)를 복사 없이 프레임으로 감싼다. (ref count = 1)
+  // owner 는 마지막 참조가 풀릴 때까지 유지되어 data 를 살려둔다. (예: mmap 된 history segment)
+  static OutboundFrame* Borrow(const uint8_t* data, uint32_t length, std::shared_ptr<const void> owner) {
+    size_t capacity = 0;
+    uint8_t* block = core::BufferPool::Allocate(sizeof(OutboundFrame), capacity);
+    return new (block) OutboundFrame(data, length, capacity, std::move(owner));
+  }
+
+  void AddRef() noexcept { ref_count_.fetch_add(1, std::memory_order_relaxed); }
+
+  void Release() noexcept {
+    if (ref_count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      size_t capacity = block_capacity_;
+      this->~OutboundFrame();
+      core::BufferPool::Free(reinterpret_cast<uint8_t*>(this), capacity);
+    }
+  }
+
+  // [Little Endian] 헤더 작성 (4 Bytes)
+  void WriteHeader(uint32_t bodyLength) noexcept {
+    buffer_[0] = (uint8_t)(bodyLength & 0xFF);
+    buffer_[1] = (uint8_t)((bodyLength >> 8) & 0xFF);
+    buffer_[2] = (uint8_t)((bodyLength >> 16) & 0xFF);
+    buffer_[3] = (uint8_t)((bodyLength >> 24) & 0xFF);
+  }
+
+  uint8_t* data() noexcept { return buffer_; }
+  uint8_t* body() noexcept { return buffer_ + kHeaderSize; }
+  uint32_t length() const noexcept { return length_; }
+
+  // 느린 소비자 정책에서 버리면 안 되는 프레임 (예: 시스템 공지, 응답)
+  bool critical() const noexcept { return critical_; }
+  void set_critical(bool critical) noexcept { critical_ = critical; }
+
+  // 같은 키를 가진 프레임은 최신 것 하나만 남겨도 되는 경우 사용 (0 = 합치기 불가)
+  // 예: 입력 중 표시(Typing) 처럼 이전 상태가 의미 없는 프레임. SlowConsumerPolicy::Conflate 참고
+  uint64_t conflation_key() const noexcept { return conflation_key_; }
+  void set_conflation_key(uint64_t key) noexcept { conflation_key_ = key; }
+
+  static constexpr uint32_t kHeaderSize = 4;
+
+private:
+  OutboundFrame(uint32_t bodyLength, size_t blockCapacity)
+      : ref_count_(1),
+        buffer_(reinterpret_cast<uint8_t*>(this + 1)),
+        length_(kHeaderSize + bodyLength),
+        block_capacity_(blockCapacity) {
+    WriteHeader(bodyLength);
+  }
+
+  OutboundFrame(const uint8_t* data, uint32_t length, size_t blockCapacity, std::shared_ptr<const void> owner)
+      : ref_count_(1),
+        buffer_(const_cast<uint8_t*>(data)),
+        length_(length),
+        block_capacity_(blockCapacity),
+        storage_owner_(std::move(owner)) {
+  }
+
+  ~OutboundFrame() = default;
+
+  OutboundFrame(const OutboundFrame&) = delete;
+  OutboundFrame& operator=(const OutboundFrame&) = delete;
+
+  std::atomic<uint32_t> ref_count_;
+  uint8_t* buffer_;
+  uint32_t length_;
+  size_t block_capacity_;
+  bool critical_ = false;
+  uint64_t conflation_key_ = 0;
+  // Borrow 로 만든 프레임의 외부 저장소 (풀에서 할당된 프레임은 비어있음)
+  std::shared_ptr<const void> storage_owner_;
+};
+
+// OutboundFrame 참조를 RAII 로 관리하는 핸들
+class FrameRef {
+public:
+  FrameRef() = default;
+  // 이미 잡혀있는 참조를 넘겨받는다 (Create 직후 사용)
+  explicit FrameRef(OutboundFrame* frame) noexcept : frame_(frame) {}
+
+  FrameRef(const FrameRef& other) noexcept : frame_(other.frame_) {
+    if (frame_ != nullptr) frame_->AddRef();
+  }
+  FrameRef(FrameRef&& other) noexcept : frame_(std::exchange(other.frame_, nullptr)) {}
+
+  FrameRef& operator=(FrameRef other) noexcept {
+    std::swap(frame_, other.frame_);
+    return *this;
+  }
+
+  ~FrameRef() {
+    if (frame_ != nullptr) frame_->Release();
+  }
+
+  OutboundFrame* get() const noexcept { return frame_; }
+  OutboundFrame* operator->() const noexcept { return frame_; }
+  explicit operator bool() const noexcept { return frame_ != nullptr; }
+
+private:
+  OutboundFrame* frame_ = nullptr;
+};
+
+}  // namespace network
+}  // namespace quicflow
+
+#endif  // QUICFLOWCPP_OUTBOUND_FRAME_HPP
@@ -6,14 +6,11 @@
 #define QUICFLOWCPP_QUIC_BUFFER_READER_HPP
 
 #include <msquic.h>
+#include <atomic>
 #include <string>
 #include <vector>
 #include <iostream>
 
-// 보안을 위한 최대 허용 메시지 크기 (예: 1MB)
-// 해커가 40억 바이트(4GB)라고 헤더를 조작해 보내면 메모리가 터지므로 제한 필수
-const uint32_t MAX_MESSAGE_SIZE = 1024 * 1024;
-
 // 통신을 위한 Buffer Reader
 // Header(Length) : 4byte
 // Body : Length byte
@@ -23,7 +20,15 @@ public:
       const QUIC_BUFFER* Buffers,
       uint32_t BufferCount,
       std::string& OutputString);
+
+  // 보안을 위한 최대 허용 메시지 크기 (기본 1MB, 서버 설정 max_message_size)
+  // 해커가 40억 바이트(4GB)라고 헤더를 조작해 보내면 메모리가 터지므로 제한 필수
+  static void SetMaxMessageSize(uint32_t size) { max_message_size_.store(size, std::memory_order_relaxed); }
+  static uint32_t max_message_size() { return max_message_size_.load(std::memory_order_relaxed); }
+
 private:
+  static inline std::atomic<uint32_t> max_message_size_{1024 * 1024};
+
   static bool CopyDataFromBuffers(
           const QUIC_BUFFER* Buffers,
           uint32_t BufferCount,
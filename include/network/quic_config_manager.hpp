@@ -17,6 +17,11 @@ namespace quicflow {
 namespace network {
 class QuicApi;
 }  // namespace network
+namespace config {
+struct ServerConfig;
+struct ProfileConfig;
+struct QuicTunables;
+}  // namespace config
 }  // namespace quicflow
 
 #ifdef QUICFLOW_HAS_MSQUIC
@@ -93,13 +98,29 @@ class QuicConfigManager {
   // Why: ListenerStart requires the same ALPN buffers as ConfigurationOpen.
   const std::vector<QUIC_BUFFER>& alpn_buffers() const noexcept;
 
+  // Profile name this configuration was created for (config::ProfileConfig::Name).
+  const std::string& profile_name() const noexcept { return profile_name_; }
+
   // Returns a human-readable error message if initialization failed.
   // Why: Diagnostic information helps developers understand why
   //      configuration creation failed (e.g., invalid ALPN, missing
   //      certificate, etc.).
   const std::string& error_message() const noexcept { return error_message_; }
 
-  bool InitializeConfig();
+  // Opens the registration/configuration for one profile and loads the
+  // certificate from `serverConfig`.
+  // Why: Each profile gets its own registration so that its execution
+  //      profile (MsQuic worker pool) is isolated from the other profiles.
+  bool InitializeConfig(const config::ServerConfig& serverConfig,
+                        const config::ProfileConfig& profile);
+
+  // Applies new QUIC_SETTINGS to the live configuration.
+  // Why: QUIC_PARAM_CONFIGURATION_SETTINGS may be changed at any time; it only
+  //      affects connections that are accepted afterwards. Execution profile
+  //      and ALPNs are fixed at RegistrationOpen/ConfigurationOpen and need a
+  //      restart. Fields left unset in `tunables` are reset to the MsQuic
+  //      global defaults instead of keeping the previously applied value.
+  bool UpdateSettings(const config::QuicTunables& tunables);
 
   // Sets the credential configuration for TLS/QUIC handshake.
   // Why: QUIC requires TLS 1.3, which needs certificate configuration.
@@ -117,6 +138,13 @@ class QuicConfigManager {
   //   - false if configuration is invalid or credential setting failed.
   bool set_credential(const QUIC_CREDENTIAL_CONFIG& credential_config);
 
+  // Shuts down the remaining connections of this registration and closes it.
+  // Why: Connections keep a reference to their configuration, so the
+  //      destructor may run long after server shutdown. RegistrationClose
+  //      blocks until every connection has finished SHUTDOWN_COMPLETE, so
+  //      this must not be called from an MsQuic callback.
+  void Close() noexcept { Cleanup(); }
+
  private:
   // Helper to initialize ALPN buffers from string vector.
   // Why: MsQuic requires QUIC_BUFFER structures for ALPN, but we want
@@ -127,8 +155,11 @@ class QuicConfigManager {
   // Helper to clean up allocated resources.
   // Why: Both destructor and move assignment need cleanup logic.
   //      DRY principle: extract to a single method.
+  // Closes the configuration and the registration (which waits for its
+  // connections to close), then releases the shared API table.
   void Cleanup() noexcept;
 
+  // 프로세스 공유 API 테이블 (참조를 하나 잡고 있으며 Cleanup 에서 돌려준다)
   const QUIC_API_TABLE* api_;
   HQUIC handle_registration_;  // QUIC_REGISTRATION is an alias for HQUIC
   HQUIC handle_config_;  // QUIC_CONFIGURATION is an alias for HQUIC
@@ -137,6 +168,7 @@ class QuicConfigManager {
 
   bool is_valid_;
   std::string error_message_;
+  std::string profile_name_;
 };
 
 }  // namespace network
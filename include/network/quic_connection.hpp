@@ -5,12 +5,20 @@
 #ifndef QUICFLOWCPP_QUIC_CONNECTION_HPP
 #define QUICFLOWCPP_QUIC_CONNECTION_HPP
 
+#include <chrono>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 #include <nlohmann/json.hpp>
 
+#include "core/latency_trace.hpp"
 #include "core/serialized_predefined.hpp"
 #include "core/serialized_task.hpp"
+#include "core/token_bucket.hpp"
+#include "network/flight_recorder.hpp"
+#include "network/outbound_frame.hpp"
 extern "C" {
 #include <msquic.h>
 }
@@ -18,29 +26,74 @@ using json = nlohmann::json;
 
 namespace quicflow {
 
+namespace manager {
+class ConnectionManager;
+}
+
 namespace network {
 
 using namespace quicflow::core;
 
 class QuicServer;
 class QuicApi;
+class AdmissionController;
 class QuicConfigManager;
 //class SerializedObject;
 #include "core/serialized_object.hpp"
 
 // [핵심] 전송이 끝날 때까지 메모리를 유지하기 위한 구조체
+// 한 번의 StreamSend 에 묶인 프레임들과 QUIC_BUFFER 배열을 함께 들고 있다가
+// SEND_COMPLETE 에서 delete 된다.
 struct SendBufferContext {
-  uint8_t* RawBuffer;
-  uint32_t TotalLength;
+  std::vector<FrameRef> Frames;
+  std::vector<QUIC_BUFFER> Buffers;
+  uint32_t TotalLength = 0;
+  // 지연 추적: StreamSend 시각과 추적 중인 프레임의 trace (SEND_COMPLETE 에서 기록)
+  uint64_t SentAt = 0;
+  std::vector<core::MessageTrace> Traces;
+};
 
-  SendBufferContext(uint32_t size) {
-    RawBuffer = new uint8_t[size];
-    TotalLength = size;
-  }
+// 느린 소비자(Slow Consumer) 처리 정책
+// Why: 모바일 클라이언트가 멈추면 MsQuic 송신 버퍼가 무한히 커질 수 있으므로
+//      Connection 별로 상한을 두고, 넘어가면 아래 정책 중 하나를 적용한다.
+enum class SlowConsumerPolicy {
+  DropOldest,  // 가장 오래된 non-critical 프레임부터 버린다
+  // conflation key 가 있는 프레임은 대기열에 같은 key 의 프레임이 있으면 그 자리를 대체한다. (상한과 무관하게 항상)
+  // 대체한 뒤에도 상한을 넘으면 DropOldest 와 같다.
+  Conflate,
+  Disconnect,  // 연결을 끊는다
+};
 
-  ~SendBufferContext() {
-    delete[] RawBuffer;
-  }
+struct OutboundLimits {
+  // 전송 완료(SEND_COMPLETE) 되지 않은 바이트 상한. 넘으면 flush 를 멈추고 대기열에 쌓는다.
+  uint64_t MaxInflightBytes = 256 * 1024;
+  // 대기열(아직 StreamSend 하지 않은 프레임) 바이트 상한. 넘으면 Policy 적용.
+  uint64_t MaxPendingBytes = 1024 * 1024;
+  SlowConsumerPolicy Policy = SlowConsumerPolicy::DropOldest;
+};
+
+// 수신 메시지 초과 시 처리 정책
+enum class ThrottlePolicy {
+  Drop,        // 초과 메시지만 버린다
+  Penalize,    // 버리고 토큰을 빚지게 해서 한동안 더 막는다
+  Disconnect,  // 연속으로 DisconnectAfter 개를 넘기면 연결을 끊는다 (그 전까지는 Drop)
+};
+
+struct InboundLimits {
+  // Connection 당 수신 메시지 제한 (RatePerSecond == 0 이면 제한 없음)
+  core::TokenBucketConfig Messages{20, 40};
+  ThrottlePolicy Policy = ThrottlePolicy::Penalize;
+  // Penalize: 초과 메시지 1개마다 추가로 빚지는 토큰 수
+  uint32_t PenaltyTokens = 5;
+  // Disconnect: 연속 초과 허용 개수
+  uint32_t DisconnectAfter = 200;
+};
+
+// 방 프레임이 방 기록에서 차지하는 위치
+// Room 은 방 incarnation (Room::epoch), Sequence 는 방 순번 (0 = 순번 없음)
+struct RoomPosition {
+  uint64_t Room = 0;
+  uint64_t Sequence = 0;
 };
 
 // 1 유저 1개의 Connection 객체
@@ -50,28 +103,181 @@ public:
   QuicConnection(HQUIC connection);
 
   //QUIC_STATUS InitConnection(const QUIC_API_TABLE* api,  std::shared_ptr<QuicConfigManager> config);
-  QUIC_STATUS InitConnection(QuicServer* server);
+  // config: 이 connection 을 받은 프로필(listener)의 configuration
+  QUIC_STATUS InitConnection(QuicServer* server, std::shared_ptr<QuicConfigManager> config);
   void CloseConnection();
 
   DECLARE_ASYNC_FUNCTION(OnChatStreamStarted, HQUIC hStream)
-  DECLARE_ASYNC_FUNCTION(OnChatStreamReceived, QUIC_STREAM_EVENT* event)
+  // received: RECEIVE 이벤트 시각 (LatencyTrace::Stamp, 꺼져 있으면 0)
+  DECLARE_ASYNC_FUNCTION(OnChatStreamReceived, QUIC_STREAM_EVENT* event, uint64_t received)
   DECLARE_ASYNC_FUNCTION(OnChatStreamClosed)
   DECLARE_ASYNC_FUNCTION(SendChatMessage, const std::string& content)
+  // 이미 직렬화된 프레임 전송 (방 fan-out 처럼 여러 connection 이 같은 프레임을 공유할 때)
+  DECLARE_ASYNC_FUNCTION(SendFrame, FrameRef frame)
+  // 방 fan-out 으로 받은 실시간 프레임. trace 가 StreamSend / SEND_COMPLETE 까지 따라간다.
+  // 이 connection 에 이미 보낸 방 순번이면 버린다. (replay 와 shard 의 실시간 전송이 겹칠 때)
+  DECLARE_ASYNC_FUNCTION(DeliverFrame, FrameRef frame, core::MessageTrace trace, RoomPosition position)
+  // 방 기록 replay. frames 는 first.Sequence 부터 연속된 순번이고, 이미 보낸 순번은 건너뛴다.
+  DECLARE_ASYNC_FUNCTION(ReplayFrames, std::vector<FrameRef> frames, RoomPosition first)
+  DECLARE_ASYNC_FUNCTION(OnSendResumed)
 
   static QUIC_STATUS ServerConnectionCallback(HQUIC connection, void* context, QUIC_CONNECTION_EVENT* Event);
   static QUIC_STATUS ServerChatCallback(HQUIC connection, void* context, QUIC_STREAM_EVENT* Event);
 
-  HQUIC connection() { return connection_; }
+  HQUIC connection() const { return connection_; }
+  // handshake 가 끝나면(성공/실패) admission->OnHandshakeFinished() 를 1번 호출한다.
+  void TrackHandshake(AdmissionController* admission) { admission_ = admission; }
+
+  // 이 connection 이 들어온 프로필 이름 (config::ProfileConfig::Name)
+  const std::string& profile_name() const { return profile_name_; }
+  // 서버가 부여한 사용자 식별자. 방으로 보내는 메시지의 UserID 로 쓴다.
+  const std::string& user_id() const { return user_id_; }
+
+  // 접속 종료 처리 시작 (ConnectionManager::OnCloseConnection 에서 방 정리 전에 표시)
+  // Why: 수신 처리(connection actor)와 종료 처리(MsQuic worker)가 다른 스레드라서, 종료 후에 도착한
+  //      Join/Resume 이 이미 닫힌 핸들을 방 멤버로 다시 넣을 수 있다. RoomManager / Room 이 이 표시를 보고 거절한다.
+  void MarkClosing() { closing_.store(true, std::memory_order_release); }
+  bool closing() const { return closing_.load(std::memory_order_acquire); }
+
+  // 송신 합치기(coalescing) 파라미터
+  // Why: 버스트 상황에서 메시지마다 StreamSend 를 호출하면 MsQuic operation 이 폭증한다.
+  //      드레인 동안 프레임을 모아서 한 번에 보내고, 너무 오래 잡고 있지 않도록 상한을 둔다.
+  static constexpr uint32_t kMaxBatchFrames = 64;
+  static constexpr uint32_t kMaxBatchBytes = 64 * 1024;
+  static constexpr std::chrono::microseconds kFlushDeadline{500};
+  // 느린 소비자로 판단해 연결을 끊을 때 사용하는 application error code
+  static constexpr uint64_t kSlowConsumerErrorCode = 0x51;
+  // 수신 제한 초과로 연결을 끊을 때 사용하는 application error code
+  static constexpr uint64_t kRateLimitErrorCode = 0x52;
+  // 서버 종료로 연결을 끊을 때 사용하는 application error code
+  static constexpr uint64_t kServerShutdownErrorCode = 0x53;
 
+  // 모든 Connection 에 적용되는 송신 상한 (서버 시작 시 설정)
+  static void SetOutboundLimits(const OutboundLimits& limits) { outbound_limits_ = limits; }
+  static const OutboundLimits& outbound_limits() { return outbound_limits_; }
+
+  // 모든 Connection 에 적용되는 수신 제한 (서버 시작 시 설정)
+  static void SetInboundLimits(const InboundLimits& limits) { inbound_limits_ = limits; }
+  static const InboundLimits& inbound_limits() { return inbound_limits_; }
+
+  // user_id 앞에 붙는 문자열 (서버 시작 시 설정). 클러스터에서는 노드마다 달라야
+  // 다른 노드에서 온 메시지의 UserID 가 로컬 사용자와 겹치지 않는다.
+  static void SetUserIdPrefix(std::string prefix) { user_id_prefix_ = std::move(prefix); }
+  // 프로세스 전체에서 수신 제한으로 버려진 메시지 수
+  static uint64_t total_throttled_messages();
+
+  // MsQuic 통계를 읽는다. (ConnectionStatsSampler 스레드에서 호출, MsQuic 콜백 안에서는 호출하지 않는다)
+  // 이미 닫혔으면 false. 읽는 도중 닫히면 ConnectionClose 는 읽기가 끝난 뒤 이 함수가 한다.
+  bool QueryStatistics(const QUIC_API_TABLE* api, QUIC_STATISTICS_V2& stats);
+
+  // 연결 종료를 시작한다. (서버 종료 시 main 스레드에서 호출, 이미 닫혔으면 아무것도 하지 않는다)
+  // 정리는 SHUTDOWN_COMPLETE 에서 평소처럼 진행된다.
+  void Shutdown(const QUIC_API_TABLE* api, uint64_t errorCode);
+
+  // 최근 이벤트 기록 (admin 요청용). 꺼져 있으면 빈 문자열
+  std::string RenderFlightRecorder() const;
+
+  uint64_t inflight_bytes() const { return inflight_bytes_.load(std::memory_order_relaxed); }
+  uint64_t dropped_frames() const { return dropped_frames_; }
+  uint64_t throttled_messages() const { return throttled_messages_; }
+
+protected:
+  // actor 드레인이 끝나는 시점에 모아둔 프레임을 flush 한다.
+  void OnDrained() override;
 
 private:
   void SendJsonMessage(HQUIC hStream, const std::string& message);
 
+  // actor 안에서만 호출: 프레임을 송신 대기열에 넣고 필요하면 flush
+  void QueueFrame(FrameRef frame, const core::MessageTrace& trace = {});
+  // Conflate 정책: 대기열에 같은 conflation key 의 프레임이 있으면 그 자리를 frame 으로 바꾸고 true
+  bool ReplaceConflatedFrame(FrameRef& frame, const core::MessageTrace& trace);
+  // 대기열의 프레임을 하나의 StreamSend 로 전송
+  // moreWorkQueued 가 true 면 QUIC_SEND_FLAG_DELAY_SEND 로 MsQuic 에 곧 더 보낼 것임을 알린다.
+  void FlushPendingFrames(bool moreWorkQueued);
+  // 대기열이 MaxPendingBytes 를 넘었을 때 정책 적용
+  void ApplySlowConsumerPolicy();
+  void DisconnectSlowConsumer();
+  // handshake 진행 중 집계에서 빠진다 (CONNECTED / SHUTDOWN_COMPLETE)
+  void FinishHandshake();
+  // SEND_COMPLETE 에서 호출 (MsQuic 스레드)
+  void OnSendComplete(SendBufferContext* context);
+  // 수신 메시지 1개를 처리해도 되는지 (디코딩 전에 호출). 초과 시 정책 적용 후 false
+  bool AdmitInboundMessage();
+  // 송신 대기열에서 버린 프레임 집계 (connection 별 + 프로세스 전체 지표)
+  void CountDroppedFrames(uint64_t count);
+  // 실시간 방 프레임의 중복 확인. 처음 보내는 순번이면 기록하고 true
+  bool MarkRoomFrameSent(const RoomPosition& position);
+  // connection_ 핸들을 MsQuic 콜백 밖의 스레드에서 쓰는 동안 닫히지 않게 잡는다. 이미 닫혔으면 false
+  bool AcquireHandle();
+  // 잡는 동안 닫혔으면 여기서 ConnectionClose 하고 false
+  bool ReleaseHandle(const QUIC_API_TABLE* api);
+
+  void Record(FlightRecorder::Event event, uint32_t value = 0, uint32_t aux = 0) {
+    if (recorder_ != nullptr) {
+      recorder_->Record(event, value, aux);
+    }
+  }
+  // 이상 종료 시 최근 이벤트를 로그로 남긴다. (초당 상한)
+  void DumpFlightRecorder(std::string_view reason);
+
+  static inline OutboundLimits outbound_limits_{};
+  static inline InboundLimits inbound_limits_{};
+  static inline std::string user_id_prefix_ = "user-";
+
   QuicServer* server_;
+  // 이 connection 을 받은 서버(shard)의 관리자. server_ 와 달리 close 후에도 유지된다.
+  manager::ConnectionManager* connection_manager_ = nullptr;
+  // handshake 진행 중이면 non-null (MsQuic connection 콜백 스레드 전용)
+  AdmissionController* admission_ = nullptr;
   HQUIC connection_;
-  HQUIC stream_chat_;
+  std::string profile_name_;
+  std::string user_id_;
+  std::atomic<bool> closing_{false};
+  HQUIC stream_chat_ = nullptr;
+  // 최근 이벤트 ring (FlightRecorder::enabled() 일 때만)
+  std::unique_ptr<FlightRecorder> recorder_;
+
+  // connection_ 핸들 수명 (CloseConnection / QueryStatistics / Shutdown)
+  // Why: GetParam 은 MsQuic worker 의 처리를 기다리므로 락을 잡은 채로 부르면 같은 worker 의
+  //      SHUTDOWN_COMPLETE(CloseConnection)와 교착된다. 락은 상태만 바꾸고, 읽는 중에 닫히면 닫기를 미룬다.
+  std::mutex handle_mutex_;
+  bool handle_closed_ = false;
+  uint32_t handle_users_ = 0;
+  bool close_deferred_ = false;
+
+  struct PendingFrame {
+    FrameRef frame;
+    core::MessageTrace trace;
+  };
+  // actor 전용 송신 대기열 (락 불필요)
+  std::vector<PendingFrame> pending_frames_;
+  uint32_t pending_bytes_ = 0;
+  std::chrono::steady_clock::time_point pending_since_;
+
+  // StreamSend 했지만 아직 SEND_COMPLETE 받지 못한 바이트 (actor / MsQuic 스레드 공유)
+  std::atomic<uint64_t> inflight_bytes_{0};
+  // inflight 상한 때문에 flush 를 미룬 상태인지 (SEND_COMPLETE 에서 재개 예약)
+  std::atomic<bool> send_blocked_{false};
+  uint64_t dropped_frames_ = 0;
+  bool slow_consumer_kicked_ = false;
+
+  // 방마다 이 connection 에 보낸 연속 순번 구간 [First, Last] (actor 전용)
+  // Why: Resume replay 와 shard 에 아직 남아있는 실시간 전송이 같은 순번을 두 번 보내지 않게 한다.
+  //      QUIC stream 은 신뢰성 있게 전달하므로 한 번 보낸 순번은 다시 보낼 필요가 없다.
+  //      느린 소비자 정책으로 프레임을 버리면 구간이 틀리므로 전부 비운다. (중복은 가능, 유실은 없음)
+  struct RoomCursor {
+    uint64_t First = 0;
+    uint64_t Last = 0;
+  };
+  std::unordered_map<uint64_t, RoomCursor> room_cursors_;
+  static constexpr size_t kMaxRoomCursors = 64;
 
-  volatile uint32_t message_id_ = 0;
+  // 수신 제한 (actor 전용)
+  core::TokenBucket inbound_bucket_;
+  uint64_t throttled_messages_ = 0;
+  uint32_t consecutive_throttled_ = 0;
+  bool rate_limit_kicked_ = false;
 };
 };
 }
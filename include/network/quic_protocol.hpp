@@ -13,12 +13,34 @@ using json = nlohmann::json;
 // 1. 데이터를 담을 구조체 정의
 struct ChatProtocol{
   std::string Type;
-  uint32_t MessageId;
+  // 방 단위 순번 (서버가 Room actor 에서 부여, 1부터 증가). 0 = 순번 없음
+  // Resume 요청에서는 클라이언트가 마지막으로 받은 순번을 담는다.
+  uint64_t MessageId = 0;
   std::string UserID;
   std::string Message;
-  std::time_t Timestamp; // C++은 날짜 타입이 복잡하므로 문자열로 주고받는 게 정신건강에 좋습니다.
+  std::time_t Timestamp = 0; // C++은 날짜 타입이 복잡하므로 문자열로 주고받는 게 정신건강에 좋습니다.
+  // 대상 방 이름 (선택). 비어있으면 기본 방(lobby)
+  // Why: 기존 클라이언트와 호환되도록 MessageId, Room, Epoch 는 아래 nlohmann 매크로에 넣지 않고,
+  //      ChatProtocolEncoder/Decoder 에서만 선택적인 key 로 다룬다.
+  std::string Room;
+  // 방 incarnation (서버가 부여, 0 = 없음). 같은 이름의 방이 다시 만들어지면 바뀌므로
+  // Resume 은 마지막으로 받은 Epoch 와 MessageId 를 함께 보낸다. 다르면 Resync.
+  uint64_t Epoch = 0;
 };
 
+// Type 값
+constexpr const char* kChatTypeChat = "Chat";
+constexpr const char* kChatTypeJoin = "Join";
+constexpr const char* kChatTypeLeave = "Leave";
+// 클라이언트 -> 서버: MessageId 이후로 놓친 메시지만 요청 (방에 없으면 참여도 함께)
+// MessageId 가 0 이 아니면 그 메시지의 Epoch 도 보내야 한다.
+constexpr const char* kChatTypeResume = "Resume";
+// 서버 -> 클라이언트: 요청한 구간이 기록에 없음. 전체 재동기화 필요 (MessageId = 현재 최신 순번, Epoch = 현재 방)
+constexpr const char* kChatTypeResync = "Resync";
+// 클라이언트 -> 서버 -> 방: 입력 중 표시 (Message = 상태). 최신 상태만 의미가 있으므로
+// 방 순번 / 기록 없이 전달하고, 느린 수신자의 대기열에서는 같은 방 / 같은 유저의 이전 표시를 대체한다.
+constexpr const char* kChatTypeTyping = "Typing";
+
 // 2. [핵심] JSON <-> 구조체 자동 변환 매크로
 NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(ChatProtocol, Type, UserID, Message, Timestamp);
 
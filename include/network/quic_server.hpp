@@ -9,13 +9,21 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 // Forward declarations
 namespace quicflow {
 namespace network {
 class QuicApi;
 class QuicConfigManager;
+class AdmissionController;
 }  // namespace network
+namespace config {
+struct ServerConfig;
+}  // namespace config
+namespace manager {
+class ConnectionManager;
+}  // namespace manager
 }  // namespace quicflow
 
 #ifdef QUICFLOW_HAS_MSQUIC
@@ -24,8 +32,6 @@ extern "C" {
 }
 #endif
 
-#include "common/singleton.hpp"
-
 namespace quicflow {
 namespace network {
 
@@ -54,12 +60,13 @@ using ConnectionCallback = std::function<void(HQUIC connection, void* context)>;
 //   if (server.Start()) {
 //     // Server is listening
 //   }
-class QuicServer : public Common::Singleton<QuicServer> {
+//
+// 한 프로세스에 여러 개를 만들 수 있다 (shard-per-port, in-process 벤치마크).
+// 각 서버는 자기 ConnectionManager 를 소유하고, MsQuic 콜백에는 endpoint /
+// connection 을 context 로 넘겨서 전역 인스턴스를 찾지 않는다.
+class QuicServer {
 
 public:
-  // Singleton이 생성자를 호출할 수 있게 친구 선언
-  friend class Singleton<QuicServer>;
-
   // Initialize a QUIC server with the given configuration.
   // Why: 서버는 QuicApi와 QuicConfigManager에 의존하므로, 생성자에서
   //      이를 받아서 저장합니다. 포트 번호도 생성 시점에 지정하여
@@ -68,15 +75,19 @@ public:
   // Args:
   //   api: Reference to initialized QuicApi instance. Must outlive this object.
   //   config: Reference to initialized QuicConfigManager. Must outlive this object.
-  //   port: UDP port number to listen on (default: 4433, standard QUIC port).
+  //   serverConfig: Port, ALPNs, execution profile, QUIC_SETTINGS and
+  //                 certificate paths (see config::ServerConfig).
   //
   // Preconditions:
   //   - api.is_available() must return true.
   //   - config.is_valid() must return true.
 
-  QUIC_STATUS InitQuicServer(uint16_t port = 4433);
+  QUIC_STATUS InitQuicServer(const config::ServerConfig& serverConfig);
+
+  // Applies new QUIC_SETTINGS of every profile at runtime (e.g. on SIGHUP).
+  // Connections accepted after this call use the new settings.
+  bool UpdateSettings(const config::ServerConfig& serverConfig);
 
-  // Constructor for Singleton
   QuicServer();
   // Non-copyable: listener handles are unique resources.
   QuicServer(const QuicServer&) = delete;
@@ -102,14 +113,29 @@ public:
   //      소멸자에서도 자동으로 호출되지만, 명시적 호출이 더 명확합니다.
   void Stop() noexcept;
 
+  // Shuts the server down for process exit.
+  // Order: close the listeners, shut down every connection, then close the
+  // registrations (RegistrationClose waits for SHUTDOWN_COMPLETE of each
+  // connection). The last server to close releases the MsQuic API table
+  // (MsQuicClose). After this returns no MsQuic callback refers to this
+  // server; drain the Executor before destroying it.
+  void Shutdown() noexcept;
+
   // Returns true if the server is currently listening.
   bool is_listening() const noexcept { return is_listening_; }
 
   // Returns the port number this server is configured to listen on.
   uint16_t port() const noexcept { return port_; }
 
-  const QUIC_API_TABLE* api() ;
-  const std::shared_ptr<QuicConfigManager> config() { return config_;}
+  // Shared MsQuic API table (nullptr before InitQuicServer / after Shutdown).
+  const QUIC_API_TABLE* api() const noexcept { return api_; }
+  // Configuration of the default profile.
+  const std::shared_ptr<QuicConfigManager> config();
+
+  // Connections accepted by this server (this shard).
+  manager::ConnectionManager& connection_manager() noexcept { return *connection_manager_; }
+  // Decides whether new connections are accepted (see AdmissionController).
+  AdmissionController& admission() noexcept { return *admission_; }
 
   // Returns a human-readable error message if Start() failed.
   const std::string& error_message() const noexcept { return error_message_; }
@@ -132,9 +158,24 @@ public:
 
   // Helper to clean up listener resources.
   void Cleanup() noexcept;
-
-  std::shared_ptr<QuicConfigManager> config_;
-  HQUIC listener_;
+  // Per-shard gauges (connections, handshakes, admission) read at scrape time.
+  void RegisterMetrics();
+  void StopListeners() noexcept;
+
+  // One listener per profile (registration + configuration).
+  // Why: Heap allocated so the address passed to ListenerOpen as context
+  //      stays stable.
+  struct Endpoint {
+    QuicServer* server = nullptr;
+    std::shared_ptr<QuicConfigManager> config;
+    HQUIC listener = nullptr;
+  };
+
+  std::vector<std::unique_ptr<Endpoint>> endpoints_;
+  std::unique_ptr<manager::ConnectionManager> connection_manager_;
+  std::unique_ptr<AdmissionController> admission_;
+  // connection 의 SHUTDOWN_COMPLETE 가 Shutdown 도중(endpoint 를 닫는 중)에도 쓰므로 따로 둔다.
+  const QUIC_API_TABLE* api_ = nullptr;
 
   uint16_t port_;
   bool is_listening_;
@@ -0,0 +1,62 @@
+#!/usr/bin/env python3
+"""QuicFlow-CPP - compare two quicflow_bench result files.
+
+Usage:
+  quicflow_bench --output=before.json   (on the base commit)
+  quicflow_bench --output=after.json    (on the change)
+  scripts/bench_compare.py before.json after.json [--threshold=5]
+
+Prints ns_per_op for every benchmark present in either file and the change in
+percent. A change is only flagged when it exceeds --threshold and the new median
+lies outside the old [min, max] range, so run-to-run noise is not reported as
+a regression.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path) as f:
+        data = json.load(f)
+    if data.get("schema") != 1:
+        raise SystemExit(f"{path}: unsupported schema {data.get('schema')}")
+    return data, {entry["name"]: entry for entry in data["benchmarks"]}
+
+
+def main():
+    parser = argparse.ArgumentParser(description="compare quicflow_bench JSON results")
+    parser.add_argument("before")
+    parser.add_argument("after")
+    parser.add_argument("--threshold", type=float, default=5.0, help="percent (default 5)")
+    args = parser.parse_args()
+
+    before_data, before = load(args.before)
+    after_data, after = load(args.after)
+    if before_data["context"] != after_data["context"]:
+        print("warning: context differs (compiler, build type or machine)", file=sys.stderr)
+
+    names = list(before) + [name for name in after if name not in before]
+    width = max((len(name) for name in names), default=10)
+    print(f"{'benchmark':<{width}}  {'before ns':>12}  {'after ns':>12}  {'change':>8}")
+    regressions = 0
+    for name in names:
+        old = before.get(name)
+        new = after.get(name)
+        if old is None or new is None or "error" in old or "error" in new:
+            state = "added" if old is None else "removed" if new is None else "error"
+            print(f"{name:<{width}}  {'':>12}  {'':>12}  {state:>8}")
+            continue
+        change = (new["ns_per_op"] - old["ns_per_op"]) / old["ns_per_op"] * 100.0
+        outside = new["ns_per_op"] < old["ns_per_op_min"] or new["ns_per_op"] > old["ns_per_op_max"]
+        mark = ""
+        if abs(change) >= args.threshold and outside:
+            mark = "  <- slower" if change > 0 else "  <- faster"
+            regressions += change > 0
+        print(f"{name:<{width}}  {old['ns_per_op']:>12.4g}  {new['ns_per_op']:>12.4g}  {change:>+7.1f}%{mark}")
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,101 @@
+#!/usr/bin/env python3
+"""QuicFlow-CPP - convert a latency trace file to Chrome trace format.
+
+The server writes 1 of every N messages when started with
+  --trace.sample_every=N --trace.file=trace.bin
+
+Usage:
+  scripts/trace_to_chrome.py trace.bin > trace.json
+  (open trace.json in chrome://tracing or https://ui.perfetto.dev)
+
+File layout (little-endian, see include/core/latency_trace.hpp):
+  8 bytes magic "QFTRACE1", then 64-byte records
+    u8 type (1 = message, 2 = delivery), 7 bytes reserved,
+    u64 id, u64 connection, u64 stamps[5] (steady clock, ns)
+  message : received, actor_start, decoded, fanout
+  delivery: received, fanout, sent (StreamSend), completed (SEND_COMPLETE)
+
+Each sampled message becomes one track (tid = message id) with its inbound
+stages, followed by one "send queue" and one "in flight" span per recipient.
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+MAGIC = b"QFTRACE1"
+RECORD = struct.Struct("<B7xQQ5Q")
+MESSAGE = 1
+DELIVERY = 2
+
+
+def read_records(path):
+    with open(path, "rb") as f:
+        if f.read(len(MAGIC)) != MAGIC:
+            raise SystemExit(f"{path}: not a QuicFlow trace file")
+        while True:
+            chunk = f.read(RECORD.size)
+            if len(chunk) < RECORD.size:
+                break
+            kind, trace_id, connection, *stamps = RECORD.unpack(chunk)
+            yield kind, trace_id, connection, stamps
+
+
+def span(name, tid, start, end, origin, args=None):
+    event = {
+        "name": name,
+        "ph": "X",
+        "pid": 1,
+        "tid": tid,
+        "ts": (start - origin) / 1000.0,
+        "dur": max(end - start, 0) / 1000.0,
+    }
+    if args:
+        event["args"] = args
+    return event
+
+
+def convert(records):
+    if not records:
+        return []
+    origin = min(stamps[0] for _, _, _, stamps in records if stamps[0] != 0)
+
+    events = []
+    for kind, trace_id, connection, stamps in records:
+        sender = {"connection": f"0x{connection:x}"}
+        if kind == MESSAGE:
+            received, actor_start, decoded, fanout = stamps[:4]
+            events.append(span("receive -> actor", trace_id, received, actor_start, origin, sender))
+            events.append(span("decode", trace_id, actor_start, decoded, origin))
+            events.append(span("room (queue + encode)", trace_id, decoded, fanout, origin))
+        elif kind == DELIVERY:
+            _, fanout, sent, completed = stamps[:4]
+            events.append(span("send queue", trace_id, fanout, sent, origin, sender))
+            events.append(span("in flight (until SEND_COMPLETE)", trace_id, sent, completed, origin, sender))
+
+    for trace_id in sorted({r[1] for r in records}):
+        events.append({"name": "thread_name", "ph": "M", "pid": 1, "tid": trace_id,
+                       "args": {"name": f"message {trace_id}"}})
+    events.append({"name": "process_name", "ph": "M", "pid": 1, "args": {"name": "quicflow messages"}})
+    return events
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("trace", help="binary trace file written by the server")
+    parser.add_argument("-o", "--output", help="output JSON file (default: stdout)")
+    args = parser.parse_args()
+
+    events = convert(list(read_records(args.trace)))
+    document = {"traceEvents": events, "displayTimeUnit": "ns"}
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(document, f)
+    else:
+        json.dump(document, sys.stdout)
+        sys.stdout.write("\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,312 @@
+//
+// QuicFlow-CPP - Cluster Pub/Sub Bus
+//
+
+#include "cluster/cluster_bus.hpp"
+
+#include <cstring>
+
+#include "common/logger.hpp"
+#include "manager/room.hpp"
+#include "manager/room_manager.hpp"
+
+namespace quicflow {
+namespace cluster {
+using namespace network;
+
+namespace {
+
+inline void WriteU16(uint8_t* out, uint16_t value) {
+  out[0] = (uint8_t)(value & 0xFF);
+  out[1] = (uint8_t)(value >> 8);
+}
+
+inline void WriteU32(uint8_t* out, uint32_t value) {
+  WriteU16(out, (uint16_t)(value & 0xFFFF));
+  WriteU16(out + 2, (uint16_t)(value >> 16));
+}
+
+inline uint16_t ReadU16(const uint8_t* in) {
+  return (uint16_t)(in[0] | (in[1] << 8));
+}
+
+inline uint32_t ReadU32(const uint8_t* in) {
+  return (uint32_t)ReadU16(in) | ((uint32_t)ReadU16(in + 2) << 16);
+}
+
+}  // namespace
+
+ClusterBus::ClusterBus() {
+}
+
+ClusterBus::~ClusterBus() {
+  Stop();
+}
+
+bool ClusterBus::Start(const ClusterConfig& config) {
+  if (config.Peers.size() > kMaxPeers) {
+    QF_LOG_ERROR(Cluster, "Too many peers ({})", config.Peers.size());
+    return false;
+  }
+
+  transport_ = ClusterTransport::Create(config.ListenAddress);
+  if (transport_ == nullptr) {
+    return false;
+  }
+
+  node_id_ = config.NodeId;
+  peer_nodes_.clear();
+  for (const auto& peer : config.Peers) {
+    if (transport_->AddPeer(peer.Address) < 0) {
+      return false;
+    }
+    peer_nodes_.push_back(peer.NodeId);
+  }
+
+  if (transport_->Start([this](int peer, const uint8_t* data, size_t length) { OnReceive(peer, data, length); })
+    == false) {
+    transport_.reset();
+    return false;
+  }
+
+  enabled_.store(true, std::memory_order_release);
+  last_announce_ = std::chrono::steady_clock::now();
+  // 먼저 떠 있던 노드들이 자기 구독 목록을 알려주도록 인사한다.
+  SendControl(MessageType::Hello, {}, -1);
+  AnnounceSubscriptions(-1);
+
+  QF_LOG_INFO(Cluster, "Node {} started with {} peers", node_id_, peer_nodes_.size());
+  return true;
+}
+
+void ClusterBus::Stop() {
+  if (enabled_.exchange(false) == false) {
+    return;
+  }
+  // 이미 송신 중인 Publish/SendControl 이 끝날 때까지 기다린 뒤 소켓/ring 을 닫는다.
+  // (이후 호출은 lock 안에서 enabled 를 다시 보고 그냥 돌아간다)
+  { std::unique_lock lock(send_mutex_); }
+  transport_->Stop();
+}
+
+void ClusterBus::AnnounceRoom(std::string_view room) {
+  if (enabled() == false) {
+    return;
+  }
+  // RoomManager 락은 FindRoom 동안만 잡는다. (RoomManager 는 자기 락을 잡은 채 여기로 오지 않는다)
+  std::lock_guard announceLock(announce_mutex_);
+  const bool exists = manager::RoomManager::GetInstance().FindRoom(room) != nullptr;
+  {
+    std::unique_lock lock(mutex_);
+    auto found = local_rooms_.find(room);
+    if (exists == (found != local_rooms_.end())) {
+      return;  // 이미 공지한 상태 (다른 스레드가 먼저 처리함)
+    }
+    if (exists) {
+      local_rooms_.emplace(room);
+    } else {
+      local_rooms_.erase(found);
+    }
+  }
+  SendControl(exists ? MessageType::Subscribe : MessageType::Unsubscribe, room, -1);
+}
+
+void ClusterBus::Publish(std::string_view room, const FrameRef& frame) {
+  // 단일 노드 / 원격 관심이 없는 경우가 대부분이므로 락과 할당 없이 먼저 거른다.
+  if (enabled() == false || interested_rooms_.load(std::memory_order_relaxed) == 0) {
+    return;
+  }
+
+  uint64_t interest = 0;
+  {
+    std::shared_lock lock(mutex_);
+    auto found = remote_interest_.find(room);
+    if (found == remote_interest_.end()) {
+      return;
+    }
+    interest = found->second;
+  }
+
+  // 관심 있는 노드가 있을 때만 Stop 과의 동기화 락을 잡는다.
+  std::shared_lock sendLock(send_mutex_);
+  if (enabled() == false) {
+    return;
+  }
+
+  uint8_t header[kHeaderSize];
+  WriteHeader(header, MessageType::Publish, room);
+  if (kHeaderSize + room.size() + frame->length() > transport_->max_message_size()) {
+    dropped_messages_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  // 헤더 / 방 이름 / 프레임을 복사 없이 한 메시지로 보낸다. 원격 노드마다 1번.
+  ClusterBuffer buffers[3] = {
+      {header, kHeaderSize},
+      {reinterpret_cast<const uint8_t*>(room.data()), room.size()},
+      {frame->data(), frame->length()},
+  };
+  for (size_t peer = 0; peer < peer_nodes_.size(); ++peer) {
+    if ((interest & (1ull << peer)) == 0) {
+      continue;
+    }
+    if (transport_->SendTo((int)peer, buffers, 3)) {
+      published_messages_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+      dropped_messages_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+}
+
+void ClusterBus::Tick() {
+  if (enabled() == false) {
+    return;
+  }
+  auto now = std::chrono::steady_clock::now();
+  if (now - last_announce_ < kAnnounceInterval) {
+    return;
+  }
+  last_announce_ = now;
+  AnnounceSubscriptions(-1);
+}
+
+void ClusterBus::OnReceive(int sender, const uint8_t* data, size_t length) {
+  if (length < kHeaderSize || ReadU32(data) != kMagic || data[4] != kVersion) {
+    dropped_messages_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  auto type = (MessageType)data[5];
+  uint16_t origin = ReadU16(data + 6);
+  uint16_t roomLength = ReadU16(data + 8);
+  if (kHeaderSize + roomLength > length) {
+    dropped_messages_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  std::string_view room(reinterpret_cast<const char*>(data + kHeaderSize), roomLength);
+  const uint8_t* payload = data + kHeaderSize + roomLength;
+  size_t payloadLength = length - kHeaderSize - roomLength;
+
+  int peer = PeerOfNode(origin);
+  if (peer < 0) {
+    // 설정에 없는 노드
+    dropped_messages_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  if (sender != ClusterTransport::kUnattributedPeer && sender != peer) {
+    // 헤더의 노드 번호가 실제로 보낸 peer 와 다름: 다른 노드를 사칭한 메시지
+    dropped_messages_.fetch_add(1, std::memory_order_relaxed);
+    QF_LOG_RATE_LIMITED(Warning, Cluster, 10, "Message claiming node {} came from node {}", origin,
+                        peer_nodes_[sender]);
+    return;
+  }
+
+  switch (type) {
+    case MessageType::Hello:
+      AnnounceSubscriptions(peer);
+      break;
+
+    case MessageType::Subscribe: {
+      std::unique_lock lock(mutex_);
+      auto found = remote_interest_.find(room);
+      if (found == remote_interest_.end()) {
+        found = remote_interest_.emplace(std::string(room), 0).first;
+      }
+      found->second |= (1ull << peer);
+      interested_rooms_.store(remote_interest_.size(), std::memory_order_relaxed);
+      break;
+    }
+
+    case MessageType::Unsubscribe: {
+      std::unique_lock lock(mutex_);
+      auto found = remote_interest_.find(room);
+      if (found != remote_interest_.end()) {
+        found->second &= ~(1ull << peer);
+        if (found->second == 0) {
+          remote_interest_.erase(found);
+        }
+      }
+      interested_rooms_.store(remote_interest_.size(), std::memory_order_relaxed);
+      break;
+    }
+
+    case MessageType::Publish: {
+      // 본문 길이는 프레임 헤더와 일치해야 한다.
+      if (payloadLength < OutboundFrame::kHeaderSize
+        || ReadU32(payload) != payloadLength - OutboundFrame::kHeaderSize) {
+        dropped_messages_.fetch_add(1, std::memory_order_relaxed);
+        return;
+      }
+      auto localRoom = manager::RoomManager::GetInstance().FindRoom(room);
+      if (localRoom == nullptr) {
+        // 이 노드에는 더 이상 없는 방: Unsubscribe 가 유실된 경우이므로 다시 알린다.
+        SendControl(MessageType::Unsubscribe, room, peer);
+        return;
+      }
+
+      // 수신 버퍼는 콜백 동안만 유효하므로 1번 복사해서 로컬 멤버 전원이 공유한다.
+      uint32_t bodyLength = (uint32_t)(payloadLength - OutboundFrame::kHeaderSize);
+      FrameRef frame(OutboundFrame::Create(bodyLength));
+      std::memcpy(frame->body(), payload + OutboundFrame::kHeaderSize, bodyLength);
+      received_messages_.fetch_add(1, std::memory_order_relaxed);
+      localRoom->DeliverRemoteAsync(std::move(frame));
+      break;
+    }
+
+    default:
+      dropped_messages_.fetch_add(1, std::memory_order_relaxed);
+      break;
+  }
+}
+
+void ClusterBus::SendControl(MessageType type, std::string_view room, int peer) {
+  std::shared_lock sendLock(send_mutex_);
+  if (enabled() == false) {
+    return;
+  }
+  uint8_t header[kHeaderSize];
+  WriteHeader(header, type, room);
+  ClusterBuffer buffers[2] = {
+      {header, kHeaderSize},
+      {reinterpret_cast<const uint8_t*>(room.data()), room.size()},
+  };
+
+  if (peer >= 0) {
+    transport_->SendTo(peer, buffers, 2);
+    return;
+  }
+  for (size_t i = 0; i < peer_nodes_.size(); ++i) {
+    transport_->SendTo((int)i, buffers, 2);
+  }
+}
+
+void ClusterBus::AnnounceSubscriptions(int peer) {
+  std::vector<std::string> rooms;
+  {
+    std::shared_lock lock(mutex_);
+    rooms.assign(local_rooms_.begin(), local_rooms_.end());
+  }
+  for (const auto& room : rooms) {
+    SendControl(MessageType::Subscribe, room, peer);
+  }
+}
+
+size_t ClusterBus::WriteHeader(uint8_t* out, MessageType type, std::string_view room) const {
+  WriteU32(out, kMagic);
+  out[4] = kVersion;
+  out[5] = (uint8_t)type;
+  WriteU16(out + 6, node_id_);
+  WriteU16(out + 8, (uint16_t)room.size());
+  return kHeaderSize;
+}
+
+int ClusterBus::PeerOfNode(uint16_t nodeId) const {
+  for (size_t i = 0; i < peer_nodes_.size(); ++i) {
+    if (peer_nodes_[i] == nodeId) {
+      return (int)i;
+    }
+  }
+  return -1;
+}
+
+}  // namespace cluster
+}  // namespace quicflow
@@ -0,0 +1,26 @@
+//
+// QuicFlow-CPP - Cluster Transport Interface
+//
+
+#include "cluster/cluster_transport.hpp"
+
+#include "cluster/datagram_transport.hpp"
+#include "cluster/shm_transport.hpp"
+#include "common/logger.hpp"
+
+namespace quicflow {
+namespace cluster {
+
+std::unique_ptr<ClusterTransport> ClusterTransport::Create(const std::string& listenAddress) {
+  if (listenAddress.starts_with("udp://") || listenAddress.starts_with("unix://")) {
+    return std::make_unique<DatagramTransport>(listenAddress);
+  }
+  if (listenAddress.starts_with("shm://")) {
+    return std::make_unique<ShmTransport>(listenAddress);
+  }
+  QF_LOG_ERROR(Cluster, "Unsupported transport address: {}", listenAddress);
+  return nullptr;
+}
+
+}  // namespace cluster
+}  // namespace quicflow
@@ -0,0 +1,239 @@
+//
+// QuicFlow-CPP - Datagram Cluster Transport (UDP / Unix domain socket)
+//
+
+#include "cluster/datagram_transport.hpp"
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+
+#include "common/logger.hpp"
+
+namespace quicflow {
+namespace cluster {
+
+namespace {
+
+constexpr std::string_view kUdpScheme = "udp://";
+constexpr std::string_view kUnixScheme = "unix://";
+
+// UDP payload 최대 크기 (IPv4: 65535 - IP 헤더 20 - UDP 헤더 8)
+constexpr size_t kMaxUdpPayload = 65507;
+// Unix datagram 은 커널 설정에 따라 다르지만 macOS 기본값(net.local.dgram.maxdgram)이 작아서
+// UDP 와 같은 값으로 맞추고 송신 버퍼를 늘린다.
+constexpr size_t kMaxUnixPayload = 65507;
+constexpr size_t kMaxIov = 8;
+
+}  // namespace
+
+DatagramTransport::DatagramTransport(std::string listenAddress) : listen_address_(std::move(listenAddress)) {
+}
+
+DatagramTransport::~DatagramTransport() {
+  Stop();
+}
+
+bool DatagramTransport::ParseAddress(const std::string& text, Endpoint& out, int& family) {
+  if (text.starts_with(kUnixScheme)) {
+    std::string path = text.substr(kUnixScheme.size());
+    sockaddr_un address{};
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+      return false;
+    }
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    std::memcpy(&out.address, &address, sizeof(address));
+    out.length = (socklen_t)sizeof(address);
+    family = AF_UNIX;
+    return true;
+  }
+
+  if (text.starts_with(kUdpScheme)) {
+    std::string hostPort = text.substr(kUdpScheme.size());
+    auto colon = hostPort.rfind(':');
+    if (colon == std::string::npos) {
+      return false;
+    }
+    std::string host = hostPort.substr(0, colon);
+    std::string port = hostPort.substr(colon + 1);
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo* result = nullptr;
+    if (getaddrinfo(host.c_str(), port.c_str(), &hints, &result) != 0 || result == nullptr) {
+      return false;
+    }
+    std::memcpy(&out.address, result->ai_addr, result->ai_addrlen);
+    out.length = (socklen_t)result->ai_addrlen;
+    family = result->ai_family;
+    freeaddrinfo(result);
+    return true;
+  }
+  return false;
+}
+
+bool DatagramTransport::Start(ReceiveHandler handler) {
+  Endpoint local;
+  if (ParseAddress(listen_address_, local, family_) == false) {
+    QF_LOG_ERROR(Cluster, "Invalid listen address: {}", listen_address_);
+    return false;
+  }
+
+  socket_ = socket(family_, SOCK_DGRAM, 0);
+  if (socket_ < 0) {
+    QF_LOG_ERROR(Cluster, "socket failed: {}", std::strerror(errno));
+    return false;
+  }
+
+  int bufferBytes = kReceiveBufferBytes;
+  setsockopt(socket_, SOL_SOCKET, SO_RCVBUF, &bufferBytes, sizeof(bufferBytes));
+  setsockopt(socket_, SOL_SOCKET, SO_SNDBUF, &bufferBytes, sizeof(bufferBytes));
+
+  if (family_ == AF_UNIX) {
+    // 이전 실행에서 남은 소켓 파일 제거
+    unix_path_ = reinterpret_cast<sockaddr_un*>(&local.address)->sun_path;
+    unlink(unix_path_.c_str());
+  }
+
+  if (bind(socket_, reinterpret_cast<sockaddr*>(&local.address), local.length) != 0) {
+    QF_LOG_ERROR(Cluster, "bind failed: {} ({})", listen_address_, std::strerror(errno));
+    close(socket_);
+    socket_ = -1;
+    return false;
+  }
+
+  handler_ = std::move(handler);
+  running_ = true;
+  receive_thread_ = std::thread([this] { ReceiveLoop(); });
+  QF_LOG_INFO(Cluster, "Transport listening on {}", listen_address_);
+  return true;
+}
+
+void DatagramTransport::Stop() {
+  if (running_.exchange(false) == false) {
+    return;
+  }
+  if (receive_thread_.joinable()) {
+    receive_thread_.join();
+  }
+  if (socket_ >= 0) {
+    close(socket_);
+    socket_ = -1;
+  }
+  if (unix_path_.empty() == false) {
+    unlink(unix_path_.c_str());
+  }
+}
+
+int DatagramTransport::AddPeer(const std::string& address) {
+  Endpoint endpoint;
+  int family = 0;
+  if (ParseAddress(address, endpoint, family) == false) {
+    QF_LOG_ERROR(Cluster, "Invalid peer address: {}", address);
+    return -1;
+  }
+  peers_.push_back(endpoint);
+  return (int)peers_.size() - 1;
+}
+
+bool DatagramTransport::SendTo(int peer, const ClusterBuffer* buffers, size_t count) {
+  if (socket_ < 0 || peer < 0 || peer >= (int)peers_.size() || count > kMaxIov) {
+    return false;
+  }
+
+  iovec iov[kMaxIov];
+  for (size_t i = 0; i < count; ++i) {
+    iov[i].iov_base = const_cast<uint8_t*>(buffers[i].data);
+    iov[i].iov_len = buffers[i].length;
+  }
+
+  msghdr message{};
+  message.msg_name = &peers_[peer].address;
+  message.msg_namelen = peers_[peer].length;
+  message.msg_iov = iov;
+  message.msg_iovlen = (decltype(message.msg_iovlen))count;
+
+  // 상대가 아직 안 떴거나 버퍼가 가득 찬 경우는 유실로 처리한다. (버스가 재공지로 복구)
+  return sendmsg(socket_, &message, MSG_DONTWAIT) >= 0;
+}
+
+int DatagramTransport::PeerOfAddress(const sockaddr_storage& address, socklen_t length) const {
+  for (size_t i = 0; i < peers_.size(); ++i) {
+    const sockaddr_storage& peer = peers_[i].address;
+    if (peer.ss_family != address.ss_family) {
+      continue;
+    }
+    bool same = false;
+    if (address.ss_family == AF_INET) {
+      auto* lhs = reinterpret_cast<const sockaddr_in*>(&peer);
+      auto* rhs = reinterpret_cast<const sockaddr_in*>(&address);
+      same = lhs->sin_port == rhs->sin_port && lhs->sin_addr.s_addr == rhs->sin_addr.s_addr;
+    } else if (address.ss_family == AF_INET6) {
+      auto* lhs = reinterpret_cast<const sockaddr_in6*>(&peer);
+      auto* rhs = reinterpret_cast<const sockaddr_in6*>(&address);
+      same = lhs->sin6_port == rhs->sin6_port
+          && std::memcmp(&lhs->sin6_addr, &rhs->sin6_addr, sizeof(lhs->sin6_addr)) == 0;
+    } else if (address.ss_family == AF_UNIX) {
+      // bind 하지 않은 소켓에서 온 datagram 은 경로가 비어 있으므로 어느 peer 와도 같지 않다.
+      auto* lhs = reinterpret_cast<const sockaddr_un*>(&peer);
+      auto* rhs = reinterpret_cast<const sockaddr_un*>(&address);
+      size_t pathLength = length > offsetof(sockaddr_un, sun_path) ? length - offsetof(sockaddr_un, sun_path) : 0;
+      std::string_view path(rhs->sun_path, strnlen(rhs->sun_path, std::min(pathLength, sizeof(rhs->sun_path))));
+      same = path.empty() == false && path == lhs->sun_path;
+    }
+    if (same) {
+      return (int)i;
+    }
+  }
+  return -1;
+}
+
+size_t DatagramTransport::max_message_size() const {
+  return family_ == AF_UNIX ? kMaxUnixPayload : kMaxUdpPayload;
+}
+
+void DatagramTransport::ReceiveLoop() {
+  std::vector<uint8_t> buffer(kMaxUdpPayload + 1);
+  pollfd descriptor{socket_, POLLIN, 0};
+
+  while (running_.load(std::memory_order_relaxed)) {
+    int ready = poll(&descriptor, 1, kPollTimeoutMs);
+    if (ready <= 0) {
+      continue;
+    }
+
+    // 한 번 깨어나면 쌓인 datagram 을 모두 읽는다.
+    while (true) {
+      sockaddr_storage source{};
+      socklen_t sourceLength = sizeof(source);
+      ssize_t received = recvfrom(socket_, buffer.data(), buffer.size(), MSG_DONTWAIT,
+                                  reinterpret_cast<sockaddr*>(&source), &sourceLength);
+      if (received < 0) {
+        break;
+      }
+      // 설정된 peer 가 아닌 곳에서 온 메시지는 헤더의 노드 번호와 상관없이 버린다.
+      int peer = PeerOfAddress(source, sourceLength);
+      if (peer < 0) {
+        ++rejected_datagrams_;
+        QF_LOG_RATE_LIMITED(Warning, Cluster, 10, "Datagram from unknown sender rejected ({} total)",
+                            rejected_datagrams_);
+        continue;
+      }
+      handler_(peer, buffer.data(), (size_t)received);
+    }
+  }
+}
+
+}  // namespace cluster
+}  // namespace quicflow
@@ -0,0 +1,433 @@
+//
+// QuicFlow-CPP - Shared Memory Ring Cluster Transport
+//
+
+#include "cluster/shm_transport.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <ctime>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <string_view>
+
+#include "common/logger.hpp"
+
+namespace quicflow {
+namespace cluster {
+
+// 공유 메모리 맨 앞의 ring 상태. 여러 프로세스가 같은 메모리를 보므로 lock-free atomic 만 사용한다.
+struct ShmRingHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t capacity;
+  std::atomic<uint32_t> alive;  // consumer 가 살아있는지 (Stop 시 0. 죽은 consumer 는 지우지 못함 -> inode 확인)
+
+  alignas(64) std::atomic<uint64_t> write_head;  // producer 예약 위치 (절대 offset)
+  alignas(64) std::atomic<uint64_t> read_tail;   // consumer 가 처리를 끝낸 위치
+  alignas(64) std::atomic<uint32_t> wake_sequence;
+  std::atomic<uint32_t> waiters;                 // consumer 가 잠들려는 중이면 1
+};
+
+namespace {
+
+constexpr std::string_view kShmScheme = "shm://";
+constexpr uint32_t kRingMagic = 0x52465151;  // "QQFR"
+constexpr uint32_t kRingVersion = 1;
+constexpr size_t kDataOffset = 256;
+constexpr size_t kMappingSize = kDataOffset + ShmTransport::kRingCapacity;
+constexpr uint32_t kPaddingFlag = 0x80000000u;
+constexpr int kSpinCount = 256;
+constexpr uint32_t kMaxIdleSleepUs = 1000;
+// macOS 의 shm 이름 제한 (PSHMNAMLEN = 31)
+constexpr size_t kMaxShmNameLength = 31;
+
+static_assert(sizeof(ShmRingHeader) <= kDataOffset);
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free);
+static_assert((ShmTransport::kRingCapacity & (ShmTransport::kRingCapacity - 1)) == 0);
+
+// 메시지 1개의 앞 8byte. length 가 0 이 아니게 되는 순간이 commit 이다.
+struct RecordHeader {
+  std::atomic<uint32_t> length;
+  uint32_t reserved;
+};
+static_assert(sizeof(RecordHeader) == 8);
+
+inline uint64_t Align8(uint64_t value) {
+  return (value + 7) & ~uint64_t{7};
+}
+
+inline uint8_t* RingData(ShmRingHeader* ring) {
+  return reinterpret_cast<uint8_t*>(ring) + kDataOffset;
+}
+
+inline RecordHeader* RecordAt(ShmRingHeader* ring, uint64_t position) {
+  return reinterpret_cast<RecordHeader*>(RingData(ring) + (position & (ShmTransport::kRingCapacity - 1)));
+}
+
+inline void CpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield");
+#endif
+}
+
+#if defined(__linux__)
+// 공유 매핑 위의 futex 이므로 FUTEX_PRIVATE_FLAG 를 쓰지 않는다.
+inline void FutexWait(std::atomic<uint32_t>* address, uint32_t expected, uint32_t timeoutMs) {
+  timespec timeout{(time_t)(timeoutMs / 1000), (long)(timeoutMs % 1000) * 1000000};
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(address), FUTEX_WAIT, expected, &timeout, nullptr, 0);
+}
+
+inline void FutexWake(std::atomic<uint32_t>* address) {
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(address), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+}
+#endif
+
+inline void Wake(ShmRingHeader* ring) {
+  ring->wake_sequence.fetch_add(1, std::memory_order_seq_cst);
+#if defined(__linux__)
+  FutexWake(&ring->wake_sequence);
+#endif
+}
+
+}  // namespace
+
+ShmTransport::ShmTransport(std::string listenAddress) : listen_address_(std::move(listenAddress)) {
+}
+
+ShmTransport::~ShmTransport() {
+  Stop();
+}
+
+bool ShmTransport::ParseAddress(const std::string& address, std::string& outName) {
+  if (address.starts_with(kShmScheme) == false) {
+    return false;
+  }
+  outName = "/quicflow-" + address.substr(kShmScheme.size());
+  return outName.size() > 10 && outName.size() <= kMaxShmNameLength
+      && outName.find('/', 1) == std::string::npos;
+}
+
+uint64_t ShmTransport::CurrentInode(const std::string& name) {
+  int fd = shm_open(name.c_str(), O_RDONLY, 0600);
+  if (fd < 0) {
+    return 0;
+  }
+  struct stat info{};
+  uint64_t inode = fstat(fd, &info) == 0 ? (uint64_t)info.st_ino : 0;
+  close(fd);
+  return inode;
+}
+
+ShmRingHeader* ShmTransport::Map(const std::string& name, bool create, uint64_t* inode) {
+  int fd = -1;
+  if (create) {
+    // 이전 실행에서 남은 ring 은 버리고 새로 만든다. (열고 있던 producer 는 alive == 0 이나 inode 변화를 보고 다시 연다)
+    shm_unlink(name.c_str());
+    fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd >= 0 && ftruncate(fd, (off_t)kMappingSize) != 0) {
+      close(fd);
+      shm_unlink(name.c_str());
+      fd = -1;
+    }
+  } else {
+    fd = shm_open(name.c_str(), O_RDWR, 0600);
+    struct stat info{};
+    if (fd >= 0 && (fstat(fd, &info) != 0 || (size_t)info.st_size < kMappingSize)) {
+      close(fd);
+      fd = -1;
+    }
+  }
+  if (fd < 0) {
+    if (create) {
+      QF_LOG_ERROR(Cluster, "shm_open failed: {} ({})", name, std::strerror(errno));
+    }
+    return nullptr;
+  }
+  if (inode != nullptr) {
+    struct stat info{};
+    *inode = fstat(fd, &info) == 0 ? (uint64_t)info.st_ino : 0;
+  }
+
+  void* base = mmap(nullptr, kMappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (base == MAP_FAILED) {
+    QF_LOG_ERROR(Cluster, "mmap failed: {} ({})", name, std::strerror(errno));
+    return nullptr;
+  }
+
+  auto* ring = static_cast<ShmRingHeader*>(base);
+  if (create) {
+    // ftruncate 한 메모리는 0 으로 채워져 있다. (모든 record length == 0)
+    new (ring) ShmRingHeader{};
+    ring->magic = kRingMagic;
+    ring->version = kRingVersion;
+    ring->capacity = kRingCapacity;
+    ring->alive.store(1, std::memory_order_release);
+  } else if (ring->magic != kRingMagic || ring->version != kRingVersion || ring->capacity != kRingCapacity
+             || ring->alive.load(std::memory_order_acquire) == 0) {
+    munmap(base, kMappingSize);
+    return nullptr;
+  }
+  return ring;
+}
+
+void ShmTransport::Unmap(ShmRingHeader* ring) {
+  if (ring != nullptr) {
+    munmap(ring, kMappingSize);
+  }
+}
+
+bool ShmTransport::Start(ReceiveHandler handler) {
+  if (ParseAddress(listen_address_, local_name_) == false) {
+    QF_LOG_ERROR(Cluster, "Invalid shm address: {}", listen_address_);
+    return false;
+  }
+  local_ = Map(local_name_, true);
+  if (local_ == nullptr) {
+    return false;
+  }
+
+  handler_ = std::move(handler);
+  read_tail_ = 0;
+  running_ = true;
+  receive_thread_ = std::thread([this] { ReceiveLoop(); });
+  QF_LOG_INFO(Cluster, "Transport listening on {} ({})", listen_address_, local_name_);
+  return true;
+}
+
+void ShmTransport::Stop() {
+  if (running_.exchange(false) == false) {
+    return;
+  }
+
+  // 이미 SendTo 안에 들어온 스레드가 상대 ring 에 쓰기(memcpy)를 끝낼 때까지 기다린다.
+  // (running_ 과 active_senders_ 는 SendTo 와 반대 순서로 seq_cst 확인)
+  while (active_senders_.load(std::memory_order_seq_cst) != 0) {
+    std::this_thread::yield();
+  }
+
+  local_->alive.store(0, std::memory_order_release);
+  Wake(local_);
+  if (receive_thread_.joinable()) {
+    receive_thread_.join();
+  }
+  Unmap(local_);
+  local_ = nullptr;
+  shm_unlink(local_name_.c_str());
+
+  for (auto& peer : peers_) {
+    std::lock_guard lock(peer->mutex);
+    Unmap(peer->ring.exchange(nullptr));
+    for (auto* ring : peer->retired) {
+      Unmap(ring);
+    }
+    peer->retired.clear();
+  }
+}
+
+int ShmTransport::AddPeer(const std::string& address) {
+  auto peer = std::make_unique<Peer>();
+  if (ParseAddress(address, peer->name) == false) {
+    QF_LOG_ERROR(Cluster, "Invalid shm peer address: {}", address);
+    return -1;
+  }
+  peers_.push_back(std::move(peer));
+  return (int)peers_.size() - 1;
+}
+
+void ShmTransport::RetirePeerRing(Peer& peer) {
+  ShmRingHeader* ring = peer.ring.exchange(nullptr, std::memory_order_acq_rel);
+  if (ring != nullptr) {
+    peer.retired.push_back(ring);
+  }
+  peer.inode = 0;
+}
+
+ShmRingHeader* ShmTransport::AcquirePeerRing(Peer& peer) {
+  const int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+  ShmRingHeader* ring = peer.ring.load(std::memory_order_acquire);
+  if (ring != nullptr && ring->alive.load(std::memory_order_acquire) != 0
+    && now < peer.next_check.load(std::memory_order_relaxed)) {
+    return ring;
+  }
+
+  // 상대가 아직 안 떴거나, 정상 종료했거나, 확인 주기가 됨: 실패하면 이번 메시지는 유실 처리.
+  std::lock_guard lock(peer.mutex);
+  ring = peer.ring.load(std::memory_order_acquire);
+  if (ring != nullptr && ring->alive.load(std::memory_order_acquire) != 0) {
+    if (now < peer.next_check.load(std::memory_order_relaxed)) {
+      return ring;  // 다른 스레드가 방금 확인함
+    }
+    peer.next_check.store(now + kRecheckInterval.count(), std::memory_order_relaxed);
+    // 죽은 consumer 는 alive 를 지우지 못하므로 이름이 같은 객체를 가리키는지 확인한다.
+    uint64_t current = CurrentInode(peer.name);
+    if (current == peer.inode) {
+      return ring;
+    }
+    if (current == 0) {
+      // 이름이 없어짐: 상대가 죽은 뒤 아직 다시 뜨지 않았다. 버려진 ring 에는 더 쓰지 않는다.
+      RetirePeerRing(peer);
+      return nullptr;
+    }
+    QF_LOG_INFO(Cluster, "Peer ring {} was recreated, reopening", peer.name);
+  }
+
+  uint64_t inode = 0;
+  ShmRingHeader* reopened = Map(peer.name, false, &inode);
+  if (reopened == nullptr) {
+    RetirePeerRing(peer);
+    return nullptr;
+  }
+  RetirePeerRing(peer);
+  peer.inode = inode;
+  peer.next_check.store(now + kRecheckInterval.count(), std::memory_order_relaxed);
+  peer.ring.store(reopened, std::memory_order_release);
+  return reopened;
+}
+
+bool ShmTransport::SendTo(int peer, const ClusterBuffer* buffers, size_t count) {
+  if (peer < 0 || peer >= (int)peers_.size()) {
+    return false;
+  }
+  // Stop 이 상대 ring 을 해제하는 동안 쓰지 않도록 들어왔음을 먼저 알리고 running_ 을 확인한다.
+  active_senders_.fetch_add(1, std::memory_order_seq_cst);
+  struct SenderGuard {
+    std::atomic<uint32_t>& count;
+    ~SenderGuard() { count.fetch_sub(1, std::memory_order_release); }
+  } guard{active_senders_};
+  if (running_.load(std::memory_order_seq_cst) == false) {
+    return false;
+  }
+  ShmRingHeader* ring = AcquirePeerRing(*peers_[peer]);
+  if (ring == nullptr) {
+    return false;
+  }
+
+  uint64_t payload = 0;
+  for (size_t i = 0; i < count; ++i) {
+    payload += buffers[i].length;
+  }
+  if (payload == 0 || payload > max_message_size()) {
+    return false;
+  }
+  const uint64_t total = Align8(sizeof(RecordHeader) + payload);
+
+  // 1. 공간 예약: 끝에 걸치면 남은 부분을 padding record 로 채우고 처음부터 쓴다.
+  uint64_t head = ring->write_head.load(std::memory_order_relaxed);
+  uint64_t padding = 0;
+  while (true) {
+    uint64_t offset = head & (kRingCapacity - 1);
+    padding = (kRingCapacity - offset < total) ? kRingCapacity - offset : 0;
+    uint64_t tail = ring->read_tail.load(std::memory_order_acquire);
+    if (head + padding + total - tail > kRingCapacity) {
+      return false;  // ring 이 가득 참: 유실 처리 (버스가 복구)
+    }
+    if (ring->write_head.compare_exchange_weak(head, head + padding + total,
+                                               std::memory_order_acq_rel, std::memory_order_relaxed)) {
+      break;
+    }
+  }
+
+  if (padding != 0) {
+    RecordAt(ring, head)->length.store(kPaddingFlag | (uint32_t)padding, std::memory_order_release);
+  }
+
+  // 2. 본문을 ring 에 바로 쓴다 (gather)
+  RecordHeader* record = RecordAt(ring, head + padding);
+  uint8_t* out = reinterpret_cast<uint8_t*>(record) + sizeof(RecordHeader);
+  for (size_t i = 0; i < count; ++i) {
+    std::memcpy(out, buffers[i].data, buffers[i].length);
+    out += buffers[i].length;
+  }
+
+  // 3. commit 후 consumer 가 잠들려는 중이면 깨운다.
+  // (commit 과 waiters 확인 사이에 seq_cst 순서가 필요: consumer 는 반대 순서로 확인한다)
+  record->length.store((uint32_t)payload, std::memory_order_seq_cst);
+  if (ring->waiters.load(std::memory_order_seq_cst) != 0) {
+    Wake(ring);
+  }
+  return true;
+}
+
+bool ShmTransport::HasData() const {
+  return RecordAt(local_, read_tail_)->length.load(std::memory_order_seq_cst) != 0;
+}
+
+size_t ShmTransport::Drain() {
+  size_t processed = 0;
+  while (true) {
+    RecordHeader* record = RecordAt(local_, read_tail_);
+    uint32_t length = record->length.load(std::memory_order_acquire);
+    if (length == 0) {
+      break;
+    }
+
+    uint64_t size = 0;
+    if (length & kPaddingFlag) {
+      size = length & ~kPaddingFlag;
+    } else {
+      // ring 안의 메시지를 복사 없이 그대로 넘긴다.
+      // 쓸 수 있는 쪽은 0600 shm 객체를 열 수 있는 같은 사용자의 프로세스뿐이고, 누가 썼는지는 알 수 없다.
+      handler_(kUnattributedPeer, reinterpret_cast<const uint8_t*>(record) + sizeof(RecordHeader), length);
+      size = Align8(sizeof(RecordHeader) + length);
+      processed++;
+    }
+
+    // 다음 바퀴에서 이전 내용이 commit 된 record 로 보이지 않도록 지우고 나서 공간을 돌려준다.
+    std::memset(reinterpret_cast<uint8_t*>(record) + sizeof(RecordHeader), 0, size - sizeof(RecordHeader));
+    record->length.store(0, std::memory_order_relaxed);
+    read_tail_ += size;
+    local_->read_tail.store(read_tail_, std::memory_order_release);
+  }
+  return processed;
+}
+
+void ShmTransport::WaitForData() {
+  for (int i = 0; i < kSpinCount; ++i) {
+    if (HasData()) {
+      return;
+    }
+    CpuRelax();
+  }
+
+#if defined(__linux__)
+  local_->waiters.store(1, std::memory_order_seq_cst);
+  uint32_t sequence = local_->wake_sequence.load(std::memory_order_seq_cst);
+  if (HasData() == false && running_.load(std::memory_order_relaxed)) {
+    FutexWait(&local_->wake_sequence, sequence, kWaitTimeoutMs);
+  }
+  local_->waiters.store(0, std::memory_order_relaxed);
+#else
+  // 프로세스 간 futex 가 없는 플랫폼: 한가할수록 길게 잔다 (최대 1ms)
+  idle_sleep_us_ = std::clamp<uint32_t>(idle_sleep_us_ * 2, 50, kMaxIdleSleepUs);
+  std::this_thread::sleep_for(std::chrono::microseconds(idle_sleep_us_));
+#endif
+}
+
+void ShmTransport::ReceiveLoop() {
+  while (running_.load(std::memory_order_relaxed)) {
+    if (Drain() > 0) {
+      idle_sleep_us_ = 0;
+      continue;
+    }
+    WaitForData();
+  }
+}
+
+}  // namespace cluster
+}  // namespace quicflow
@@ -4,9 +4,418 @@
 
 #include "common/logger.hpp"
 
+#include <pthread.h>
+#include <signal.h>
+
+#include <condition_variable>
+#include <cstdio>
+#include <ctime>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 namespace common {
 
-// 정적 멤버 변수 정의
-std::mutex Logger::_mutex;
+namespace {
+
+constexpr size_t kRingMask = Logger::kRingBytes - 1;
+static_assert((Logger::kRingBytes & kRingMask) == 0, "ring size must be a power of two");
+
+// 쓸 것이 없을 때 백그라운드 스레드가 쉬는 시간
+constexpr auto kIdleWait = std::chrono::milliseconds(2);
+
+// 스레드 하나가 쓰고 백그라운드 스레드 하나가 읽는 ring
+struct Ring {
+  explicit Ring(uint32_t index) : buffer(new uint8_t[Logger::kRingBytes]), thread_index(index) {}
+
+  std::unique_ptr<uint8_t[]> buffer;
+  const uint32_t thread_index;
+
+  // 쓰는 쪽
+  alignas(64) std::atomic<uint64_t> head{0};
+  uint64_t pending = 0;      // Reserve 후 Commit 할 head
+  uint64_t cached_tail = 0;  // tail 을 매번 읽지 않도록 캐시
+  std::atomic<uint64_t> dropped{0};
+
+  // 읽는 쪽
+  alignas(64) std::atomic<uint64_t> tail{0};
+  uint64_t reported_dropped = 0;
+  std::atomic<bool> closed{false};  // 스레드 종료. 비워지면 백그라운드 스레드가 정리한다.
+};
+
+// 스레드가 끝날 때 ring 을 닫는다.
+struct ThreadRing {
+  std::shared_ptr<Ring> ring;
+  ~ThreadRing() {
+    if (ring != nullptr) {
+      ring->closed.store(true, std::memory_order_release);
+    }
+  }
+};
+
+thread_local ThreadRing t_ring;
+
+constexpr const char* kLevelTags[] = {" [TRACE] ", " [DEBUG] ", " [LOG] ", " [WARN] ", " [ERR] "};
+constexpr const char* kLevelNames[] = {"trace", "debug", "info", "warning", "error", "off"};
+constexpr const char* kCategoryNames[] = {"main", "server", "conn", "stream", "manager",
+                                          "room", "history", "cluster", "core", "config"};
+static_assert(std::size(kCategoryNames) == (size_t)LogCategory::kCount);
+
+const char* LevelColor(LogLevel level) {
+  switch (level) {
+    case LogLevel::Warning:
+      return COLOR_WARN;
+    case LogLevel::Error:
+      return COLOR_ERROR;
+    default:
+      return COLOR_INFO;
+  }
+}
+
+}  // namespace
+
+class LoggerBackend {
+public:
+  using Level = Logger::Level;
+  using RecordHeader = Logger::RecordHeader;
+
+  // 정적 소멸 순서와 상관없이 쓸 수 있도록 해제하지 않는다.
+  static LoggerBackend& Instance() {
+    static LoggerBackend* instance = new LoggerBackend();
+    return *instance;
+  }
+
+  // 호출 스레드의 ring 을 만든다. 종료 후에는 nullptr
+  Ring* Register() {
+    std::lock_guard lock(mutex_);
+    if (stopped_) {
+      return nullptr;
+    }
+    if (thread_.joinable() == false) {
+      // 처음 로그는 main 이 EventLoop::WatchSignal 로 시그널을 block 하기 전에 올 수 있다.
+      // 로그 스레드가 SIGINT/SIGTERM 을 받아 기본 동작(종료)으로 죽이지 않도록 모든 시그널을 block 한 채로 만든다.
+      // (새 스레드는 만든 스레드의 mask 를 물려받으므로 시작하는 순간부터 block 된 상태)
+      sigset_t all;
+      sigset_t previous;
+      sigfillset(&all);
+      pthread_sigmask(SIG_SETMASK, &all, &previous);
+      thread_ = std::thread([this]() { Run(); });
+      pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+      std::atexit([]() { Logger::Shutdown(); });
+    }
+    t_ring.ring = std::make_shared<Ring>(next_thread_index_++);
+    rings_.push_back(t_ring.ring);
+    return t_ring.ring.get();
+  }
+
+  bool SetFile(const std::string& path) {
+    FILE* file = nullptr;
+    if (path.empty() == false) {
+      file = std::fopen(path.c_str(), "a");
+      if (file == nullptr) {
+        return false;
+      }
+    }
+    std::lock_guard lock(sink_mutex_);
+    if (file_ != nullptr) {
+      std::fclose(file_);
+    }
+    file_ = file;
+    return true;
+  }
+
+  void Flush() {
+    std::unique_lock lock(mutex_);
+    if (thread_.joinable() == false || stopped_) {
+      return;
+    }
+    // 요청 이후에 시작한 drain 이 한 번 끝날 때까지
+    uint64_t target = passes_ + 2;
+    ++flush_waiters_;
+    wake_.notify_one();
+    flushed_.wait(lock, [&]() { return passes_ >= target || stopped_; });
+    --flush_waiters_;
+  }
+
+  void Shutdown() {
+    std::unique_lock lock(mutex_);
+    if (stopped_) {
+      return;
+    }
+    stopped_ = true;
+    if (thread_.joinable() == false) {
+      return;
+    }
+    wake_.notify_one();
+    lock.unlock();
+    thread_.join();
+    flushed_.notify_all();
+
+    std::lock_guard sinkLock(sink_mutex_);
+    if (file_ != nullptr) {
+      std::fclose(file_);
+      file_ = nullptr;
+    }
+  }
+
+  uint64_t dropped() const { return total_dropped_.load(std::memory_order_relaxed); }
+
+private:
+  struct Entry {
+    int64_t timestamp_ns;
+    Level level;
+    LogCategory category;
+    uint32_t thread_index;
+    size_t offset;  // text_ 안의 위치
+    size_t length;
+  };
+
+  LoggerBackend()
+      : system_base_(std::chrono::system_clock::now()), steady_base_(std::chrono::steady_clock::now()) {
+  }
+
+  void Run() {
+    std::unique_lock lock(mutex_);
+    while (true) {
+      bool stopping = stopped_;
+      lock.unlock();
+      bool wrote = Drain();
+      lock.lock();
+      ++passes_;
+      flushed_.notify_all();
+      if (stopping) {
+        return;
+      }
+      if (wrote == false) {
+        wake_.wait_for(lock, kIdleWait, [&]() { return stopped_ || flush_waiters_ > 0; });
+      }
+    }
+  }
+
+  // 모든 ring 을 비우고 시간순으로 쓴다.
+  bool Drain() {
+    std::vector<std::shared_ptr<Ring>> rings;
+    {
+      std::lock_guard lock(mutex_);
+      rings = rings_;
+    }
+
+    entries_.clear();
+    text_.clear();
+    bool removeClosed = false;
+    for (auto& ring : rings) {
+      bool closed = ring->closed.load(std::memory_order_acquire);
+      DrainRing(*ring);
+      removeClosed |= closed;
+    }
+    if (removeClosed) {
+      std::lock_guard lock(mutex_);
+      std::erase_if(rings_, [](const std::shared_ptr<Ring>& ring) {
+        return ring->closed.load(std::memory_order_acquire)
+          && ring->tail.load(std::memory_order_relaxed) == ring->head.load(std::memory_order_acquire);
+      });
+    }
+
+    if (entries_.empty()) {
+      return false;
+    }
+    std::stable_sort(entries_.begin(), entries_.end(),
+                     [](const Entry& a, const Entry& b) { return a.timestamp_ns < b.timestamp_ns; });
+    Write();
+    return true;
+  }
+
+  void DrainRing(Ring& ring) {
+    const uint8_t* buffer = ring.buffer.get();
+    uint64_t head = ring.head.load(std::memory_order_acquire);
+    uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+
+    while (tail < head) {
+      size_t offset = tail & kRingMask;
+      size_t contiguous = Logger::kRingBytes - offset;
+      if (contiguous < sizeof(RecordHeader)) {
+        tail += contiguous;  // 헤더도 들어가지 않는 끝부분은 쓰는 쪽이 건너뛴다.
+        continue;
+      }
+      RecordHeader header;
+      std::memcpy(&header, buffer + offset, sizeof(header));
+      if (header.formatter != nullptr) {
+        size_t start = text_.size();
+        try {
+          header.formatter(std::string_view(header.format, header.format_size),
+                           buffer + offset + sizeof(RecordHeader), text_);
+        } catch (const std::exception& e) {
+          text_.resize(start);
+          text_.append("(format error: ").append(e.what()).append(")");
+        }
+        entries_.push_back({header.timestamp_ns, header.level, header.category, ring.thread_index, start,
+                            text_.size() - start});
+      }
+      tail += header.size;
+    }
+    ring.tail.store(tail, std::memory_order_release);
+
+    uint64_t dropped = ring.dropped.load(std::memory_order_relaxed);
+    if (dropped != ring.reported_dropped) {
+      size_t start = text_.size();
+      std::format_to(std::back_inserter(text_), "{} log records dropped (ring full)", dropped - ring.reported_dropped);
+      total_dropped_.fetch_add(dropped - ring.reported_dropped, std::memory_order_relaxed);
+      ring.reported_dropped = dropped;
+      int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+      entries_.push_back({now, Level::Warning, LogCategory::General, ring.thread_index, start, text_.size() - start});
+    }
+  }
+
+  void Write() {
+    out_.clear();
+    err_.clear();
+    std::lock_guard lock(sink_mutex_);
+    bool console = file_ == nullptr;
+
+    for (const auto& entry : entries_) {
+      std::string& target = console && entry.level == Level::Error ? err_ : out_;
+      if (console) {
+        target.append(LevelColor(entry.level));
+      }
+      AppendTime(target, entry.timestamp_ns);
+      target.append(kLevelTags[(size_t)entry.level]);
+      std::format_to(std::back_inserter(target), "[{}] [T{}] ", kCategoryNames[(size_t)entry.category],
+                     entry.thread_index);
+      target.append(text_, entry.offset, entry.length);
+      if (console) {
+        target.append(COLOR_RESET);
+      }
+      target.push_back('\n');
+    }
+
+    FILE* out = console ? stdout : file_;
+    if (out_.empty() == false) {
+      std::fwrite(out_.data(), 1, out_.size(), out);
+      std::fflush(out);
+    }
+    if (err_.empty() == false) {
+      std::fwrite(err_.data(), 1, err_.size(), stderr);
+      std::fflush(stderr);
+    }
+  }
+
+  // HH:MM:SS.uuuuuu (로컬 시간)
+  void AppendTime(std::string& out, int64_t steadyNs) const {
+    auto wall = system_base_ + std::chrono::duration_cast<std::chrono::system_clock::duration>(
+      std::chrono::steady_clock::time_point(std::chrono::nanoseconds(steadyNs)) - steady_base_);
+    auto micros = std::chrono::duration_cast<std::chrono::microseconds>(wall.time_since_epoch()).count();
+    std::time_t seconds = (std::time_t)(micros / 1000000);
+    std::tm local{};
+    localtime_r(&seconds, &local);
+    std::format_to(std::back_inserter(out), "{:02}:{:02}:{:02}.{:06}",
+                   local.tm_hour, local.tm_min, local.tm_sec, micros % 1000000);
+  }
+
+  const std::chrono::system_clock::time_point system_base_;
+  const std::chrono::steady_clock::time_point steady_base_;
+
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable flushed_;
+  std::thread thread_;
+  std::vector<std::shared_ptr<Ring>> rings_;
+  uint32_t next_thread_index_ = 0;
+  uint64_t passes_ = 0;
+  uint32_t flush_waiters_ = 0;
+  bool stopped_ = false;
+
+  std::mutex sink_mutex_;
+  FILE* file_ = nullptr;  // nullptr 이면 콘솔
+
+  // 백그라운드 스레드 전용
+  std::vector<Entry> entries_;
+  std::string text_;
+  std::string out_;
+  std::string err_;
+  std::atomic<uint64_t> total_dropped_{0};
+};
+
+uint8_t* Logger::Reserve(size_t size) {
+  Ring* ring = t_ring.ring.get();
+  if (ring == nullptr) {
+    ring = LoggerBackend::Instance().Register();
+    if (ring == nullptr) {
+      return nullptr;
+    }
+  }
+  if (size > kRingBytes / 4) {
+    ring->dropped.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+
+  uint64_t head = ring->head.load(std::memory_order_relaxed);
+  size_t offset = head & kRingMask;
+  size_t contiguous = kRingBytes - offset;
+  // 레코드는 ring 끝에서 나뉘지 않게 한다. 남은 공간은 padding
+  size_t padding = contiguous < size ? contiguous : 0;
+  uint64_t end = head + padding + size;
+  if (end - ring->cached_tail > kRingBytes) {
+    ring->cached_tail = ring->tail.load(std::memory_order_acquire);
+    if (end - ring->cached_tail > kRingBytes) {
+      ring->dropped.fetch_add(1, std::memory_order_relaxed);
+      return nullptr;
+    }
+  }
+
+  if (padding >= sizeof(RecordHeader)) {
+    RecordHeader header{};
+    header.size = (uint32_t)padding;
+    std::memcpy(ring->buffer.get() + offset, &header, sizeof(header));
+  }
+  ring->pending = end;
+  return ring->buffer.get() + ((head + padding) & kRingMask);
+}
+
+void Logger::Commit() {
+  Ring* ring = t_ring.ring.get();
+  ring->head.store(ring->pending, std::memory_order_release);
+}
+
+bool Logger::SetFile(const std::string& path) {
+  return LoggerBackend::Instance().SetFile(path);
+}
+
+void Logger::Flush() {
+  LoggerBackend::Instance().Flush();
+}
+
+void Logger::Shutdown() {
+  LoggerBackend::Instance().Shutdown();
+}
+
+uint64_t Logger::dropped() {
+  return LoggerBackend::Instance().dropped();
+}
+
+bool Logger::ParseLevel(std::string_view text, LogLevel& out) {
+  for (size_t i = 0; i < std::size(kLevelNames); ++i) {
+    if (text == kLevelNames[i]) {
+      out = (LogLevel)i;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool Logger::ParseCategory(std::string_view text, LogCategory& out) {
+  for (size_t i = 0; i < std::size(kCategoryNames); ++i) {
+    if (text == kCategoryNames[i]) {
+      out = (LogCategory)i;
+      return true;
+    }
+  }
+  return false;
+}
+
+const char* Logger::CategoryName(LogCategory category) {
+  return kCategoryNames[(size_t)category];
+}
 
 }
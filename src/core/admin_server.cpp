@@ -0,0 +1,188 @@
+//
+// QuicFlow-CPP - Local Admin HTTP Endpoint
+//
+
+#include "core/admin_server.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <format>
+
+#include "common/logger.hpp"
+
+namespace quicflow {
+namespace core {
+
+namespace {
+
+// scraper/curl 이 응답 도중 끊어도 SIGPIPE 로 서버 전체가 죽지 않게 한다. (macOS 는 소켓 옵션 SO_NOSIGPIPE)
+#if defined(MSG_NOSIGNAL)
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = 0;
+#endif
+
+void SendAll(int client, std::string_view data) {
+  while (data.empty() == false) {
+    ssize_t sent = send(client, data.data(), data.size(), kSendFlags);
+    if (sent <= 0) {
+      return;
+    }
+    data.remove_prefix((size_t)sent);
+  }
+}
+
+void SendResponse(int client, std::string_view status, std::string_view contentType, std::string_view body) {
+  SendAll(client, std::format("HTTP/1.0 {}\r\nContent-Type: {}\r\nContent-Length: {}\r\nConnection: close\r\n\r\n",
+                              status, contentType, body.size()));
+  SendAll(client, body);
+}
+
+}  // namespace
+
+AdminServer::~AdminServer() {
+  Stop();
+}
+
+void AdminServer::Handle(std::string path, std::string contentType, Handler handler) {
+  std::lock_guard lock(routes_mutex_);
+  routes_[std::move(path)] = Route{std::move(contentType), std::move(handler)};
+}
+
+bool AdminServer::Start(const AdminConfig& config) {
+  if (config.Port == 0 || running_.load()) {
+    return false;
+  }
+
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(config.Port);
+  if (inet_pton(AF_INET, config.BindAddress.c_str(), &address.sin_addr) != 1) {
+    QF_LOG_ERROR(Core, "Invalid admin bind address: {}", config.BindAddress);
+    return false;
+  }
+
+  listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+  if (listen_fd_ < 0) {
+    QF_LOG_ERROR(Core, "admin socket failed: {}", std::strerror(errno));
+    return false;
+  }
+  int reuse = 1;
+  setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+  if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+    || listen(listen_fd_, 16) != 0) {
+    QF_LOG_ERROR(Core, "admin bind failed: {}:{} ({})", config.BindAddress, config.Port, std::strerror(errno));
+    close(listen_fd_);
+    listen_fd_ = -1;
+    return false;
+  }
+
+  running_ = true;
+  thread_ = std::thread([this] { AcceptLoop(); });
+  QF_LOG_INFO(Core, "Admin endpoint listening on http://{}:{}", config.BindAddress, config.Port);
+  return true;
+}
+
+void AdminServer::Stop() {
+  if (running_.exchange(false) == false) {
+    return;
+  }
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  if (listen_fd_ >= 0) {
+    close(listen_fd_);
+    listen_fd_ = -1;
+  }
+}
+
+void AdminServer::AcceptLoop() {
+  pollfd descriptor{listen_fd_, POLLIN, 0};
+
+  while (running_.load(std::memory_order_relaxed)) {
+    int ready = poll(&descriptor, 1, kPollTimeoutMs);
+    if (ready <= 0) {
+      continue;
+    }
+    int client = accept(listen_fd_, nullptr, nullptr);
+    if (client < 0) {
+      continue;
+    }
+    Serve(client);
+    close(client);
+  }
+}
+
+void AdminServer::Serve(int client) {
+  timeval timeout{};
+  timeout.tv_sec = kReceiveTimeoutMs / 1000;
+  timeout.tv_usec = (kReceiveTimeoutMs % 1000) * 1000;
+  setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+#if defined(SO_NOSIGPIPE)
+  int noSigpipe = 1;
+  setsockopt(client, SOL_SOCKET, SO_NOSIGPIPE, &noSigpipe, sizeof(noSigpipe));
+#endif
+
+  // 요청 줄만 필요하므로 헤더 끝까지만 읽는다. (본문 없는 GET)
+  std::string request;
+  char buffer[1024];
+  while (request.find("\r\n\r\n") == std::string::npos && request.size() < kMaxRequestBytes) {
+    ssize_t received = recv(client, buffer, sizeof(buffer), 0);
+    if (received <= 0) {
+      break;
+    }
+    request.append(buffer, (size_t)received);
+  }
+
+  // "GET /path?query HTTP/1.1"
+  std::string_view line(request);
+  line = line.substr(0, line.find("\r\n"));
+  auto methodEnd = line.find(' ');
+  auto targetEnd = methodEnd == std::string_view::npos ? methodEnd : line.find(' ', methodEnd + 1);
+  if (targetEnd == std::string_view::npos) {
+    SendResponse(client, "400 Bad Request", "text/plain", "bad request\n");
+    return;
+  }
+  if (line.substr(0, methodEnd) != "GET") {
+    SendResponse(client, "405 Method Not Allowed", "text/plain", "GET only\n");
+    return;
+  }
+  std::string_view target = line.substr(methodEnd + 1, targetEnd - methodEnd - 1);
+  std::string_view path = target;
+  std::string_view query;
+  if (auto question = target.find('?'); question != std::string_view::npos) {
+    path = target.substr(0, question);
+    query = target.substr(question + 1);
+  }
+
+  Route route;
+  {
+    std::lock_guard lock(routes_mutex_);
+    auto found = routes_.find(path);
+    if (found == routes_.end()) {
+      std::string known;
+      for (const auto& [name, unused] : routes_) {
+        known += name;
+        known += '\n';
+      }
+      SendResponse(client, "404 Not Found", "text/plain", known);
+      return;
+    }
+    route = found->second;
+  }
+
+  QF_LOG_DEBUG(Core, "Admin request {}", target);
+  SendResponse(client, "200 OK", route.content_type, route.handler(query));
+}
+
+}  // namespace core
+}  // namespace quicflow
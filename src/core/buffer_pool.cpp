@@ -0,0 +1,102 @@
+//
+// QuicFlow-CPP - Send Buffer Pool
+//
+
+#include "core/buffer_pool.hpp"
+
+#include <array>
+#include <atomic>
+
+#include "core/concurrentqueue.h"
+
+namespace quicflow {
+namespace core {
+
+namespace {
+
+struct SizeClass {
+  moodycamel::ConcurrentQueue<uint8_t*> free_list;
+  std::atomic<size_t> cached{0};
+};
+
+std::array<SizeClass, BufferPool::kClassCount>& Classes() {
+  static std::array<SizeClass, BufferPool::kClassCount> classes;
+  return classes;
+}
+
+// size 를 담을 수 있는 가장 작은 class index
+size_t ClassIndex(size_t size) {
+  size_t index = 0;
+  size_t classSize = BufferPool::kMinClassSize;
+  while (classSize < size) {
+    classSize <<= 1;
+    ++index;
+  }
+  return index;
+}
+
+}  // namespace
+
+uint8_t* BufferPool::Allocate(size_t size, size_t& capacity) {
+  if (size > kMaxClassSize) {
+    capacity = size;
+    return new uint8_t[size];
+  }
+
+  size_t index = ClassIndex(size);
+  capacity = kMinClassSize << index;
+
+  auto& sizeClass = Classes()[index];
+  uint8_t* buffer = nullptr;
+  if (sizeClass.free_list.try_dequeue(buffer)) {
+    sizeClass.cached.fetch_sub(1, std::memory_order_relaxed);
+    return buffer;
+  }
+  return new uint8_t[capacity];
+}
+
+void BufferPool::Free(uint8_t* buffer, size_t capacity) noexcept {
+  if (buffer == nullptr) {
+    return;
+  }
+  if (capacity > kMaxClassSize) {
+    delete[] buffer;
+    return;
+  }
+
+  auto& sizeClass = Classes()[ClassIndex(capacity)];
+  // 상한을 넘으면 그냥 해제 (버스트 이후 메모리가 계속 잡혀있지 않도록)
+  if (sizeClass.cached.fetch_add(1, std::memory_order_relaxed) >= kMaxCachedPerClass
+    || sizeClass.free_list.enqueue(buffer) == false) {
+    sizeClass.cached.fetch_sub(1, std::memory_order_relaxed);
+    delete[] buffer;
+  }
+}
+
+size_t BufferPool::Trim() noexcept {
+  size_t released = 0;
+  size_t classSize = kMinClassSize;
+  for (auto& sizeClass : Classes()) {
+    uint8_t* buffer = nullptr;
+    while (sizeClass.free_list.try_dequeue(buffer)) {
+      sizeClass.cached.fetch_sub(1, std::memory_order_relaxed);
+      delete[] buffer;
+      released += classSize;
+    }
+    classSize <<= 1;
+  }
+  return released;
+}
+
+size_t BufferPool::cached_bytes() noexcept {
+  size_t total = 0;
+  size_t classSize = kMinClassSize;
+  for (auto& sizeClass : Classes()) {
+    total += sizeClass.cached.load(std::memory_order_relaxed) * classSize;
+    classSize <<= 1;
+  }
+  return total;
+}
+
+}  // namespace core
+}  // namespace quicflow
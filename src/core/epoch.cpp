@@ -0,0 +1,164 @@
+//
+// QuicFlow-CPP - Epoch Based Reclamation
+//
+
+#include "core/epoch.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace quicflow {
+namespace core {
+
+namespace {
+
+// 스레드마다 하나씩 점유하는 읽기 슬롯 (false sharing 방지를 위해 cache line 정렬)
+struct alignas(64) ReaderSlot {
+  std::atomic<uint64_t> epoch{0};  // 0 = 읽기 구간 밖
+  std::atomic<bool> in_use{false};
+};
+
+struct RetiredObject {
+  void* ptr;
+  Epoch::Deleter deleter;
+  uint64_t epoch;
+};
+
+struct EpochState {
+  std::atomic<uint64_t> global_epoch{1};
+  // 슬롯을 못 얻은 스레드가 읽기 구간에 있는 수 (0 이 아니면 epoch 를 진행하지 않는다)
+  std::atomic<int> overflow_readers{0};
+  ReaderSlot slots[Epoch::kMaxReaderSlots];
+
+  std::mutex retire_mutex;
+  std::vector<RetiredObject> retired;
+};
+
+EpochState& State() {
+  static EpochState state;
+  return state;
+}
+
+struct ThreadState {
+  int slot = -1;
+  int depth = 0;
+  bool overflow = false;
+
+  ~ThreadState() {
+    if (slot >= 0) {
+      State().slots[slot].epoch.store(0, std::memory_order_release);
+      State().slots[slot].in_use.store(false, std::memory_order_release);
+    }
+  }
+
+  void ClaimSlot() {
+    auto& state = State();
+    for (size_t i = 0; i < Epoch::kMaxReaderSlots; ++i) {
+      bool expected = false;
+      if (state.slots[i].in_use.load(std::memory_order_relaxed) == false
+        && state.slots[i].in_use.compare_exchange_strong(expected, true)) {
+        slot = (int)i;
+        return;
+      }
+    }
+  }
+};
+
+thread_local ThreadState t_state;
+
+}  // namespace
+
+Epoch::Guard::Guard() {
+  if (t_state.depth++ > 0) {
+    return;
+  }
+
+  auto& state = State();
+  if (t_state.slot < 0) {
+    t_state.ClaimSlot();
+  }
+  if (t_state.slot < 0) {
+    state.overflow_readers.fetch_add(1, std::memory_order_seq_cst);
+    t_state.overflow = true;
+    return;
+  }
+
+  // 현재 epoch 를 공개한 뒤에 공유 포인터를 읽어야 한다 (seq_cst)
+  state.slots[t_state.slot].epoch.store(state.global_epoch.load(std::memory_order_seq_cst),
+                                        std::memory_order_seq_cst);
+}
+
+Epoch::Guard::~Guard() {
+  if (--t_state.depth > 0) {
+    return;
+  }
+
+  if (t_state.overflow) {
+    t_state.overflow = false;
+    State().overflow_readers.fetch_sub(1, std::memory_order_release);
+    return;
+  }
+  State().slots[t_state.slot].epoch.store(0, std::memory_order_release);
+}
+
+void Epoch::Retire(void* ptr, Deleter deleter) {
+  auto& state = State();
+  {
+    std::lock_guard<std::mutex> lock(state.retire_mutex);
+    state.retired.push_back({ptr, deleter, state.global_epoch.load(std::memory_order_seq_cst)});
+  }
+  Reclaim();
+}
+
+size_t Epoch::Reclaim() {
+  auto& state = State();
+  std::vector<RetiredObject> freeList;
+  {
+    std::lock_guard<std::mutex> lock(state.retire_mutex);
+
+    // 1. 모든 활성 reader 가 현재 epoch 에 있으면 한 칸 진행 (한 번 호출에 최대 2칸)
+    uint64_t current = state.global_epoch.load(std::memory_order_seq_cst);
+    for (int step = 0; step < 2; ++step) {
+      bool canAdvance = state.overflow_readers.load(std::memory_order_seq_cst) == 0;
+      for (size_t i = 0; canAdvance && i < kMaxReaderSlots; ++i) {
+        uint64_t epoch = state.slots[i].epoch.load(std::memory_order_seq_cst);
+        if (epoch != 0 && epoch != current) {
+          canAdvance = false;
+        }
+      }
+      if (canAdvance == false) {
+        break;
+      }
+      state.global_epoch.compare_exchange_strong(current, current + 1);
+      current = state.global_epoch.load(std::memory_order_seq_cst);
+    }
+
+    // 2. 두 epoch 이전에 retire 된 객체는 더 이상 아무도 볼 수 없다.
+    auto& retired = state.retired;
+    size_t kept = 0;
+    for (size_t i = 0; i < retired.size(); ++i) {
+      if (retired[i].epoch + 2 <= current) {
+        freeList.push_back(retired[i]);
+      } else {
+        retired[kept++] = retired[i];
+      }
+    }
+    retired.resize(kept);
+  }
+
+  // deleter 는 락 밖에서 호출 (deleter 안에서 다시 Retire 해도 안전하도록)
+  for (auto& object : freeList) {
+    object.deleter(object.ptr);
+  }
+  return freeList.size();
+}
+
+size_t Epoch::pending() noexcept {
+  auto& state = State();
+  std::lock_guard<std::mutex> lock(state.retire_mutex);
+  return state.retired.size();
+}
+
+}  // namespace core
+}  // namespace quicflow
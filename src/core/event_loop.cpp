@@ -0,0 +1,262 @@
+//
+// QuicFlow-CPP - Main Thread Event Loop
+//
+
+#include "core/event_loop.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+
+#include <pthread.h>
+#include <unistd.h>
+#if defined(__APPLE__)
+#include <sys/event.h>
+#else
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#endif
+
+#include "common/logger.hpp"
+
+namespace quicflow {
+namespace core {
+
+namespace {
+
+#if defined(__APPLE__)
+constexpr uintptr_t kWakeupIdent = 1;
+#endif
+
+timespec ToTimespec(std::chrono::nanoseconds duration) {
+  if (duration.count() < 0) {
+    duration = std::chrono::nanoseconds(0);
+  }
+  timespec value{};
+  value.tv_sec = (time_t)(duration.count() / 1000000000);
+  value.tv_nsec = (long)(duration.count() % 1000000000);
+  return value;
+}
+
+}  // namespace
+
+EventLoop::EventLoop() {
+#if defined(__APPLE__)
+  poll_fd_ = kqueue();
+  if (poll_fd_ < 0) {
+    QF_LOG_ERROR(Core, "kqueue failed: {}", std::strerror(errno));
+    return;
+  }
+  struct kevent change;
+  EV_SET(&change, kWakeupIdent, EVFILT_USER, EV_ADD | EV_CLEAR, 0, 0, nullptr);
+  if (kevent(poll_fd_, &change, 1, nullptr, 0, nullptr) != 0) {
+    QF_LOG_ERROR(Core, "kevent(EVFILT_USER) failed: {}", std::strerror(errno));
+    return;
+  }
+#else
+  poll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+  wakeup_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  // steady_clock 은 Linux 에서 CLOCK_MONOTONIC 이므로 deadline 을 그대로 넘길 수 있다.
+  timer_fd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  if (poll_fd_ < 0 || wakeup_fd_ < 0 || timer_fd_ < 0) {
+    QF_LOG_ERROR(Core, "epoll/eventfd/timerfd failed: {}", std::strerror(errno));
+    return;
+  }
+  for (int fd : {wakeup_fd_, timer_fd_}) {
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if (epoll_ctl(poll_fd_, EPOLL_CTL_ADD, fd, &event) != 0) {
+      QF_LOG_ERROR(Core, "epoll_ctl failed: {}", std::strerror(errno));
+      return;
+    }
+  }
+#endif
+  valid_ = true;
+}
+
+EventLoop::~EventLoop() {
+  for (int fd : {poll_fd_, wakeup_fd_, signal_fd_, timer_fd_}) {
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+}
+
+bool EventLoop::WatchSignal(int signo, Callback callback) {
+  if (is_valid() == false) {
+    return false;
+  }
+  signal_callbacks_[signo] = std::move(callback);
+
+#if defined(__APPLE__)
+  // EVFILT_SIGNAL 은 기본 동작(종료 등) 이후에 통지되므로 기본 동작은 끈다.
+  std::signal(signo, SIG_IGN);
+  struct kevent change;
+  EV_SET(&change, (uintptr_t)signo, EVFILT_SIGNAL, EV_ADD, 0, 0, nullptr);
+  return kevent(poll_fd_, &change, 1, nullptr, 0, nullptr) == 0;
+#else
+  sigset_t mask;
+  sigemptyset(&mask);
+  for (const auto& [watched, unused] : signal_callbacks_) {
+    sigaddset(&mask, watched);
+  }
+  if (pthread_sigmask(SIG_BLOCK, &mask, nullptr) != 0) {
+    return false;
+  }
+
+  bool created = signal_fd_ < 0;
+  signal_fd_ = signalfd(signal_fd_, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+  if (signal_fd_ < 0) {
+    QF_LOG_ERROR(Core, "signalfd failed: {}", std::strerror(errno));
+    return false;
+  }
+  if (created) {
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = signal_fd_;
+    epoll_ctl(poll_fd_, EPOLL_CTL_ADD, signal_fd_, &event);
+  }
+  return true;
+#endif
+}
+
+void EventLoop::Schedule(std::string name, std::chrono::microseconds interval, Callback callback) {
+  timers_.push_back({std::move(name), interval, Clock::now() + interval, std::move(callback)});
+}
+
+void EventLoop::Post(Callback task) {
+  {
+    std::lock_guard lock(posted_mutex_);
+    posted_.push_back(std::move(task));
+  }
+  Wakeup();
+}
+
+void EventLoop::Run() {
+  if (is_valid() == false) {
+    return;
+  }
+  while (running_.load(std::memory_order_acquire)) {
+    WaitAndDispatch();
+    RunPosted();
+    RunDueTimers();
+  }
+}
+
+void EventLoop::Stop() {
+  running_.store(false, std::memory_order_release);
+  Wakeup();
+}
+
+void EventLoop::Wakeup() {
+#if defined(__APPLE__)
+  struct kevent change;
+  EV_SET(&change, kWakeupIdent, EVFILT_USER, 0, NOTE_TRIGGER, 0, nullptr);
+  kevent(poll_fd_, &change, 1, nullptr, 0, nullptr);
+#else
+  uint64_t one = 1;
+  [[maybe_unused]] ssize_t written = write(wakeup_fd_, &one, sizeof(one));
+#endif
+}
+
+void EventLoop::WaitAndDispatch() {
+  // 다음 타이머 시각
+  Clock::time_point next = Clock::time_point::max();
+  for (const auto& timer : timers_) {
+    next = std::min(next, timer.deadline);
+  }
+
+  std::vector<int> signals;
+#if defined(__APPLE__)
+  timespec timeout{};
+  timespec* timeoutPointer = nullptr;
+  if (next != Clock::time_point::max()) {
+    timeout = ToTimespec(next - Clock::now());
+    timeoutPointer = &timeout;
+  }
+  struct kevent events[16];
+  int count = kevent(poll_fd_, nullptr, 0, events, 16, timeoutPointer);
+  for (int i = 0; i < count; ++i) {
+    if (events[i].filter == EVFILT_SIGNAL) {
+      signals.push_back((int)events[i].ident);
+    }
+  }
+#else
+  if (next != Clock::time_point::max()) {
+    ArmTimer(next);
+  }
+  epoll_event events[8];
+  int count = epoll_wait(poll_fd_, events, 8, -1);
+  for (int i = 0; i < count; ++i) {
+    int fd = events[i].data.fd;
+    if (fd == wakeup_fd_ || fd == timer_fd_) {
+      uint64_t value;
+      while (read(fd, &value, sizeof(value)) > 0) {
+      }
+    } else if (fd == signal_fd_) {
+      signalfd_siginfo info;
+      while (read(signal_fd_, &info, sizeof(info)) == (ssize_t)sizeof(info)) {
+        signals.push_back((int)info.ssi_signo);
+      }
+    }
+  }
+#endif
+
+  for (int signo : signals) {
+    auto found = signal_callbacks_.find(signo);
+    if (found != signal_callbacks_.end()) {
+      found->second();
+    }
+  }
+}
+
+void EventLoop::ArmTimer(Clock::time_point deadline) {
+#if !defined(__APPLE__)
+  itimerspec spec{};
+  spec.it_value = ToTimespec(deadline.time_since_epoch());
+  if (spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0) {
+    spec.it_value.tv_nsec = 1;  // 0 이면 timer 가 해제된다
+  }
+  timerfd_settime(timer_fd_, TFD_TIMER_ABSTIME, &spec, nullptr);
+#else
+  (void)deadline;
+#endif
+}
+
+void EventLoop::RunDueTimers() {
+  for (auto& timer : timers_) {
+    auto now = Clock::now();
+    if (timer.deadline > now || running_.load(std::memory_order_acquire) == false) {
+      continue;
+    }
+    auto lateness = std::chrono::duration_cast<std::chrono::microseconds>(now - timer.deadline);
+    if (lateness.count() > max_lateness_us_.load(std::memory_order_relaxed)) {
+      max_lateness_us_.store(lateness.count(), std::memory_order_relaxed);
+    }
+
+    // 고정 주기로 다음 시각을 잡되, 이미 지났으면 지금부터 다시 센다.
+    timer.deadline += timer.interval;
+    if (timer.deadline <= now) {
+      timer.deadline = now + timer.interval;
+    }
+    timer.callback();
+  }
+}
+
+void EventLoop::RunPosted() {
+  std::vector<Callback> tasks;
+  {
+    std::lock_guard lock(posted_mutex_);
+    tasks.swap(posted_);
+  }
+  for (auto& task : tasks) {
+    task();
+  }
+}
+
+}  // namespace core
+}  // namespace quicflow
@@ -0,0 +1,160 @@
+//
+// QuicFlow-CPP - Message Latency Tracing
+//
+
+#include "core/latency_trace.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+
+#include "common/logger.hpp"
+#include "core/metrics.hpp"
+
+namespace quicflow {
+namespace core {
+
+namespace {
+
+constexpr std::string_view kStageHelp = "Latency of one message pipeline stage";
+Histogram& receive_to_actor = Metrics::GetHistogram(
+    "quicflow_message_stage_latency_ns", kStageHelp, "stage=\"receive_to_actor\"");
+Histogram& actor_to_decoded = Metrics::GetHistogram(
+    "quicflow_message_stage_latency_ns", kStageHelp, "stage=\"actor_to_decoded\"");
+Histogram& decoded_to_fanout = Metrics::GetHistogram(
+    "quicflow_message_stage_latency_ns", kStageHelp, "stage=\"decoded_to_fanout\"");
+Histogram& fanout_to_send = Metrics::GetHistogram(
+    "quicflow_message_stage_latency_ns", kStageHelp, "stage=\"fanout_to_send\"");
+Histogram& send_to_complete = Metrics::GetHistogram(
+    "quicflow_message_stage_latency_ns", kStageHelp, "stage=\"send_to_complete\"");
+Histogram& end_to_end = Metrics::GetHistogram(
+    "quicflow_message_stage_latency_ns", kStageHelp, "stage=\"end_to_end\"");
+
+// 표본 기록 파일 (표본만 쓰므로 락으로 충분하다)
+struct TraceFile {
+  std::mutex mutex;
+  FILE* file = nullptr;
+  uint64_t written = 0;
+  uint64_t limit = 0;
+};
+
+TraceFile& GetTraceFile() {
+  static TraceFile* traceFile = new TraceFile();
+  return *traceFile;
+}
+
+uint64_t Elapsed(uint64_t from, uint64_t to) {
+  return to > from ? to - from : 0;
+}
+
+}  // namespace
+
+bool LatencyTrace::Configure(const LatencyTraceConfig& config) {
+  Close();
+  sample_every_ = 0;
+  enabled_.store(config.Enabled, std::memory_order_relaxed);
+  if (config.Enabled == false || config.SampleEvery == 0 || config.File.empty()) {
+    return true;
+  }
+
+  auto& traceFile = GetTraceFile();
+  std::lock_guard lock(traceFile.mutex);
+  traceFile.file = std::fopen(config.File.c_str(), "wb");
+  if (traceFile.file == nullptr) {
+    QF_LOG_ERROR(Core, "Cannot open trace file {}: {}", config.File, std::strerror(errno));
+    return false;
+  }
+  std::setvbuf(traceFile.file, nullptr, _IOFBF, 1 << 20);
+  std::fwrite(kFileMagic, sizeof(kFileMagic), 1, traceFile.file);
+  traceFile.written = sizeof(kFileMagic);
+  traceFile.limit = config.MaxFileBytes;
+  sample_every_ = config.SampleEvery;
+  QF_LOG_INFO(Core, "Tracing 1 of every {} messages to {}", config.SampleEvery, config.File);
+  return true;
+}
+
+void LatencyTrace::Close() {
+  auto& traceFile = GetTraceFile();
+  std::lock_guard lock(traceFile.mutex);
+  if (traceFile.file != nullptr) {
+    std::fclose(traceFile.file);
+    traceFile.file = nullptr;
+  }
+}
+
+MessageTrace LatencyTrace::Begin(uint64_t received) {
+  MessageTrace trace;
+  if (received == 0) {
+    return trace;
+  }
+  trace.received = received;
+  trace.actor_start = Now();
+  receive_to_actor.Record(Elapsed(received, trace.actor_start));
+
+  if (sample_every_ != 0) {
+    // 스레드마다 세다가 N 번째에만 전역 번호를 받는다. (메시지마다 전역 atomic 을 건드리지 않도록)
+    thread_local uint32_t countdown = 0;
+    if (countdown == 0) {
+      countdown = sample_every_;
+      trace.id = sequence_.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+    --countdown;
+  }
+  return trace;
+}
+
+void LatencyTrace::RecordFanout(const MessageTrace& trace, const void* sender) {
+  if (trace.active() == false) {
+    return;
+  }
+  actor_to_decoded.Record(Elapsed(trace.actor_start, trace.decoded));
+  decoded_to_fanout.Record(Elapsed(trace.decoded, trace.fanout));
+
+  if (trace.id != 0) {
+    TraceRecord record{};
+    record.type = (uint8_t)RecordType::Message;
+    record.id = trace.id;
+    record.connection = (uint64_t)(uintptr_t)sender;
+    record.stamps[0] = trace.received;
+    record.stamps[1] = trace.actor_start;
+    record.stamps[2] = trace.decoded;
+    record.stamps[3] = trace.fanout;
+    Write(record);
+  }
+}
+
+void LatencyTrace::RecordSend(const MessageTrace& trace, uint64_t sent) {
+  fanout_to_send.Record(Elapsed(trace.fanout, sent));
+}
+
+void LatencyTrace::RecordComplete(const MessageTrace& trace, uint64_t sent, uint64_t completed,
+                                  const void* recipient) {
+  send_to_complete.Record(Elapsed(sent, completed));
+  end_to_end.Record(Elapsed(trace.received, completed));
+
+  if (trace.id != 0) {
+    TraceRecord record{};
+    record.type = (uint8_t)RecordType::Delivery;
+    record.id = trace.id;
+    record.connection = (uint64_t)(uintptr_t)recipient;
+    record.stamps[0] = trace.received;
+    record.stamps[1] = trace.fanout;
+    record.stamps[2] = sent;
+    record.stamps[3] = completed;
+    Write(record);
+  }
+}
+
+void LatencyTrace::Write(const TraceRecord& record) {
+  auto& traceFile = GetTraceFile();
+  std::lock_guard lock(traceFile.mutex);
+  if (traceFile.file == nullptr || traceFile.written + sizeof(record) > traceFile.limit) {
+    return;
+  }
+  std::fwrite(&record, sizeof(record), 1, traceFile.file);
+  traceFile.written += sizeof(record);
+}
+
+}  // namespace core
+}  // namespace quicflow
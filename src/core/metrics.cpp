@@ -0,0 +1,329 @@
+//
+// QuicFlow-CPP - In-process Metrics
+//
+
+#include "core/metrics.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <mutex>
+
+#include "common/logger.hpp"
+
+namespace quicflow {
+namespace core {
+
+namespace {
+
+// 이름 하나(= Prometheus metric family)에 labels 별 값이 여러 개 붙는다.
+struct Series {
+  std::string labels;
+  std::unique_ptr<Counter> counter;
+  std::unique_ptr<Gauge> gauge;
+  std::unique_ptr<Histogram> histogram;
+  const void* owner = nullptr;
+  std::function<double()> read;
+};
+
+struct Family {
+  Metrics::Type type;
+  std::string help;
+  std::vector<std::unique_ptr<Series>> series;
+};
+
+struct Registry {
+  std::mutex mutex;
+  std::map<std::string, Family, std::less<>> families;  // 이름 순으로 출력
+};
+
+// 종료 중에도 MsQuic / executor 스레드가 기록할 수 있으므로 지우지 않는다.
+Registry& GetRegistry() {
+  static Registry* registry = new Registry();
+  return *registry;
+}
+
+const char* TypeName(Metrics::Type type) {
+  switch (type) {
+    case Metrics::Type::Counter:
+      return "counter";
+    case Metrics::Type::Gauge:
+      return "gauge";
+    case Metrics::Type::Histogram:
+      return "histogram";
+  }
+  return "untyped";
+}
+
+// registry 락을 잡은 상태에서 호출
+Series& FindOrAdd(Metrics::Type type, std::string_view name, std::string_view help, std::string_view labels) {
+  auto& registry = GetRegistry();
+  auto found = registry.families.find(name);
+  if (found == registry.families.end()) {
+    found = registry.families.emplace(std::string(name), Family{type, std::string(help), {}}).first;
+  }
+  Family& family = found->second;
+
+  // 같은 이름을 다른 종류로 등록하면 출력되지 않는 값을 돌려준다. (호출하는 쪽은 그대로 동작)
+  if (family.type != type) {
+    QF_LOG_ERROR(Core, "Metric {} registered as {} and {}", name, TypeName(family.type), TypeName(type));
+    static std::vector<std::unique_ptr<Series>>* orphans = new std::vector<std::unique_ptr<Series>>();
+    orphans->push_back(std::make_unique<Series>());
+    return *orphans->back();
+  }
+
+  for (auto& series : family.series) {
+    if (series->labels == labels && series->read == nullptr) {
+      return *series;
+    }
+  }
+  family.series.push_back(std::make_unique<Series>());
+  family.series.back()->labels = labels;
+  return *family.series.back();
+}
+
+// {labels} 또는 {labels,extra}. 둘 다 비어 있으면 빈 문자열
+std::string LabelSet(std::string_view labels, std::string_view extra = {}) {
+  if (labels.empty() && extra.empty()) {
+    return {};
+  }
+  std::string out = "{";
+  out += labels;
+  if (labels.empty() == false && extra.empty() == false) {
+    out += ',';
+  }
+  out += extra;
+  out += '}';
+  return out;
+}
+
+std::string JsonEscape(std::string_view text) {
+  std::string out;
+  out.reserve(text.size());
+  for (char c : text) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+    }
+    out += c;
+  }
+  return out;
+}
+
+}  // namespace
+
+size_t AssignMetricShard() {
+  static std::atomic<size_t> next{0};
+  return next.fetch_add(1, std::memory_order_relaxed) % kMetricShards;
+}
+
+uint64_t Counter::value() const {
+  uint64_t total = 0;
+  for (const auto& shard : shards_) {
+    total += shard.value.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+HistogramSnapshot Histogram::Snapshot() const {
+  HistogramSnapshot snapshot;
+  snapshot.Buckets.assign(kBucketCount, 0);
+  for (size_t i = 0; i < kMetricShards; ++i) {
+    const Shard& shard = shards_[i];
+    for (size_t bucket = 0; bucket < kBucketCount; ++bucket) {
+      snapshot.Buckets[bucket] += shard.buckets[bucket].load(std::memory_order_relaxed);
+    }
+    snapshot.Sum += shard.sum.load(std::memory_order_relaxed);
+  }
+  // 기록 중에 읽으면 count 와 bucket 합이 어긋날 수 있으므로 bucket 합을 기준으로 한다.
+  for (uint64_t count : snapshot.Buckets) {
+    snapshot.Count += count;
+  }
+  return snapshot;
+}
+
+uint64_t HistogramSnapshot::Percentile(double q) const {
+  if (Count == 0) {
+    return 0;
+  }
+  uint64_t rank = (uint64_t)(q * (double)Count);
+  rank = std::clamp<uint64_t>(rank, 1, Count);
+  uint64_t seen = 0;
+  for (size_t i = 0; i < Buckets.size(); ++i) {
+    seen += Buckets[i];
+    if (seen >= rank) {
+      uint64_t lower = Histogram::BucketLowerBound(i);
+      return lower + (Histogram::BucketUpperBound(i) - lower) / 2;
+    }
+  }
+  return Max();
+}
+
+uint64_t HistogramSnapshot::Max() const {
+  for (size_t i = Buckets.size(); i > 0; --i) {
+    if (Buckets[i - 1] != 0) {
+      return Histogram::BucketUpperBound(i - 1);
+    }
+  }
+  return 0;
+}
+
+Counter& Metrics::GetCounter(std::string_view name, std::string_view help, std::string_view labels) {
+  std::lock_guard lock(GetRegistry().mutex);
+  Series& series = FindOrAdd(Type::Counter, name, help, labels);
+  if (series.counter == nullptr) {
+    series.counter = std::make_unique<Counter>();
+  }
+  return *series.counter;
+}
+
+Gauge& Metrics::GetGauge(std::string_view name, std::string_view help, std::string_view labels) {
+  std::lock_guard lock(GetRegistry().mutex);
+  Series& series = FindOrAdd(Type::Gauge, name, help, labels);
+  if (series.gauge == nullptr) {
+    series.gauge = std::make_unique<Gauge>();
+  }
+  return *series.gauge;
+}
+
+Histogram& Metrics::GetHistogram(std::string_view name, std::string_view help, std::string_view labels) {
+  std::lock_guard lock(GetRegistry().mutex);
+  Series& series = FindOrAdd(Type::Histogram, name, help, labels);
+  if (series.histogram == nullptr) {
+    series.histogram = std::make_unique<Histogram>();
+  }
+  return *series.histogram;
+}
+
+void Metrics::AddCallback(const void* owner, Type type, std::string_view name, std::string_view help,
+                          std::string_view labels, std::function<double()> read) {
+  if (type == Type::Histogram || read == nullptr) {
+    return;
+  }
+  auto& registry = GetRegistry();
+  std::lock_guard lock(registry.mutex);
+  auto found = registry.families.find(name);
+  if (found == registry.families.end()) {
+    found = registry.families.emplace(std::string(name), Family{type, std::string(help), {}}).first;
+  }
+  if (found->second.type != type) {
+    QF_LOG_ERROR(Core, "Metric {} registered as {} and {}", name, TypeName(found->second.type), TypeName(type));
+    return;
+  }
+  auto series = std::make_unique<Series>();
+  series->labels = labels;
+  series->owner = owner;
+  series->read = std::move(read);
+  found->second.series.push_back(std::move(series));
+}
+
+void Metrics::RemoveCallbacks(const void* owner) {
+  auto& registry = GetRegistry();
+  std::lock_guard lock(registry.mutex);
+  for (auto it = registry.families.begin(); it != registry.families.end();) {
+    auto& series = it->second.series;
+    std::erase_if(series, [owner](const std::unique_ptr<Series>& entry) {
+      return entry->read != nullptr && entry->owner == owner;
+    });
+    it = series.empty() ? registry.families.erase(it) : std::next(it);
+  }
+}
+
+std::string Metrics::RenderPrometheus() {
+  auto& registry = GetRegistry();
+  std::lock_guard lock(registry.mutex);
+
+  std::string out;
+  out.reserve(16 * 1024);
+  for (const auto& [name, family] : registry.families) {
+    std::format_to(std::back_inserter(out), "# HELP {} {}\n# TYPE {} {}\n", name, family.help, name,
+                   TypeName(family.type));
+
+    for (const auto& series : family.series) {
+      if (series->read != nullptr) {
+        std::format_to(std::back_inserter(out), "{}{} {}\n", name, LabelSet(series->labels), series->read());
+      } else if (series->counter != nullptr) {
+        std::format_to(std::back_inserter(out), "{}{} {}\n", name, LabelSet(series->labels), series->counter->value());
+      } else if (series->gauge != nullptr) {
+        std::format_to(std::back_inserter(out), "{}{} {}\n", name, LabelSet(series->labels), series->gauge->value());
+      } else if (series->histogram != nullptr) {
+        // 세밀한 bucket 을 모두 내보내면 시계열이 수백 개가 되므로 2 의 거듭제곱 경계(le = 2^k - 1)로 합친다.
+        // 경계가 내부 bucket 경계와 겹치므로 합쳐도 오차가 생기지 않는다.
+        HistogramSnapshot snapshot = series->histogram->Snapshot();
+        uint64_t cumulative = 0;
+        size_t bucket = 0;
+        int topPower = (int)std::bit_width(snapshot.Max());
+        for (int power = 0; power <= topPower && power < 64; ++power) {
+          uint64_t bound = (1ull << power) - 1;
+          while (bucket < snapshot.Buckets.size() && Histogram::BucketUpperBound(bucket) <= bound) {
+            cumulative += snapshot.Buckets[bucket++];
+          }
+          std::format_to(std::back_inserter(out), "{}_bucket{} {}\n", name,
+                         LabelSet(series->labels, std::format("le=\"{}\"", bound)), cumulative);
+        }
+        std::format_to(std::back_inserter(out), "{}_bucket{} {}\n", name, LabelSet(series->labels, "le=\"+Inf\""),
+                       snapshot.Count);
+        std::format_to(std::back_inserter(out), "{}_sum{} {}\n", name, LabelSet(series->labels), snapshot.Sum);
+        std::format_to(std::back_inserter(out), "{}_count{} {}\n", name, LabelSet(series->labels), snapshot.Count);
+      }
+    }
+  }
+  return out;
+}
+
+std::string Metrics::RenderJson() {
+  auto& registry = GetRegistry();
+  std::lock_guard lock(registry.mutex);
+
+  auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+  std::string out = std::format("{{\n  \"timestamp_ms\": {},\n  \"metrics\": {{", (int64_t)now);
+  bool first = true;
+  for (const auto& [name, family] : registry.families) {
+    for (const auto& series : family.series) {
+      out += first ? "\n    \"" : ",\n    \"";
+      first = false;
+      out += JsonEscape(name + LabelSet(series->labels));
+      out += "\": ";
+
+      if (series->read != nullptr) {
+        std::format_to(std::back_inserter(out), "{}", series->read());
+      } else if (series->counter != nullptr) {
+        std::format_to(std::back_inserter(out), "{}", series->counter->value());
+      } else if (series->gauge != nullptr) {
+        std::format_to(std::back_inserter(out), "{}", series->gauge->value());
+      } else if (series->histogram != nullptr) {
+        HistogramSnapshot snapshot = series->histogram->Snapshot();
+        std::format_to(std::back_inserter(out),
+                       "{{\"count\": {}, \"sum\": {}, \"p50\": {}, \"p90\": {}, \"p99\": {}, \"p999\": {}, \"max\": {}}}",
+                       snapshot.Count, snapshot.Sum, snapshot.Percentile(0.5), snapshot.Percentile(0.9),
+                       snapshot.Percentile(0.99), snapshot.Percentile(0.999), snapshot.Max());
+      } else {
+        out += "null";
+      }
+    }
+  }
+  out += "\n  }\n}\n";
+  return out;
+}
+
+bool Metrics::WriteSnapshot(const std::string& path) {
+  std::string temporary = path + ".tmp";
+  {
+    std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+    if (!file) {
+      return false;
+    }
+    file << RenderJson();
+    if (!file) {
+      return false;
+    }
+  }
+  return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+}  // namespace core
+}  // namespace quicflow
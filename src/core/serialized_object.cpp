@@ -4,6 +4,7 @@
 
 #include "core/serialized_object.hpp"
 #include "core/serialized_task.hpp"
+#include "core/executor.hpp"
 
 using namespace quicflow::core;
 
@@ -14,10 +15,22 @@ SerializedObject::SerializedObject() {
 }
 
 void SerializedObject::Serialize(std::shared_ptr<SerializedTask> newTask) {
+  if (executor_ != nullptr) {
+    // executor 모드: 항상 큐에 넣고, 처음 넣은 쪽이 드레인 작업을 worker 에 맡긴다.
+    if (Enqueue(newTask) == 0) {
+      auto self = shared_from_this();
+      executor_->Post([self]() { self->RunQueue(); });
+    }
+    return;
+  }
+
   long count = 0;
   if (count_.compare_exchange_strong(count, 1)) {
     newTask->Process();
-    Logger::Log("Serialized Object Procesed");
+    QF_LOG_TRACE(Core, "Serialized object processed");
+    if (HasPendingTasks() == false) {
+      OnDrained();
+    }
 
     if (count_.fetch_sub(1) > 1) { // 감소시키기 전값이 리턴됨
       // run
@@ -26,7 +39,7 @@ void SerializedObject::Serialize(std::shared_ptr<SerializedTask> newTask) {
     return;
   }else {
     count = Enqueue(newTask);
-    Logger::Log("Serialized Object Enqueued");
+    QF_LOG_TRACE(Core, "Serialized object enqueued");
     if (count == 0) {
       //run
       RunQueue();
@@ -53,13 +66,16 @@ void SerializedObject::RunQueue() {
     }
 
     curTask = Dequeue();
-    Logger::Log("Serialized Object Dequeue");
+    QF_LOG_TRACE(Core, "Serialized object dequeued");
     if (curTask == nullptr) {
       //error
       return;
     }
     curTask->Process();
-    Logger::Log("Serialized Object Processed in RunQueue");
+    QF_LOG_TRACE(Core, "Serialized object processed in RunQueue");
+    if (HasPendingTasks() == false) {
+      OnDrained();
+    }
   }while (count_.fetch_sub(1) > 1);
 }
 long SerializedObject::Enqueue(std::shared_ptr<SerializedTask> task) {
@@ -10,12 +10,29 @@
 //  - The server can be started/stopped explicitly, making it suitable for
 //    both long-running services and test scenarios.
 
+#include <charconv>
 #include <chrono>
 #include <csignal>
 #include <cstdlib>
-#include <iostream>
-#include <thread>
+#include <format>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
 
+#include "cluster/cluster_bus.hpp"
+#include "common/logger.hpp"
+#include "config/server_config.hpp"
+#include "core/admin_server.hpp"
+#include "core/buffer_pool.hpp"
+#include "core/epoch.hpp"
+#include "core/event_loop.hpp"
+#include "core/executor.hpp"
+#include "core/latency_trace.hpp"
+#include "core/metrics.hpp"
+#include "manager/connection_manager.hpp"
+#include "network/admission_controller.hpp"
+#include "network/connection_stats.hpp"
 #include "network/quic_certificate.hpp"
 #include "network/quic_config_manager.hpp"
 #include "network/quic_connection.hpp"
@@ -24,67 +41,245 @@
 namespace quicflow {
 namespace network {
 
-// Signal handler for graceful shutdown.
-void SignalHandler(int signal) {
-  if (QuicServer::GetInstance().is_listening()) {
-    std::cout << "\n[QuicFlow] Received signal " << signal
-              << ", shutting down server..." << std::endl;
-    QuicServer::GetInstance().Stop();
+// shard 마다 하나씩 (shard-per-port)
+std::vector<std::unique_ptr<QuicServer>> servers;
+
+bool AnyListening() {
+  for (const auto& server : servers) {
+    if (server->is_listening()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// listener -> connection -> registration -> MsQuicClose 순으로 닫고, Executor 를 비운 뒤 서버를 없앤다.
+// Why: MsQuic 콜백과 Executor 작업은 server_ / connection_manager_ 를 raw pointer 로 들고 있다.
+//      둘 다 끝나기 전에 servers 를 지우면 해제된 서버를 가리키게 된다.
+void ShutdownServers() {
+  for (auto& server : servers) {
+    server->Shutdown();
+  }
+  core::Executor::GetInstance().Shutdown();
+  servers.clear();
+}
+
+// 부하 단계를 갱신하고, 어느 shard 든 Throttled 이상이면 stateless retry 를 켠다. (MsQuic 전역 설정)
+void UpdateAdmission() {
+  bool throttled = false;
+  for (auto& server : servers) {
+    server->admission().Update();
+    throttled |= server->admission().level() != AdmissionLevel::Normal;
+  }
+  if (AdmissionController::limits().StatelessRetry) {
+    AdmissionController::SetStatelessRetry(servers.front()->api(), throttled);
+  }
+}
+
+// QUIC_SETTINGS 와 메시지 크기만 실행 중에 바뀐다. 나머지는 재시작해야 적용된다.
+void ReloadConfig(config::ServerConfig& serverConfig) {
+  std::string configError;
+  config::ServerConfig reloaded;
+  if (config::ServerConfigLoader::Reload(serverConfig, reloaded, configError) == false) {
+    QF_LOG_ERROR(General, "Config reload failed: {}", configError);
+    return;
+  }
+  for (auto& server : servers) {
+    if (server->UpdateSettings(reloaded) == false) {
+      QF_LOG_ERROR(General, "Failed to apply QUIC settings (port {}): {}", server->port(), server->error_message());
+    }
+  }
+  config::ServerConfigLoader::Apply(reloaded, false);
+  serverConfig.Quic = reloaded.Quic;
+  serverConfig.Profiles = reloaded.Profiles;
+  serverConfig.MaxMessageSize = reloaded.MaxMessageSize;
+  QF_LOG_INFO(General, "Configuration reloaded");
+}
+
+// GET /connections/flight?connection=0x7f...  (로그/outlier 목록에 찍힌 connection 주소)
+std::string RenderFlightRecorder(std::string_view query) {
+  constexpr std::string_view kKey = "connection=";
+  auto begin = query.find(kKey);
+  if (begin == std::string_view::npos) {
+    return "usage: /connections/flight?connection=0x<handle>\n";
+  }
+  std::string_view text = query.substr(begin + kKey.size());
+  text = text.substr(0, text.find('&'));
+  if (text.starts_with("0x")) {
+    text.remove_prefix(2);
+  }
+  uintptr_t address = 0;
+  auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), address, 16);
+  if (error != std::errc() || end != text.data() + text.size()) {
+    return "invalid connection handle\n";
+  }
+
+  for (auto& server : servers) {
+    auto connection = server->connection_manager().FindConnection(reinterpret_cast<HQUIC>(address));
+    if (connection != nullptr) {
+      std::string out = std::format("connection {} (port {}, profile {})\n", (const void*)connection->connection(),
+                                    server->port(), connection->profile_name());
+      std::string events = connection->RenderFlightRecorder();
+      out += events.empty() ? "flight recorder disabled\n" : events;
+      return out;
+    }
   }
+  return "connection not found\n";
+}
+
+// 다른 곳에서 이미 세고 있는 프로세스 단위 값
+void RegisterProcessMetrics(const core::EventLoop& loop) {
+  using core::Metrics;
+  Metrics::AddCallback(&loop, Metrics::Type::Counter, "quicflow_log_dropped_total",
+                       "Log records dropped because a thread's log ring was full", {},
+                       [] { return (double)common::Logger::dropped(); });
+  Metrics::AddCallback(&loop, Metrics::Type::Gauge, "quicflow_buffer_pool_cached_bytes",
+                       "Bytes held in the frame buffer pool free lists", {},
+                       [] { return (double)core::BufferPool::cached_bytes(); });
+  Metrics::AddCallback(&loop, Metrics::Type::Gauge, "quicflow_resident_memory_bytes", "Process resident set size", {},
+                       [] { return (double)AdmissionController::ResidentMemoryBytes(); });
+  Metrics::AddCallback(&loop, Metrics::Type::Gauge, "quicflow_event_loop_max_lateness_us",
+                       "Largest delay of a housekeeping timer since start", {},
+                       [&loop] { return (double)loop.max_timer_lateness().count(); });
 }
 
 }  // namespace network
 }  // namespace quicflow
 
-int main() {
+int main(int argc, char** argv) {
   using namespace quicflow;
   using namespace quicflow::network;
 
-  // Create and start the QUIC server.
-  constexpr uint16_t kServerPort = 4433;
-  QuicServer& server = QuicServer::GetInstance();
-  QUIC_STATUS status = server.InitQuicServer(kServerPort);
-  if (QUIC_FAILED(status)) {
-    std::cout << "[QuicFlow] Server initialization failed" << std::endl;
+  config::ServerConfig serverConfig;
+  std::string configError;
+  if (config::ServerConfigLoader::Load(argc, argv, serverConfig, configError) == false) {
+    if (configError.empty()) {
+      return EXIT_SUCCESS;  // --help
+    }
+    QF_LOG_ERROR(General, "{}", configError);
+    return EXIT_FAILURE;
+  }
+  config::ServerConfigLoader::Apply(serverConfig, true);
 
+  // 시그널은 이벤트 루프에서 받는다. (signalfd 는 block mask 를 쓰므로 Executor / MsQuic 스레드가 생기기 전에 등록)
+  core::EventLoop loop;
+  if (loop.is_valid() == false) {
     return EXIT_FAILURE;
   }
+  auto stop = [&loop]() {
+    QF_LOG_INFO(General, "Shutting down server...");
+    loop.Stop();
+  };
+  loop.WatchSignal(SIGINT, stop);
+  loop.WatchSignal(SIGTERM, stop);
+  loop.WatchSignal(SIGHUP, [&serverConfig]() { ReloadConfig(serverConfig); });
+
+  // Create the QUIC servers (one per shard, on consecutive ports).
+  for (uint16_t shard = 0; shard < serverConfig.Shards; ++shard) {
+    config::ServerConfig shardConfig = serverConfig;
+    shardConfig.Port = (uint16_t)(serverConfig.Port + shard);
+
+    auto server = std::make_unique<QuicServer>();
+    QUIC_STATUS status = server->InitQuicServer(shardConfig);
+    if (QUIC_FAILED(status)) {
+      QF_LOG_ERROR(General, "Server initialization failed (port {})", shardConfig.Port);
+      ShutdownServers();
+      return EXIT_FAILURE;
+    }
+    servers.push_back(std::move(server));
+  }
 
   // Set up connection callback.
   // Why: When a new connection is accepted, we want to log it and potentially
   //      create a connection handler. In a full implementation, this callback
   //      would create a QuicConnection wrapper and register stream callbacks.
 
-  // Register signal handlers for graceful shutdown.
-  std::signal(SIGINT, SignalHandler);
-  std::signal(SIGTERM, SignalHandler);
+  // Start the servers.
+  for (auto& server : servers) {
+    if (!server->Start()) {
+      QF_LOG_ERROR(General, "Failed to start server: {}", server->error_message());
+      ShutdownServers();
+      return EXIT_FAILURE;
+    }
 
-  // Start the server.
-  if (!server.Start()) {
-    std::cerr << "[QuicFlow] Failed to start server: " << server.error_message()
-              << std::endl;
-    return EXIT_FAILURE;
+    QF_LOG_INFO(General, "Server is running on UDP port {}", server->port());
   }
 
-  std::cout << "[QuicFlow] Server is running on UDP port " << kServerPort
-            << std::endl;
-  std::cout << "[QuicFlow] Press Ctrl+C to stop the server" << std::endl;
+  if (serverConfig.Cluster.ListenAddress.empty() == false
+    && cluster::ClusterBus::GetInstance().Start(serverConfig.Cluster) == false) {
+    QF_LOG_ERROR(General, "Failed to start cluster bus");
+    ShutdownServers();
+    return EXIT_FAILURE;
+  }
 
-  // Main event loop: keep the server running until stopped.
-  // Why: MsQuic uses an event-driven model. The server will process events
-  //      in the background, but we need to keep the main thread alive.
-  //      In Phase 2, this will be replaced with Boost.Asio's io_context::run().
-  int count = 0;
-  while (server.is_listening()) {
-    std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-    if (count++ % 10 == 0) {
-      std::cout <<".";
+  // 운영용 HTTP endpoint (Prometheus scrape)
+  RegisterProcessMetrics(loop);
+  ConnectionStatsSampler quicStats;
+  core::AdminServer admin;
+  admin.Handle("/metrics", "text/plain; version=0.0.4", [](std::string_view) {
+    return core::Metrics::RenderPrometheus();
+  });
+  admin.Handle("/metrics.json", "application/json", [](std::string_view) { return core::Metrics::RenderJson(); });
+  admin.Handle("/connections/flight", "text/plain", RenderFlightRecorder);
+  admin.Handle("/connections/outliers", "application/json",
+               [&quicStats](std::string_view) { return quicStats.RenderOutliersJson(); });
+  if (serverConfig.Admin.Port != 0 && admin.Start(serverConfig.Admin) == false) {
+    QF_LOG_ERROR(General, "Failed to start admin endpoint");
+    ShutdownServers();
+    return EXIT_FAILURE;
+  }
+  if (serverConfig.QuicStats.IntervalMs != 0) {
+    std::vector<QuicServer*> sampled;
+    for (auto& server : servers) {
+      sampled.push_back(server.get());
     }
+    quicStats.Start(std::move(sampled), serverConfig.QuicStats);
+  }
+  QF_LOG_INFO(General, "Press Ctrl+C to stop the server");
 
+  // Main event loop: signals and periodic housekeeping run on this thread.
+  // Why: MsQuic and the actor executor own their threads. Maintenance work runs here
+  //      at its own interval instead of on those threads or in a 1-second sleep loop.
+  const auto& housekeeping = serverConfig.Housekeeping;
+  loop.Schedule("admission", std::chrono::microseconds(housekeeping.AdmissionIntervalUs), UpdateAdmission);
+  loop.Schedule("cluster", std::chrono::seconds(1), []() { cluster::ClusterBus::GetInstance().Tick(); });
+  loop.Schedule("epoch-reclaim", std::chrono::milliseconds(housekeeping.ReclaimIntervalMs),
+                []() { core::Epoch::Reclaim(); });
+  loop.Schedule("pool-trim", std::chrono::milliseconds(housekeeping.PoolTrimIntervalMs),
+                [limit = housekeeping.PoolTrimBytes]() {
+                  if (core::BufferPool::cached_bytes() > limit) {
+                    core::BufferPool::Trim();
+                  }
+                });
+  if (serverConfig.Metrics.SnapshotFile.empty() == false) {
+    loop.Schedule("metrics-snapshot", std::chrono::milliseconds(serverConfig.Metrics.SnapshotIntervalMs),
+                  [path = serverConfig.Metrics.SnapshotFile]() {
+                    if (core::Metrics::WriteSnapshot(path) == false) {
+                      QF_LOG_RATE_LIMITED(Warning, General, 1, "Failed to write metrics snapshot {}", path);
+                    }
+                  });
   }
+  // listener 가 모두 내려가면 (MsQuic 쪽 오류 등) 프로세스를 끝낸다.
+  loop.Schedule("liveness", std::chrono::seconds(1), [&loop]() {
+    if (AnyListening() == false) {
+      loop.Stop();
+    }
+  });
+  loop.Run();
 
-  std::cout << "[QuicFlow] Server stopped" << std::endl;
+  // 종료 순서: 운영용 스레드를 멈추고 클러스터 연결을 끊은 뒤, 서버를 닫고 (ShutdownServers 참고)
+  // 마지막으로 회수 대기 중인 객체를 정리한다.
+  admin.Stop();
+  quicStats.Stop();
+  cluster::ClusterBus::GetInstance().Stop();
+  ShutdownServers();
+  core::Epoch::Reclaim();
+  if (serverConfig.Metrics.SnapshotFile.empty() == false) {
+    core::Metrics::WriteSnapshot(serverConfig.Metrics.SnapshotFile);
+  }
+  core::Metrics::RemoveCallbacks(&loop);
+  core::LatencyTrace::Close();
+  QF_LOG_INFO(General, "Server stopped");
+  common::Logger::Shutdown();
   return EXIT_SUCCESS;
 }
-
-
@@ -4,9 +4,15 @@
 
 #include "manager/connection_manager.hpp"
 
-#include <iostream>
+#include <ctime>
 #include <memory>
 
+#include "common/logger.hpp"
+#include "core/metrics.hpp"
+
+#include "manager/room.hpp"
+#include "manager/room_manager.hpp"
+#include "network/chat_protocol_decoder.hpp"
 #include "network/quic_connection.hpp"
 #include "network/quic_protocol.hpp"
 
@@ -14,72 +20,175 @@ namespace quicflow {
 namespace manager {
 using namespace network;
 
+namespace {
+
+core::Counter& connections_opened = core::Metrics::GetCounter(
+    "quicflow_connections_opened_total", "Connections registered with a connection manager");
+core::Counter& connections_closed = core::Metrics::GetCounter(
+    "quicflow_connections_closed_total", "Connections removed from a connection manager");
+core::Counter& unknown_connection_messages = core::Metrics::GetCounter(
+    "quicflow_unknown_connection_messages_total", "Messages from connections that were not (or no longer) registered");
+core::Counter& decode_failures = core::Metrics::GetCounter(
+    "quicflow_decode_failures_total", "Chat messages that failed to decode");
+core::Counter& decode_fallbacks = core::Metrics::GetCounter(
+    "quicflow_decode_fallbacks_total", "Chat messages decoded by the nlohmann fallback path");
+
+constexpr std::string_view kMessagesHelp = "Decoded chat messages by type";
+core::Counter& chat_messages = core::Metrics::GetCounter("quicflow_chat_messages_total", kMessagesHelp, "type=\"chat\"");
+core::Counter& join_messages = core::Metrics::GetCounter("quicflow_chat_messages_total", kMessagesHelp, "type=\"join\"");
+core::Counter& resume_messages = core::Metrics::GetCounter("quicflow_chat_messages_total", kMessagesHelp, "type=\"resume\"");
+core::Counter& leave_messages = core::Metrics::GetCounter("quicflow_chat_messages_total", kMessagesHelp, "type=\"leave\"");
+core::Counter& typing_messages = core::Metrics::GetCounter("quicflow_chat_messages_total", kMessagesHelp, "type=\"typing\"");
+core::Counter& unknown_type_messages = core::Metrics::GetCounter(
+    "quicflow_unknown_type_messages_total", "Decoded messages rejected because of an unknown or server-only Type");
+
+}  // namespace
+
 ConnectionManager::ConnectionManager() {
 }
 
 // 새로운 connection 이 들어왔을때 처리
 void ConnectionManager::OnNewConnection(std::shared_ptr<QuicConnection> connection) {
-  std::cout << "[ConnectionManager] OnNewConnection Called (" << connection->connection() << ")" << std::endl;
+  QF_LOG_DEBUG(Manager, "OnNewConnection ({})", (const void*)connection->connection());
   auto key = connection->connection();
 
-  if (connection_map_.contains(key) == true) {
-    // 기존의 존재하는경우 새로운 걸로 교체하고 기존꺼는 버린다.
-    auto oldConnection = connection_map_.at(key) ;
-    std::cerr << "[DEBUG][F] Already existed connection(" << connection->connection()<< ")" << std::endl;
-    connection_map_.erase(key);
+  // 기존의 존재하는경우 새로운 걸로 교체하고 기존꺼는 버린다.
+  auto oldConnection = connection_map_.Insert(key, connection);
+  connections_opened.Increment();
+  if (oldConnection != nullptr) {
+    QF_LOG_WARN(Manager, "Replaced existing connection ({})", (const void*)connection->connection());
   }
-  connection_map_.insert(std::make_pair(key, connection));
+
+  // 모든 유저는 기본 방에 들어간다. (Room 을 지정하지 않는 기존 클라이언트 호환)
+  // 기록은 보내지 않는다: 필요한 클라이언트는 Join/Resume 으로 요청한다.
+  RoomManager::GetInstance().Join(connection, kDefaultRoomName, Room::JoinReplay::None);
 }
 
 // connection close 처리
 void ConnectionManager::OnCloseConnection(std::shared_ptr<QuicConnection> connection) {
-  std::clog << "[DEBUG][F] OnCloseConnection Called (" << connection->connection()<< ")" << std::endl;
+  QF_LOG_DEBUG(Manager, "OnCloseConnection ({})", (const void*)connection->connection());
   auto key = connection->connection();
-  if (connection_map_.contains(key) == false) {
-    std::cerr << "[DEBUG][F] no connection(" << connection->connection()<< ")" << std::endl;
+  if (connection_map_.Erase(key) == nullptr) {
+    QF_LOG_DEBUG(Manager, "Close of unknown connection ({})", (const void*)connection->connection());
     return;
   }
-  std::cerr << "[DEBUG][F] Erase connection(" << connection->connection()<< ")" << std::endl;
+  QF_LOG_TRACE(Manager, "Erased connection ({})", (const void*)connection->connection());
+  connections_closed.Increment();
+  // LeaveAll 보다 먼저 표시한다. 이후의 Join/Resume 은 RoomManager 락 안에서 이 표시를 보고 거절되고,
+  // 그 전에 락을 잡은 Join 은 LeaveAll 이 정리한다.
+  connection->MarkClosing();
+  RoomManager::GetInstance().LeaveAll(key);
   connection->CloseConnection();
-  connection_map_.erase(key);
 }
 
-// chatting message를 받아 다른 유저에게 broadcasting 한다
-void ConnectionManager::OnReceiveChatMessage(std::shared_ptr<network::QuicConnection> connection, std::string& jsonMessage) {
+// chatting message를 받아 같은 방의 유저에게 전달한다
+void ConnectionManager::OnReceiveChatMessage(std::shared_ptr<network::QuicConnection> connection, std::string& jsonMessage,
+                                             core::MessageTrace trace) {
   auto key = connection->connection();
 
-  if (connection_map_.contains(key) == false) {
-    std::cerr << "[DEBUG][F] No connection(" << connection->connection()<< ")" << std::endl;
+  if (connection_map_.Contains(key) == false) {
+    QF_LOG_RATE_LIMITED(Debug, Manager, 10, "Message from unknown connection ({})", (const void*)connection->connection());
+    unknown_connection_messages.Increment();
     return;
   }
 
   // message deserialize
-  try
-  {
-    // 1. 파싱 (문자열 -> json 객체)
-    json j = json::parse(jsonMessage);
-    // 2. 역직렬화 (json 객체 -> 구조체)
-    // C#의 JsonSerializer.Deserialize<ChatPayload>와 똑같습니다.
-    auto parsedData = j.get<ChatProtocol>();
-
-    // 3. 사용
-    std::cout << "[Deserialized] Type: " << parsedData.Type << std::endl;
-    std::cout << "[Deserialized] MessageId: " << parsedData.MessageId<< std::endl;
-    std::cout << "[Deserialized] User: " << parsedData.UserID << std::endl;
-    std::cout << "[Deserialized] Msg: "  << parsedData.Message << std::endl;
-    std::cout << "[Deserialized] Time: " << parsedData.Timestamp << std::endl;
-
-    for (auto curIter = connection_map_.begin(); curIter != connection_map_.end(); ++curIter) {
-      auto curConnection = curIter->second;
-      curConnection->SendChatMessageAsync(parsedData.Message);
+  // 1. on-demand 디코더: DOM 없이 필요한 필드만 수신 버퍼의 view 로 꺼낸다.
+  ChatProtocolView parsedData;
+  std::string scratch;
+  auto result = ChatProtocolDecoder::Decode(jsonMessage, parsedData, scratch);
+
+  if (result == ChatProtocolDecoder::Result::Invalid) {
+    // JSON 형식이 깨졌거나 필수 필드가 없거나 타입이 다를 때
+    QF_LOG_RATE_LIMITED(Warning, Manager, 10, "ChatProtocol decode failed");
+    decode_failures.Increment();
+    return;
+  }
+
+  ChatProtocol fallbackData;
+  std::string fallbackRoom;
+  if (result == ChatProtocolDecoder::Result::Fallback) {
+    // 2. 디코더가 다루지 않는 형식(실수형 Timestamp 등)은 기존 nlohmann 경로로 처리
+    decode_fallbacks.Increment();
+    try
+    {
+      json j = json::parse(jsonMessage);
+      fallbackData = j.get<ChatProtocol>();
+      fallbackRoom = j.value("Room", "");
+      // 빠른 경로와 같이 0 이상의 정수가 아니면 무시 (value() 는 다른 타입에서 throw)
+      auto messageId = j.find("MessageId");
+      if (messageId != j.end() && messageId->is_number_unsigned()) {
+        fallbackData.MessageId = messageId->get<uint64_t>();
+      }
+      auto epoch = j.find("Epoch");
+      if (epoch != j.end() && epoch->is_number_unsigned()) {
+        fallbackData.Epoch = epoch->get<uint64_t>();
+      }
+    } catch (json::parse_error& e) {
+      QF_LOG_RATE_LIMITED(Warning, Manager, 10, "JSON parse failed: {}", e.what());
+      decode_failures.Increment();
+      return;
+    } catch (json::type_error& e) {
+      QF_LOG_RATE_LIMITED(Warning, Manager, 10, "Data type mismatch: {}", e.what());
+      decode_failures.Increment();
+      return;
     }
-  } catch (json::parse_error& e) {
-    // JSON 형식이 깨져서 왔을 때
-    std::cerr << "[Error] JSON Parse failed: " << e.what() << std::endl;
-  } catch (json::type_error& e) {
-    // 필수 필드가 없거나 타입이 다를 때 (예: 숫자가 와야 하는데 문자열이 옴)
-    std::cerr << "[Error] Data type mismatch: " << e.what() << std::endl;
+    parsedData.Type = fallbackData.Type;
+    parsedData.UserID = fallbackData.UserID;
+    parsedData.Message = fallbackData.Message;
+    parsedData.Timestamp = (int64_t)fallbackData.Timestamp;
+    parsedData.Room = fallbackRoom;
+    parsedData.MessageId = fallbackData.MessageId;
+    parsedData.Epoch = fallbackData.Epoch;
   }
+
+  if (trace.active()) {
+    trace.decoded = core::LatencyTrace::Now();
+  }
+
+  // 3. 사용
+  QF_LOG_TRACE(Manager, "Deserialized Type: {}, MessageId: {}, User: {}, Msg: {}, Time: {}, Room: {}",
+               parsedData.Type, parsedData.MessageId, parsedData.UserID, parsedData.Message, parsedData.Timestamp,
+               parsedData.Room);
+
+  // 4. Type 에 따라 방 참여/퇴장 또는 방 안으로 전달
+  auto& roomManager = RoomManager::GetInstance();
+  std::string_view roomName = parsedData.Room.empty() ? std::string_view(kDefaultRoomName) : parsedData.Room;
+
+  if (parsedData.Type == kChatTypeJoin) {
+    join_messages.Increment();
+    roomManager.Join(connection, roomName);
+    return;
+  }
+  if (parsedData.Type == kChatTypeResume) {
+    // MessageId / Epoch = 클라이언트가 마지막으로 받은 방 순번과 그 방의 incarnation
+    resume_messages.Increment();
+    roomManager.Resume(connection, roomName, parsedData.MessageId, parsedData.Epoch);
+    return;
+  }
+  if (parsedData.Type == kChatTypeLeave) {
+    leave_messages.Increment();
+    roomManager.Leave(key, roomName);
+    return;
+  }
+
+  const bool typing = parsedData.Type == kChatTypeTyping;
+  if (parsedData.Type != kChatTypeChat && typing == false) {
+    // Resync 같은 서버 -> 클라이언트 전용 Type 이나 모르는 Type 은 방에 흘려보내지 않는다.
+    QF_LOG_RATE_LIMITED(Warning, Manager, 10, "Unknown message type: {}", parsedData.Type);
+    unknown_type_messages.Increment();
+    return;
+  }
+
+  // 비동기 전송 작업이 들고 갈 구조체는 여기서 한 번만 만든다. (방 actor 에서 한 번만 직렬화)
+  // UserID 는 클라이언트가 보낸 값이 아니라 서버가 부여한 값 (다른 사용자를 사칭하지 못하게)
+  (typing ? typing_messages : chat_messages).Increment();
+  ChatProtocol message;
+  message.Type = typing ? kChatTypeTyping : kChatTypeChat;
+  message.UserID = connection->user_id();
+  message.Message = std::string(parsedData.Message);
+  message.Timestamp = std::time(nullptr);
+  roomManager.Publish(key, roomName, std::move(message), trace);
 }
 
 }
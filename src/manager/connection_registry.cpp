@@ -0,0 +1,123 @@
+//
+// QuicFlow-CPP - Sharded Connection Registry
+//
+
+#include "manager/connection_registry.hpp"
+
+#include <algorithm>
+#include <functional>
+
+#include "network/quic_connection.hpp"
+
+namespace quicflow {
+namespace manager {
+
+namespace {
+
+bool KeyLess(const ConnectionRegistry::Entry& entry, HQUIC key) {
+  return std::less<HQUIC>()(entry.key, key);
+}
+
+}  // namespace
+
+ConnectionRegistry::ConnectionRegistry(size_t shardCount) {
+  // shard 수는 2의 거듭제곱으로 맞춘다 (index 계산을 mask 로)
+  size_t count = 1;
+  while (count < shardCount) {
+    count <<= 1;
+  }
+
+  shards_.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    auto shard = std::make_unique<Shard>();
+    shard->current.store(new Snapshot(), std::memory_order_relaxed);
+    shards_.push_back(std::move(shard));
+  }
+}
+
+ConnectionRegistry::~ConnectionRegistry() {
+  // 소멸 시점에는 reader 가 없어야 한다.
+  for (auto& shard : shards_) {
+    delete shard->current.load(std::memory_order_acquire);
+  }
+}
+
+size_t ConnectionRegistry::ShardIndex(HQUIC key) const noexcept {
+  // 포인터 하위 비트는 정렬 때문에 항상 0 이므로 섞어서 사용
+  auto value = reinterpret_cast<uintptr_t>(key);
+  value ^= value >> 17;
+  value *= 0x9E3779B97F4A7C15ull;
+  value ^= value >> 29;
+  return (size_t)value & (shards_.size() - 1);
+}
+
+void ConnectionRegistry::Publish(Shard& shard, Snapshot* next) {
+  const Snapshot* previous = shard.current.exchange(next, std::memory_order_seq_cst);
+  core::Epoch::Retire(const_cast<Snapshot*>(previous),
+                      [](void* ptr) { delete static_cast<Snapshot*>(ptr); });
+}
+
+std::shared_ptr<network::QuicConnection> ConnectionRegistry::Insert(
+    HQUIC key, std::shared_ptr<network::QuicConnection> connection) {
+  auto& shard = *shards_[ShardIndex(key)];
+  std::lock_guard<std::mutex> lock(shard.write_mutex);
+
+  // copy-on-write: writer 만 current 를 바꾸므로 락 안에서는 그대로 읽어도 안전
+  const Snapshot* current = shard.current.load(std::memory_order_acquire);
+  auto* next = new Snapshot(*current);
+  auto& entries = next->entries;
+
+  std::shared_ptr<network::QuicConnection> previous;
+  auto iter = std::lower_bound(entries.begin(), entries.end(), key, KeyLess);
+  if (iter != entries.end() && iter->key == key) {
+    previous = std::move(iter->connection);
+    iter->connection = std::move(connection);
+  } else {
+    entries.insert(iter, Entry{key, std::move(connection)});
+    size_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  Publish(shard, next);
+  return previous;
+}
+
+std::shared_ptr<network::QuicConnection> ConnectionRegistry::Erase(HQUIC key) {
+  auto& shard = *shards_[ShardIndex(key)];
+  std::lock_guard<std::mutex> lock(shard.write_mutex);
+
+  const Snapshot* current = shard.current.load(std::memory_order_acquire);
+  auto found = std::lower_bound(current->entries.begin(), current->entries.end(), key, KeyLess);
+  if (found == current->entries.end() || found->key != key) {
+    return nullptr;
+  }
+
+  auto* next = new Snapshot();
+  next->entries.reserve(current->entries.size() - 1);
+  std::shared_ptr<network::QuicConnection> removed = found->connection;
+  for (const auto& entry : current->entries) {
+    if (entry.key != key) {
+      next->entries.push_back(entry);
+    }
+  }
+  size_.fetch_sub(1, std::memory_order_relaxed);
+
+  Publish(shard, next);
+  return removed;
+}
+
+bool ConnectionRegistry::Contains(HQUIC key) const {
+  return Find(key) != nullptr;
+}
+
+std::shared_ptr<network::QuicConnection> ConnectionRegistry::Find(HQUIC key) const {
+  core::Epoch::Guard guard;
+  const Snapshot* snapshot = shards_[ShardIndex(key)]->current.load(std::memory_order_seq_cst);
+  auto iter = std::lower_bound(snapshot->entries.begin(), snapshot->entries.end(), key, KeyLess);
+  if (iter != snapshot->entries.end() && iter->key == key) {
+    return iter->connection;
+  }
+  return nullptr;
+}
+
+}  // namespace manager
+}  // namespace quicflow
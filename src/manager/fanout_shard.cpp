@@ -0,0 +1,29 @@
+//
+// QuicFlow-CPP - Room Fan-out Shard
+//
+
+#include "manager/fanout_shard.hpp"
+
+#include "network/quic_connection.hpp"
+
+namespace quicflow {
+namespace manager {
+using namespace network;
+
+DEFINE_ASYNC_FUNCTION(FanoutShard, Add, std::shared_ptr<QuicConnection> connection) {
+  HQUIC key = connection->connection();
+  members_.Add(key, std::move(connection));
+}
+
+DEFINE_ASYNC_FUNCTION(FanoutShard, Remove, HQUIC key) {
+  members_.Remove(key);
+}
+
+DEFINE_ASYNC_FUNCTION(FanoutShard, Deliver, FrameRef frame, core::MessageTrace trace, RoomPosition position) {
+  for (const auto& member : members_.members()) {
+    member.connection->DeliverFrameAsync(frame, trace, position);
+  }
+}
+
+}  // namespace manager
+}  // namespace quicflow
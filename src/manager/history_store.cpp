@@ -0,0 +1,322 @@
+//
+// QuicFlow-CPP - Room Message History
+//
+
+#include "manager/history_store.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+
+#include "common/logger.hpp"
+
+namespace quicflow {
+namespace manager {
+using namespace network;
+
+namespace {
+
+std::mutex directory_mutex;
+std::string history_directory;
+
+std::string HistoryDirectory() {
+  std::lock_guard lock(directory_mutex);
+  if (history_directory.empty()) {
+    std::error_code error;
+    auto temp = std::filesystem::temp_directory_path(error);
+    history_directory = ((error ? std::filesystem::path("/tmp") : temp) / "quicflow-history").string();
+  }
+  return history_directory;
+}
+
+std::atomic<uint64_t> store_sequence{0};
+
+// 모든 방의 기록 메모리 합계 = segment 매핑 + ring
+// (segment 는 borrowed 프레임이 풀릴 때까지 남을 수 있으므로 segment 가 센다)
+std::atomic<uint64_t> segment_budget{HistoryStore::kDefaultSegmentBudget};
+std::atomic<uint64_t> budget_used{0};
+// 그중 segment 매핑 / ring (지표용)
+std::atomic<uint64_t> mapped_bytes{0};
+std::atomic<uint64_t> total_ring_bytes{0};
+
+// budget 안에서 size 만큼 예약. 실패하면 false
+bool ReserveHistoryBytes(uint64_t size) {
+  uint64_t current = budget_used.load(std::memory_order_relaxed);
+  do {
+    if (current + size > segment_budget.load(std::memory_order_relaxed)) {
+      return false;
+    }
+  } while (budget_used.compare_exchange_weak(current, current + size, std::memory_order_relaxed) == false);
+  return true;
+}
+
+void ReleaseHistoryBytes(uint64_t size) {
+  budget_used.fetch_sub(size, std::memory_order_relaxed);
+}
+
+}  // namespace
+
+// mmap 된 segment 파일 1개
+// 프레임 바이트를 이어 쓰기만 하고, borrowed 프레임이 shared_ptr 로 잡고 있는 동안 매핑을 유지한다.
+class HistorySegment {
+public:
+  ~HistorySegment() {
+    if (base_ != nullptr) {
+      munmap(base_, size_);
+      mapped_bytes.fetch_sub(size_, std::memory_order_relaxed);
+      ReleaseHistoryBytes(size_);
+    }
+  }
+
+  // budget 을 넘으면 nullptr (파일을 만들지 않는다)
+  static std::shared_ptr<HistorySegment> Create(const std::string& path, uint32_t size) {
+    if (ReserveHistoryBytes(size) == false) {
+      QF_LOG_RATE_LIMITED(Warning, History, 10, "History budget exhausted ({} bytes mapped, {} bytes in rings)",
+                          mapped_bytes.load(std::memory_order_relaxed),
+                          total_ring_bytes.load(std::memory_order_relaxed));
+      return nullptr;
+    }
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) {
+      QF_LOG_ERROR(History, "open failed: {} ({})", path, std::strerror(errno));
+      ReleaseHistoryBytes(size);
+      return nullptr;
+    }
+    if (ftruncate(fd, size) != 0) {
+      QF_LOG_ERROR(History, "ftruncate failed: {} ({})", path, std::strerror(errno));
+      close(fd);
+      unlink(path.c_str());
+      ReleaseHistoryBytes(size);
+      return nullptr;
+    }
+
+    void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    // 매핑이 살아있는 동안 파일은 유지되므로 바로 unlink 해서 비정상 종료 시에도 파일이 남지 않게 한다.
+    close(fd);
+    unlink(path.c_str());
+    if (base == MAP_FAILED) {
+      QF_LOG_ERROR(History, "mmap failed: {} ({})", path, std::strerror(errno));
+      ReleaseHistoryBytes(size);
+      return nullptr;
+    }
+
+    mapped_bytes.fetch_add(size, std::memory_order_relaxed);
+    auto segment = std::shared_ptr<HistorySegment>(new HistorySegment());
+    segment->base_ = static_cast<uint8_t*>(base);
+    segment->size_ = size;
+    return segment;
+  }
+
+  // 남은 공간이 부족하면 false
+  bool Append(const uint8_t* data, uint32_t length, uint32_t& outOffset) {
+    if (size_ - used_ < length) {
+      return false;
+    }
+    std::memcpy(base_ + used_, data, length);
+    outOffset = used_;
+    used_ += length;
+    return true;
+  }
+
+  const uint8_t* data(uint32_t offset) const { return base_ + offset; }
+
+private:
+  HistorySegment() = default;
+
+  uint8_t* base_ = nullptr;
+  uint32_t size_ = 0;
+  uint32_t used_ = 0;
+};
+
+HistoryStore::HistoryStore(std::string roomName)
+    : room_name_(std::move(roomName)) {
+}
+
+HistoryStore::~HistoryStore() {
+  ReleaseHistoryBytes(ring_bytes_);
+  total_ring_bytes.fetch_sub(ring_bytes_, std::memory_order_relaxed);
+}
+
+void HistoryStore::SetDirectory(std::string directory) {
+  std::lock_guard lock(directory_mutex);
+  history_directory = std::move(directory);
+}
+
+void HistoryStore::SetSegmentBudget(uint64_t bytes) {
+  segment_budget.store(bytes, std::memory_order_relaxed);
+}
+
+uint64_t HistoryStore::mapped_segment_bytes() {
+  return mapped_bytes.load(std::memory_order_relaxed);
+}
+
+uint64_t HistoryStore::ring_bytes() {
+  return total_ring_bytes.load(std::memory_order_relaxed);
+}
+
+void HistoryStore::Append(uint64_t messageId, FrameRef frame) {
+  if (ring_count_ == ring_.size() && GrowRing() == false) {
+    // 더 늘릴 수 없으면 가장 오래된 slot 을 segment 로 내보내고 그 자리를 재사용한다.
+    EvictOldest();
+  }
+
+  // 보관하는 프레임 바이트는 ring 크기로 제한되므로 budget 을 넘어도 센다. (그만큼 segment 를 덜 연다)
+  uint32_t length = frame->length();
+  budget_used.fetch_add(length, std::memory_order_relaxed);
+  total_ring_bytes.fetch_add(length, std::memory_order_relaxed);
+  ring_bytes_ += length;
+
+  RingSlot& slot = ring_[(ring_head_ + ring_count_) & (ring_.size() - 1)];
+  slot.id = messageId;
+  slot.frame = std::move(frame);
+  ring_count_++;
+  last_id_ = messageId;
+}
+
+bool HistoryStore::GrowRing() {
+  size_t capacity = ring_.empty() ? kMinRingCapacity : ring_.size() * 2;
+  if (capacity > kRingCapacity) {
+    return false;
+  }
+  // 처음 ring 은 budget 과 상관없이 만든다. (기록이 아예 없으면 Resume 이 항상 Resync 가 된다)
+  uint64_t added = (capacity - ring_.size()) * sizeof(RingSlot);
+  if (ring_.empty()) {
+    budget_used.fetch_add(added, std::memory_order_relaxed);
+  } else if (ReserveHistoryBytes(added) == false) {
+    return false;
+  }
+  total_ring_bytes.fetch_add(added, std::memory_order_relaxed);
+  ring_bytes_ += added;
+
+  // 오래된 순으로 앞에서부터 다시 놓는다.
+  std::vector<RingSlot> grown(capacity);
+  for (size_t i = 0; i < ring_count_; ++i) {
+    grown[i] = std::move(ring_[(ring_head_ + i) & (ring_.size() - 1)]);
+  }
+  ring_ = std::move(grown);
+  ring_head_ = 0;
+  return true;
+}
+
+void HistoryStore::EvictOldest() {
+  RingSlot& oldest = ring_[ring_head_];
+  if (Spill(oldest.id, oldest.frame) == false) {
+    // 이 메시지만 빠지면 기록 중간에 구멍이 생기므로 그보다 오래된 기록도 함께 버린다.
+    // (이후 first_id 는 ring 의 다음 메시지가 되고, 그 이전을 요청한 Resume 은 Resync 를 받는다)
+    DropSegments();
+  }
+  uint32_t length = oldest.frame->length();
+  ReleaseHistoryBytes(length);
+  total_ring_bytes.fetch_sub(length, std::memory_order_relaxed);
+  ring_bytes_ -= length;
+
+  oldest.frame = FrameRef();
+  ring_head_ = (ring_head_ + 1) & (ring_.size() - 1);
+  ring_count_--;
+}
+
+bool HistoryStore::Spill(uint64_t messageId, const FrameRef& frame) {
+  uint32_t length = frame->length();
+  if (length > kSegmentSize) {
+    QF_LOG_RATE_LIMITED(Warning, History, 10, "Frame too large to spill ({}) in {}", length, room_name_);
+    return false;
+  }
+
+  uint32_t offset = 0;
+  if (segments_.empty() || segments_.back()->Append(frame->data(), length, offset) == false) {
+    if (OpenSegment() == false) {
+      return false;
+    }
+    segments_.back()->Append(frame->data(), length, offset);
+  }
+
+  index_.push_back(IndexEntry{messageId, first_segment_ + (uint32_t)segments_.size() - 1, offset, length});
+  return true;
+}
+
+void HistoryStore::DropSegments() {
+  index_.clear();
+  first_segment_ += (uint32_t)segments_.size();
+  segments_.clear();
+}
+
+bool HistoryStore::OpenSegment() {
+  // 방 상한에 닿았거나 프로세스 budget 이 모자라면 자기 segment 부터 재사용한다.
+  if (segments_.size() >= kMaxSegments
+    || (segments_.empty() == false && budget_used.load(std::memory_order_relaxed) + kSegmentSize
+                                          > segment_budget.load(std::memory_order_relaxed))) {
+    DropOldestSegment();
+  }
+
+  std::string directory = HistoryDirectory();
+  std::error_code error;
+  std::filesystem::create_directories(directory, error);
+
+  // 같은 이름의 방이 다시 만들어질 수 있으므로 store 마다 고유 번호를 붙인다.
+  char name[96];
+  std::snprintf(name, sizeof(name), "%016zx-%d-%llu-%u.seg", std::hash<std::string>{}(room_name_), (int)getpid(),
+                (unsigned long long)store_sequence.fetch_add(1, std::memory_order_relaxed),
+                first_segment_ + (uint32_t)segments_.size());
+
+  auto segment = HistorySegment::Create((std::filesystem::path(directory) / name).string(), kSegmentSize);
+  if (segment == nullptr) {
+    return false;
+  }
+  segments_.push_back(std::move(segment));
+  return true;
+}
+
+void HistoryStore::DropOldestSegment() {
+  // 버린 segment 를 가리키는 인덱스는 앞쪽에 모여있다.
+  while (!index_.empty() && index_.front().segment == first_segment_) {
+    index_.pop_front();
+  }
+  // 이미 내보낸 borrowed 프레임이 있으면 그것들이 풀릴 때 매핑이 해제된다.
+  segments_.pop_front();
+  first_segment_++;
+}
+
+size_t HistoryStore::ReadFrom(uint64_t fromId, size_t maxCount, std::vector<FrameRef>& out) const {
+  size_t added = 0;
+
+  // 1. segment 에 내려간 오래된 프레임
+  auto entry = std::lower_bound(index_.begin(), index_.end(), fromId,
+                                [](const IndexEntry& lhs, uint64_t id) { return lhs.id < id; });
+  for (; entry != index_.end() && added < maxCount; ++entry) {
+    const auto& segment = segments_[entry->segment - first_segment_];
+    out.emplace_back(OutboundFrame::Borrow(segment->data(entry->offset), entry->length, segment));
+    added++;
+  }
+
+  // 2. 메모리 ring 의 최근 프레임
+  for (size_t i = 0; i < ring_count_ && added < maxCount; ++i) {
+    const RingSlot& slot = ring_[(ring_head_ + i) & (ring_.size() - 1)];
+    if (slot.id < fromId) {
+      continue;
+    }
+    out.push_back(slot.frame);
+    added++;
+  }
+  return added;
+}
+
+uint64_t HistoryStore::first_id() const {
+  if (!index_.empty()) {
+    return index_.front().id;
+  }
+  if (ring_count_ > 0) {
+    return ring_[ring_head_].id;
+  }
+  return 0;
+}
+
+}  // namespace manager
+}  // namespace quicflow
@@ -0,0 +1,299 @@
+//
+// QuicFlow-CPP - Chat Room
+//
+
+#include "manager/room.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <functional>
+#include <string_view>
+
+#include "cluster/cluster_bus.hpp"
+#include "common/logger.hpp"
+#include "core/executor.hpp"
+#include "manager/fanout_shard.hpp"
+#include "network/chat_protocol_decoder.hpp"
+#include "network/chat_protocol_encoder.hpp"
+#include "network/quic_connection.hpp"
+
+namespace quicflow {
+namespace manager {
+using namespace network;
+
+namespace {
+
+std::atomic<uint64_t> last_epoch{0};
+
+// 벽시계(ms) x 1024 에서 시작해 프로세스 안에서는 항상 증가한다.
+// 재시작한 서버의 방도 이전 실행의 Epoch 와 겹치지 않는다. (시계가 뒤로 가지 않는 한)
+// JSON 정수(int64) 범위 안: 2^63 / 1024 ms 는 약 28 만 년
+uint64_t NextEpoch() {
+  uint64_t now = (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count() * 1024;
+  uint64_t previous = last_epoch.load(std::memory_order_relaxed);
+  uint64_t next;
+  do {
+    next = std::max(previous + 1, now);
+  } while (last_epoch.compare_exchange_weak(previous, next, std::memory_order_relaxed) == false);
+  return next;
+}
+
+// 방 + 보낸 사람마다 하나. 0 은 "합치기 불가" 라서 피한다.
+uint64_t ConflationKey(std::string_view room, std::string_view userId) {
+  uint64_t roomHash = std::hash<std::string_view>{}(room);
+  uint64_t key = roomHash ^ (std::hash<std::string_view>{}(userId) + 0x9e3779b97f4a7c15ULL + (roomHash << 6)
+                             + (roomHash >> 2));
+  return key == 0 ? 1 : key;
+}
+
+}  // namespace
+
+Room::Room(std::string name) : name_(std::move(name)), epoch_(NextEpoch()), history_(name_) {
+}
+
+DEFINE_ASYNC_FUNCTION(Room, Join, std::shared_ptr<QuicConnection> connection, JoinReplay replay, uint64_t lastSeenId,
+                      uint64_t lastSeenEpoch) {
+  // 종료가 시작된 connection: LeaveAll 이 넣은 Leave 가 이 Join 보다 먼저 처리됐을 수 있으므로 추가하지 않는다.
+  // (표시는 LeaveAll 전에 되므로, 이 Join 이 Leave 뒤에 실행되면 반드시 보인다)
+  if (connection->closing()) {
+    return;
+  }
+  HQUIC key = connection->connection();
+  bool added = members_.Add(key, connection);
+
+  // 기록을 먼저 보낸다. 이후 실시간 메시지는 이 뒤에 큐잉되므로 순서가 유지된다.
+  ReplayHistory(connection, replay, lastSeenId, lastSeenEpoch);
+  if (added == false) {
+    return;
+  }
+  member_count_hint_.store(members_.size(), std::memory_order_relaxed);
+
+  if (parallel_fanout()) {
+    ShardOf(key).AddAsync(std::move(connection));
+  } else if (members_.size() >= kParallelFanoutThreshold) {
+    EnableParallelFanout();
+  }
+}
+
+DEFINE_ASYNC_FUNCTION(Room, Leave, HQUIC key) {
+  if (members_.Remove(key) == false) {
+    return;
+  }
+  member_count_hint_.store(members_.size(), std::memory_order_relaxed);
+
+  if (parallel_fanout()) {
+    ShardOf(key).RemoveAsync(key);
+  }
+}
+
+DEFINE_ASYNC_FUNCTION(Room, Publish, HQUIC sender, ChatProtocol message, core::MessageTrace trace) {
+  if (members_.Contains(sender) == false) {
+    QF_LOG_RATE_LIMITED(Warning, Room, 10, "Publish from non-member ({}) to {}", (const void*)sender, name_);
+    return;
+  }
+  // 인코딩/fan-out 전에 방 단위 제한을 확인한다.
+  if (publish_bucket_.TryConsume(publish_limit_, CoarseClock::NowMs()) == false) {
+    throttled_messages_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  const bool transient = message.Type == kChatTypeTyping;
+  FrameRef frame = transient ? EncodeTransient(message) : Sequence(message);
+  if (!frame) {
+    return;
+  }
+
+  // 같은 방이 있는 다른 노드에는 노드당 1번만 보낸다.
+  cluster::ClusterBus::GetInstance().Publish(name_, frame);
+
+  if (trace.active()) {
+    trace.fanout = core::LatencyTrace::Now();
+    core::LatencyTrace::RecordFanout(trace, sender);
+  }
+  // 순번 0 은 수신자 쪽 중복 확인을 하지 않는다.
+  FanOut(frame, trace, transient ? 0 : last_sequence_);
+}
+
+DEFINE_ASYNC_FUNCTION(Room, DeliverRemote, FrameRef frame) {
+  // 원격 프레임은 그 노드의 방 순번을 가지므로 그대로 보내면 로컬 순번과 겹치거나 Resume 구간에 구멍이 생긴다.
+  // 노드당 1번 받는 프레임이므로 여기서 다시 인코딩해도 멤버 수와 상관없이 1번이다.
+  std::string_view json(reinterpret_cast<const char*>(frame->body()), frame->length() - OutboundFrame::kHeaderSize);
+  ChatProtocolView view;
+  std::string scratch;
+  // 상대 노드의 인코더가 만든 프레임이므로 Fallback 형식(실수형 Timestamp 등)도 잘못된 것으로 본다.
+  if (ChatProtocolDecoder::Decode(json, view, scratch) != ChatProtocolDecoder::Result::Ok
+    || (view.Type != kChatTypeChat && view.Type != kChatTypeTyping)) {
+    rejected_remote_messages_.fetch_add(1, std::memory_order_relaxed);
+    QF_LOG_RATE_LIMITED(Warning, Room, 10, "Invalid remote frame for {}", name_);
+    return;
+  }
+
+  const bool transient = view.Type == kChatTypeTyping;
+  ChatProtocol message;
+  message.Type = transient ? kChatTypeTyping : kChatTypeChat;
+  message.UserID = std::string(view.UserID);
+  message.Message = std::string(view.Message);
+  message.Timestamp = (std::time_t)view.Timestamp;
+  FrameRef local = transient ? EncodeTransient(message) : Sequence(message);
+  if (!local) {
+    return;
+  }
+  FanOut(local, {}, transient ? 0 : last_sequence_);
+}
+
+FrameRef Room::Sequence(ChatProtocol& message) {
+  // 방 멤버 전원에게 같은 바이트를 보내므로 한 번만 직렬화하고 프레임을 공유한다.
+  // 기본 방은 기존 클라이언트와 바이트 호환을 위해 Room key 를 붙이지 않는다.
+  if (name_ != kDefaultRoomName) {
+    message.Room = name_;
+  }
+  message.MessageId = last_sequence_ + 1;
+  message.Epoch = epoch_;
+  FrameRef frame = ChatProtocolEncoder::EncodeFrame(message);
+  if (!frame) {
+    QF_LOG_RATE_LIMITED(Warning, Room, 10, "Encode failed (invalid UTF-8) in {}", name_);
+    return frame;
+  }
+  // 인코딩에 성공한 메시지에만 순번을 소비해서 구간에 빈 번호가 생기지 않게 한다.
+  last_sequence_++;
+  history_.Append(last_sequence_, frame);
+  return frame;
+}
+
+FrameRef Room::EncodeTransient(ChatProtocol& message) {
+  if (name_ != kDefaultRoomName) {
+    message.Room = name_;
+  }
+  FrameRef frame = ChatProtocolEncoder::EncodeFrame(message);
+  if (!frame) {
+    QF_LOG_RATE_LIMITED(Warning, Room, 10, "Encode failed (invalid UTF-8) in {}", name_);
+    return frame;
+  }
+  frame->set_conflation_key(ConflationKey(name_, message.UserID));
+  return frame;
+}
+
+void Room::FanOut(const FrameRef& frame, const core::MessageTrace& trace, uint64_t sequence) {
+  const RoomPosition position{epoch_, sequence};
+  if (parallel_fanout()) {
+    // shard 에는 프레임 참조만 넘기고 바로 반환한다. 실제 전송은 worker 들에서 병렬로.
+    for (const auto& shard : shards_) {
+      shard->DeliverAsync(frame, trace, position);
+    }
+    return;
+  }
+
+  for (const auto& member : members_.members()) {
+    member.connection->DeliverFrameAsync(frame, trace, position);
+  }
+}
+
+void Room::ReplayHistory(const std::shared_ptr<QuicConnection>& connection, JoinReplay replay, uint64_t lastSeenId,
+                         uint64_t lastSeenEpoch) {
+  uint64_t fromId = 0;
+  size_t count = 0;
+
+  switch (replay) {
+    case JoinReplay::None:
+      return;
+
+    case JoinReplay::Recent:
+      count = (size_t)std::min<uint64_t>(last_sequence_, kJoinReplayMessages);
+      fromId = last_sequence_ - count + 1;
+      break;
+
+    case JoinReplay::After:
+      // 다른 incarnation 의 순번이면 (방이 지워졌다가 다시 만들어짐, 서버 재시작) 비교할 수 없다.
+      // 순번을 하나라도 받은 클라이언트는 그 Epoch 도 받았으므로 0 은 "아무것도 못 받음" 일 때만 허용한다.
+      if (lastSeenId != 0 && lastSeenEpoch != epoch_) {
+        SendResync(connection);
+        return;
+      }
+      if (lastSeenId == last_sequence_) {
+        return;  // 놓친 메시지 없음
+      }
+      // 클라이언트가 더 앞서 있거나, 기록에서 이미 빠졌거나, 너무 많이 놓쳤으면 전체 재동기화
+      if (lastSeenId > last_sequence_
+          || history_.empty()
+          || lastSeenId + 1 < history_.first_id()
+          || last_sequence_ - lastSeenId > kMaxResumeMessages) {
+        SendResync(connection);
+        return;
+      }
+      fromId = lastSeenId + 1;
+      count = (size_t)(last_sequence_ - lastSeenId);
+      break;
+  }
+
+  if (count == 0 || history_.empty()) {
+    return;
+  }
+
+  // Recent 는 기록에 남은 만큼만 보낸다.
+  if (replay == JoinReplay::Recent && fromId < history_.first_id()) {
+    fromId = history_.first_id();
+    count = (size_t)(last_sequence_ - fromId + 1);
+  }
+
+  std::vector<FrameRef> frames;
+  frames.reserve(count);
+  size_t read = history_.ReadFrom(fromId, count, frames);
+  if (replay == JoinReplay::After && read != count) {
+    // 요청 구간이 기록에서 연속으로 읽히지 않으면 일부만 보내지 않고 재동기화시킨다.
+    SendResync(connection);
+    return;
+  }
+  // 이미 멤버인 connection 의 Resume 이면 같은 순번이 shard 나 송신 대기열에 아직 남아 있을 수 있다.
+  // connection 이 보낸 순번 구간을 보고 겹치는 것은 한 번만 보낸다.
+  connection->ReplayFramesAsync(std::move(frames), RoomPosition{epoch_, fromId});
+}
+
+void Room::SendResync(const std::shared_ptr<QuicConnection>& connection) {
+  ChatProtocol message;
+  message.Type = kChatTypeResync;
+  message.MessageId = last_sequence_;
+  message.Epoch = epoch_;
+  if (name_ != kDefaultRoomName) {
+    message.Room = name_;
+  }
+  message.Timestamp = std::time(nullptr);
+
+  FrameRef frame = ChatProtocolEncoder::EncodeFrame(message);
+  if (!frame) {
+    return;
+  }
+  // 느린 소비자 정책에서 버려지면 클라이언트가 복구할 수 없으므로 critical
+  frame->set_critical(true);
+  connection->SendFrameAsync(std::move(frame));
+}
+
+// 멤버를 key 해시로 shard 에 나누고 이후 fan-out 을 shard 에 맡긴다.
+// 이 시점 이전의 직접 전송은 이미 각 connection 큐에 들어가 있으므로 수신자별 순서는 유지된다.
+void Room::EnableParallelFanout() {
+  auto& executor = Executor::GetInstance();
+  size_t shardCount = std::clamp<size_t>(executor.thread_count(), 1, kMaxFanoutShards);
+
+  shards_.reserve(shardCount);
+  for (size_t i = 0; i < shardCount; ++i) {
+    auto shard = std::make_shared<FanoutShard>();
+    shard->SetExecutor(&executor);
+    shards_.push_back(std::move(shard));
+  }
+
+  for (const auto& member : members_.members()) {
+    ShardOf(member.key).AddAsync(member.connection);
+  }
+  QF_LOG_INFO(Room, "{} switched to parallel fan-out ({} members, {} shards)", name_, members_.size(), shardCount);
+}
+
+FanoutShard& Room::ShardOf(HQUIC key) {
+  // HQUIC 는 정렬된 포인터라 하위 비트가 비어있으므로 섞어서 나눈다.
+  uint64_t hash = (uint64_t)(uintptr_t)key * 0x9E3779B97F4A7C15ull;
+  return *shards_[(hash >> 32) % shards_.size()];
+}
+
+}  // namespace manager
+}  // namespace quicflow
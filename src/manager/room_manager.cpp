@@ -0,0 +1,196 @@
+//
+// QuicFlow-CPP - Room Manager
+//
+
+#include "manager/room_manager.hpp"
+
+#include <algorithm>
+#include <mutex>
+
+#include "cluster/cluster_bus.hpp"
+#include "common/logger.hpp"
+#include "network/quic_connection.hpp"
+
+namespace quicflow {
+namespace manager {
+using namespace network;
+
+RoomManager::RoomManager() {
+}
+
+bool RoomManager::Join(const std::shared_ptr<QuicConnection>& connection, std::string_view roomName,
+                       Room::JoinReplay replay) {
+  bool alreadyJoined = false;
+  auto room = AddMembership(*connection, roomName, alreadyJoined);
+  if (room == nullptr || alreadyJoined) {
+    return false;
+  }
+
+  // 멤버 목록 변경은 Room actor 에서 직렬화된다. (같은 방의 Publish 와 순서 보장)
+  room->JoinAsync(connection, replay, (uint64_t)0, (uint64_t)0);
+  return true;
+}
+
+bool RoomManager::Resume(const std::shared_ptr<QuicConnection>& connection, std::string_view roomName,
+                         uint64_t lastSeenId, uint64_t lastSeenEpoch) {
+  bool alreadyJoined = false;
+  auto room = AddMembership(*connection, roomName, alreadyJoined);
+  if (room == nullptr) {
+    return false;
+  }
+
+  // 이미 참여 중이어도 Room 에서 놓친 구간만 다시 보낸다.
+  room->JoinAsync(connection, Room::JoinReplay::After, lastSeenId, lastSeenEpoch);
+  return true;
+}
+
+std::shared_ptr<Room> RoomManager::AddMembership(const QuicConnection& connection, std::string_view roomName,
+                                                 bool& alreadyJoined) {
+  if (roomName.empty() || roomName.size() > kMaxRoomNameLength) {
+    QF_LOG_RATE_LIMITED(Warning, Room, 10, "Invalid room name length ({})", roomName.size());
+    return nullptr;
+  }
+
+  HQUIC key = connection.connection();
+  std::shared_ptr<Room> room;
+  bool created = false;
+  {
+    std::unique_lock lock(mutex_);
+    // 종료 처리는 표시 후 이 락으로 LeaveAll 을 하므로, 락 안에서 확인하면 LeaveAll 뒤에 멤버십이 남지 않는다.
+    if (connection.closing()) {
+      return nullptr;
+    }
+    auto& joined = user_rooms_[key];
+    if (std::find(joined.begin(), joined.end(), roomName) != joined.end()) {
+      alreadyJoined = true;
+      auto found = rooms_.find(std::string(roomName));
+      return found == rooms_.end() ? nullptr : found->second.room;
+    }
+    if (joined.size() >= kMaxRoomsPerUser) {
+      QF_LOG_RATE_LIMITED(Warning, Room, 10, "Too many rooms for ({})", (const void*)key);
+      return nullptr;
+    }
+
+    auto found = rooms_.find(std::string(roomName));
+    if (found == rooms_.end()) {
+      found = rooms_.emplace(std::string(roomName), RoomEntry{std::make_shared<Room>(std::string(roomName)), 0}).first;
+      created = true;
+    }
+    found->second.members++;
+    joined.emplace_back(roomName);
+    room = found->second.room;
+  }
+
+  // 클러스터 공지는 락 밖에서 (순서는 ClusterBus::AnnounceRoom 이 현재 상태를 다시 보고 맞춘다)
+  if (created) {
+    cluster::ClusterBus::GetInstance().AnnounceRoom(roomName);
+  }
+  return room;
+}
+
+bool RoomManager::Leave(HQUIC key, std::string_view roomName) {
+  std::shared_ptr<Room> room;
+  bool removed = false;
+  {
+    std::unique_lock lock(mutex_);
+    auto user = user_rooms_.find(key);
+    if (user == user_rooms_.end()) {
+      return false;
+    }
+    auto& joined = user->second;
+    auto position = std::find(joined.begin(), joined.end(), roomName);
+    if (position == joined.end()) {
+      return false;
+    }
+    joined.erase(position);
+    if (joined.empty()) {
+      user_rooms_.erase(user);
+    }
+
+    auto found = rooms_.find(std::string(roomName));
+    if (found == rooms_.end()) {
+      return false;
+    }
+    room = found->second.room;
+    // 마지막 멤버가 나가면 목록에서 제거. Room 객체는 남은 작업이 끝날 때까지 shared_ptr 로 유지된다.
+    if (--found->second.members == 0) {
+      rooms_.erase(found);
+      removed = true;
+    }
+  }
+
+  if (removed) {
+    cluster::ClusterBus::GetInstance().AnnounceRoom(roomName);
+  }
+  room->LeaveAsync(key);
+  return true;
+}
+
+void RoomManager::LeaveAll(HQUIC key) {
+  std::vector<std::shared_ptr<Room>> leftRooms;
+  std::vector<std::string> removedRooms;
+  {
+    std::unique_lock lock(mutex_);
+    auto user = user_rooms_.find(key);
+    if (user == user_rooms_.end()) {
+      return;
+    }
+    for (const auto& roomName : user->second) {
+      auto found = rooms_.find(roomName);
+      if (found == rooms_.end()) {
+        continue;
+      }
+      leftRooms.push_back(found->second.room);
+      if (--found->second.members == 0) {
+        rooms_.erase(found);
+        removedRooms.push_back(roomName);
+      }
+    }
+    user_rooms_.erase(user);
+  }
+
+  for (const auto& roomName : removedRooms) {
+    cluster::ClusterBus::GetInstance().AnnounceRoom(roomName);
+  }
+  for (auto& room : leftRooms) {
+    room->LeaveAsync(key);
+  }
+}
+
+bool RoomManager::Publish(HQUIC sender, std::string_view roomName, ChatProtocol message, core::MessageTrace trace) {
+  auto room = FindRoom(roomName);
+  if (room == nullptr) {
+    QF_LOG_RATE_LIMITED(Debug, Room, 10, "No room ({})", roomName);
+    return false;
+  }
+
+  // 멤버 여부는 Room actor 안에서 확인한다. (Join 직후 Publish 도 actor 순서대로 처리됨)
+  room->PublishAsync(sender, std::move(message), trace);
+  return true;
+}
+
+std::shared_ptr<Room> RoomManager::FindRoom(std::string_view roomName) const {
+  std::shared_lock lock(mutex_);
+  auto found = rooms_.find(std::string(roomName));
+  if (found == rooms_.end()) {
+    return nullptr;
+  }
+  return found->second.room;
+}
+
+std::vector<std::string> RoomManager::RoomsOf(HQUIC key) const {
+  std::shared_lock lock(mutex_);
+  auto user = user_rooms_.find(key);
+  if (user == user_rooms_.end()) {
+    return {};
+  }
+  return user->second;
+}
+
+size_t RoomManager::room_count() const {
+  std::shared_lock lock(mutex_);
+  return rooms_.size();
+}
+
+}  // namespace manager
+}  // namespace quicflow
@@ -0,0 +1,158 @@
+//
+// QuicFlow-CPP - Connection Admission Control
+//
+
+#include "network/admission_controller.hpp"
+
+#include <algorithm>
+#include <fstream>
+
+#include <unistd.h>
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#endif
+
+#include "common/logger.hpp"
+#include "core/executor.hpp"
+#include "manager/connection_manager.hpp"
+
+namespace quicflow {
+namespace network {
+
+namespace {
+
+const char* LevelName(AdmissionLevel level) {
+  switch (level) {
+    case AdmissionLevel::Normal:
+      return "normal";
+    case AdmissionLevel::Throttled:
+      return "throttled";
+    case AdmissionLevel::Overloaded:
+      return "overloaded";
+  }
+  return "unknown";
+}
+
+// 한도 대비 비율 (%). 한도가 0 이면 사용하지 않는 신호
+uint32_t Percent(uint64_t value, uint64_t limit) {
+  if (limit == 0) {
+    return 0;
+  }
+  return (uint32_t)std::min<uint64_t>(value * 100 / limit, 1000);
+}
+
+}  // namespace
+
+AdmissionController::AdmissionController(const manager::ConnectionManager& connections)
+    : connections_(connections) {
+}
+
+bool AdmissionController::TryAdmit() {
+  const auto& limits = limits_;
+
+  if (limits.MaxConnections != 0 && connections_.connection_count() >= limits.MaxConnections) {
+    return Reject(AdmissionReject::Connections);
+  }
+
+  switch (level_.load(std::memory_order_relaxed)) {
+    case AdmissionLevel::Normal:
+      break;
+    case AdmissionLevel::Throttled: {
+      std::lock_guard lock(bucket_mutex_);
+      if (accept_bucket_.TryConsume(limits.ThrottledAcceptRate, core::CoarseClock::NowMs()) == false) {
+        return Reject(AdmissionReject::Rate);
+      }
+      break;
+    }
+    case AdmissionLevel::Overloaded:
+      return Reject(AdmissionReject::Overloaded);
+  }
+
+  // 진행 중 handshake 한도는 예약 후 검사해서 동시에 들어온 요청이 한도를 넘지 않게 한다.
+  uint32_t inFlight = handshakes_.fetch_add(1, std::memory_order_relaxed) + 1;
+  if (limits.MaxHandshakes != 0 && inFlight > limits.MaxHandshakes) {
+    handshakes_.fetch_sub(1, std::memory_order_relaxed);
+    return Reject(AdmissionReject::Handshakes);
+  }
+
+  accepted_.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+void AdmissionController::OnHandshakeFinished() {
+  handshakes_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+bool AdmissionController::Reject(AdmissionReject reason) {
+  rejected_[(size_t)reason].fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+void AdmissionController::Update() {
+  const auto& limits = limits_;
+
+  uint32_t pressure = std::max(Percent(connections_.connection_count(), limits.MaxConnections),
+                               Percent(handshakes_.load(std::memory_order_relaxed), limits.MaxHandshakes));
+  if (limits.MaxExecutorLagMs != 0) {
+    auto& executor = core::Executor::GetInstance();
+    executor.ProbeLag();
+    pressure = std::max(pressure, Percent(executor.lag_us(), (uint64_t)limits.MaxExecutorLagMs * 1000));
+  }
+  if (limits.MaxMemoryBytes != 0) {
+    pressure = std::max(pressure, Percent(ResidentMemoryBytes(), limits.MaxMemoryBytes));
+  }
+  pressure_percent_.store(pressure, std::memory_order_relaxed);
+
+  AdmissionLevel current = level_.load(std::memory_order_relaxed);
+  // 올라갈 때는 임계값에서 바로, 내려갈 때는 임계값보다 kHysteresisPercent 아래에서
+  uint32_t margin = current == AdmissionLevel::Normal ? 0 : kHysteresisPercent;
+  AdmissionLevel next = AdmissionLevel::Normal;
+  if (pressure >= 100 || (current == AdmissionLevel::Overloaded && pressure + margin >= 100)) {
+    next = AdmissionLevel::Overloaded;
+  } else if (pressure + margin >= limits.ThrottlePercent) {
+    next = AdmissionLevel::Throttled;
+  }
+
+  if (next != current) {
+    level_.store(next, std::memory_order_relaxed);
+    QF_LOG_WARN(Server, "Admission {} -> {} (pressure {}%)", LevelName(current), LevelName(next), pressure);
+  }
+}
+
+void AdmissionController::SetStatelessRetry(const QUIC_API_TABLE* api, bool enable) {
+  if (api == nullptr || stateless_retry_.exchange(enable) == enable) {
+    return;
+  }
+  // 0% 이면 handshake 메모리 사용량과 상관없이 모든 새 connection 에 retry 를 보낸다.
+  uint16_t percent = enable ? 0 : kDefaultRetryMemoryPercent;
+  QUIC_STATUS status = api->SetParam(nullptr, QUIC_PARAM_GLOBAL_RETRY_MEMORY_PERCENT, sizeof(percent), &percent);
+  if (QUIC_FAILED(status)) {
+    QF_LOG_ERROR(Server, "Failed to set stateless retry: 0x{:x}", (uint32_t)status);
+    stateless_retry_.store(!enable);
+    return;
+  }
+  QF_LOG_INFO(Server, "Stateless retry {}", enable ? "enabled" : "disabled");
+}
+
+uint64_t AdmissionController::ResidentMemoryBytes() {
+#if defined(__APPLE__)
+  mach_task_basic_info_data_t info{};
+  mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+  if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) != KERN_SUCCESS) {
+    return 0;
+  }
+  return info.resident_size;
+#else
+  // /proc/self/statm: size resident ... (page 단위)
+  std::ifstream statm("/proc/self/statm");
+  uint64_t size = 0;
+  uint64_t resident = 0;
+  if (!(statm >> size >> resident)) {
+    return 0;
+  }
+  return resident * (uint64_t)sysconf(_SC_PAGESIZE);
+#endif
+}
+
+}  // namespace network
+}  // namespace quicflow
@@ -0,0 +1,429 @@
+//
+// QuicFlow-CPP - ChatProtocol On-Demand JSON Decoder
+//
+
+#include "network/chat_protocol_decoder.hpp"
+
+#include "network/json_simd.hpp"
+
+namespace quicflow {
+namespace network {
+
+namespace {
+
+using Result = ChatProtocolDecoder::Result;
+
+enum class Field { Unknown, Type, MessageId, UserID, Message, Timestamp, Room, Epoch };
+
+Field MatchKey(std::string_view key) {
+  if (key == "Type") return Field::Type;
+  if (key == "MessageId") return Field::MessageId;
+  if (key == "UserID") return Field::UserID;
+  if (key == "Message") return Field::Message;
+  if (key == "Timestamp") return Field::Timestamp;
+  if (key == "Room") return Field::Room;
+  if (key == "Epoch") return Field::Epoch;
+  return Field::Unknown;
+}
+
+int HexValue(uint8_t c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+void AppendUtf8(std::string& out, uint32_t codepoint) {
+  if (codepoint < 0x80) {
+    out.push_back((char)codepoint);
+  } else if (codepoint < 0x800) {
+    out.push_back((char)(0xC0 | (codepoint >> 6)));
+    out.push_back((char)(0x80 | (codepoint & 0x3F)));
+  } else if (codepoint < 0x10000) {
+    out.push_back((char)(0xE0 | (codepoint >> 12)));
+    out.push_back((char)(0x80 | ((codepoint >> 6) & 0x3F)));
+    out.push_back((char)(0x80 | (codepoint & 0x3F)));
+  } else {
+    out.push_back((char)(0xF0 | (codepoint >> 18)));
+    out.push_back((char)(0x80 | ((codepoint >> 12) & 0x3F)));
+    out.push_back((char)(0x80 | ((codepoint >> 6) & 0x3F)));
+    out.push_back((char)(0x80 | (codepoint & 0x3F)));
+  }
+}
+
+// 입력 위에서 앞으로만 움직이는 파서 (DOM 없음)
+class Parser {
+public:
+  Parser(std::string_view json, std::string& scratch)
+      : cur_(reinterpret_cast<const uint8_t*>(json.data())),
+        end_(cur_ + json.size()),
+        scratch_(scratch) {}
+
+  void SkipWhitespace() {
+    while (cur_ < end_ && (*cur_ == ' ' || *cur_ == '\n' || *cur_ == '\r' || *cur_ == '\t')) {
+      ++cur_;
+    }
+  }
+
+  bool Consume(uint8_t c) {
+    SkipWhitespace();
+    if (cur_ < end_ && *cur_ == c) {
+      ++cur_;
+      return true;
+    }
+    return false;
+  }
+
+  bool Peek(uint8_t& c) {
+    SkipWhitespace();
+    if (cur_ >= end_) return false;
+    c = *cur_;
+    return true;
+  }
+
+  bool AtEnd() {
+    SkipWhitespace();
+    return cur_ == end_;
+  }
+
+  // 여는 따옴표 다음 위치에서 호출. 성공 시 out 은 입력 또는 scratch 를 가리킨다.
+  bool ParseString(std::string_view& out) {
+    const uint8_t* start = cur_;
+    size_t offset = json_simd::FindStringSpecial(cur_, (size_t)(end_ - cur_));
+    cur_ += offset;
+    if (cur_ >= end_) return false;
+
+    if (*cur_ == '"') {
+      // fast path: escape 없음 -> 입력 버퍼를 그대로 가리키는 view
+      out = std::string_view(reinterpret_cast<const char*>(start), offset);
+      ++cur_;
+      return true;
+    }
+    if (*cur_ != '\\') {
+      return false;  // 문자열 안의 제어문자는 JSON 오류
+    }
+
+    // slow path: escape 를 풀어서 scratch 에 쓴다.
+    // 풀어쓴 결과는 항상 원문보다 짧으므로, 처음 한 번 입력 크기만큼 reserve 해두면
+    // 이후 append 로 재할당되지 않아 앞서 만든 view 들도 유효하다.
+    if (scratch_.empty()) {
+      scratch_.reserve((size_t)(end_ - start));
+    }
+    size_t scratchStart = scratch_.size();
+    scratch_.append(reinterpret_cast<const char*>(start), offset);
+
+    while (cur_ < end_) {
+      uint8_t c = *cur_;
+      if (c == '"') {
+        ++cur_;
+        out = std::string_view(scratch_.data() + scratchStart, scratch_.size() - scratchStart);
+        return true;
+      }
+      if (c != '\\') {
+        return false;  // 제어문자
+      }
+      if (++cur_ >= end_) return false;
+
+      switch (*cur_++) {
+        case '"': scratch_.push_back('"'); break;
+        case '\\': scratch_.push_back('\\'); break;
+        case '/': scratch_.push_back('/'); break;
+        case 'b': scratch_.push_back('\b'); break;
+        case 'f': scratch_.push_back('\f'); break;
+        case 'n': scratch_.push_back('\n'); break;
+        case 'r': scratch_.push_back('\r'); break;
+        case 't': scratch_.push_back('\t'); break;
+        case 'u': {
+          uint32_t codepoint = 0;
+          if (ParseHex4(codepoint) == false) return false;
+          if (codepoint >= 0xD800 && codepoint <= 0xDBFF) {
+            // surrogate pair: 반드시 \uDC00..DFFF 가 뒤따라야 함
+            uint32_t low = 0;
+            if (end_ - cur_ < 2 || cur_[0] != '\\' || cur_[1] != 'u') return false;
+            cur_ += 2;
+            if (ParseHex4(low) == false || low < 0xDC00 || low > 0xDFFF) return false;
+            codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+          } else if (codepoint >= 0xDC00 && codepoint <= 0xDFFF) {
+            return false;
+          }
+          AppendUtf8(scratch_, codepoint);
+          break;
+        }
+        default:
+          return false;
+      }
+
+      size_t run = json_simd::FindStringSpecial(cur_, (size_t)(end_ - cur_));
+      scratch_.append(reinterpret_cast<const char*>(cur_), run);
+      cur_ += run;
+    }
+    return false;
+  }
+
+  // JSON 숫자 문법 검사 + 정수라면 값 추출
+  // isInteger == false 면 소수/지수 표기, overflow 는 fits == false
+  bool ParseNumber(bool& isInteger, bool& fits, int64_t& value) {
+    SkipWhitespace();
+    const uint8_t* start = cur_;
+    bool negative = false;
+    if (cur_ < end_ && *cur_ == '-') {
+      negative = true;
+      ++cur_;
+    }
+    if (cur_ >= end_ || *cur_ < '0' || *cur_ > '9') return false;
+
+    uint64_t magnitude = 0;
+    fits = true;
+    if (*cur_ == '0') {
+      ++cur_;
+    } else {
+      while (cur_ < end_ && *cur_ >= '0' && *cur_ <= '9') {
+        uint64_t digit = (uint64_t)(*cur_ - '0');
+        if (magnitude > (UINT64_MAX - digit) / 10) fits = false;
+        magnitude = magnitude * 10 + digit;
+        ++cur_;
+      }
+    }
+
+    isInteger = true;
+    if (cur_ < end_ && *cur_ == '.') {
+      isInteger = false;
+      ++cur_;
+      if (SkipDigits() == false) return false;
+    }
+    if (cur_ < end_ && (*cur_ == 'e' || *cur_ == 'E')) {
+      isInteger = false;
+      ++cur_;
+      if (cur_ < end_ && (*cur_ == '+' || *cur_ == '-')) ++cur_;
+      if (SkipDigits() == false) return false;
+    }
+
+    if (isInteger) {
+      uint64_t limit = negative ? (uint64_t)INT64_MAX + 1 : (uint64_t)INT64_MAX;
+      if (magnitude > limit) fits = false;
+      value = negative ? (int64_t)(0 - magnitude) : (int64_t)magnitude;
+    }
+    return cur_ > start;
+  }
+
+  bool ParseLiteral(std::string_view literal) {
+    if ((size_t)(end_ - cur_) < literal.size()
+      || std::string_view(reinterpret_cast<const char*>(cur_), literal.size()) != literal) {
+      return false;
+    }
+    cur_ += literal.size();
+    return true;
+  }
+
+  // 관심 없는 값: 형식만 검증하고 건너뛴다.
+  bool SkipValue(int depth) {
+    if (depth > ChatProtocolDecoder::kMaxDepth) return false;
+    uint8_t c = 0;
+    if (Peek(c) == false) return false;
+
+    switch (c) {
+      case '"': {
+        ++cur_;
+        return SkipString();
+      }
+      case '{': {
+        ++cur_;
+        if (Consume('}')) return true;
+        do {
+          if (Consume('"') == false || SkipString() == false) return false;
+          if (Consume(':') == false || SkipValue(depth + 1) == false) return false;
+        } while (Consume(','));
+        return Consume('}');
+      }
+      case '[': {
+        ++cur_;
+        if (Consume(']')) return true;
+        do {
+          if (SkipValue(depth + 1) == false) return false;
+        } while (Consume(','));
+        return Consume(']');
+      }
+      case 't': return ParseLiteral("true");
+      case 'f': return ParseLiteral("false");
+      case 'n': return ParseLiteral("null");
+      default: {
+        bool isInteger = false, fits = false;
+        int64_t value = 0;
+        return ParseNumber(isInteger, fits, value);
+      }
+    }
+  }
+
+private:
+  bool ParseHex4(uint32_t& out) {
+    if (end_ - cur_ < 4) return false;
+    out = 0;
+    for (int i = 0; i < 4; ++i) {
+      int digit = HexValue(*cur_++);
+      if (digit < 0) return false;
+      out = (out << 4) | (uint32_t)digit;
+    }
+    return true;
+  }
+
+  bool SkipDigits() {
+    const uint8_t* start = cur_;
+    while (cur_ < end_ && *cur_ >= '0' && *cur_ <= '9') ++cur_;
+    return cur_ > start;
+  }
+
+  // 건너뛸 문자열은 scratch 에 쓰지 않고 escape 형식만 검사
+  bool SkipString() {
+    while (cur_ < end_) {
+      cur_ += json_simd::FindStringSpecial(cur_, (size_t)(end_ - cur_));
+      if (cur_ >= end_) return false;
+      uint8_t c = *cur_++;
+      if (c == '"') return true;
+      if (c != '\\' || cur_ >= end_) return false;
+      uint8_t escaped = *cur_++;
+      if (escaped == 'u') {
+        uint32_t codepoint = 0;
+        if (ParseHex4(codepoint) == false) return false;
+        if (codepoint >= 0xD800 && codepoint <= 0xDBFF) {
+          uint32_t low = 0;
+          if (end_ - cur_ < 2 || cur_[0] != '\\' || cur_[1] != 'u') return false;
+          cur_ += 2;
+          if (ParseHex4(low) == false || low < 0xDC00 || low > 0xDFFF) return false;
+        } else if (codepoint >= 0xDC00 && codepoint <= 0xDFFF) {
+          return false;
+        }
+      } else if (std::string_view("\"\\/bfnrt").find((char)escaped) == std::string_view::npos) {
+        return false;
+      }
+    }
+    return false;
+  }
+
+  const uint8_t* cur_;
+  const uint8_t* end_;
+  std::string& scratch_;
+};
+
+}  // namespace
+
+ChatProtocolDecoder::Result ChatProtocolDecoder::Decode(std::string_view json,
+                                                        ChatProtocolView& out,
+                                                        std::string& scratch) {
+  // 1. UTF-8 검증은 버퍼 전체를 한 번에 (ASCII 구간은 SIMD 로 건너뜀)
+  if (json_simd::ValidateUtf8(reinterpret_cast<const uint8_t*>(json.data()), json.size()) == false) {
+    return Result::Invalid;
+  }
+
+  scratch.clear();
+  Parser parser(json, scratch);
+  bool hasType = false, hasUser = false, hasMessage = false, hasTimestamp = false;
+  bool needsFallback = false;
+
+  if (parser.Consume('{') == false) {
+    return Result::Invalid;
+  }
+
+  if (parser.Consume('}') == false) {
+    do {
+      std::string_view key;
+      if (parser.Consume('"') == false || parser.ParseString(key) == false) {
+        return Result::Invalid;
+      }
+      if (parser.Consume(':') == false) {
+        return Result::Invalid;
+      }
+
+      Field field = MatchKey(key);
+      uint8_t next = 0;
+      if (parser.Peek(next) == false) {
+        return Result::Invalid;
+      }
+
+      // 같은 key 가 여러 번 나오면 마지막 값을 사용한다 (nlohmann 과 동일)
+      switch (field) {
+        case Field::Type:
+        case Field::UserID:
+        case Field::Message:
+        case Field::Room: {
+          if (next != '"') {
+            // 문자열이 아닌 값이 오면 nlohmann 도 type_error -> 형식만 검사 후 실패
+            return Result::Invalid;
+          }
+          parser.Consume('"');
+          std::string_view value;
+          if (parser.ParseString(value) == false) {
+            return Result::Invalid;
+          }
+          if (field == Field::Type) { out.Type = value; hasType = true; }
+          if (field == Field::UserID) { out.UserID = value; hasUser = true; }
+          if (field == Field::Message) { out.Message = value; hasMessage = true; }
+          if (field == Field::Room) { out.Room = value; }
+          break;
+        }
+
+        case Field::Timestamp: {
+          if (next == '-' || (next >= '0' && next <= '9')) {
+            bool isInteger = false, fits = false;
+            int64_t value = 0;
+            if (parser.ParseNumber(isInteger, fits, value) == false) {
+              return Result::Invalid;
+            }
+            if (isInteger == false || fits == false) {
+              needsFallback = true;  // 실수/범위 초과 변환 규칙은 nlohmann 에 맡긴다
+            }
+            out.Timestamp = value;
+            hasTimestamp = true;
+          } else if (next == 't' || next == 'f') {
+            // nlohmann 은 boolean 을 숫자로 변환해 준다 -> 그대로 맡긴다
+            if (parser.SkipValue(0) == false) return Result::Invalid;
+            needsFallback = true;
+            hasTimestamp = true;
+          } else {
+            return Result::Invalid;
+          }
+          break;
+        }
+
+        case Field::MessageId:
+        case Field::Epoch: {
+          // MessageId/Epoch 는 nlohmann 변환에서 읽지 않는 선택 필드: 0 이상의 정수면 사용, 아니면 무시
+          if (next == '-' || (next >= '0' && next <= '9')) {
+            bool isInteger = false, fits = false;
+            int64_t value = 0;
+            if (parser.ParseNumber(isInteger, fits, value) == false) {
+              return Result::Invalid;
+            }
+            if (isInteger && fits && value >= 0) {
+              (field == Field::MessageId ? out.MessageId : out.Epoch) = (uint64_t)value;
+            }
+          } else if (parser.SkipValue(0) == false) {
+            return Result::Invalid;
+          }
+          break;
+        }
+
+        case Field::Unknown:
+          if (parser.SkipValue(0) == false) {
+            return Result::Invalid;
+          }
+          break;
+      }
+    } while (parser.Consume(','));
+
+    if (parser.Consume('}') == false) {
+      return Result::Invalid;
+    }
+  }
+
+  // 뒤에 남은 데이터가 있으면 잘못된 JSON
+  if (parser.AtEnd() == false) {
+    return Result::Invalid;
+  }
+  if (!hasType || !hasUser || !hasMessage || !hasTimestamp) {
+    return Result::Invalid;
+  }
+  return needsFallback ? Result::Fallback : Result::Ok;
+}
+
+}  // namespace network
+}  // namespace quicflow
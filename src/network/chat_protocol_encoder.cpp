@@ -0,0 +1,209 @@
+//
+// QuicFlow-CPP - ChatProtocol JSON Encoder
+//
+
+#include "network/chat_protocol_encoder.hpp"
+
+#include <cstring>
+
+#include "network/json_simd.hpp"
+
+namespace quicflow {
+namespace network {
+
+namespace {
+
+// nlohmann::json 의 object 는 key 사전순으로 직렬화된다.
+constexpr std::string_view kObjectBegin = "{";
+constexpr std::string_view kKeyEpoch = R"("Epoch":)";
+constexpr std::string_view kComma = ",";
+constexpr std::string_view kKeyMessage = R"("Message":")";
+constexpr std::string_view kKeyMessageId = R"(,"MessageId":)";
+constexpr std::string_view kKeyRoom = R"(,"Room":")";
+constexpr std::string_view kKeyTimestamp = R"(,"Timestamp":)";
+constexpr std::string_view kQuote = R"(")";
+constexpr std::string_view kKeyType = R"(,"Type":")";
+constexpr std::string_view kKeyUserID = R"(","UserID":")";
+constexpr std::string_view kObjectEnd = R"("})";
+
+constexpr char kHexDigits[] = "0123456789abcdef";
+
+// 바이트 하나의 escape 후 길이 (0 = escape 불필요, 1 바이트 그대로)
+// nlohmann serializer 의 dump_escaped 와 같은 규칙
+inline uint32_t EscapeLength(uint8_t c) {
+  switch (c) {
+    case '\b': case '\t': case '\n': case '\f': case '\r': case '"': case '\\':
+      return 2;
+    default:
+      return c <= 0x1F ? 6 : 1;
+  }
+}
+
+inline uint8_t* WriteRaw(std::string_view text, uint8_t* out) {
+  memcpy(out, text.data(), text.size());
+  return out + text.size();
+}
+
+}  // namespace
+
+bool ChatProtocolEncoder::EscapedLength(std::string_view value, uint32_t& outLength) {
+  auto* s = reinterpret_cast<const uint8_t*>(value.data());
+  size_t size = value.size();
+  uint64_t length = 0;
+
+  for (size_t i = 0; i < size;) {
+    if (s[i] < 0x80) {
+      length += EscapeLength(s[i]);
+      ++i;
+      continue;
+    }
+    size_t sequence = json_simd::Utf8SequenceLength(s + i, size - i);
+    if (sequence == 0) {
+      return false;
+    }
+    length += sequence;
+    i += sequence;
+  }
+
+  if (length > UINT32_MAX) {
+    return false;
+  }
+  outLength = (uint32_t)length;
+  return true;
+}
+
+uint8_t* ChatProtocolEncoder::WriteEscaped(std::string_view value, uint8_t* out) {
+  auto* s = reinterpret_cast<const uint8_t*>(value.data());
+  size_t size = value.size();
+  size_t runStart = 0;
+
+  // escape 가 필요 없는 구간은 memcpy 로 한 번에 복사
+  for (size_t i = 0; i < size; ++i) {
+    uint8_t c = s[i];
+    if (EscapeLength(c) == 1) {
+      continue;
+    }
+
+    memcpy(out, s + runStart, i - runStart);
+    out += i - runStart;
+    runStart = i + 1;
+
+    *out++ = '\\';
+    switch (c) {
+      case '\b': *out++ = 'b'; break;
+      case '\t': *out++ = 't'; break;
+      case '\n': *out++ = 'n'; break;
+      case '\f': *out++ = 'f'; break;
+      case '\r': *out++ = 'r'; break;
+      case '"': *out++ = '"'; break;
+      case '\\': *out++ = '\\'; break;
+      default:
+        *out++ = 'u';
+        *out++ = '0';
+        *out++ = '0';
+        *out++ = (uint8_t)kHexDigits[c >> 4];
+        *out++ = (uint8_t)kHexDigits[c & 0x0F];
+        break;
+    }
+  }
+
+  memcpy(out, s + runStart, size - runStart);
+  return out + (size - runStart);
+}
+
+uint32_t ChatProtocolEncoder::IntegerLength(int64_t value) {
+  uint64_t magnitude = value < 0 ? 0 - (uint64_t)value : (uint64_t)value;
+  uint32_t length = value < 0 ? 2 : 1;
+  while (magnitude >= 10) {
+    magnitude /= 10;
+    ++length;
+  }
+  return length;
+}
+
+uint8_t* ChatProtocolEncoder::WriteInteger(int64_t value, uint8_t* out) {
+  uint64_t magnitude = value < 0 ? 0 - (uint64_t)value : (uint64_t)value;
+  if (value < 0) {
+    *out++ = '-';
+  }
+
+  uint8_t digits[20];
+  uint32_t count = 0;
+  do {
+    digits[count++] = (uint8_t)('0' + magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude != 0);
+
+  while (count > 0) {
+    *out++ = digits[--count];
+  }
+  return out;
+}
+
+bool ChatProtocolEncoder::EncodedSize(const ChatProtocol& protocol, uint32_t& outSize) {
+  uint32_t message = 0, type = 0, user = 0, room = 0;
+  if (EscapedLength(protocol.Message, message) == false
+    || EscapedLength(protocol.Type, type) == false
+    || EscapedLength(protocol.UserID, user) == false
+    || EscapedLength(protocol.Room, room) == false) {
+    return false;
+  }
+
+  uint64_t total = kObjectBegin.size()
+                 + (protocol.Epoch == 0 ? 0 : kKeyEpoch.size() + IntegerLength((int64_t)protocol.Epoch) + kComma.size())
+                 + kKeyMessage.size() + message + kQuote.size()
+                 + (protocol.MessageId == 0 ? 0 : kKeyMessageId.size() + IntegerLength((int64_t)protocol.MessageId))
+                 + (protocol.Room.empty() ? 0 : kKeyRoom.size() + room + kQuote.size())
+                 + kKeyTimestamp.size() + IntegerLength((int64_t)protocol.Timestamp)
+                 + kKeyType.size() + type
+                 + kKeyUserID.size() + user
+                 + kObjectEnd.size();
+  if (total > UINT32_MAX - OutboundFrame::kHeaderSize) {
+    return false;
+  }
+  outSize = (uint32_t)total;
+  return true;
+}
+
+uint8_t* ChatProtocolEncoder::Encode(const ChatProtocol& protocol, uint8_t* out) {
+  out = WriteRaw(kObjectBegin, out);
+  if (protocol.Epoch != 0) {
+    out = WriteRaw(kKeyEpoch, out);
+    out = WriteInteger((int64_t)protocol.Epoch, out);
+    out = WriteRaw(kComma, out);
+  }
+  out = WriteRaw(kKeyMessage, out);
+  out = WriteEscaped(protocol.Message, out);
+  out = WriteRaw(kQuote, out);
+  if (protocol.MessageId != 0) {
+    out = WriteRaw(kKeyMessageId, out);
+    out = WriteInteger((int64_t)protocol.MessageId, out);
+  }
+  if (protocol.Room.empty() == false) {
+    out = WriteRaw(kKeyRoom, out);
+    out = WriteEscaped(protocol.Room, out);
+    out = WriteRaw(kQuote, out);
+  }
+  out = WriteRaw(kKeyTimestamp, out);
+  out = WriteInteger((int64_t)protocol.Timestamp, out);
+  out = WriteRaw(kKeyType, out);
+  out = WriteEscaped(protocol.Type, out);
+  out = WriteRaw(kKeyUserID, out);
+  out = WriteEscaped(protocol.UserID, out);
+  return WriteRaw(kObjectEnd, out);
+}
+
+FrameRef ChatProtocolEncoder::EncodeFrame(const ChatProtocol& protocol) {
+  uint32_t bodyLength = 0;
+  if (EncodedSize(protocol, bodyLength) == false) {
+    return FrameRef();
+  }
+
+  // 헤더는 Create 에서 이미 bodyLength 로 작성된다.
+  FrameRef frame(OutboundFrame::Create(bodyLength));
+  Encode(protocol, frame->body());
+  return frame;
+}
+
+}  // namespace network
+}  // namespace quicflow
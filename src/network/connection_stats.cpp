@@ -0,0 +1,339 @@
+//
+// QuicFlow-CPP - MsQuic Connection Statistics Sampler
+//
+
+#include "network/connection_stats.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <format>
+#include <iterator>
+#include <memory>
+
+#include "common/logger.hpp"
+#include "core/metrics.hpp"
+#include "manager/connection_manager.hpp"
+#include "network/quic_connection.hpp"
+#include "network/quic_server.hpp"
+
+namespace quicflow {
+namespace network {
+
+namespace {
+
+core::Histogram& connection_rtt = core::Metrics::GetHistogram(
+    "quicflow_quic_conn_rtt_us", "Smoothed RTT of live connections (one sample per connection per round)");
+core::Histogram& connection_min_rtt = core::Metrics::GetHistogram(
+    "quicflow_quic_conn_min_rtt_us", "Minimum RTT of live connections");
+core::Histogram& connection_cwnd = core::Metrics::GetHistogram(
+    "quicflow_quic_conn_cwnd_bytes", "Congestion window of live connections");
+core::Histogram& connection_loss = core::Metrics::GetHistogram(
+    "quicflow_quic_conn_loss_permille", "Packets lost per 1000 sent since the previous round");
+core::Histogram& connection_inflight = core::Metrics::GetHistogram(
+    "quicflow_quic_conn_inflight_bytes", "Bytes handed to StreamSend and not yet completed");
+
+constexpr std::string_view kRttLastHelp = "RTT percentile across live connections in the last round";
+core::Gauge& rtt_last_p50 = core::Metrics::GetGauge("quicflow_quic_conn_rtt_last_us", kRttLastHelp, "quantile=\"0.5\"");
+core::Gauge& rtt_last_p90 = core::Metrics::GetGauge("quicflow_quic_conn_rtt_last_us", kRttLastHelp, "quantile=\"0.9\"");
+core::Gauge& rtt_last_p99 = core::Metrics::GetGauge("quicflow_quic_conn_rtt_last_us", kRttLastHelp, "quantile=\"0.99\"");
+core::Gauge& rtt_last_max = core::Metrics::GetGauge("quicflow_quic_conn_rtt_last_us", kRttLastHelp, "quantile=\"1\"");
+core::Gauge& loss_rate_last = core::Metrics::GetGauge(
+    "quicflow_quic_conn_loss_rate_last_permille", "Packets lost per 1000 sent by all connections in the last round");
+core::Gauge& sampled_connections = core::Metrics::GetGauge(
+    "quicflow_quic_stats_sampled_connections", "Connections whose statistics were read in the last round");
+core::Gauge& round_duration = core::Metrics::GetGauge(
+    "quicflow_quic_stats_round_duration_us", "Time taken by the last statistics round");
+core::Gauge& outlier_connections = core::Metrics::GetGauge(
+    "quicflow_quic_outlier_connections", "Connections flagged as outliers in the last round");
+
+core::Counter& sent_packets = core::Metrics::GetCounter(
+    "quicflow_quic_sent_packets_total", "Packets sent by sampled connections (summed between rounds)");
+core::Counter& lost_packets = core::Metrics::GetCounter(
+    "quicflow_quic_lost_packets_total", "Packets lost (suspected minus spurious) by sampled connections");
+core::Counter& congestion_events = core::Metrics::GetCounter(
+    "quicflow_quic_congestion_events_total", "Congestion events of sampled connections");
+core::Counter& rtt_outliers = core::Metrics::GetCounter(
+    "quicflow_quic_outliers_total", "Connections flagged as outliers, per round", "reason=\"rtt\"");
+core::Counter& loss_outliers = core::Metrics::GetCounter(
+    "quicflow_quic_outliers_total", "Connections flagged as outliers, per round", "reason=\"loss\"");
+
+// 전역 perf counter 중 내보내는 것
+struct PerfCounter {
+  QUIC_PERFORMANCE_COUNTERS index;
+  core::Metrics::Type type;
+  std::string_view name;
+  std::string_view help;
+};
+
+constexpr PerfCounter kPerfCounters[] = {
+    {QUIC_PERF_COUNTER_CONN_CREATED, core::Metrics::Type::Counter, "quicflow_msquic_conn_created_total",
+     "MsQuic connections created"},
+    {QUIC_PERF_COUNTER_CONN_HANDSHAKE_FAIL, core::Metrics::Type::Counter, "quicflow_msquic_conn_handshake_fail_total",
+     "MsQuic handshakes that failed"},
+    {QUIC_PERF_COUNTER_CONN_APP_REJECT, core::Metrics::Type::Counter, "quicflow_msquic_conn_app_reject_total",
+     "MsQuic connections rejected by the application"},
+    {QUIC_PERF_COUNTER_CONN_LOAD_REJECT, core::Metrics::Type::Counter, "quicflow_msquic_conn_load_reject_total",
+     "MsQuic connections rejected because of worker load"},
+    {QUIC_PERF_COUNTER_CONN_ACTIVE, core::Metrics::Type::Gauge, "quicflow_msquic_conn_active",
+     "MsQuic connections currently allocated"},
+    {QUIC_PERF_COUNTER_CONN_CONNECTED, core::Metrics::Type::Gauge, "quicflow_msquic_conn_connected",
+     "MsQuic connections currently connected"},
+    {QUIC_PERF_COUNTER_CONN_PROTOCOL_ERRORS, core::Metrics::Type::Counter, "quicflow_msquic_conn_protocol_errors_total",
+     "MsQuic connections shut down with a protocol error"},
+    {QUIC_PERF_COUNTER_STRM_ACTIVE, core::Metrics::Type::Gauge, "quicflow_msquic_streams_active",
+     "MsQuic streams currently allocated"},
+    {QUIC_PERF_COUNTER_PKTS_SUSPECTED_LOST, core::Metrics::Type::Counter, "quicflow_msquic_packets_suspected_lost_total",
+     "Packets MsQuic suspected lost"},
+    {QUIC_PERF_COUNTER_PKTS_DROPPED, core::Metrics::Type::Counter, "quicflow_msquic_packets_dropped_total",
+     "Received packets MsQuic dropped"},
+    {QUIC_PERF_COUNTER_PKTS_DECRYPTION_FAIL, core::Metrics::Type::Counter,
+     "quicflow_msquic_packets_decryption_fail_total", "Received packets that failed decryption"},
+    {QUIC_PERF_COUNTER_UDP_RECV, core::Metrics::Type::Counter, "quicflow_msquic_udp_recv_total",
+     "UDP datagrams received"},
+    {QUIC_PERF_COUNTER_UDP_SEND, core::Metrics::Type::Counter, "quicflow_msquic_udp_send_total", "UDP datagrams sent"},
+    {QUIC_PERF_COUNTER_UDP_RECV_BYTES, core::Metrics::Type::Counter, "quicflow_msquic_udp_recv_bytes_total",
+     "UDP payload bytes received"},
+    {QUIC_PERF_COUNTER_UDP_SEND_BYTES, core::Metrics::Type::Counter, "quicflow_msquic_udp_send_bytes_total",
+     "UDP payload bytes sent"},
+    {QUIC_PERF_COUNTER_CONN_QUEUE_DEPTH, core::Metrics::Type::Gauge, "quicflow_msquic_conn_queue_depth",
+     "Connections queued on MsQuic workers"},
+    {QUIC_PERF_COUNTER_CONN_OPER_QUEUE_DEPTH, core::Metrics::Type::Gauge, "quicflow_msquic_conn_oper_queue_depth",
+     "Connection operations queued on MsQuic workers"},
+    {QUIC_PERF_COUNTER_WORK_OPER_QUEUE_DEPTH, core::Metrics::Type::Gauge, "quicflow_msquic_work_oper_queue_depth",
+     "Work operations queued on MsQuic workers"},
+    {QUIC_PERF_COUNTER_PATH_FAILURE, core::Metrics::Type::Counter, "quicflow_msquic_path_failure_total",
+     "Path validations that failed"},
+    {QUIC_PERF_COUNTER_SEND_STATELESS_RETRY, core::Metrics::Type::Counter, "quicflow_msquic_stateless_retry_total",
+     "Stateless retry packets sent"},
+};
+
+int64_t NowMs() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+uint32_t PercentileOf(const std::vector<uint32_t>& sorted, double q) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  return sorted[std::min(sorted.size() - 1, (size_t)(q * (double)sorted.size()))];
+}
+
+}  // namespace
+
+ConnectionStatsSampler::~ConnectionStatsSampler() {
+  Stop();
+}
+
+bool ConnectionStatsSampler::Start(std::vector<QuicServer*> servers, const ConnectionStatsConfig& config) {
+  if (config.IntervalMs == 0 || servers.empty() || thread_.joinable()) {
+    return false;
+  }
+  servers_ = std::move(servers);
+  config_ = config;
+  stopping_ = false;
+  RegisterMetrics();
+  thread_ = std::thread([this] { Run(); });
+  QF_LOG_INFO(Server, "Sampling QUIC connection statistics every {} ms", config.IntervalMs);
+  return true;
+}
+
+void ConnectionStatsSampler::Stop() {
+  {
+    std::lock_guard lock(stop_mutex_);
+    stopping_ = true;
+  }
+  stop_condition_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  core::Metrics::RemoveCallbacks(this);
+}
+
+void ConnectionStatsSampler::Run() {
+  std::unique_lock lock(stop_mutex_);
+  while (stop_condition_.wait_for(lock, std::chrono::milliseconds(config_.IntervalMs),
+                                  [this] { return stopping_; }) == false) {
+    lock.unlock();
+    SamplePerfCounters();
+    SampleConnections();
+    lock.lock();
+  }
+}
+
+void ConnectionStatsSampler::RegisterMetrics() {
+  for (const auto& counter : kPerfCounters) {
+    auto& value = perf_counters_[counter.index];
+    core::Metrics::AddCallback(this, counter.type, counter.name, counter.help, {},
+                               [&value] { return (double)value.load(std::memory_order_relaxed); });
+  }
+}
+
+void ConnectionStatsSampler::SamplePerfCounters() {
+  const QUIC_API_TABLE* api = servers_.front()->api();
+  if (api == nullptr) {
+    return;
+  }
+  int64_t counters[QUIC_PERF_COUNTER_MAX] = {};
+  uint32_t size = sizeof(counters);
+  QUIC_STATUS status = api->GetParam(nullptr, QUIC_PARAM_GLOBAL_PERF_COUNTERS, &size, counters);
+  if (QUIC_FAILED(status)) {
+    QF_LOG_RATE_LIMITED(Warning, Server, 1, "Failed to read MsQuic perf counters: 0x{:x}", (uint32_t)status);
+    return;
+  }
+  for (size_t i = 0; i < QUIC_PERF_COUNTER_MAX; ++i) {
+    perf_counters_[i].store(counters[i], std::memory_order_relaxed);
+  }
+}
+
+void ConnectionStatsSampler::SampleConnections() {
+  auto startedAt = std::chrono::steady_clock::now();
+
+  // GetParam 은 MsQuic worker 를 기다리므로 epoch guard(레지스트리 순회) 밖에서 부른다.
+  std::vector<std::pair<const QUIC_API_TABLE*, std::shared_ptr<QuicConnection>>> connections;
+  for (QuicServer* server : servers_) {
+    const QUIC_API_TABLE* api = server->api();
+    server->connection_manager().ForEachConnection([&](const std::shared_ptr<QuicConnection>& connection) {
+      connections.emplace_back(api, connection);
+    });
+  }
+
+  struct Sample {
+    Outlier info;
+    bool loss_measured = false;
+  };
+  std::vector<Sample> samples;
+  samples.reserve(connections.size());
+  std::unordered_map<const void*, Previous> next;
+  next.reserve(connections.size());
+  uint64_t roundSent = 0;
+  uint64_t roundLost = 0;
+
+  for (const auto& [api, connection] : connections) {
+    QUIC_STATISTICS_V2 stats{};
+    if (api == nullptr || connection->QueryStatistics(api, stats) == false) {
+      continue;
+    }
+
+    uint64_t lost = stats.SendSuspectedLostPackets > stats.SendSpuriousLostPackets
+                        ? stats.SendSuspectedLostPackets - stats.SendSpuriousLostPackets
+                        : 0;
+    Previous current{stats.CorrelationId, stats.SendTotalPackets, lost, stats.SendCongestionCount};
+
+    // 같은 주소에 새 connection 이 생겼을 수 있으므로 CorrelationId 로 확인한다.
+    Previous previous{};
+    if (auto found = previous_.find(connection.get());
+        found != previous_.end() && found->second.correlation_id == stats.CorrelationId) {
+      previous = found->second;
+    }
+    uint64_t sentDelta = current.sent_packets - std::min(previous.sent_packets, current.sent_packets);
+    uint64_t lostDelta = current.lost_packets - std::min(previous.lost_packets, current.lost_packets);
+    uint32_t congestionDelta =
+        current.congestion_events - std::min(previous.congestion_events, current.congestion_events);
+    next.emplace(connection.get(), current);
+
+    sent_packets.Increment(sentDelta);
+    lost_packets.Increment(lostDelta);
+    congestion_events.Increment(congestionDelta);
+    roundSent += sentDelta;
+    roundLost += lostDelta;
+
+    Sample sample;
+    sample.info.connection = connection->connection();
+    sample.info.correlation_id = stats.CorrelationId;
+    sample.info.profile = connection->profile_name();
+    sample.info.rtt_us = stats.Rtt;
+    sample.info.min_rtt_us = stats.MinRtt;
+    sample.info.cwnd_bytes = stats.SendCongestionWindow;
+    sample.info.inflight_bytes = connection->inflight_bytes();
+    connection_rtt.Record(stats.Rtt);
+    connection_min_rtt.Record(stats.MinRtt);
+    connection_cwnd.Record(stats.SendCongestionWindow);
+    connection_inflight.Record(sample.info.inflight_bytes);
+    if (sentDelta >= config_.MinPacketsForLoss) {
+      sample.info.loss_permille = (uint32_t)std::min<uint64_t>(lostDelta * 1000 / sentDelta, 1000);
+      sample.loss_measured = true;
+      connection_loss.Record(sample.info.loss_permille);
+    }
+    samples.push_back(std::move(sample));
+  }
+  previous_ = std::move(next);
+
+  // 이번 회차 분포
+  std::vector<uint32_t> rtts;
+  rtts.reserve(samples.size());
+  for (const auto& sample : samples) {
+    rtts.push_back(sample.info.rtt_us);
+  }
+  std::sort(rtts.begin(), rtts.end());
+  uint32_t medianRtt = PercentileOf(rtts, 0.5);
+  rtt_last_p50.Set(medianRtt);
+  rtt_last_p90.Set(PercentileOf(rtts, 0.9));
+  rtt_last_p99.Set(PercentileOf(rtts, 0.99));
+  rtt_last_max.Set(rtts.empty() ? 0 : rtts.back());
+  loss_rate_last.Set(roundSent == 0 ? 0 : (int64_t)(roundLost * 1000 / roundSent));
+  sampled_connections.Set((int64_t)samples.size());
+
+  // outlier: 절대 기준과 이번 회차 중앙값 대비 기준을 모두 넘어야 한다. (망 전체가 나쁠 때 전부 걸리지 않도록)
+  uint64_t rttThreshold = std::max<uint64_t>((uint64_t)config_.OutlierRttMs * 1000,
+                                             (uint64_t)medianRtt * config_.OutlierRttFactor);
+  std::vector<Outlier> outliers;
+  for (auto& sample : samples) {
+    bool slow = sample.info.rtt_us >= rttThreshold;
+    bool lossy = sample.loss_measured && sample.info.loss_permille >= config_.OutlierLossPercent * 10;
+    if (slow == false && lossy == false) {
+      continue;
+    }
+    sample.info.reason = slow && lossy ? "rtt+loss" : (slow ? "rtt" : "loss");
+    if (slow) {
+      rtt_outliers.Increment();
+    }
+    if (lossy) {
+      loss_outliers.Increment();
+    }
+    outliers.push_back(std::move(sample.info));
+  }
+  // 가장 나쁜 connection 부터
+  std::sort(outliers.begin(), outliers.end(), [](const Outlier& a, const Outlier& b) {
+    return a.loss_permille != b.loss_permille ? a.loss_permille > b.loss_permille : a.rtt_us > b.rtt_us;
+  });
+  outlier_connections.Set((int64_t)outliers.size());
+
+  for (size_t i = 0; i < std::min(outliers.size(), kMaxOutliersLogged); ++i) {
+    const auto& outlier = outliers[i];
+    QF_LOG_WARN(Connection, "Outlier connection ({}, id {}, {}): rtt {} us (median {} us), loss {}/1000, cwnd {}, inflight {}",
+                (const void*)outlier.connection, outlier.correlation_id, outlier.reason, outlier.rtt_us, medianRtt,
+                outlier.loss_permille, outlier.cwnd_bytes, outlier.inflight_bytes);
+  }
+
+  auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startedAt);
+  round_duration.Set(elapsed.count());
+  QF_LOG_DEBUG(Server, "Sampled {} connections in {} us: rtt p50 {} us, p99 {} us, loss {}/1000, {} outliers",
+               samples.size(), (int64_t)elapsed.count(), medianRtt, PercentileOf(rtts, 0.99),
+               roundSent == 0 ? 0 : roundLost * 1000 / roundSent, outliers.size());
+
+  std::lock_guard lock(outliers_mutex_);
+  outliers_ = std::move(outliers);
+  outliers_sampled_at_ms_ = NowMs();
+}
+
+std::string ConnectionStatsSampler::RenderOutliersJson() const {
+  std::lock_guard lock(outliers_mutex_);
+  std::string out = std::format("{{\n  \"sampled_at_ms\": {},\n  \"outliers\": [", outliers_sampled_at_ms_);
+  bool first = true;
+  for (const auto& outlier : outliers_) {
+    out += first ? "\n    " : ",\n    ";
+    first = false;
+    std::format_to(std::back_inserter(out),
+                   "{{\"connection\": \"{}\", \"correlation_id\": {}, \"profile\": \"{}\", \"reason\": \"{}\", "
+                   "\"rtt_us\": {}, \"min_rtt_us\": {}, \"loss_permille\": {}, \"cwnd_bytes\": {}, \"inflight_bytes\": {}}}",
+                   (const void*)outlier.connection, outlier.correlation_id, outlier.profile, outlier.reason,
+                   outlier.rtt_us, outlier.min_rtt_us, outlier.loss_permille, outlier.cwnd_bytes,
+                   outlier.inflight_bytes);
+  }
+  out += "\n  ]\n}\n";
+  return out;
+}
+
+}  // namespace network
+}  // namespace quicflow
@@ -0,0 +1,167 @@
+//
+// QuicFlow-CPP - Per-connection Flight Recorder
+//
+
+#include "network/flight_recorder.hpp"
+
+#include <algorithm>
+#include <format>
+#include <iterator>
+#include <thread>
+
+#include "core/metrics.hpp"
+#include "core/token_bucket.hpp"
+
+namespace quicflow {
+namespace network {
+
+namespace {
+
+core::Counter& dumps_written = core::Metrics::GetCounter(
+    "quicflow_flight_recorder_dumps_total", "Flight recorder rings dumped to the log automatically");
+core::Counter& dumps_suppressed = core::Metrics::GetCounter(
+    "quicflow_flight_recorder_dumps_suppressed_total", "Automatic dumps skipped by the per-second limit");
+
+struct EventFormat {
+  std::string_view name;
+  std::string_view value;  // 비어 있으면 출력하지 않는다
+  std::string_view aux;
+  bool hex = false;
+};
+
+constexpr EventFormat kEventFormats[] = {
+    {"connected", "", ""},
+    {"peer_shutdown", "error", ""},
+    {"transport_shutdown", "status", "", true},
+    {"shutdown_complete", "", ""},
+    {"stream_started", "", ""},
+    {"stream_closed", "", ""},
+    {"stream_receive", "bytes", "buffers"},
+    {"message_received", "bytes", ""},
+    {"parse_failed", "buffers", ""},
+    {"throttled", "consecutive", ""},
+    {"frame_queued", "bytes", "pending"},
+    {"flush", "bytes", "frames"},
+    {"send_blocked", "inflight", "pending"},
+    {"send_failed", "status", "", true},
+    {"send_complete", "bytes", "canceled"},
+    {"frames_dropped", "frames", "pending"},
+    {"slow_consumer_kick", "inflight", "pending"},
+    {"rate_limit_kick", "throttled", ""},
+};
+static_assert(std::size(kEventFormats) == (size_t)FlightRecorder::Event::kCount);
+
+uint64_t SteadyNs() {
+  return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}  // namespace
+
+void FlightRecorder::Configure(const FlightRecorderConfig& config) {
+  enabled_ = config.Enabled;
+  max_dumps_per_second_ = config.MaxDumpsPerSecond;
+  if (origin_ticks_ == 0) {
+    origin_ticks_ = Ticks();
+    origin_ns_ = SteadyNs();
+  }
+}
+
+bool FlightRecorder::TryAcquireDump() {
+  static std::atomic<uint64_t> window{0};
+  static std::atomic<uint32_t> count{0};
+
+  // 경계에서 몇 개 더 나가는 것은 허용한다. (락 없이 대략적인 상한)
+  uint64_t second = core::CoarseClock::NowMs() / 1000;
+  if (window.load(std::memory_order_relaxed) != second) {
+    window.store(second, std::memory_order_relaxed);
+    count.store(0, std::memory_order_relaxed);
+  }
+  if (count.fetch_add(1, std::memory_order_relaxed) >= max_dumps_per_second_) {
+    dumps_suppressed.Increment();
+    return false;
+  }
+  dumps_written.Increment();
+  return true;
+}
+
+std::string_view FlightRecorder::EventName(Event event) {
+  if (event >= Event::kCount) {
+    return "unknown";
+  }
+  return kEventFormats[(size_t)event].name;
+}
+
+double FlightRecorder::NanosPerTick() {
+#if defined(__x86_64__) || defined(__i386__)
+  // TSC 주파수는 Configure 시점과 지금 사이의 steady_clock 으로 잰다. (너무 가까우면 잠깐 기다린다)
+  if (origin_ticks_ == 0) {
+    return 1.0;
+  }
+  constexpr uint64_t kMinCalibrationNs = 10 * 1000 * 1000;
+  if (SteadyNs() - origin_ns_ < kMinCalibrationNs) {
+    std::this_thread::sleep_for(std::chrono::nanoseconds(kMinCalibrationNs));
+  }
+  uint64_t ticks = Ticks();
+  uint64_t ns = SteadyNs();
+  return ticks > origin_ticks_ ? (double)(ns - origin_ns_) / (double)(ticks - origin_ticks_) : 1.0;
+#elif defined(__aarch64__)
+  uint64_t frequency;
+  asm volatile("mrs %0, cntfrq_el0" : "=r"(frequency));
+  return frequency != 0 ? 1e9 / (double)frequency : 1.0;
+#else
+  return 1.0;
+#endif
+}
+
+std::string FlightRecorder::Render() const {
+  struct Entry {
+    uint64_t ticks;
+    uint64_t data;
+  };
+  std::array<Entry, kCapacity> entries;
+
+  uint64_t head = head_.load(std::memory_order_acquire);
+  size_t count = (size_t)std::min<uint64_t>(head, kCapacity);
+  for (size_t i = 0; i < count; ++i) {
+    const Slot& slot = slots_[(head - count + i) & (kCapacity - 1)];
+    entries[i] = {slot.ticks.load(std::memory_order_relaxed), slot.data.load(std::memory_order_relaxed)};
+  }
+
+  std::string out = std::format("{} of {} events (oldest first, time before the last event)\n", count, head);
+  if (count == 0) {
+    return out;
+  }
+  uint64_t newest = entries[count - 1].ticks;
+  double nanosPerTick = NanosPerTick();
+
+  for (size_t i = 0; i < count; ++i) {
+    auto type = (size_t)(entries[i].data >> 56);
+    auto aux = (uint32_t)((entries[i].data >> 32) & 0xFFFFFF);
+    auto value = (uint32_t)entries[i].data;
+    uint64_t before = newest > entries[i].ticks ? newest - entries[i].ticks : 0;
+    auto beforeUs = (uint64_t)((double)before * nanosPerTick / 1000.0);
+
+    if (type >= std::size(kEventFormats)) {
+      std::format_to(std::back_inserter(out), "  -{:>10} us  unknown ({})\n", beforeUs, type);
+      continue;
+    }
+    const EventFormat& format = kEventFormats[type];
+    std::format_to(std::back_inserter(out), "  -{:>10} us  {:<18}", beforeUs, format.name);
+    if (format.value.empty() == false) {
+      if (format.hex) {
+        std::format_to(std::back_inserter(out), " {}=0x{:x}", format.value, value);
+      } else {
+        std::format_to(std::back_inserter(out), " {}={}", format.value, value);
+      }
+    }
+    if (format.aux.empty() == false) {
+      std::format_to(std::back_inserter(out), " {}={}", format.aux, aux);
+    }
+    out += '\n';
+  }
+  return out;
+}
+
+}  // namespace network
+}  // namespace quicflow
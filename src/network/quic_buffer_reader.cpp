@@ -4,6 +4,8 @@
 
 #include "network/quic_buffer_reader.hpp"
 
+#include "common/logger.hpp"
+
 bool QuicBufferReader::CopyDataFromBuffers(
         const QUIC_BUFFER* Buffers,
         uint32_t BufferCount,
@@ -83,8 +85,8 @@ bool QuicBufferReader::TryParseStringMessage(
       ((uint32_t)HeaderBytes[3] << 24);
 
   // [검증 1] 보안 체크: 메시지가 너무 크면 거부 (메모리 공격 방지)
-  if (BodyLength > MAX_MESSAGE_SIZE) {
-    printf("[Error] Message size too large: %u\n", BodyLength);
+  if (BodyLength > max_message_size()) {
+    QF_LOG_RATE_LIMITED(Warning, Stream, 10, "Message size too large: {}", BodyLength);
     // 필요 시 여기서 연결을 끊는 로직 추가 (StreamShutdown 등)
     return false;
   }
@@ -103,7 +105,7 @@ bool QuicBufferReader::TryParseStringMessage(
   // 헤더 4바이트 건너뛰고(Offset=4), BodyLength만큼 복사
   CopyDataFromBuffers(Buffers, BufferCount, 4, &OutputString[0], BodyLength);
 
-  std::cout << "[QuicStream] Receive Buffer Success : " << BodyLength << "!" << std::endl;
+  QF_LOG_TRACE(Stream, "Parsed message body: {} bytes", BodyLength);
 
   return true; // 파싱 성공!
 }
\ No newline at end of file
@@ -2,9 +2,10 @@
 
 #include <cstring>
 #include <filesystem>
-#include <iostream>
 #include <string>
 
+#include "common/logger.hpp"
+
 namespace quicflow {
 namespace network {
 
@@ -34,8 +35,8 @@ QUIC_CREDENTIAL_CONFIG CreateSelfSignedCertificate(
   // validation (acceptable for test environments).
   cred_config.Type = QUIC_CREDENTIAL_TYPE_NONE;
 
-  std::cout << "[QuicCertificate] Created self-signed certificate config for '"
-            << common_name << "' (test mode: validation disabled)" << std::endl;
+  QF_LOG_INFO(Config, "Created self-signed certificate config for '{}' (test mode: validation disabled)",
+              common_name);
 
   return cred_config;
 }
@@ -52,15 +53,13 @@ QUIC_CREDENTIAL_CONFIG LoadCertificateFromFiles(const std::string& cert_file,
   std::filesystem::path key_path(key_file);
 
   if (!std::filesystem::exists(cert_path)) {
-    std::cerr << "[QuicCertificate] Certificate file not found: " << cert_file
-              << std::endl;
+    QF_LOG_ERROR(Config, "Certificate file not found: {}", cert_file);
     cred_config.Type = QUIC_CREDENTIAL_TYPE_NONE;
     return cred_config;
   }
 
   if (!std::filesystem::exists(key_path)) {
-    std::cerr << "[QuicCertificate] Key file not found: " << key_file
-              << std::endl;
+    QF_LOG_ERROR(Config, "Key file not found: {}", key_file);
     cred_config.Type = QUIC_CREDENTIAL_TYPE_NONE;
     return cred_config;
   }
@@ -95,9 +94,8 @@ QUIC_CREDENTIAL_CONFIG LoadCertificateFromFiles(const std::string& cert_file,
   cred_config.CertificateFile = &cert_file_struct;
 
 
-  std::cout << "[QuicCertificate]   Certificate: " << abs_cert_file
-            << std::endl;
-  std::cout << "[QuicCertificate]   Private Key: " << abs_key_file << std::endl;
+  QF_LOG_INFO(Config, "Certificate: {}", abs_cert_file);
+  QF_LOG_INFO(Config, "Private Key: {}", abs_key_file);
 
   return cred_config;
 }
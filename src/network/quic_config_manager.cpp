@@ -2,30 +2,73 @@
 
 #include <algorithm>
 #include <cstring>
-#include <iostream>
+#include <mutex>
 #include <sstream>
 
+#include "common/logger.hpp"
+#include "config/server_config.hpp"
 #include "network/quic_certificate.hpp"
 
 namespace quicflow {
 namespace network {
 
+namespace {
+
+// MsQuic API 테이블은 프로세스에서 한 번만 열고 모든 프로필 / shard 가 공유한다.
+// Why: MsQuicOpen2 는 호출마다 참조를 하나씩 늘리므로 같은 수의 MsQuicClose 가 필요하다.
+//      마지막 QuicConfigManager 가 registration 을 닫은 뒤에 MsQuicClose 한다.
+std::mutex api_mutex;
+const QUIC_API_TABLE* shared_api = nullptr;
+size_t api_references = 0;
+
+const QUIC_API_TABLE* AcquireApi(QUIC_STATUS& status) {
+  std::lock_guard<std::mutex> lock(api_mutex);
+  if (shared_api == nullptr) {
+    status = MsQuicOpen2(&shared_api);
+    if (QUIC_FAILED(status)) {
+      shared_api = nullptr;
+      return nullptr;
+    }
+    QF_LOG_INFO(Config, "MsQuic API initialized successfully");
+  }
+  status = QUIC_STATUS_SUCCESS;
+  ++api_references;
+  return shared_api;
+}
+
+void ReleaseApi() {
+  std::lock_guard<std::mutex> lock(api_mutex);
+  if (api_references == 0 || --api_references != 0) {
+    return;
+  }
+  MsQuicClose(shared_api);
+  shared_api = nullptr;
+  QF_LOG_INFO(Config, "MsQuic API closed");
+}
+
+}  // namespace
+
 QuicConfigManager::QuicConfigManager()
-    : handle_config_(nullptr),
+    : api_(nullptr),
+      handle_registration_(nullptr),
+      handle_config_(nullptr),
       is_valid_(false)
 {
 }
 
 QuicConfigManager::QuicConfigManager(QuicConfigManager&& other) noexcept
     : api_(other.api_),
+      handle_registration_(other.handle_registration_),
       handle_config_(other.handle_config_),
       alpn_buffers_(std::move(other.alpn_buffers_)),
       alpn_storage_(std::move(other.alpn_storage_)),
       is_valid_(other.is_valid_),
-      error_message_(std::move(other.error_message_))
+      error_message_(std::move(other.error_message_)),
+      profile_name_(std::move(other.profile_name_))
 {
   // Reset source object to prevent double cleanup.
   other.api_ = nullptr;
+  other.handle_registration_ = nullptr;
   other.handle_config_ = nullptr;
   other.is_valid_ = false;
   other.error_message_.clear();
@@ -37,15 +80,18 @@ QuicConfigManager& QuicConfigManager::operator=(
     Cleanup();
 
     api_ = other.api_;
+    handle_registration_ = other.handle_registration_;
     handle_config_ = other.handle_config_;
     alpn_buffers_ = std::move(other.alpn_buffers_);
     alpn_storage_ = std::move(other.alpn_storage_);
 
     is_valid_ = other.is_valid_;
     error_message_ = std::move(other.error_message_);
+    profile_name_ = std::move(other.profile_name_);
 
     // Reset source object.
     other.api_ = nullptr;
+    other.handle_registration_ = nullptr;
     other.handle_config_ = nullptr;
     other.is_valid_ = false;
     other.error_message_.clear();
@@ -71,22 +117,22 @@ const std::vector<QUIC_BUFFER>& QuicConfigManager::alpn_buffers() const noexcept
   return alpn_buffers_;
 }
 
-bool QuicConfigManager::InitializeConfig() {
-  // Initialize MsQuic API.
-  QUIC_STATUS status = MsQuicOpen2(&api_);
-  if (status != QUIC_STATUS_SUCCESS) {
-    // We do not throw here to keep Phase 1 sample usage minimal.
-    // Instead, we leave the pointer null and let caller check.
-    std::cerr << "[QuicApi] MsQuicOpen2 failed with status: " << status << std::endl;
-    api_ = nullptr;
-  } else {
-    std::cout << "[QuicApi] MsQuic API initialized successfully" << std::endl;
+bool QuicConfigManager::InitializeConfig(const config::ServerConfig& serverConfig,
+                                         const config::ProfileConfig& profile) {
+  // 다시 초기화하는 경우 이전 핸들과 API 참조를 먼저 돌려준다.
+  Cleanup();
+  profile_name_ = profile.Name;
+
+  // Initialize MsQuic API (shared by every profile and shard).
+  QUIC_STATUS status = QUIC_STATUS_SUCCESS;
+  api_ = AcquireApi(status);
+  if (api_ == nullptr) {
+    QF_LOG_ERROR(Config, "MsQuicOpen2 failed with status: 0x{:x}", (uint32_t)status);
+    error_message_ = "MsQuicOpen2 failed: status " + std::to_string(status);
+    return false;
   }
 
-  handle_config_ = nullptr;
-  is_valid_ = false;
-  std::vector<std::string> alpn_protocols = {"h3", "quicflow"};
-  //std::vector<std::string> alpn_protocols = {"h3"};
+  const std::vector<std::string>& alpn_protocols = profile.Alpns;
   if (alpn_protocols.empty()) {
     error_message_ = "ALPN protocols list cannot be empty";
     return false;
@@ -97,27 +143,25 @@ bool QuicConfigManager::InitializeConfig() {
   //      std::string for type safety and convenience in C++ code.
   InitializeAlpnBuffers(alpn_protocols);
 
-  QUIC_REGISTRATION_CONFIG RegConfig = { "QuicServer App", QUIC_EXECUTION_PROFILE_LOW_LATENCY };
+  // AppName 은 MsQuic 로그/트레이스에서 registration 을 구분하는 데 쓰인다.
+  const std::string appName = "QuicServer App (" + profile.Name + ")";
+  QUIC_REGISTRATION_CONFIG RegConfig = { appName.c_str(), profile.ExecutionProfile };
 
   // 1. Registration을 먼저 엽니다.
-  QUIC_STATUS Status = api_->RegistrationOpen(&RegConfig, &handle_registration_);
+  status = api_->RegistrationOpen(&RegConfig, &handle_registration_);
 
-  if (QUIC_FAILED(Status)) {
-    // Registration 생성 실패 시 처리
+  if (QUIC_FAILED(status)) {
+    error_message_ = "Failed to open registration: status " + std::to_string(status);
+    handle_registration_ = nullptr;
+    Cleanup();
     return false;
   }
 
-  // Create QUIC configuration with default settings.
-  // Why: We use QUIC_SETTINGS defaults initially. Advanced tuning
-  //      (e.g., connection migration, idle timeout) can be added later
-  //      via additional setter methods if needed.
+  // Create QUIC configuration with the configured settings.
+  // Why: Only the fields present in the server config are marked IsSet, so
+  //      everything else keeps the MsQuic default.
   QUIC_SETTINGS settings = {};
-  settings.IdleTimeoutMs = 60 * 60 * 1000;  // 1 hour
-  settings.IsSet.IdleTimeoutMs = TRUE;
-  settings.PeerBidiStreamCount = 100;  // Allow bidirectional streams
-  settings.IsSet.PeerBidiStreamCount = TRUE;
-  settings.KeepAliveIntervalMs = 30 * 1000; // 30초
-  settings.IsSet.KeepAliveIntervalMs = TRUE;
+  config::ServerConfigLoader::FillQuicSettings(profile.Quic, settings);
 
   // 2. configuration open
   // Note: ConfigurationOpen requires a registration handle.
@@ -136,6 +180,7 @@ bool QuicConfigManager::InitializeConfig() {
   if (QUIC_FAILED(status)) {
     error_message_ = "Failed to create QUIC configuration: status " +
                      std::to_string(status);
+    handle_config_ = nullptr;
     Cleanup();
     return false;
   }
@@ -144,18 +189,18 @@ bool QuicConfigManager::InitializeConfig() {
   // Load certificate from files.
   // Why: QUIC/TLS requires a certificate. We load the certificate and key
   //      from files in the certificate/ directory for production use.
-  const std::string cert_file = "certificate/server.cert";
-  const std::string key_file = "certificate/server.key";
+  const std::string& cert_file = serverConfig.CertificateFile;
+  const std::string& key_file = serverConfig.KeyFile;
 
   auto cred_config = LoadCertificateFromFiles(cert_file, key_file);
   if (cred_config.Type == QUIC_CREDENTIAL_TYPE_NONE) {
-    std::cerr << "[QuicFlow] Failed to load certificate from files" << std::endl;
+    error_message_ = "Failed to load certificate from files";
+    QF_LOG_ERROR(Config, "{}", error_message_);
     return false;
   }
 
   if (!set_credential(cred_config)) {
-    std::cerr << "[QuicFlow] Failed to set certificate: "
-              << error_message() << std::endl;
+    QF_LOG_ERROR(Config, "Failed to set certificate: {}", error_message());
     return false;
   }
 
@@ -164,6 +209,35 @@ bool QuicConfigManager::InitializeConfig() {
   return true;
 }
 
+bool QuicConfigManager::UpdateSettings(const config::QuicTunables& tunables) {
+  if (!is_valid_) {
+    error_message_ = "Configuration is not valid";
+    return false;
+  }
+
+  // Settings are layered, so a field that was set before and is now unset
+  // would keep its old value. Fill unset fields from the global settings
+  // (the MsQuic defaults) so that "default" really means default on reload.
+  QUIC_SETTINGS defaults = {};
+  uint32_t defaults_size = sizeof(defaults);
+  QUIC_STATUS status = api_->GetParam(nullptr, QUIC_PARAM_GLOBAL_SETTINGS, &defaults_size, &defaults);
+  if (QUIC_FAILED(status)) {
+    error_message_ = "Failed to read default settings: status " + std::to_string(status);
+    return false;
+  }
+
+  QUIC_SETTINGS settings = {};
+  config::ServerConfigLoader::FillQuicSettings(tunables, settings, &defaults);
+  status = api_->SetParam(
+      handle_config_, QUIC_PARAM_CONFIGURATION_SETTINGS, sizeof(settings), &settings);
+
+  if (QUIC_FAILED(status)) {
+    error_message_ = "Failed to update settings: status " + std::to_string(status);
+    return false;
+  }
+  return true;
+}
+
 bool QuicConfigManager::set_credential(const QUIC_CREDENTIAL_CONFIG& credential_config) {
   if (api_ == nullptr || handle_config_ == nullptr) {
     error_message_ = "Configuration is not valid";
@@ -176,7 +250,7 @@ bool QuicConfigManager::set_credential(const QUIC_CREDENTIAL_CONFIG& credential_
     error_message_ = "Failed to load credential: status " + std::to_string(status);
     return false;
   }
-  std::cerr << "[DEBUG]" << R"({"config_handler":")" << handle_config_  << R"("})" << std::endl;
+  QF_LOG_DEBUG(Config, "Configuration handle {}", (const void*)handle_config_);
 
   return true;
 }
@@ -207,13 +281,20 @@ void QuicConfigManager::Cleanup() noexcept {
 #ifdef QUICFLOW_HAS_MSQUIC
   if (handle_config_ != nullptr && api_ != nullptr) {
     api_->ConfigurationClose(handle_config_);
-    handle_config_ = nullptr;
   }
-#else
-  if (handle_config_ != nullptr) {
-    handle_config_ = nullptr;
+  // RegistrationClose 는 이 registration 의 connection / listener 가 모두 닫힐 때까지 기다린다.
+  // 아직 종료를 시작하지 않은 connection 이 있으면 영원히 기다리므로 먼저 RegistrationShutdown 한다.
+  if (handle_registration_ != nullptr && api_ != nullptr) {
+    api_->RegistrationShutdown(handle_registration_, QUIC_CONNECTION_SHUTDOWN_FLAG_NONE, 0);
+    api_->RegistrationClose(handle_registration_);
+  }
+  if (api_ != nullptr) {
+    ReleaseApi();
   }
 #endif
+  handle_config_ = nullptr;
+  handle_registration_ = nullptr;
+  api_ = nullptr;
 
   is_valid_ = false;
 }
@@ -4,9 +4,14 @@
 
 #include "network/quic_connection.hpp"
 
-#include <iostream>
+#include <algorithm>
+#include <limits>
 
+#include "common/logger.hpp"
+#include "core/metrics.hpp"
 #include "manager/connection_manager.hpp"
+#include "network/admission_controller.hpp"
+#include "network/chat_protocol_encoder.hpp"
 #include "network/quic_buffer_reader.hpp"
 #include "network/quic_config_manager.hpp"
 #include "network/quic_protocol.hpp"
@@ -15,34 +20,86 @@
 namespace quicflow {
 namespace network {
 
+namespace {
+
+// 프로세스 전체(모든 shard) 합계
+core::Counter& messages_received = core::Metrics::GetCounter(
+    "quicflow_messages_received_total", "Framed messages received on chat streams");
+core::Counter& bytes_received = core::Metrics::GetCounter(
+    "quicflow_received_bytes_total", "Bytes of framed messages received (header included)");
+core::Histogram& message_size = core::Metrics::GetHistogram(
+    "quicflow_received_message_bytes", "Size of received message bodies");
+core::Counter& receive_parse_failures = core::Metrics::GetCounter(
+    "quicflow_receive_parse_failures_total", "Receive events whose buffers could not be parsed into a message");
+core::Counter& messages_throttled = core::Metrics::GetCounter(
+    "quicflow_messages_throttled_total", "Inbound messages dropped by the per-connection rate limit");
+core::Counter& frames_sent = core::Metrics::GetCounter(
+    "quicflow_frames_sent_total", "Outbound frames handed to StreamSend");
+core::Counter& bytes_sent = core::Metrics::GetCounter(
+    "quicflow_sent_bytes_total", "Outbound bytes handed to StreamSend");
+core::Histogram& send_batch_frames = core::Metrics::GetHistogram(
+    "quicflow_send_batch_frames", "Frames coalesced into one StreamSend");
+core::Counter& send_failures = core::Metrics::GetCounter(
+    "quicflow_stream_send_failures_total", "StreamSend calls that failed");
+core::Counter& send_blocked = core::Metrics::GetCounter(
+    "quicflow_send_blocked_total", "Flushes deferred because in-flight bytes reached the limit");
+core::Counter& frames_dropped = core::Metrics::GetCounter(
+    "quicflow_frames_dropped_total", "Outbound frames dropped by the slow consumer policy");
+core::Counter& frames_conflated = core::Metrics::GetCounter(
+    "quicflow_frames_conflated_total", "Queued frames replaced by a newer frame with the same conflation key");
+core::Counter& slow_consumer_disconnects = core::Metrics::GetCounter(
+    "quicflow_disconnects_total", "Connections closed by the server", "reason=\"slow_consumer\"");
+core::Counter& rate_limit_disconnects = core::Metrics::GetCounter(
+    "quicflow_disconnects_total", "Connections closed by the server", "reason=\"rate_limit\"");
+core::Counter& transport_shutdowns = core::Metrics::GetCounter(
+    "quicflow_transport_shutdowns_total", "Connections shut down by the transport (idle timeout, errors)");
+
+// flight recorder 값은 32 bit
+uint32_t Clamp32(uint64_t value) {
+  return (uint32_t)std::min<uint64_t>(value, std::numeric_limits<uint32_t>::max());
+}
+
+}  // namespace
+
+uint64_t QuicConnection::total_throttled_messages() {
+  return messages_throttled.value();
+}
+
 QuicConnection::QuicConnection(HQUIC connection) {
   connection_ = connection;
+  // 프로세스 안에서 유일한 번호. 클라이언트가 보낸 UserID 는 믿지 않는다.
+  static std::atomic<uint64_t> next_user_number{1};
+  user_id_ = user_id_prefix_ + std::to_string(next_user_number.fetch_add(1, std::memory_order_relaxed));
+  if (FlightRecorder::enabled()) {
+    recorder_ = std::make_unique<FlightRecorder>();
+  }
 }
 //QUIC_STATUS QuicConnection::InitConnection(const QUIC_API_TABLE* api,  std::shared_ptr<QuicConfigManager> config) {
-QUIC_STATUS QuicConnection::InitConnection(QuicServer* server) {
+QUIC_STATUS QuicConnection::InitConnection(QuicServer* server, std::shared_ptr<QuicConfigManager> config) {
   if (server == nullptr) {
     return QUIC_STATUS_INTERNAL_ERROR;
   }
   server_ = server;
+  connection_manager_ = &server->connection_manager();
   auto api = server_->api();
-  auto config = server_->config();
 
   if ( api == nullptr
     || config == nullptr
     || connection_ == nullptr) {
     return QUIC_STATUS_INTERNAL_ERROR;
   }
+  profile_name_ = config->profile_name();
 
   api->SetCallbackHandler(connection_, (void*)ServerConnectionCallback, this);
 
-  std::cout << "[QuicConnection] Regist Handler and Context "  << &ServerConnectionCallback << ", " << this << std::endl;
+  QF_LOG_TRACE(Connection, "Registered connection handler, context {}", (const void*)this);
 
   // 3. 설정(Configuration) 적용
   // 주의: configuration_ 핸들이 유효해야 함
   QUIC_STATUS status = api->ConnectionSetConfiguration(connection_, config->configuration());
   if (QUIC_FAILED(status)) {
-    std::cerr << "[QuicServer] Failed to set connection configuration: "
-              << status << " (0x" << std::hex << status << std::dec << ")" << std::endl;
+    QF_LOG_RATE_LIMITED(Error, Connection, 10, "Failed to set connection configuration: {} (0x{:x})",
+                        (uint32_t)status, (uint32_t)status);
 
     return status;
   }
@@ -54,102 +111,461 @@ void QuicConnection::CloseConnection() {
 
   if (connection_ != nullptr) {
     auto api = server_->api();
-    api->ConnectionClose(connection_);
+    bool closeNow;
+    {
+      std::lock_guard lock(handle_mutex_);
+      handle_closed_ = true;
+      close_deferred_ = handle_users_ != 0;
+      closeNow = handle_users_ == 0;
+    }
+    if (closeNow) {
+      api->ConnectionClose(connection_);
+    }
   }
 
   server_ = nullptr;
 }
 
+bool QuicConnection::AcquireHandle() {
+  std::lock_guard lock(handle_mutex_);
+  if (handle_closed_ || connection_ == nullptr) {
+    return false;
+  }
+  ++handle_users_;
+  return true;
+}
+
+bool QuicConnection::ReleaseHandle(const QUIC_API_TABLE* api) {
+  bool closeNow;
+  {
+    std::lock_guard lock(handle_mutex_);
+    --handle_users_;
+    closeNow = close_deferred_ && handle_users_ == 0;
+    if (closeNow) {
+      close_deferred_ = false;
+    }
+  }
+  if (closeNow) {
+    api->ConnectionClose(connection_);
+    return false;
+  }
+  return true;
+}
+
+bool QuicConnection::QueryStatistics(const QUIC_API_TABLE* api, QUIC_STATISTICS_V2& stats) {
+  if (AcquireHandle() == false) {
+    return false;
+  }
+
+  uint32_t size = sizeof(stats);
+  QUIC_STATUS status = api->GetParam(connection_, QUIC_PARAM_CONN_STATISTICS_V2, &size, &stats);
+
+  if (ReleaseHandle(api) == false) {
+    return false;
+  }
+  return QUIC_SUCCEEDED(status);
+}
+
+void QuicConnection::Shutdown(const QUIC_API_TABLE* api, uint64_t errorCode) {
+  if (AcquireHandle() == false) {
+    return;
+  }
+  api->ConnectionShutdown(connection_, QUIC_CONNECTION_SHUTDOWN_FLAG_NONE, errorCode);
+  ReleaseHandle(api);
+}
+
 DEFINE_ASYNC_FUNCTION(QuicConnection, SendChatMessage, const std::string& message) {
   if (stream_chat_ == nullptr) {
-    std::cerr << "[QuicConnection] SendChatMessage called with nullptr" << std::endl;
+    QF_LOG_ERROR(Connection, "SendChatMessage called with nullptr");
     return;
   }
 
-  // 1. JSON 객체 생성 (C# Dictionary보다 더 직관적)
+  // 1. 프로토콜 구조체 생성
   ChatProtocol jsonData;
   jsonData.Type = "Chat";
-  jsonData.MessageId = message_id_;
+  // 방을 거치지 않는 직접 메시지에는 순번을 붙이지 않는다 (순번은 Room 에서만 부여).
   jsonData.UserID = "User1";
   jsonData.Message = message;
   jsonData.Timestamp = std::time(nullptr);
 
-  message_id_++;
+  // 2. 직렬화: json 트리/중간 문자열 없이 풀에서 받은 송신 프레임에 바로 쓴다.
+  FrameRef frame = ChatProtocolEncoder::EncodeFrame(jsonData);
+  if (!frame) {
+    QF_LOG_RATE_LIMITED(Warning, Connection, 10, "SendChatMessage encode failed (invalid UTF-8)");
+    return;
+  }
+  QueueFrame(std::move(frame));
+}
 
-  json j = jsonData;
+DEFINE_ASYNC_FUNCTION(QuicConnection, SendFrame, FrameRef frame) {
+  if (stream_chat_ == nullptr) {
+    QF_LOG_ERROR(Connection, "SendFrame called with nullptr");
+    return;
+  }
+  QueueFrame(std::move(frame));
+}
 
-  // 2. 직렬화 (std::string으로 변환)
-  std::string serializedStr = j.dump();
-  SendJsonMessage(stream_chat_, serializedStr);
+DEFINE_ASYNC_FUNCTION(QuicConnection, DeliverFrame, FrameRef frame, core::MessageTrace trace, RoomPosition position) {
+  if (stream_chat_ == nullptr) {
+    QF_LOG_ERROR(Connection, "DeliverFrame called with nullptr");
+    return;
+  }
+  if (position.Sequence != 0 && MarkRoomFrameSent(position) == false) {
+    return;  // replay 로 이미 보냈다
+  }
+  QueueFrame(std::move(frame), trace);
 }
 
-// 메시지를 Little Endian 헤더와 합쳐서 전송하는 함수
+DEFINE_ASYNC_FUNCTION(QuicConnection, ReplayFrames, std::vector<FrameRef> frames, RoomPosition first) {
+  if (stream_chat_ == nullptr) {
+    QF_LOG_ERROR(Connection, "ReplayFrames called with nullptr");
+    return;
+  }
+  if (frames.empty()) {
+    return;
+  }
+  const uint64_t last = first.Sequence + frames.size() - 1;
+
+  // 이미 보낸 구간과 겹치는 순번만 건너뛴다. (QueueFrame 이 구간을 비울 수 있으므로 값으로 복사)
+  RoomCursor sent;
+  if (auto found = room_cursors_.find(first.Room); found != room_cursors_.end()) {
+    sent = found->second;
+  }
+  const uint64_t droppedBefore = dropped_frames_;
+  uint64_t sequence = first.Sequence;
+  for (auto& frame : frames) {
+    if (sent.Last == 0 || sequence < sent.First || sequence > sent.Last) {
+      QueueFrame(std::move(frame));
+    }
+    sequence++;
+  }
+  if (dropped_frames_ != droppedBefore) {
+    return;  // 보내는 도중 버린 프레임이 있으면 구간을 남기지 않는다
+  }
+
+  // replay 구간이 기존 구간과 이어지면 합치고, 떨어져 있으면 replay 구간으로 바꾼다.
+  RoomCursor updated{first.Sequence, last};
+  if (sent.Last != 0 && first.Sequence <= sent.Last + 1 && last + 1 >= sent.First) {
+    updated = RoomCursor{std::min(sent.First, first.Sequence), std::max(sent.Last, last)};
+  }
+  if (room_cursors_.size() >= kMaxRoomCursors && room_cursors_.contains(first.Room) == false) {
+    room_cursors_.clear();
+  }
+  room_cursors_[first.Room] = updated;
+}
+
+bool QuicConnection::MarkRoomFrameSent(const RoomPosition& position) {
+  auto found = room_cursors_.find(position.Room);
+  if (found == room_cursors_.end()) {
+    if (room_cursors_.size() >= kMaxRoomCursors) {
+      // 오래 떠난 방의 구간이 쌓이지 않도록. 비우면 중복 전송만 가능해진다.
+      room_cursors_.clear();
+    }
+    room_cursors_.emplace(position.Room, RoomCursor{position.Sequence, position.Sequence});
+    return true;
+  }
+
+  RoomCursor& cursor = found->second;
+  if (position.Sequence >= cursor.First && position.Sequence <= cursor.Last) {
+    return false;
+  }
+  if (position.Sequence == cursor.Last + 1) {
+    cursor.Last = position.Sequence;
+  } else if (position.Sequence + 1 == cursor.First) {
+    cursor.First = position.Sequence;
+  } else {
+    // 구간과 떨어진 순번 (방을 나갔다가 다시 들어옴 등): 새 구간으로 시작
+    cursor = RoomCursor{position.Sequence, position.Sequence};
+  }
+  return true;
+}
+
+// 메시지를 Little Endian 헤더와 합쳐서 송신 대기열에 넣는 함수
+// 실제 StreamSend 는 FlushPendingFrames 에서 묶어서 호출된다.
 void QuicConnection::SendJsonMessage( const HQUIC hStream, const std::string& jsonMessage)
 {
-  uint32_t bodyLength = (uint32_t)jsonMessage.length();
-  uint32_t totalLength = 4 + bodyLength;
+  if (hStream == nullptr) {
+    QF_LOG_RATE_LIMITED(Warning, Stream, 10, "SendJsonMessage called with nullptr stream");
+    return;
+  }
 
-  // 1. 단 하나의 버퍼만 할당 (Header + Body)
-  // SendBufferContext를 힙에 생성하여 전송 완료 시점까지 살려둡니다.
-  auto* SendCtx = new SendBufferContext(totalLength);
-  uint8_t* BufferPtr = SendCtx->RawBuffer;
+  uint32_t bodyLength = (uint32_t)jsonMessage.length();
 
-  // 2. [Little Endian] 헤더 작성 (4 Bytes)
-  // CPU 아키텍처 상관없이 강제로 리틀 엔디안으로 박아넣음
-  BufferPtr[0] = (uint8_t)(bodyLength & 0xFF);
-  BufferPtr[1] = (uint8_t)((bodyLength >> 8) & 0xFF);
-  BufferPtr[2] = (uint8_t)((bodyLength >> 16) & 0xFF);
-  BufferPtr[3] = (uint8_t)((bodyLength >> 24) & 0xFF);
+  // 1. 단 하나의 버퍼만 할당 (Header + Body), 헤더는 Create 에서 작성됨
+  FrameRef frame(OutboundFrame::Create(bodyLength));
 
-  // 3. 본문 복사 (Offset 4부터 시작)
+  // 2. 본문 복사 (Offset 4부터 시작)
   if (bodyLength > 0) {
-    memcpy(BufferPtr + 4, jsonMessage.c_str(), bodyLength);
+    memcpy(frame->body(), jsonMessage.c_str(), bodyLength);
   }
 
-  // 4. QUIC_BUFFER 구조체 세팅
-  QUIC_BUFFER* QuicBuf = new QUIC_BUFFER();
-//#ifdef _WIN32
-  // Windows 방식
-  QuicBuf->Length = totalLength;
-  QuicBuf->Buffer = SendCtx->RawBuffer;
-/*#else
-  // Mac/Linux 방식 (iovec)
-  // iovec 구조체로 캐스팅해서 넣어야 안전합니다.
-  struct iovec* vec = (struct iovec*)&QuicBuf;
-  vec->iov_base = SendCtx->RawBuffer; // 포인터가 먼저!
-  vec->iov_len = totalLength;         // 길이가 나중!
-#endif*/
+  QueueFrame(std::move(frame));
+}
 
-  auto api = server_->config()->api(); // 실제 데이터가 들어있는 힙 메모리 주소
+void QuicConnection::QueueFrame(FrameRef frame, const core::MessageTrace& trace) {
+  if (slow_consumer_kicked_) {
+    // 이미 끊기로 한 연결에는 더 쌓지 않는다.
+    CountDroppedFrames(1);
+    return;
+  }
 
-  printf("[DEBUG] Real Buffer Address (Heap): %p\n", SendCtx->RawBuffer);
-  printf("[DEBUG] Intended Length: %u\n", totalLength);
+  if (ReplaceConflatedFrame(frame, trace) == false) {
+    if (pending_frames_.empty()) {
+      pending_since_ = std::chrono::steady_clock::now();
+    }
+    uint32_t frameLength = frame->length();
+    pending_bytes_ += frameLength;
+    pending_frames_.push_back({std::move(frame), trace});
+    Record(FlightRecorder::Event::FrameQueued, frameLength, (uint32_t)pending_frames_.size());
+  }
 
-  printf("Size Check: QUIC_BUFFER=%zu, iovec=%zu\n", sizeof(QUIC_BUFFER), sizeof(struct iovec));
+  if (pending_bytes_ > outbound_limits_.MaxPendingBytes) {
+    ApplySlowConsumerPolicy();
+    if (pending_frames_.empty()) {
+      return;
+    }
+  }
 
-  /*void** rawPtr = (void**)&RealVec;
-  // QUIC_BUFFER 구조체 내부의 첫 8바이트와 두 번째 8바이트 확인
-  printf("[DEBUG] Struct Slot 0 (First 8 bytes):  0x%llX\n", rawPtr[0]);
-  printf("[DEBUG] Struct Slot 1 (Second 8 bytes): 0x%llX\n", rawPtr[1]);*/
+  // 드레인이 길어지면 끝까지 기다리지 않고 중간에 flush
+  // Why: 배치가 너무 커지거나 오래 잡혀있으면 첫 메시지의 지연이 커진다.
+  if (pending_frames_.size() >= kMaxBatchFrames
+    || pending_bytes_ >= kMaxBatchBytes
+    || std::chrono::steady_clock::now() - pending_since_ >= kFlushDeadline) {
+    FlushPendingFrames(HasPendingTasks());
+  }
+}
 
-  // 5. 전송 (비동기)
+bool QuicConnection::ReplaceConflatedFrame(FrameRef& frame, const core::MessageTrace& trace) {
+  const uint64_t key = frame->conflation_key();
+  if (outbound_limits_.Policy != SlowConsumerPolicy::Conflate || key == 0) {
+    return false;
+  }
+  // 아직 StreamSend 하지 않은 프레임만 대기열에 있으므로 바꿔도 된다.
+  // 자리는 이전 프레임의 것을 쓴다. (최신 상태가 조금 일찍 나가는 것은 문제 없다)
+  for (auto& pending : pending_frames_) {
+    if (pending.frame->conflation_key() != key || pending.frame->critical()) {
+      continue;
+    }
+    pending_bytes_ = pending_bytes_ - pending.frame->length() + frame->length();
+    pending.frame = std::move(frame);
+    pending.trace = trace;
+    // 순번이 없는 프레임이므로 보낸 구간 기록(room_cursors_)은 그대로 둔다. (CountDroppedFrames 와 다름)
+    frames_conflated.Increment();
+    return true;
+  }
+  return false;
+}
+
+void QuicConnection::OnDrained() {
+  FlushPendingFrames(false);
+}
+
+void QuicConnection::FlushPendingFrames(bool moreWorkQueued) {
+  if (pending_frames_.empty()) {
+    return;
+  }
+
+  if (stream_chat_ == nullptr || server_ == nullptr) {
+    // 스트림이 닫힌 상태면 보낼 곳이 없으므로 버린다.
+    pending_frames_.clear();
+    pending_bytes_ = 0;
+    return;
+  }
+
+  // 클라이언트가 ACK 를 못 따라오고 있으면 더 밀어넣지 않고 대기열에 둔다.
+  // SEND_COMPLETE 로 inflight 가 줄어들면 OnSendResumed 가 다시 flush 한다.
+  if (send_blocked_.load(std::memory_order_acquire)) {
+    // 이미 막혀 있고 재개가 예약되어 있으므로 다시 세지 않는다.
+    return;
+  }
+  if (inflight_bytes_.load(std::memory_order_acquire) >= outbound_limits_.MaxInflightBytes) {
+    send_blocked_.store(true, std::memory_order_release);
+    // store 이후 다시 확인: 그 사이 SEND_COMPLETE 가 모두 끝났다면 재개 예약이 없으므로 직접 진행
+    if (inflight_bytes_.load(std::memory_order_acquire) >= outbound_limits_.MaxInflightBytes
+      || send_blocked_.exchange(false) == false) {
+      send_blocked.Increment();
+      Record(FlightRecorder::Event::SendBlocked, Clamp32(inflight_bytes()), (uint32_t)pending_frames_.size());
+      return;
+    }
+  }
+
+  // 3. QUIC_BUFFER 배열 세팅 (프레임 1개당 버퍼 1개, 복사 없음)
+  // SendBufferContext 를 힙에 생성하여 전송 완료 시점까지 프레임들을 살려둡니다.
+  auto* SendCtx = new SendBufferContext();
+  SendCtx->Buffers.reserve(pending_frames_.size());
+  SendCtx->Frames.reserve(pending_frames_.size());
+  SendCtx->SentAt = core::LatencyTrace::Stamp();
+  for (auto& pending : pending_frames_) {
+    QUIC_BUFFER buffer{};
+    buffer.Length = pending.frame->length();
+    buffer.Buffer = pending.frame->data();
+    SendCtx->Buffers.push_back(buffer);
+    SendCtx->Frames.push_back(std::move(pending.frame));
+    if (pending.trace.active() && SendCtx->SentAt != 0) {
+      core::LatencyTrace::RecordSend(pending.trace, SendCtx->SentAt);
+      SendCtx->Traces.push_back(pending.trace);
+    }
+  }
+  pending_frames_.clear();
+  SendCtx->TotalLength = pending_bytes_;
+  pending_bytes_ = 0;
+  // StreamSend 이후에는 SEND_COMPLETE 가 다른 스레드에서 SendCtx 를 지울 수 있음
+  size_t frameCount = SendCtx->Frames.size();
+  uint64_t totalLength = SendCtx->TotalLength;
+  inflight_bytes_.fetch_add(SendCtx->TotalLength, std::memory_order_acq_rel);
+
+  auto api = server_->api();
+  Record(FlightRecorder::Event::Flush, (uint32_t)totalLength, (uint32_t)frameCount);
+
+  // 4. 전송 (비동기)
   // ClientSendContext 파라미터(마지막 인자)에 우리가 만든 SendCtx를 넘깁니다.
   // 이 포인터는 SEND_COMPLETE 이벤트에서 다시 돌려받아 delete 할 것입니다.
+  // 뒤에 더 보낼 작업이 남아 있으면 DELAY_SEND 로 MsQuic 이 바로 패킷을 만들지 않게 한다.
   QUIC_STATUS Status = api->StreamSend(
-      hStream,
-      QuicBuf,
-      //(QUIC_BUFFER*)&RealVec,
-      1,
-      QUIC_SEND_FLAG_NONE,
+      stream_chat_,
+      SendCtx->Buffers.data(),
+      (uint32_t)SendCtx->Buffers.size(),
+      moreWorkQueued ? QUIC_SEND_FLAG_DELAY_SEND : QUIC_SEND_FLAG_NONE,
       SendCtx // ★ 중요: 콜백으로 넘겨줄 문맥 포인터
   );
 
   if (QUIC_FAILED(Status)) {
-    printf("[Error] StreamSend failed: 0x%x\n", Status);
+    QF_LOG_RATE_LIMITED(Error, Stream, 10, "StreamSend failed: 0x{:x}", (uint32_t)Status);
+    send_failures.Increment();
+    Record(FlightRecorder::Event::SendFailed, (uint32_t)Status);
+    inflight_bytes_.fetch_sub(SendCtx->TotalLength, std::memory_order_acq_rel);
     delete SendCtx; // 전송 실패 시 즉시 해제
+    return;
+  }
+
+  frames_sent.Increment(frameCount);
+  bytes_sent.Increment(totalLength);
+  send_batch_frames.Record(frameCount);
+  QF_LOG_TRACE(Stream, "FlushPendingFrames sent {} frames", frameCount);
+}
+
+void QuicConnection::ApplySlowConsumerPolicy() {
+  const uint64_t limit = outbound_limits_.MaxPendingBytes;
+
+  switch (outbound_limits_.Policy) {
+    case SlowConsumerPolicy::Conflate:
+      // 같은 key 의 프레임은 QueueFrame 에서 이미 대체했다. 그래도 넘으면 오래된 것부터 버린다.
+      [[fallthrough]];
+
+    case SlowConsumerPolicy::DropOldest: {
+      // 오래된 것부터 non-critical 프레임을 버려서 상한 아래로 맞춘다.
+      auto last = std::remove_if(pending_frames_.begin(), pending_frames_.end(),
+          [&](const PendingFrame& pending) {
+            if (pending_bytes_ <= limit || pending.frame->critical()) {
+              return false;
+            }
+            pending_bytes_ -= pending.frame->length();
+            CountDroppedFrames(1);
+            return true;
+          });
+      pending_frames_.erase(last, pending_frames_.end());
+
+      if (pending_bytes_ <= limit) {
+        return;
+      }
+      // critical 프레임만으로도 상한을 넘으면 더 버틸 수 없으므로 끊는다.
+      DisconnectSlowConsumer();
+      return;
+    }
+
+    case SlowConsumerPolicy::Disconnect:
+      DisconnectSlowConsumer();
+      return;
+  }
+}
+
+void QuicConnection::CountDroppedFrames(uint64_t count) {
+  dropped_frames_ += count;
+  // 버린 프레임은 다시 보내야 하므로 보낸 구간 기록을 믿을 수 없다.
+  room_cursors_.clear();
+  frames_dropped.Increment(count);
+  Record(FlightRecorder::Event::FramesDropped, Clamp32(count), (uint32_t)pending_frames_.size());
+}
+
+void QuicConnection::DisconnectSlowConsumer() {
+  uint32_t pendingFrames = (uint32_t)pending_frames_.size();
+  CountDroppedFrames(pending_frames_.size());
+  pending_frames_.clear();
+  pending_bytes_ = 0;
+
+  if (slow_consumer_kicked_ || server_ == nullptr || connection_ == nullptr) {
+    return;
+  }
+  slow_consumer_kicked_ = true;
+  slow_consumer_disconnects.Increment();
+  Record(FlightRecorder::Event::SlowConsumerKick, Clamp32(inflight_bytes()), pendingFrames);
+  DumpFlightRecorder("slow consumer");
+
+  QF_LOG_RATE_LIMITED(Warning, Connection, 20, "Slow consumer disconnected ({}), inflight: {}",
+                      (const void*)connection_, inflight_bytes());
+  server_->api()->ConnectionShutdown(connection_, QUIC_CONNECTION_SHUTDOWN_FLAG_NONE,
+                                     kSlowConsumerErrorCode);
+}
+
+bool QuicConnection::AdmitInboundMessage() {
+  if (rate_limit_kicked_) {
+    return false;
+  }
+
+  const auto& limits = inbound_limits_;
+  if (inbound_bucket_.TryConsume(limits.Messages, CoarseClock::NowMs())) {
+    consecutive_throttled_ = 0;
+    return true;
+  }
+
+  ++throttled_messages_;
+  ++consecutive_throttled_;
+  messages_throttled.Increment();
+  Record(FlightRecorder::Event::Throttled, consecutive_throttled_);
+
+  switch (limits.Policy) {
+    case ThrottlePolicy::Drop:
+      break;
+
+    case ThrottlePolicy::Penalize:
+      inbound_bucket_.Penalize(limits.Messages, limits.PenaltyTokens);
+      break;
+
+    case ThrottlePolicy::Disconnect:
+      if (consecutive_throttled_ >= limits.DisconnectAfter && server_ != nullptr && connection_ != nullptr) {
+        rate_limit_kicked_ = true;
+        rate_limit_disconnects.Increment();
+        Record(FlightRecorder::Event::RateLimitKick, Clamp32(throttled_messages_));
+        QF_LOG_RATE_LIMITED(Warning, Connection, 20, "Rate limit exceeded, disconnecting ({}), throttled: {}",
+                            (const void*)connection_, throttled_messages_);
+        server_->api()->ConnectionShutdown(connection_, QUIC_CONNECTION_SHUTDOWN_FLAG_NONE, kRateLimitErrorCode);
+      }
+      break;
+  }
+  return false;
+}
+
+void QuicConnection::OnSendComplete(SendBufferContext* context) {
+  if (context->Traces.empty() == false) {
+    uint64_t completed = core::LatencyTrace::Now();
+    for (const auto& trace : context->Traces) {
+      core::LatencyTrace::RecordComplete(trace, context->SentAt, completed, connection_);
+    }
+  }
+
+  uint64_t before = inflight_bytes_.fetch_sub(context->TotalLength, std::memory_order_acq_rel);
+  uint64_t after = before - context->TotalLength;
+
+  // 상한의 절반 아래로 내려오면 밀려있던 대기열 전송을 재개한다.
+  if (after < outbound_limits_.MaxInflightBytes / 2
+    && send_blocked_.load(std::memory_order_acquire)
+    && send_blocked_.exchange(false)) {
+    OnSendResumedAsync();
   }
+}
 
-  std::cout << "[QuicConnection] SendJsonMessage Success " << totalLength << std::endl;
+DEFINE_ASYNC_FUNCTION(QuicConnection, OnSendResumed) {
+  FlushPendingFrames(HasPendingTasks());
 }
 
 QUIC_STATUS QUIC_API QuicConnection::ServerConnectionCallback(HQUIC connection, void* context, QUIC_CONNECTION_EVENT* event) {
@@ -158,37 +574,49 @@ QUIC_STATUS QUIC_API QuicConnection::ServerConnectionCallback(HQUIC connection,
   auto quicConnection = std::static_pointer_cast<QuicConnection>(quicConnectionPtr->shared_from_this());
 
   if (quicConnection == nullptr) {
-    std::cerr << "[QuicServer] Connection is nullptr" << std::endl;
+    QF_LOG_ERROR(Connection, "Connection is nullptr");
     return QUIC_STATUS_INTERNAL_ERROR;
   }
 
   //auto quicConnection = std::make_shared<QuicConnection>(connectionPtr->connection());
-  auto api = QuicServer::GetInstance().api();
 
-  std::cout << "[QuicConnection] ServerConnectionCallback Called (" << connection << "),(" << event->Type << ")"<< std::endl;
+  QF_LOG_TRACE(Connection, "ServerConnectionCallback ({}), event {}", (const void*)connection, (int)event->Type);
 
   switch (event->Type) {
     // [연결 성공] 핸드셰이크 완료
     case QUIC_CONNECTION_EVENT_CONNECTED:{
-      std::cout << "[Conn] Client Connected!" << std::endl;
+      QF_LOG_DEBUG(Connection, "Client connected ({})", (const void*)connection);
+      quicConnection->Record(FlightRecorder::Event::Connected);
+      quicConnection->FinishHandshake();
       //quicConnection->SendJsonMessage("Welcome to Server");
       break;
     }
     case QUIC_CONNECTION_EVENT_SHUTDOWN_INITIATED_BY_TRANSPORT: {
-      std::cout << "[Conn] Client Connection SHUTDOWN INITIATED BY TRANSPORT!" << std::endl;
-      QUIC_STATUS innerStatus = event->SHUTDOWN_INITIATED_BY_TRANSPORT.Status;
-      QUIC_STATUS innerErrorCode = event->SHUTDOWN_INITIATED_BY_TRANSPORT.ErrorCode;
-
+      transport_shutdowns.Increment();
       // Status 코드를 찍어봐야 합니다.
       // 리눅스/맥에서는 0x..., 윈도우에서는 음수/양수 등으로 나옴
-      std::cout << "[Conn] Transport Shutdown! Status: " << innerStatus << "," << innerErrorCode << std::endl;
+      QF_LOG_DEBUG(Connection, "Shutdown initiated by transport ({}), status: 0x{:x}, error code: {}",
+                   (const void*)connection, (uint32_t)event->SHUTDOWN_INITIATED_BY_TRANSPORT.Status,
+                   (uint64_t)event->SHUTDOWN_INITIATED_BY_TRANSPORT.ErrorCode);
+      quicConnection->Record(FlightRecorder::Event::TransportShutdown,
+                             (uint32_t)event->SHUTDOWN_INITIATED_BY_TRANSPORT.Status);
+      quicConnection->DumpFlightRecorder("transport shutdown");
+      break;
+    }
+
+    case QUIC_CONNECTION_EVENT_SHUTDOWN_INITIATED_BY_PEER: {
+      QF_LOG_DEBUG(Connection, "Shutdown initiated by peer ({}), error code: {}", (const void*)connection,
+                   (uint64_t)event->SHUTDOWN_INITIATED_BY_PEER.ErrorCode);
+      quicConnection->Record(FlightRecorder::Event::PeerShutdown, (uint32_t)event->SHUTDOWN_INITIATED_BY_PEER.ErrorCode);
       break;
     }
 
     // [연결 종료]
     case QUIC_CONNECTION_EVENT_SHUTDOWN_COMPLETE: {
-      std::cout << "[Conn] Closed." << std::endl;
-      manager::ConnectionManager::GetInstance().OnCloseConnection(quicConnection);
+      QF_LOG_DEBUG(Connection, "Closed ({})", (const void*)connection);
+      quicConnection->Record(FlightRecorder::Event::ShutdownComplete);
+      quicConnection->FinishHandshake();
+      quicConnection->connection_manager_->OnCloseConnection(quicConnection);
 
       break;
     }
@@ -196,13 +624,14 @@ QUIC_STATUS QUIC_API QuicConnection::ServerConnectionCallback(HQUIC connection,
     // [스트림 수신] 클라이언트가 먼저 스트림을 열어서 데이터를 보냈을 때
     case QUIC_CONNECTION_EVENT_PEER_STREAM_STARTED: {
       // 이 스트림을 처리할 콜백 지정
+      quicConnection->Record(FlightRecorder::Event::StreamStarted);
       quicConnection->OnChatStreamStartedAsync(event->PEER_STREAM_STARTED.Stream);
-      std::cout << "[Conn] Connection Event Pear Stream Started!" << std::endl;
+      QF_LOG_DEBUG(Connection, "Peer stream started ({})", (const void*)connection);
       break;
     }
 
     default: {
-      std::cout << "[Conn] Connection Event Type!" << event->Type <<std::endl;
+      QF_LOG_TRACE(Connection, "Unhandled connection event {}", (int)event->Type);
       break;
     }
 
@@ -210,31 +639,62 @@ QUIC_STATUS QUIC_API QuicConnection::ServerConnectionCallback(HQUIC connection,
   return QUIC_STATUS_SUCCESS;
 }
 
+std::string QuicConnection::RenderFlightRecorder() const {
+  if (recorder_ == nullptr) {
+    return {};
+  }
+  return recorder_->Render();
+}
+
+void QuicConnection::DumpFlightRecorder(std::string_view reason) {
+  if (recorder_ == nullptr || FlightRecorder::TryAcquireDump() == false) {
+    return;
+  }
+  // 로그 레코드 하나에 담기지 않으므로 한 줄씩 남긴다.
+  std::string text = recorder_->Render();
+  QF_LOG_WARN(Connection, "Flight recorder ({}, {}): {}", (const void*)connection_, reason,
+              std::string_view(text).substr(0, text.find('\n')));
+  std::string_view rest(text);
+  rest.remove_prefix(std::min(rest.size(), rest.find('\n') + 1));
+  while (rest.empty() == false) {
+    auto end = rest.find('\n');
+    QF_LOG_WARN(Connection, "{}", rest.substr(0, end));
+    rest.remove_prefix(end == std::string_view::npos ? rest.size() : end + 1);
+  }
+}
+
+void QuicConnection::FinishHandshake() {
+  if (admission_ != nullptr) {
+    admission_->OnHandshakeFinished();
+    admission_ = nullptr;
+  }
+}
+
 DEFINE_ASYNC_FUNCTION(QuicConnection, OnChatStreamStarted, HQUIC hStream){
   if (hStream == nullptr) {
-    std::cerr << "[QuicConnection] Stream is nullptr" << std::endl;
+    QF_LOG_ERROR(Stream, "Stream is nullptr");
     return;
   }
   stream_chat_ = hStream;
   auto api = server_->api();
   if (api == nullptr) {
-    std::cerr << "[QuicConnection] Server API is nullptr" << std::endl;
+    QF_LOG_ERROR(Stream, "Server API is nullptr");
     return ;
   }
 
   api->SetCallbackHandler(stream_chat_, (void*)ServerChatCallback, this);
-  std::cout << "[QuicConnection] Set ServerChatCallback Handler" << std::endl;
+  QF_LOG_TRACE(Stream, "Set ServerChatCallback handler");
 }
 
 DEFINE_ASYNC_FUNCTION(QuicConnection, OnChatStreamClosed){
   if (stream_chat_== nullptr) {
-    std::cerr << "[QuicConnection] Chat Stream is nullptr" << std::endl;
+    QF_LOG_ERROR(Stream, "Chat stream is nullptr");
     return;
   }
 
   auto api = server_->api();
   if (api == nullptr) {
-    std::cerr << "[QuicServer] Server API is nullptr" << std::endl;
+    QF_LOG_ERROR(Stream, "Server API is nullptr");
     return ;
   }
 
@@ -242,18 +702,31 @@ DEFINE_ASYNC_FUNCTION(QuicConnection, OnChatStreamClosed){
   stream_chat_ = nullptr;
 }
 
-DEFINE_ASYNC_FUNCTION(QuicConnection, OnChatStreamReceived, QUIC_STREAM_EVENT* event) {
+DEFINE_ASYNC_FUNCTION(QuicConnection, OnChatStreamReceived, QUIC_STREAM_EVENT* event, uint64_t received) {
+  core::MessageTrace trace = core::LatencyTrace::Begin(received);
   const QUIC_BUFFER* buffer = event->RECEIVE.Buffers;
   uint32_t bufferCount = event->RECEIVE.BufferCount;
 
   std::string outputString;
 
   if (QuicBufferReader::TryParseStringMessage(buffer, bufferCount, outputString) == false) {
-    std::cerr << "[QuicStream] Receive Buffer Error" << bufferCount << "!" << std::endl;
+    QF_LOG_RATE_LIMITED(Warning, Stream, 10, "Receive buffer parse failed ({} buffers)", bufferCount);
+    receive_parse_failures.Increment();
+    Record(FlightRecorder::Event::ParseFailed, bufferCount);
+    return;
+  }
+  messages_received.Increment();
+  Record(FlightRecorder::Event::MessageReceived, Clamp32(outputString.size()));
+  bytes_received.Increment(outputString.size() + OutboundFrame::kHeaderSize);
+  message_size.Record(outputString.size());
+
+  // 디코딩/브로드캐스트 전에 가장 싼 지점에서 거른다.
+  if (AdmitInboundMessage() == false) {
     return;
   }
 
-  manager::ConnectionManager::GetInstance().OnReceiveChatMessage(std::static_pointer_cast<QuicConnection>(shared_from_this()), outputString);
+  connection_manager_->OnReceiveChatMessage(std::static_pointer_cast<QuicConnection>(shared_from_this()), outputString,
+                                            trace);
 }
 
 // static callback
@@ -261,31 +734,34 @@ QUIC_STATUS QuicConnection::ServerChatCallback(HQUIC hStream, void* context, QUI
   auto quicConnectionPtr = static_cast<QuicConnection*>(context);
   auto quicConnection = std::static_pointer_cast<QuicConnection>(quicConnectionPtr->shared_from_this());
 
-  std::cout << "[QuicConnection] ServerMessageCallback Event Type! " << event->Type << std::endl;
+  QF_LOG_TRACE(Stream, "ServerChatCallback event {}", (int)event->Type);
 
   switch (event->Type) {
     case QUIC_STREAM_EVENT_RECEIVE:
-      std::cout << "[QuicStream] Receive Event Type!" << std::endl;
-      quicConnection->OnChatStreamReceivedAsync(event);
+      quicConnection->Record(FlightRecorder::Event::StreamReceive, Clamp32(event->RECEIVE.TotalBufferLength),
+                             event->RECEIVE.BufferCount);
+      quicConnection->OnChatStreamReceivedAsync(event, core::LatencyTrace::Stamp());
       break;
     case QUIC_STREAM_EVENT_SEND_COMPLETE:
       // ★ 핵심: 전송이 완료되었으므로 힙에 할당했던 JSON 문자열 해제
       if (event->SEND_COMPLETE.ClientContext) {
         auto payload = (SendBufferContext*)event->SEND_COMPLETE.ClientContext;
 
-        printf("[DEBUG] Real Buffer Address (Heap): %p\n", payload->RawBuffer);
-        printf("[DEBUG] Intended Length: %u\n", payload->TotalLength);
+        QF_LOG_TRACE(Stream, "Send complete, frames: {}, length: {}", payload->Frames.size(), payload->TotalLength);
+        quicConnection->Record(FlightRecorder::Event::SendComplete, payload->TotalLength,
+                               event->SEND_COMPLETE.Canceled ? 1u : 0u);
 
-        delete payload; // 메모리 해제!
+        quicConnection->OnSendComplete(payload);
+        delete payload; // 메모리 해제! (프레임 참조도 함께 해제)
       }
-      std::cout << "[QuicStream] STREAM Event SEND COMPLETE!" << std::endl;
       break;
 
     case QUIC_STREAM_EVENT_SHUTDOWN_COMPLETE:
+      quicConnection->Record(FlightRecorder::Event::StreamClosed);
       quicConnection->OnChatStreamClosedAsync();
       break;
     default:
-      std::cout << "[QuicStream] Stream Event Type!" << event->Type << std::endl;
+      QF_LOG_TRACE(Stream, "Unhandled stream event {}", (int)event->Type);
       break;
 
       // ... 기타 에러 처리 ...
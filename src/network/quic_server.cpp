@@ -1,64 +1,160 @@
 #include "network/quic_server.hpp"
 
 #include <cstring>
-#include <iostream>
+#include <format>
 
+#include "common/logger.hpp"
+#include "config/server_config.hpp"
+#include "core/metrics.hpp"
 #include "manager/connection_manager.hpp"
+#include "network/admission_controller.hpp"
 #include "network/quic_config_manager.hpp"
 #include "network/quic_connection.hpp"
 
 namespace quicflow {
 namespace network {
 
-QuicServer::QuicServer() {
-  std::cout << "QuicServer Instance Created" << std::endl;
+namespace {
+
+core::Counter& connections_accepted = core::Metrics::GetCounter(
+    "quicflow_connections_accepted_total", "Connections accepted by a listener (all shards)");
+core::Counter& connection_setup_failures = core::Metrics::GetCounter(
+    "quicflow_connection_setup_failures_total", "Admitted connections that failed configuration or setup");
+
+const char* AdmissionRejectName(AdmissionReject reason) {
+  switch (reason) {
+    case AdmissionReject::Connections:
+      return "connections";
+    case AdmissionReject::Handshakes:
+      return "handshakes";
+    case AdmissionReject::Overloaded:
+      return "overloaded";
+    case AdmissionReject::Rate:
+      return "rate";
+    case AdmissionReject::kCount:
+      break;
+  }
+  return "unknown";
+}
+
+}  // namespace
+
+QuicServer::QuicServer()
+    : connection_manager_(std::make_unique<manager::ConnectionManager>()),
+      admission_(std::make_unique<AdmissionController>(*connection_manager_)) {
+  QF_LOG_DEBUG(Server, "QuicServer instance created");
 }
 
 
-const QUIC_API_TABLE* QuicServer::api() {
-  if (config_ == nullptr) {
+const std::shared_ptr<QuicConfigManager> QuicServer::config() {
+  if (endpoints_.empty()) {
     return nullptr;
   }
-  return config_->api();
+  return endpoints_.front()->config;
 }
 
-QUIC_STATUS QuicServer::InitQuicServer(uint16_t port) {
+QUIC_STATUS QuicServer::InitQuicServer(const config::ServerConfig& serverConfig) {
 
-  port_ = port;
+  port_ = serverConfig.Port;
   is_listening_ = false;
-  listener_ = nullptr;
-
-  // Create QUIC configuration with HTTP/3 and WebTransport ALPN.
-  // Why: We support multiple ALPN protocols for backward compatibility and
-  //      future extensibility (WebTransport for real-time chat).
-  //QuicConfigManager config(api, {"h3", "h3-29", "webtransport"});
-  std::shared_ptr<QuicConfigManager> config(new QuicConfigManager());
+  endpoints_.clear();
+
+  // Create one registration + configuration per profile.
+  // Why: Each profile (e.g. low-latency chat, max-throughput bulk) runs on
+  //      its own MsQuic worker pool. The listeners share the UDP port and
+  //      MsQuic routes a new connection to the listener whose ALPN matched.
+  for (const auto& profile : config::ServerConfigLoader::ResolveProfiles(serverConfig)) {
+    std::shared_ptr<QuicConfigManager> config(new QuicConfigManager());
+
+    if (config->InitializeConfig(serverConfig, profile) == false) {
+      QF_LOG_ERROR(Server, "Failed to initialize QUIC configuration '{}': {}", profile.Name,
+                   config->error_message());
+      endpoints_.clear();
+      return QUIC_STATUS_INTERNAL_ERROR;
+    }
 
-  if (config->InitializeConfig() == false) {
-    std::cerr << "[QuicFlow] Failed to initialize QUIC configuration: "
-              << config->error_message() << std::endl;
-    return QUIC_STATUS_INTERNAL_ERROR;
+    auto endpoint = std::make_unique<Endpoint>();
+    endpoint->server = this;
+    endpoint->config = std::move(config);
+    endpoints_.push_back(std::move(endpoint));
   }
-  config_ = config;
 
-  if (config_ == nullptr || !config_->is_valid()) {
+  if (endpoints_.empty() || !endpoints_.front()->config->is_valid()) {
     error_message_ = "QuicConfigManager is not valid";
 
     return QUIC_STATUS_INTERNAL_ERROR;
   }
+  api_ = endpoints_.front()->config->api();
 
+  RegisterMetrics();
   return QUIC_STATUS_SUCCESS;
 }
 
+void QuicServer::RegisterMetrics() {
+  // shard 별 값은 이미 ConnectionManager / AdmissionController 가 세고 있으므로 읽을 때 가져온다.
+  // owner 는 이동(move)해도 주소가 바뀌지 않는 admission_ 으로 한다.
+  const void* owner = admission_.get();
+  core::Metrics::RemoveCallbacks(owner);
+
+  std::string shard = std::format("port=\"{}\"", port_);
+  const manager::ConnectionManager* connections = connection_manager_.get();
+  const AdmissionController* admission = admission_.get();
+
+  core::Metrics::AddCallback(owner, core::Metrics::Type::Gauge, "quicflow_connections", "Open connections per shard",
+                             shard, [connections] { return (double)connections->connection_count(); });
+  core::Metrics::AddCallback(owner, core::Metrics::Type::Gauge, "quicflow_handshakes_in_flight",
+                             "Admitted connections still in handshake", shard,
+                             [admission] { return (double)admission->handshakes_in_flight(); });
+  core::Metrics::AddCallback(owner, core::Metrics::Type::Gauge, "quicflow_admission_level",
+                             "0 normal, 1 throttled, 2 overloaded", shard,
+                             [admission] { return (double)admission->level(); });
+  core::Metrics::AddCallback(owner, core::Metrics::Type::Gauge, "quicflow_admission_pressure_percent",
+                             "Highest load signal relative to its limit at the last update", shard,
+                             [admission] { return (double)admission->pressure_percent(); });
+  for (size_t i = 0; i < (size_t)AdmissionReject::kCount; ++i) {
+    auto reason = (AdmissionReject)i;
+    core::Metrics::AddCallback(owner, core::Metrics::Type::Counter, "quicflow_connections_refused_total",
+                               "New connections refused by admission control",
+                               std::format("{},reason=\"{}\"", shard, AdmissionRejectName(reason)),
+                               [admission, reason] { return (double)admission->rejected(reason); });
+  }
+}
+
+bool QuicServer::UpdateSettings(const config::ServerConfig& serverConfig) {
+  if (endpoints_.empty()) {
+    error_message_ = "QuicConfigManager is not available";
+    return false;
+  }
+
+  // 프로필 구성(이름/ALPN)은 재시작해야 바뀌므로 이름이 같은 프로필의 QUIC_SETTINGS 만 적용한다.
+  for (const auto& profile : config::ServerConfigLoader::ResolveProfiles(serverConfig)) {
+    for (const auto& endpoint : endpoints_) {
+      if (endpoint->config->profile_name() != profile.Name) {
+        continue;
+      }
+      if (endpoint->config->UpdateSettings(profile.Quic) == false) {
+        error_message_ = profile.Name + ": " + endpoint->config->error_message();
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 QuicServer::QuicServer(QuicServer&& other) noexcept
-    : config_(other.config_),
-      listener_(other.listener_),
+    : endpoints_(std::move(other.endpoints_)),
+      connection_manager_(std::move(other.connection_manager_)),
+      admission_(std::move(other.admission_)),
+      api_(other.api_),
       port_(other.port_),
       is_listening_(other.is_listening_),
       error_message_(std::move(other.error_message_)){
+  for (auto& endpoint : endpoints_) {
+    endpoint->server = this;
+  }
   // Reset source object to prevent double cleanup.
-  other.config_ = nullptr;
-  other.listener_ = nullptr;
+  other.endpoints_.clear();
+  other.api_ = nullptr;
   other.port_ = 0;
   other.is_listening_ = false;
   other.error_message_.clear();
@@ -67,17 +163,25 @@ QuicServer::QuicServer(QuicServer&& other) noexcept
 QuicServer& QuicServer::operator=(QuicServer&& other) noexcept {
   if (this != &other) {
     Cleanup();
+    if (admission_ != nullptr) {
+      core::Metrics::RemoveCallbacks(admission_.get());
+    }
 
-    config_ = other.config_;
-    listener_ = other.listener_;
+    endpoints_ = std::move(other.endpoints_);
+    connection_manager_ = std::move(other.connection_manager_);
+    admission_ = std::move(other.admission_);
+    for (auto& endpoint : endpoints_) {
+      endpoint->server = this;
+    }
 
+    api_ = other.api_;
     port_ = other.port_;
     is_listening_ = other.is_listening_;
     error_message_ = std::move(other.error_message_);
 
     // Reset source object.
-    other.config_ = nullptr;
-    other.listener_ = nullptr;
+    other.endpoints_.clear();
+    other.api_ = nullptr;
     other.port_ = 0;
     other.is_listening_ = false;
     other.error_message_.clear();
@@ -85,7 +189,12 @@ QuicServer& QuicServer::operator=(QuicServer&& other) noexcept {
   return *this;
 }
 
-QuicServer::~QuicServer() { Cleanup(); }
+QuicServer::~QuicServer() {
+  Cleanup();
+  if (admission_ != nullptr) {
+    core::Metrics::RemoveCallbacks(admission_.get());
+  }
+}
 
 bool QuicServer::Start() {
   if (is_listening_) {
@@ -93,29 +202,11 @@ bool QuicServer::Start() {
     return false;
   }
 
-  if (config_ == nullptr) {
+  if (endpoints_.empty()) {
     error_message_ = "QuicApi or QuicConfigManager is not available";
     return false;
   }
 
-  // Open the listener with our callback function.
-  // Why: ListenerCallback is a static method, so we pass 'this' as context
-  //      to access instance members.
-  auto api = config_->api();
-  auto config= config_->configuration();
-  auto registration = config_->registration();
-
-  QUIC_STATUS status = api->ListenerOpen(
-      registration,  // Registration handle
-      ServerListenerCallback,   // Static callback function
-      this,               // Context (QuicServer*)
-      &listener_);
-
-  if (QUIC_FAILED(status)) {
-    error_message_ = "Failed to open listener: status " + std::to_string(status);
-    return false;
-  }
-
   // Start listening on the specified port.
   // Why: QUIC_ADDRESS_FAMILY_UNSPEC allows both IPv4 and IPv6.
   //      We bind to INADDR_ANY (0.0.0.0) to accept connections from any interface.
@@ -123,55 +214,109 @@ bool QuicServer::Start() {
   QuicAddrSetFamily(&address, QUIC_ADDRESS_FAMILY_UNSPEC);
   QuicAddrSetPort(&address, port_);
 
-  auto buffers = config_->alpn_buffers();
+  for (auto& endpoint : endpoints_) {
+    // Open the listener with our callback function.
+    // Why: ListenerCallback is a static method, so we pass the endpoint as
+    //      context to know which profile accepted the connection.
+    auto api = endpoint->config->api();
+    auto registration = endpoint->config->registration();
+
+    QUIC_STATUS status = api->ListenerOpen(
+        registration,  // Registration handle (profile's execution profile)
+        ServerListenerCallback,   // Static callback function
+        endpoint.get(),           // Context (Endpoint*)
+        &endpoint->listener);
+
+    if (QUIC_FAILED(status)) {
+      error_message_ = "Failed to open listener: status " + std::to_string(status);
+      StopListeners();
+      Cleanup();
+      return false;
+    }
 
-  // ListenerStart signature: (HQUIC, const QUIC_BUFFER*, uint32_t, const QUIC_ADDR*)
-  // Why: We pass nullptr for ALPN buffers to use the configuration's ALPN.
-  //      AlpnBufferCount must be 0 when AlpnBuffers is nullptr.
-  status = api->ListenerStart(listener_, &buffers[0], 1, &address);
+    const auto& buffers = endpoint->config->alpn_buffers();
 
-  if (QUIC_FAILED(status)) {
-    error_message_ = "Failed to start listener on port " + std::to_string(port_) +
-                     ": status " + std::to_string(status);
-    Cleanup();
-    return false;
+    // ListenerStart signature: (HQUIC, const QUIC_BUFFER*, uint32_t, const QUIC_ADDR*)
+    // Why: The listener advertises the profile's ALPNs; the configuration
+    //      was opened with the same list. Listeners on the same port must
+    //      not share an ALPN (checked by ServerConfigLoader).
+    status = api->ListenerStart(endpoint->listener, &buffers[0], static_cast<uint32_t>(buffers.size()), &address);
+
+    if (QUIC_FAILED(status)) {
+      error_message_ = "Failed to start listener '" + endpoint->config->profile_name() +
+                       "' on port " + std::to_string(port_) + ": status " + std::to_string(status);
+      StopListeners();
+      Cleanup();
+      return false;
+    }
+    QF_LOG_INFO(Server, "Profile '{}' listening with {} ALPN(s)", endpoint->config->profile_name(), buffers.size());
   }
 
   is_listening_ = true;
-  std::cout << "[QuicServer] Started listening on UDP port " << port_ << std::endl;
+  QF_LOG_INFO(Server, "Started listening on UDP port {}", port_);
   return true;
 }
 
 void QuicServer::Stop() noexcept {
-  if (!is_listening_) {
+  bool wasListening = is_listening_;
+
+  StopListeners();
+
+  Cleanup();
+  if (wasListening) {
+    QF_LOG_INFO(Server, "Stopped listening on port {}", port_);
+  }
+}
+
+void QuicServer::Shutdown() noexcept {
+  // 1. 새 connection 을 받지 않는다. (ListenerClose 는 STOP_COMPLETE 까지 기다린다)
+  Stop();
+  if (api_ == nullptr) {
     return;
   }
 
-  if (listener_ != nullptr) {
-    auto api = config_->api();
-    api->ListenerStop(listener_);
+  // 2. 열려 있는 connection 의 종료를 시작한다. 방 정리는 각 connection 의 SHUTDOWN_COMPLETE 에서 한다.
+  connection_manager_->ForEachConnection([this](const std::shared_ptr<QuicConnection>& connection) {
+    connection->Shutdown(api_, QuicConnection::kServerShutdownErrorCode);
+  });
+
+  // 3. registration 을 닫는다. 모든 connection 의 SHUTDOWN_COMPLETE 가 끝날 때까지 기다리고,
+  //    마지막 registration 이면 MsQuicClose 까지 한다.
+  //    SHUTDOWN_COMPLETE(CloseConnection)가 api() 를 쓰므로 api_ 는 모두 닫은 뒤에 지운다.
+  for (auto& endpoint : endpoints_) {
+    endpoint->config->Close();
   }
+  api_ = nullptr;
+  QF_LOG_INFO(Server, "Shut down server on port {} ({} connection(s) left)", port_,
+              connection_manager_->connection_count());
+}
 
-  Cleanup();
-  std::cout << "[QuicServer] Stopped listening on port " << port_ << std::endl;
+void QuicServer::StopListeners() noexcept {
+  for (auto& endpoint : endpoints_) {
+    if (endpoint->listener != nullptr) {
+      endpoint->config->api()->ListenerStop(endpoint->listener);
+    }
+  }
 }
+
 QUIC_STATUS QUIC_API QuicServer::ServerListenerCallback(HQUIC listener,
                                                   void* context,
                                                   QUIC_LISTENER_EVENT* event) {
-  // Cast context back to QuicServer instance.
+  // Cast context back to the endpoint (profile) that owns this listener.
   // Why: Static method cannot access instance members, so we use the context
   //      pointer that was passed during ListenerOpen.
-  QuicServer* server = static_cast<QuicServer*>(context);
-  if (server == nullptr) {
+  Endpoint* endpoint = static_cast<Endpoint*>(context);
+  if (endpoint == nullptr || endpoint->server == nullptr) {
     return QUIC_STATUS_INVALID_PARAMETER;
   }
+  QuicServer* server = endpoint->server;
 
-  auto config = server->config();
+  auto config = endpoint->config;
   if (config == nullptr) {
     return QUIC_STATUS_INVALID_PARAMETER;
   }
 
-  std::cout << "ServerListenerCallback called (" << event->Type << ")" <<std::endl;
+  QF_LOG_TRACE(Server, "ServerListenerCallback event {}", (int)event->Type);
 
   auto api = config->api();
   switch (event->Type) {
@@ -181,14 +326,24 @@ QUIC_STATUS QUIC_API QuicServer::ServerListenerCallback(HQUIC listener,
       //      The connection handle is then passed to the user callback.
       HQUIC hConnection= event->NEW_CONNECTION.Connection;
 
-      std::cout << "[QuicServer] QUIC_LISTENER_EVENT_NEW_CONNECTION called" << std::endl;
+      QF_LOG_TRACE(Server, "New connection ({})", (const void*)hConnection);
+
+      // Admission control: refuse before any per-connection work is done.
+      // Why: Returning a failure here makes MsQuic close the connection with
+      //      CONNECTION_REFUSED, which costs far less than finishing the
+      //      handshake and closing it afterwards.
+      auto& admission = server->admission();
+      if (admission.TryAdmit() == false) {
+        return QUIC_STATUS_CONNECTION_REFUSED;
+      }
 
       // Accept the connection with our configuration.
       QUIC_STATUS status = api->ConnectionSetConfiguration(hConnection, config->configuration());
 
       if (QUIC_FAILED(status)) {
-        std::cerr << "[QuicServer] Failed to set connection configuration: "
-                  << status << std::endl;
+        QF_LOG_RATE_LIMITED(Error, Server, 10, "Failed to set connection configuration: 0x{:x}", (uint32_t)status);
+        connection_setup_failures.Increment();
+        admission.OnHandshakeFinished();
         return status;
       }
 
@@ -198,17 +353,24 @@ QUIC_STATUS QUIC_API QuicServer::ServerListenerCallback(HQUIC listener,
       try {
         auto newConnection = std::make_shared<QuicConnection>(hConnection);
 
-        auto status = newConnection->InitConnection(server);
+        auto status = newConnection->InitConnection(server, config);
         if (QUIC_FAILED(status)) {
-          std::cerr << "[QuicServer] Failed to init connection: " << status << std::endl;
+          QF_LOG_RATE_LIMITED(Error, Server, 10, "Failed to init connection: 0x{:x}", (uint32_t)status);
+          connection_setup_failures.Increment();
+          admission.OnHandshakeFinished();
           return QUIC_STATUS_INTERNAL_ERROR;
         }
 
-        manager::ConnectionManager::GetInstance().OnNewConnection(newConnection);
+        server->connection_manager().OnNewConnection(newConnection);
+        // 이제부터는 connection 이 CONNECTED / SHUTDOWN_COMPLETE 에서 handshake 종료를 알린다.
+        // (connection 이벤트는 이 콜백이 끝난 뒤 같은 worker 에서 전달된다)
+        newConnection->TrackHandshake(&admission);
+        connections_accepted.Increment();
 
       } catch (const std::exception& e) {
-        std::cerr << "[QuicServer] Exception in connection callback: " << e.what()
-                  << std::endl;
+        QF_LOG_RATE_LIMITED(Error, Server, 10, "Exception in connection callback: {}", e.what());
+        connection_setup_failures.Increment();
+        admission.OnHandshakeFinished();
         return QUIC_STATUS_INTERNAL_ERROR;
       }
 
@@ -217,7 +379,7 @@ QUIC_STATUS QUIC_API QuicServer::ServerListenerCallback(HQUIC listener,
 
     case QUIC_LISTENER_EVENT_STOP_COMPLETE:
       // Listener has stopped (can be used for cleanup if needed).
-      std::cout << "[QuicServer] Listener stop completed" << std::endl;
+      QF_LOG_INFO(Server, "Listener stop completed");
       return QUIC_STATUS_SUCCESS;
 
     default:
@@ -227,9 +389,12 @@ QUIC_STATUS QUIC_API QuicServer::ServerListenerCallback(HQUIC listener,
 }
 
 void QuicServer::Cleanup() noexcept {
-  if (listener_ != nullptr) {
-    //api_->ListenerClose(listener_);
-    listener_ = nullptr;
+  for (auto& endpoint : endpoints_) {
+    if (endpoint->listener != nullptr) {
+      // listener 를 닫은 뒤에는 Endpoint(context)를 가리키는 콜백이 오지 않는다.
+      endpoint->config->api()->ListenerClose(endpoint->listener);
+      endpoint->listener = nullptr;
+    }
   }
 
   is_listening_ = false;
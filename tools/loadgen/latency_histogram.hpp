@@ -0,0 +1,142 @@
+//
+// QuicFlow-CPP - Latency Histogram for Load Generation
+//
+
+#ifndef QUICFLOWCPP_LATENCY_HISTOGRAM_HPP
+#define QUICFLOWCPP_LATENCY_HISTOGRAM_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace quicflow {
+namespace tools {
+
+// ns 단위 지연 히스토그램 (log-linear, 옥타브당 2^kSubBucketBits 칸)
+// Why: 서버 지표용 core::Histogram 은 옥타브당 8칸(최대 12.5% 오차)이라 빌드 간 수 % 차이를
+//      비교하기에는 거칠다. 여기서는 128칸(< 0.8%)을 쓰고, 대신 프로세스에 하나만 둔다.
+//
+// 여러 MsQuic worker 가 동시에 기록하므로 스레드마다 shard 를 골라 relaxed atomic 으로 센다.
+class LatencyHistogram {
+public:
+  static constexpr uint32_t kSubBucketBits = 7;
+  static constexpr uint32_t kSubBuckets = 1u << kSubBucketBits;
+  static constexpr size_t kBucketCount = (64 - kSubBucketBits + 1) * kSubBuckets;
+  static constexpr size_t kShards = 16;
+
+  struct Summary {
+    uint64_t count = 0;
+    uint64_t min = 0;
+    uint64_t max = 0;
+    double mean = 0;
+    uint64_t p50 = 0;
+    uint64_t p90 = 0;
+    uint64_t p99 = 0;
+    uint64_t p999 = 0;
+    uint64_t p9999 = 0;
+  };
+
+  LatencyHistogram() : shards_(std::make_unique<Shard[]>(kShards)) {}
+
+  void Record(uint64_t value) noexcept {
+    Shard& shard = shards_[ShardIndex()];
+    shard.buckets[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    shard.sum.fetch_add(value, std::memory_order_relaxed);
+    uint64_t min = shard.min.load(std::memory_order_relaxed);
+    while (value < min && shard.min.compare_exchange_weak(min, value, std::memory_order_relaxed) == false) {
+    }
+    uint64_t max = shard.max.load(std::memory_order_relaxed);
+    while (value > max && shard.max.compare_exchange_weak(max, value, std::memory_order_relaxed) == false) {
+    }
+  }
+
+  // 기록이 끝난 뒤 호출한다. (동시에 불러도 되지만 그 순간의 근사값)
+  Summary Summarize() const {
+    std::vector<uint64_t> merged(kBucketCount, 0);
+    Summary summary;
+    summary.min = std::numeric_limits<uint64_t>::max();
+    uint64_t sum = 0;
+    for (size_t s = 0; s < kShards; ++s) {
+      const Shard& shard = shards_[s];
+      for (size_t i = 0; i < kBucketCount; ++i) {
+        uint64_t count = shard.buckets[i].load(std::memory_order_relaxed);
+        merged[i] += count;
+        summary.count += count;
+      }
+      sum += shard.sum.load(std::memory_order_relaxed);
+      summary.min = std::min(summary.min, shard.min.load(std::memory_order_relaxed));
+      summary.max = std::max(summary.max, shard.max.load(std::memory_order_relaxed));
+    }
+    if (summary.count == 0) {
+      return Summary{};
+    }
+    summary.mean = (double)sum / (double)summary.count;
+    summary.p50 = Percentile(merged, summary, 0.5);
+    summary.p90 = Percentile(merged, summary, 0.9);
+    summary.p99 = Percentile(merged, summary, 0.99);
+    summary.p999 = Percentile(merged, summary, 0.999);
+    summary.p9999 = Percentile(merged, summary, 0.9999);
+    return summary;
+  }
+
+  static constexpr size_t BucketIndex(uint64_t value) {
+    if (value < kSubBuckets) {
+      return (size_t)value;
+    }
+    uint32_t exponent = (uint32_t)std::bit_width(value) - kSubBucketBits - 1;
+    return (size_t)((exponent + 1) * kSubBuckets + ((value >> exponent) - kSubBuckets));
+  }
+
+  // 칸의 가운데 값 (보고용)
+  static constexpr uint64_t BucketMidpoint(size_t index) {
+    if (index < kSubBuckets) {
+      return index;
+    }
+    uint32_t exponent = (uint32_t)(index / kSubBuckets) - 1;
+    uint64_t lower = (kSubBuckets + index % kSubBuckets) << exponent;
+    return lower + ((1ull << exponent) >> 1);
+  }
+
+private:
+  struct alignas(64) Shard {
+    std::array<std::atomic<uint64_t>, kBucketCount> buckets{};
+    std::atomic<uint64_t> sum{0};
+    std::atomic<uint64_t> min{std::numeric_limits<uint64_t>::max()};
+    std::atomic<uint64_t> max{0};
+  };
+
+  static size_t ShardIndex() noexcept {
+    static std::atomic<size_t> next{0};
+    thread_local const size_t index = next.fetch_add(1, std::memory_order_relaxed) % kShards;
+    return index;
+  }
+
+  // 양 끝은 실제 min/max 로 잘라서 칸 가운데 값이 범위를 넘지 않게 한다.
+  static uint64_t Percentile(const std::vector<uint64_t>& buckets, const Summary& summary, double q) {
+    auto rank = (uint64_t)(q * (double)summary.count);
+    if (rank >= summary.count) {
+      rank = summary.count - 1;
+    }
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+      seen += buckets[i];
+      if (seen > rank) {
+        return std::clamp(BucketMidpoint(i), summary.min, summary.max);
+      }
+    }
+    return summary.max;
+  }
+
+  std::unique_ptr<Shard[]> shards_;
+};
+
+}  // namespace tools
+}  // namespace quicflow
+
+#endif  // QUICFLOWCPP_LATENCY_HISTOGRAM_HPP
@@ -0,0 +1,516 @@
+//
+// QuicFlow-CPP - QUIC Load Generator
+//
+
+#include "loadgen/load_generator.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <queue>
+#include <random>
+#include <thread>
+#include <utility>
+
+#include "network/chat_protocol_decoder.hpp"
+#include "network/chat_protocol_encoder.hpp"
+#include "network/quic_protocol.hpp"
+
+namespace quicflow {
+namespace tools {
+
+using network::ChatProtocolDecoder;
+using network::ChatProtocolEncoder;
+using network::FrameRef;
+
+namespace {
+
+constexpr std::string_view kMessagePrefix = "lg ";
+// 예정보다 이만큼 늦게 보낸 메시지는 late_sends 로 센다. (loadgen 자체가 부하를 못 따라감)
+constexpr uint64_t kLateSendNs = 1000 * 1000;
+constexpr uint32_t kShutdownWaitMs = 5000;
+
+// StreamSend 1회의 수명 (SEND_COMPLETE 에서 해제)
+struct SendContext {
+  FrameRef frame;
+  QUIC_BUFFER buffer;
+};
+
+template <typename T>
+char* AppendNumber(char* out, char* end, T value) {
+  return std::to_chars(out, end, value).ptr;
+}
+
+}  // namespace
+
+struct LoadGenerator::Client {
+  LoadGenerator* owner = nullptr;
+  uint32_t index = 0;
+  uint32_t room = 0;
+  HQUIC connection = nullptr;
+  HQUIC stream = nullptr;
+  std::atomic<bool> ready{false};              // stream 이 열려 송신 가능
+  std::atomic<bool> settled{false};            // 연결 성공/실패를 이미 셌는지
+  std::atomic<bool> shutdown_complete{false};
+  uint64_t sequence = 0;                       // 송신 스레드 전용
+  std::string receive_buffer;                  // stream 콜백 전용 (MsQuic 이 connection 단위로 직렬화)
+};
+
+LoadGenerator::LoadGenerator(const LoadGenConfig& config) : config_(config) {
+  config_.MessageBytes = std::max(config_.MessageBytes, kMinMessageBytes);
+  config_.SenderThreads = std::max(config_.SenderThreads, 1u);
+  uint32_t rooms = std::max(config_.Rooms, 1u);
+  room_members_.assign(rooms, 0);
+  room_sent_ = std::make_unique<std::atomic<uint64_t>[]>(rooms);
+}
+
+LoadGenerator::~LoadGenerator() {
+  Shutdown();
+}
+
+uint64_t LoadGenerator::NowNs() {
+  return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+std::string LoadGenerator::RoomName(uint32_t room) const {
+  if (config_.Rooms == 0) {
+    return {};
+  }
+  return "loadgen-" + std::to_string(room);
+}
+
+bool LoadGenerator::Run(LoadGenReport& report, std::string& error) {
+  if (Initialize(error) == false) {
+    Shutdown();
+    return false;
+  }
+
+  AssignRooms();
+  Connect();
+  if (connected_.load() == 0) {
+    error = "no connection established (" + std::to_string(connect_failures_.load()) + " failed)";
+    Shutdown();
+    return false;
+  }
+  std::fprintf(stderr, "loadgen: %u/%u connected, warmup %us\n", connected_.load(), config_.Connections,
+               config_.WarmupSeconds);
+
+  std::vector<std::thread> senders;
+  if (config_.MessagesPerSecond > 0) {
+    for (uint32_t i = 0; i < config_.SenderThreads; ++i) {
+      senders.emplace_back([this, i] { SendLoop(i); });
+    }
+  }
+
+  std::this_thread::sleep_for(std::chrono::seconds(config_.WarmupSeconds));
+
+  // 집계 시작 시점의 방 인원. (이후 끊긴 connection 은 disconnected 로 보고)
+  for (const auto& client : clients_) {
+    if (client->ready.load()) {
+      room_members_[client->room]++;
+    }
+  }
+  uint32_t disconnectedBefore = disconnected_.load();
+  uint64_t start = NowNs();
+  measure_start_ns_.store(start);
+  std::this_thread::sleep_for(std::chrono::seconds(config_.DurationSeconds));
+  uint64_t end = NowNs();
+  measure_end_ns_.store(end);
+
+  stopping_.store(true);
+  for (auto& sender : senders) {
+    sender.join();
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(config_.DrainMs));
+
+  report.connected = connected_.load();
+  report.connect_failures = connect_failures_.load();
+  report.disconnected = disconnected_.load() - disconnectedBefore;
+  report.sent = sent_.load();
+  report.send_failures = send_failures_.load();
+  report.late_sends = late_sends_.load();
+  report.expected = 0;
+  for (size_t room = 0; room < room_members_.size(); ++room) {
+    report.expected += room_sent_[room].load() * room_members_[room];
+  }
+  report.received = received_.load();
+  report.received_total = received_total_.load();
+  report.decode_failures = decode_failures_.load();
+  report.foreign_messages = foreign_messages_.load();
+  report.measured_seconds = (double)(end - start) / 1e9;
+  report.latency = latency_.Summarize();
+
+  Shutdown();
+  return true;
+}
+
+bool LoadGenerator::Initialize(std::string& error) {
+  QUIC_STATUS status = MsQuicOpen2(&api_);
+  if (QUIC_FAILED(status)) {
+    api_ = nullptr;
+    error = "MsQuicOpen2 failed: " + std::to_string((uint32_t)status);
+    return false;
+  }
+
+  // Why: 서버보다 먼저 loadgen 이 병목이 되지 않도록 MsQuic worker 를 지연 우선으로 둔다.
+  const QUIC_REGISTRATION_CONFIG registrationConfig = {"quicflow_loadgen", QUIC_EXECUTION_PROFILE_LOW_LATENCY};
+  status = api_->RegistrationOpen(&registrationConfig, &registration_);
+  if (QUIC_FAILED(status)) {
+    error = "RegistrationOpen failed: " + std::to_string((uint32_t)status);
+    return false;
+  }
+
+  QUIC_BUFFER alpn;
+  alpn.Length = (uint32_t)config_.Alpn.size();
+  alpn.Buffer = reinterpret_cast<uint8_t*>(config_.Alpn.data());
+
+  QUIC_SETTINGS settings = {};
+  settings.IdleTimeoutMs = 30 * 1000;
+  settings.IsSet.IdleTimeoutMs = TRUE;
+  status = api_->ConfigurationOpen(registration_, &alpn, 1, &settings, sizeof(settings), nullptr, &configuration_);
+  if (QUIC_FAILED(status)) {
+    error = "ConfigurationOpen failed: " + std::to_string((uint32_t)status);
+    return false;
+  }
+
+  // 측정용 도구이므로 서버 인증서(self-signed)는 검증하지 않는다.
+  QUIC_CREDENTIAL_CONFIG credential = {};
+  credential.Type = QUIC_CREDENTIAL_TYPE_NONE;
+  credential.Flags = (QUIC_CREDENTIAL_FLAGS)(QUIC_CREDENTIAL_FLAG_CLIENT | QUIC_CREDENTIAL_FLAG_NO_CERTIFICATE_VALIDATION);
+  status = api_->ConfigurationLoadCredential(configuration_, &credential);
+  if (QUIC_FAILED(status)) {
+    error = "ConfigurationLoadCredential failed: " + std::to_string((uint32_t)status);
+    return false;
+  }
+  return true;
+}
+
+void LoadGenerator::AssignRooms() {
+  clients_.reserve(config_.Connections);
+  std::mt19937_64 random(config_.Seed);
+
+  // Zipf: 방 k 의 가중치 1 / (k+1)^s 의 누적 분포에서 뽑는다.
+  std::vector<double> cumulative;
+  if (config_.Rooms > 1 && config_.Distribution == RoomDistribution::Zipf) {
+    double total = 0;
+    for (uint32_t k = 0; k < config_.Rooms; ++k) {
+      total += 1.0 / std::pow((double)(k + 1), config_.ZipfExponent);
+      cumulative.push_back(total);
+    }
+    for (double& value : cumulative) {
+      value /= total;
+    }
+  }
+  std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+  for (uint32_t i = 0; i < config_.Connections; ++i) {
+    auto client = std::make_unique<Client>();
+    client->owner = this;
+    client->index = i;
+    if (cumulative.empty() == false) {
+      auto it = std::lower_bound(cumulative.begin(), cumulative.end(), unit(random));
+      client->room = (uint32_t)std::min<size_t>((size_t)(it - cumulative.begin()), config_.Rooms - 1);
+    } else if (config_.Rooms > 0) {
+      client->room = i % config_.Rooms;
+    }
+    clients_.push_back(std::move(client));
+  }
+}
+
+void LoadGenerator::Connect() {
+  // Why: 서버 admission 제한(초당 handshake)을 넘지 않도록 일정 간격으로 연결한다.
+  uint64_t intervalNs = config_.ConnectRate > 0 ? 1000000000ull / config_.ConnectRate : 0;
+  uint64_t next = NowNs();
+
+  for (auto& client : clients_) {
+    if (intervalNs > 0) {
+      std::this_thread::sleep_until(std::chrono::steady_clock::time_point(std::chrono::nanoseconds(next)));
+      next += intervalNs;
+    }
+    QUIC_STATUS status = api_->ConnectionOpen(registration_, ConnectionCallback, client.get(), &client->connection);
+    if (QUIC_SUCCEEDED(status)) {
+      status = api_->ConnectionStart(client->connection, configuration_, QUIC_ADDRESS_FAMILY_UNSPEC,
+                                     config_.Host.c_str(), config_.Port);
+    }
+    if (QUIC_FAILED(status)) {
+      // SHUTDOWN_COMPLETE 가 오지 않으므로 여기서 실패로 확정한다. (handle 은 Shutdown 에서 닫는다)
+      client->shutdown_complete.store(true);
+      Settle(*client, false);
+    }
+  }
+
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(config_.ConnectTimeoutMs);
+  while (settled_.load() < config_.Connections && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+}
+
+void LoadGenerator::OnConnected(Client& client) {
+  QUIC_STATUS status = api_->StreamOpen(client.connection, QUIC_STREAM_OPEN_FLAG_NONE, StreamCallback, &client,
+                                        &client.stream);
+  if (QUIC_SUCCEEDED(status)) {
+    status = api_->StreamStart(client.stream, QUIC_STREAM_START_FLAG_IMMEDIATE);
+  }
+  if (QUIC_FAILED(status)) {
+    Settle(client, false);
+    api_->ConnectionShutdown(client.connection, QUIC_CONNECTION_SHUTDOWN_FLAG_NONE, 0);
+    return;
+  }
+
+  // 서버는 접속 시 기본 방(lobby)에 넣는다. 전용 방을 쓰면 lobby fan-out 을 섞지 않도록 나간다.
+  // (같은 stream 이라 서버에서 Join -> Leave -> Chat 순서가 유지된다)
+  if (config_.Rooms > 0) {
+    std::string room = RoomName(client.room);
+    if (Send(client, kChatTypeJoin, room, {}) == false || Send(client, kChatTypeLeave, {}, {}) == false) {
+      Settle(client, false);
+      api_->ConnectionShutdown(client.connection, QUIC_CONNECTION_SHUTDOWN_FLAG_NONE, 0);
+      return;
+    }
+  }
+
+  client.ready.store(true, std::memory_order_release);
+  Settle(client, true);
+}
+
+void LoadGenerator::OnShutdownComplete(Client& client) {
+  bool wasReady = client.ready.exchange(false);
+  // handshake 실패면 여기서 실패로 확정된다. (이미 센 경우는 무시됨)
+  Settle(client, false);
+  if (wasReady && stopping_.load() == false) {
+    disconnected_.fetch_add(1);
+  }
+  client.shutdown_complete.store(true);
+}
+
+void LoadGenerator::Settle(Client& client, bool connected) {
+  if (client.settled.exchange(true)) {
+    return;
+  }
+  if (connected) {
+    connected_.fetch_add(1);
+  } else {
+    connect_failures_.fetch_add(1);
+  }
+  settled_.fetch_add(1);
+}
+
+bool LoadGenerator::Send(Client& client, std::string_view type, std::string_view room, std::string_view message) {
+  ChatProtocol protocol;
+  protocol.Type = std::string(type);
+  protocol.UserID = "loadgen-" + std::to_string(client.index);
+  protocol.Message = std::string(message);
+  protocol.Room = std::string(room);
+
+  FrameRef frame = ChatProtocolEncoder::EncodeFrame(protocol);
+  if (!frame) {
+    return false;
+  }
+  auto* context = new SendContext{std::move(frame), {}};
+  context->buffer.Length = context->frame->length();
+  context->buffer.Buffer = context->frame->data();
+
+  QUIC_STATUS status = api_->StreamSend(client.stream, &context->buffer, 1, QUIC_SEND_FLAG_NONE, context);
+  if (QUIC_FAILED(status)) {
+    delete context;
+    return false;
+  }
+  return true;
+}
+
+void LoadGenerator::SendChat(Client& client, uint64_t scheduledNs) {
+  // Message = "lg <예정 송신 시각> <connection> <순번> " + 채움
+  // Why: 실제 송신 시각 대신 예정 시각을 넣는다. loadgen 이 밀려서 늦게 보내더라도 그만큼의
+  //      대기가 지연에 포함되어야 서버가 느려진 구간의 지연이 가려지지 않는다. (coordinated omission)
+  std::string message(config_.MessageBytes, 'x');
+  char* out = message.data();
+  char* end = out + message.size();
+  std::memcpy(out, kMessagePrefix.data(), kMessagePrefix.size());
+  out += kMessagePrefix.size();
+  out = AppendNumber(out, end, scheduledNs);
+  *out++ = ' ';
+  out = AppendNumber(out, end, client.index);
+  *out++ = ' ';
+  out = AppendNumber(out, end, client.sequence++);
+  *out = ' ';
+
+  bool measured = scheduledNs >= measure_start_ns_.load(std::memory_order_relaxed) &&
+                  scheduledNs < measure_end_ns_.load(std::memory_order_relaxed);
+  if (Send(client, kChatTypeChat, RoomName(client.room), message) == false) {
+    if (measured) {
+      send_failures_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return;
+  }
+  if (measured) {
+    sent_.fetch_add(1, std::memory_order_relaxed);
+    room_sent_[client.room].fetch_add(1, std::memory_order_relaxed);
+    if (NowNs() - scheduledNs > kLateSendNs) {
+      late_sends_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+}
+
+void LoadGenerator::SendLoop(uint32_t threadIndex) {
+  // 이 스레드가 맡은 connection 들의 다음 송신 예정 시각 (min-heap)
+  using Entry = std::pair<uint64_t, uint32_t>;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<>> schedule;
+
+  std::mt19937_64 random(config_.Seed + threadIndex + 1);
+  double intervalNs = 1e9 / (double)config_.MessagesPerSecond;
+  std::uniform_real_distribution<double> phase(0.0, intervalNs);
+  std::exponential_distribution<double> gap(1.0 / intervalNs);
+
+  // 고정 간격이면 위상을 흩어서 모든 connection 이 같은 순간에 보내지 않게 한다.
+  uint64_t now = NowNs();
+  for (uint32_t i = threadIndex; i < clients_.size(); i += config_.SenderThreads) {
+    schedule.emplace(now + (uint64_t)(config_.Poisson ? gap(random) : phase(random)), i);
+  }
+
+  while (schedule.empty() == false && stopping_.load(std::memory_order_relaxed) == false) {
+    auto [due, index] = schedule.top();
+    schedule.pop();
+    if (due > NowNs()) {
+      std::this_thread::sleep_until(std::chrono::steady_clock::time_point(std::chrono::nanoseconds(due)));
+    }
+
+    Client& client = *clients_[index];
+    if (client.ready.load(std::memory_order_acquire)) {
+      SendChat(client, due);
+    }
+    schedule.emplace(due + (uint64_t)(config_.Poisson ? gap(random) : intervalNs), index);
+  }
+}
+
+void LoadGenerator::OnReceive(Client& client, const QUIC_STREAM_EVENT* event) {
+  for (uint32_t i = 0; i < event->RECEIVE.BufferCount; ++i) {
+    const QUIC_BUFFER& buffer = event->RECEIVE.Buffers[i];
+    client.receive_buffer.append(reinterpret_cast<const char*>(buffer.Buffer), buffer.Length);
+  }
+
+  // [4 byte little-endian 길이][JSON] 프레임 단위로 자른다.
+  std::string& data = client.receive_buffer;
+  size_t offset = 0;
+  while (data.size() - offset >= network::OutboundFrame::kHeaderSize) {
+    const auto* header = reinterpret_cast<const uint8_t*>(data.data() + offset);
+    uint32_t length = (uint32_t)header[0] | ((uint32_t)header[1] << 8) | ((uint32_t)header[2] << 16) |
+                      ((uint32_t)header[3] << 24);
+    if (data.size() - offset - network::OutboundFrame::kHeaderSize < length) {
+      break;
+    }
+    OnMessage(std::string_view(data).substr(offset + network::OutboundFrame::kHeaderSize, length));
+    offset += network::OutboundFrame::kHeaderSize + length;
+  }
+  data.erase(0, offset);
+}
+
+void LoadGenerator::OnMessage(std::string_view body) {
+  uint64_t now = NowNs();
+  thread_local std::string scratch;
+  network::ChatProtocolView view;
+  if (ChatProtocolDecoder::Decode(body, view, scratch) != ChatProtocolDecoder::Result::Ok) {
+    decode_failures_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  if (view.Type != kChatTypeChat || view.Message.starts_with(kMessagePrefix) == false) {
+    foreign_messages_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  std::string_view text = view.Message.substr(kMessagePrefix.size());
+  uint64_t sentNs = 0;
+  auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), sentNs);
+  if (ec != std::errc()) {
+    foreign_messages_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  received_total_.fetch_add(1, std::memory_order_relaxed);
+  if (sentNs >= measure_start_ns_.load(std::memory_order_relaxed) &&
+      sentNs < measure_end_ns_.load(std::memory_order_relaxed)) {
+    received_.fetch_add(1, std::memory_order_relaxed);
+    latency_.Record(now > sentNs ? now - sentNs : 0);
+  }
+}
+
+QUIC_STATUS QUIC_API LoadGenerator::ConnectionCallback(HQUIC /*connection*/, void* context,
+                                                       QUIC_CONNECTION_EVENT* event) {
+  auto* client = static_cast<Client*>(context);
+  switch (event->Type) {
+    case QUIC_CONNECTION_EVENT_CONNECTED:
+      client->owner->OnConnected(*client);
+      break;
+    case QUIC_CONNECTION_EVENT_SHUTDOWN_COMPLETE:
+      // handle 은 Shutdown 에서 한꺼번에 닫는다. (송신 스레드가 아직 쓰고 있을 수 있음)
+      client->owner->OnShutdownComplete(*client);
+      break;
+    default:
+      break;
+  }
+  return QUIC_STATUS_SUCCESS;
+}
+
+QUIC_STATUS QUIC_API LoadGenerator::StreamCallback(HQUIC /*stream*/, void* context, QUIC_STREAM_EVENT* event) {
+  auto* client = static_cast<Client*>(context);
+  switch (event->Type) {
+    case QUIC_STREAM_EVENT_RECEIVE:
+      client->owner->OnReceive(*client, event);
+      break;
+    case QUIC_STREAM_EVENT_SEND_COMPLETE:
+      delete static_cast<SendContext*>(event->SEND_COMPLETE.ClientContext);
+      break;
+    default:
+      break;
+  }
+  return QUIC_STATUS_SUCCESS;
+}
+
+void LoadGenerator::Shutdown() {
+  if (api_ == nullptr) {
+    return;
+  }
+  stopping_.store(true);
+
+  for (auto& client : clients_) {
+    if (client->connection != nullptr && client->shutdown_complete.load() == false) {
+      api_->ConnectionShutdown(client->connection, QUIC_CONNECTION_SHUTDOWN_FLAG_NONE, 0);
+    }
+  }
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(kShutdownWaitMs);
+  for (auto& client : clients_) {
+    while (client->connection != nullptr && client->shutdown_complete.load() == false &&
+           std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+
+  for (auto& client : clients_) {
+    if (client->stream != nullptr) {
+      api_->StreamClose(client->stream);
+      client->stream = nullptr;
+    }
+    if (client->connection != nullptr) {
+      api_->ConnectionClose(client->connection);
+      client->connection = nullptr;
+    }
+  }
+  clients_.clear();
+
+  if (configuration_ != nullptr) {
+    api_->ConfigurationClose(configuration_);
+    configuration_ = nullptr;
+  }
+  if (registration_ != nullptr) {
+    api_->RegistrationClose(registration_);
+    registration_ = nullptr;
+  }
+  MsQuicClose(api_);
+  api_ = nullptr;
+}
+
+}  // namespace tools
+}  // namespace quicflow
@@ -0,0 +1,150 @@
+//
+// QuicFlow-CPP - QUIC Load Generator
+//
+
+#ifndef QUICFLOWCPP_LOAD_GENERATOR_HPP
+#define QUICFLOWCPP_LOAD_GENERATOR_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "loadgen/latency_histogram.hpp"
+
+extern "C" {
+#include <msquic.h>
+}
+
+namespace quicflow {
+namespace tools {
+
+enum class RoomDistribution : uint8_t {
+  Uniform,  // connection i -> 방 i % Rooms
+  Zipf,     // 소수의 방에 몰린다 (ZipfExponent)
+};
+
+struct LoadGenConfig {
+  std::string Host = "127.0.0.1";
+  uint16_t Port = 4433;
+  std::string Alpn = "quicflow";
+  uint32_t Connections = 100;
+  uint32_t ConnectRate = 500;        // 초당 새 connection (0 = 한 번에). 서버 admission 한도보다 낮게
+  uint32_t ConnectTimeoutMs = 10 * 1000;
+
+  uint32_t MessagesPerSecond = 1;    // connection 당 송신 속도
+  bool Poisson = false;              // false: 고정 간격(무작위 위상), true: 지수 분포 간격
+  uint32_t MessageBytes = 64;        // Message 필드 길이 (송신 시각 등 포함, 최소 56)
+  uint32_t Rooms = 0;                // 0 = 모두 기본 방(lobby). 그 외에는 loadgen-<n> 방에 나눠서 참여
+  RoomDistribution Distribution = RoomDistribution::Uniform;
+  double ZipfExponent = 1.0;
+
+  uint32_t WarmupSeconds = 5;        // 이 동안 보낸 메시지는 집계하지 않는다
+  uint32_t DurationSeconds = 30;     // 집계 구간
+  uint32_t DrainMs = 2000;           // 송신을 멈춘 뒤 수신을 기다리는 시간
+  uint32_t SenderThreads = 1;
+  uint64_t Seed = 1;                 // 방 배정/송신 위상 (같은 값이면 같은 부하)
+  std::string Label;                 // 보고서에 그대로 남긴다 (빌드 이름 등)
+};
+
+struct LoadGenReport {
+  uint32_t connected = 0;
+  uint32_t connect_failures = 0;
+  uint32_t disconnected = 0;        // 집계 도중 끊긴 connection
+
+  // 집계 구간(warmup 이후)에 보낸 메시지 기준
+  uint64_t sent = 0;
+  uint64_t send_failures = 0;
+  uint64_t late_sends = 0;          // 예정 시각보다 1ms 이상 늦게 보냄 (loadgen 이 병목)
+  uint64_t expected = 0;            // 보낸 메시지 x 방 인원 (보낸 사람 포함)
+  uint64_t received = 0;
+  // 전체 (warmup, drain 포함)
+  uint64_t received_total = 0;
+  uint64_t decode_failures = 0;
+  uint64_t foreign_messages = 0;    // loadgen 이 보내지 않은 메시지
+
+  double measured_seconds = 0;
+  LatencyHistogram::Summary latency;  // 송신 직전 ~ 수신 콜백 (ns)
+};
+
+// MsQuic 클라이언트 N 개로 서버에 채팅 부하를 건다.
+// Why: 실제 게임 클라이언트 없이 서버 빌드 간 처리량/지연을 같은 조건으로 비교한다.
+//
+// 서버와 같은 프레이밍(4 byte little-endian 길이 + ChatProtocol JSON)을 쓰고, Message 필드에
+// 송신 시각(steady_clock ns)을 넣는다. 보내고 받는 쪽이 모두 이 프로세스이므로 서버가 다른
+// 호스트에 있어도 시계 차이 없이 end-to-end 지연을 잰다.
+//
+//   connect -> (Rooms > 0 이면 Join + 기본 방 Leave) -> warmup -> 집계 -> drain -> 종료
+//
+// 서버의 수신 제한(inbound.rate), 방 송신 제한(room.publish_rate), admission 한도가 부하보다
+// 낮으면 메시지가 버려지고 expected 대비 received 로 드러난다.
+class LoadGenerator {
+public:
+  explicit LoadGenerator(const LoadGenConfig& config);
+  ~LoadGenerator();
+
+  LoadGenerator(const LoadGenerator&) = delete;
+  LoadGenerator& operator=(const LoadGenerator&) = delete;
+
+  // 끝까지 실행한다. MsQuic 초기화나 모든 connection 이 실패하면 false (error 에 이유)
+  bool Run(LoadGenReport& report, std::string& error);
+
+  // Message 앞부분: "lg <송신 예정 ns> <connection> <순번> " + 채움 문자
+  static constexpr uint32_t kMinMessageBytes = 56;
+
+private:
+  struct Client;
+
+  bool Initialize(std::string& error);
+  void Connect();
+  void AssignRooms();
+  void SendLoop(uint32_t threadIndex);
+  bool Send(Client& client, std::string_view type, std::string_view room, std::string_view message);
+  void SendChat(Client& client, uint64_t scheduledNs);
+  void Shutdown();
+
+  void OnConnected(Client& client);
+  void OnShutdownComplete(Client& client);
+  void Settle(Client& client, bool connected);
+  void OnReceive(Client& client, const QUIC_STREAM_EVENT* event);
+  void OnMessage(std::string_view body);
+
+  static QUIC_STATUS QUIC_API ConnectionCallback(HQUIC connection, void* context, QUIC_CONNECTION_EVENT* event);
+  static QUIC_STATUS QUIC_API StreamCallback(HQUIC stream, void* context, QUIC_STREAM_EVENT* event);
+
+  static uint64_t NowNs();
+  std::string RoomName(uint32_t room) const;
+
+  LoadGenConfig config_;
+  const QUIC_API_TABLE* api_ = nullptr;
+  HQUIC registration_ = nullptr;
+  HQUIC configuration_ = nullptr;
+
+  std::vector<std::unique_ptr<Client>> clients_;
+  std::vector<uint32_t> room_members_;                 // 방별 연결된 인원
+  std::unique_ptr<std::atomic<uint64_t>[]> room_sent_;  // 방별 집계 구간 송신 수
+
+  std::atomic<uint32_t> settled_{0};  // 연결 성공 또는 실패가 확정된 수
+  std::atomic<uint32_t> connected_{0};
+  std::atomic<uint32_t> connect_failures_{0};
+  std::atomic<uint32_t> disconnected_{0};
+  std::atomic<bool> stopping_{false};
+
+  // 집계 구간 [measure_start_ns_, measure_end_ns_) 에 송신 시각이 들어가는 메시지만 센다.
+  std::atomic<uint64_t> measure_start_ns_{~0ull};
+  std::atomic<uint64_t> measure_end_ns_{~0ull};
+  std::atomic<uint64_t> sent_{0};
+  std::atomic<uint64_t> send_failures_{0};
+  std::atomic<uint64_t> late_sends_{0};
+  std::atomic<uint64_t> received_{0};
+  std::atomic<uint64_t> received_total_{0};
+  std::atomic<uint64_t> decode_failures_{0};
+  std::atomic<uint64_t> foreign_messages_{0};
+  LatencyHistogram latency_;
+};
+
+}  // namespace tools
+}  // namespace quicflow
+
+#endif  // QUICFLOWCPP_LOAD_GENERATOR_HPP
@@ -0,0 +1,301 @@
+//
+// QuicFlow-CPP - quicflow_loadgen
+//
+// 사용 예:
+//   quicflow_loadgen --connections=1000 --rate=5 --rooms=50 --distribution=zipf
+//                    --duration=60 --label=build-a --format=csv --output=results.csv
+//
+// 같은 seed/옵션이면 같은 부하(방 배정, 송신 위상)가 만들어지므로 서버 빌드만 바꿔 가며
+// 결과 파일에 행을 쌓아 비교한다.
+//
+
+#include <charconv>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <string_view>
+
+#include <nlohmann/json.hpp>
+
+#include "loadgen/load_generator.hpp"
+
+using namespace quicflow::tools;
+
+namespace {
+
+struct Options {
+  LoadGenConfig Config;
+  std::string Format = "json";  // json | csv
+  std::string Output;           // 비어 있으면 stdout. csv 는 파일 끝에 행을 덧붙인다
+};
+
+template <typename T>
+bool ParseUnsigned(std::string_view text, T& out) {
+  uint64_t value = 0;
+  auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+  if (result.ec != std::errc() || result.ptr != text.data() + text.size()
+    || value > std::numeric_limits<T>::max()) {
+    return false;
+  }
+  out = (T)value;
+  return true;
+}
+
+bool ParseDouble(std::string_view text, double& out) {
+  try {
+    size_t used = 0;
+    out = std::stod(std::string(text), &used);
+    return used == text.size();
+  } catch (const std::exception&) {
+    return false;
+  }
+}
+
+struct Option {
+  std::string_view Key;
+  std::string_view Help;
+  bool (*Parse)(std::string_view value, Options& out);
+};
+
+const Option kOptions[] = {
+    {"host", "server address (default 127.0.0.1)",
+     [](std::string_view v, Options& o) { o.Config.Host = v; return v.empty() == false; }},
+    {"port", "server UDP port (default 4433)",
+     [](std::string_view v, Options& o) { return ParseUnsigned(v, o.Config.Port); }},
+    {"alpn", "ALPN (default quicflow)",
+     [](std::string_view v, Options& o) { o.Config.Alpn = v; return v.empty() == false; }},
+    {"connections", "number of QUIC connections (default 100)",
+     [](std::string_view v, Options& o) { return ParseUnsigned(v, o.Config.Connections) && o.Config.Connections > 0; }},
+    {"connect_rate", "new connections per second (0 = all at once, default 500)",
+     [](std::string_view v, Options& o) { return ParseUnsigned(v, o.Config.ConnectRate); }},
+    {"connect_timeout_ms", "wait for handshakes (default 10000)",
+     [](std::string_view v, Options& o) { return ParseUnsigned(v, o.Config.ConnectTimeoutMs); }},
+    {"rate", "chat messages per second per connection (0 = connect only, default 1)",
+     [](std::string_view v, Options& o) { return ParseUnsigned(v, o.Config.MessagesPerSecond); }},
+    {"poisson", "exponential inter-send gaps instead of a fixed interval (default false)",
+     [](std::string_view v, Options& o) {
+       if (v == "true" || v == "1") { o.Config.Poisson = true; return true; }
+       if (v == "false" || v == "0") { o.Config.Poisson = false; return true; }
+       return false;
+     }},
+    {"message_bytes", "Message field length (min 56, default 64)",
+     [](std::string_view v, Options& o) { return ParseUnsigned(v, o.Config.MessageBytes); }},
+    {"rooms", "rooms to spread connections over (0 = default room, default 0)",
+     [](std::string_view v, Options& o) { return ParseUnsigned(v, o.Config.Rooms); }},
+    {"distribution", "uniform | zipf (room assignment, default uniform)",
+     [](std::string_view v, Options& o) {
+       if (v == "uniform") { o.Config.Distribution = RoomDistribution::Uniform; return true; }
+       if (v == "zipf") { o.Config.Distribution = RoomDistribution::Zipf; return true; }
+       return false;
+     }},
+    {"zipf_exponent", "zipf skew (default 1.0)",
+     [](std::string_view v, Options& o) { return ParseDouble(v, o.Config.ZipfExponent) && o.Config.ZipfExponent >= 0; }},
+    {"warmup", "seconds before measuring (default 5)",
+     [](std::string_view v, Options& o) { return ParseUnsigned(v, o.Config.WarmupSeconds); }},
+    {"duration", "measured seconds (default 30)",
+     [](std::string_view v, Options& o) { return ParseUnsigned(v, o.Config.DurationSeconds) && o.Config.DurationSeconds > 0; }},
+    {"drain_ms", "wait for in-flight messages after sending stops (default 2000)",
+     [](std::string_view v, Options& o) { return ParseUnsigned(v, o.Config.DrainMs); }},
+    {"sender_threads", "sending threads (default 1)",
+     [](std::string_view v, Options& o) { return ParseUnsigned(v, o.Config.SenderThreads) && o.Config.SenderThreads > 0; }},
+    {"seed", "room assignment / send phase seed (default 1)",
+     [](std::string_view v, Options& o) { return ParseUnsigned(v, o.Config.Seed); }},
+    {"label", "free text copied into the report (e.g. build name)",
+     [](std::string_view v, Options& o) { o.Config.Label = v; return true; }},
+    {"format", "json | csv (default json)",
+     [](std::string_view v, Options& o) { o.Format = v; return v == "json" || v == "csv"; }},
+    {"output", "report file (default stdout; csv appends a row)",
+     [](std::string_view v, Options& o) { o.Output = v; return true; }},
+};
+
+void PrintUsage(const char* program) {
+  std::cout << "Usage: " << program << " [--key=value ...]\n"
+            << "  Opens QUIC connections to a quicflow server, sends timestamped chat messages and\n"
+            << "  reports end-to-end latency percentiles. Raise the server's inbound.rate_per_second and\n"
+            << "  room.publish_rate_per_second (and admission limits for large connection counts) above the\n"
+            << "  offered load, or throttled messages show up as missing deliveries.\n\n";
+  for (const auto& option : kOptions) {
+    std::cout << "  --" << option.Key << "  " << option.Help << "\n";
+  }
+  std::cout << std::flush;
+}
+
+bool ParseArguments(int argc, char** argv, Options& out, std::string& error) {
+  for (int i = 1; i < argc; ++i) {
+    std::string_view argument = argv[i];
+    size_t equals = argument.find('=');
+    if (argument.starts_with("--") == false || equals == std::string_view::npos) {
+      error = "expected --key=value: " + std::string(argument);
+      return false;
+    }
+    std::string_view key = argument.substr(2, equals - 2);
+    std::string_view value = argument.substr(equals + 1);
+
+    bool found = false;
+    for (const auto& option : kOptions) {
+      if (option.Key == key) {
+        found = true;
+        if (option.Parse(value, out) == false) {
+          error = "invalid value for --" + std::string(key) + ": " + std::string(value);
+          return false;
+        }
+        break;
+      }
+    }
+    if (found == false) {
+      error = "unknown option: --" + std::string(key);
+      return false;
+    }
+  }
+  return true;
+}
+
+// 보고서 항목 (json 과 csv 가 같은 이름/순서를 쓴다)
+nlohmann::ordered_json BuildReport(const LoadGenConfig& config, const LoadGenReport& report) {
+  double seconds = report.measured_seconds > 0 ? report.measured_seconds : 1.0;
+  nlohmann::ordered_json out;
+  out["label"] = config.Label;
+  out["config"] = {
+      {"host", config.Host},
+      {"port", config.Port},
+      {"connections", config.Connections},
+      {"rate", config.MessagesPerSecond},
+      {"poisson", config.Poisson},
+      {"message_bytes", config.MessageBytes},
+      {"rooms", config.Rooms},
+      {"distribution", config.Distribution == RoomDistribution::Zipf ? "zipf" : "uniform"},
+      {"zipf_exponent", config.ZipfExponent},
+      {"warmup", config.WarmupSeconds},
+      {"duration", config.DurationSeconds},
+      {"seed", config.Seed},
+  };
+  out["connections"] = {
+      {"connected", report.connected},
+      {"failed", report.connect_failures},
+      {"disconnected", report.disconnected},
+  };
+  out["messages"] = {
+      {"sent", report.sent},
+      {"send_failures", report.send_failures},
+      {"late_sends", report.late_sends},
+      {"expected", report.expected},
+      {"received", report.received},
+      {"delivery_ratio", report.expected > 0 ? (double)report.received / (double)report.expected : 0.0},
+      {"received_total", report.received_total},
+      {"decode_failures", report.decode_failures},
+      {"foreign", report.foreign_messages},
+  };
+  out["throughput"] = {
+      {"sent_per_sec", (double)report.sent / seconds},
+      {"received_per_sec", (double)report.received / seconds},
+  };
+  const LatencyHistogram::Summary& latency = report.latency;
+  out["latency_us"] = {
+      {"count", latency.count},
+      {"min", (double)latency.min / 1000.0},
+      {"mean", latency.mean / 1000.0},
+      {"p50", (double)latency.p50 / 1000.0},
+      {"p90", (double)latency.p90 / 1000.0},
+      {"p99", (double)latency.p99 / 1000.0},
+      {"p999", (double)latency.p999 / 1000.0},
+      {"p9999", (double)latency.p9999 / 1000.0},
+      {"max", (double)latency.max / 1000.0},
+  };
+  return out;
+}
+
+// 중첩된 항목을 "section.key" 열로 편다.
+void Flatten(const nlohmann::ordered_json& node, const std::string& prefix, std::string& header, std::string& row) {
+  for (const auto& [key, value] : node.items()) {
+    std::string name = prefix.empty() ? key : prefix + "." + key;
+    if (value.is_object()) {
+      Flatten(value, name, header, row);
+      continue;
+    }
+    if (header.empty() == false) {
+      header += ',';
+      row += ',';
+    }
+    header += name;
+    std::string text = value.is_string() ? value.get<std::string>() : value.dump();
+    // label 에 쉼표나 따옴표가 있으면 CSV 규칙대로 감싼다.
+    if (text.find_first_of(",\"\n") != std::string::npos) {
+      std::string quoted = "\"";
+      for (char c : text) {
+        quoted += c;
+        if (c == '"') {
+          quoted += '"';
+        }
+      }
+      text = quoted + "\"";
+    }
+    row += text;
+  }
+}
+
+bool WriteReport(const Options& options, const nlohmann::ordered_json& report) {
+  std::string text;
+  bool append = false;
+  if (options.Format == "csv") {
+    std::string header;
+    std::string row;
+    Flatten(report, "", header, row);
+    // 이미 행이 있는 파일에는 header 를 다시 쓰지 않는다.
+    bool needHeader = true;
+    if (options.Output.empty() == false) {
+      std::ifstream existing(options.Output, std::ios::binary | std::ios::ate);
+      needHeader = existing.is_open() == false || existing.tellg() <= 0;
+    }
+    text = (needHeader ? header + "\n" : std::string()) + row + "\n";
+    append = true;
+  } else {
+    text = report.dump(2) + "\n";
+  }
+
+  if (options.Output.empty()) {
+    std::cout << text << std::flush;
+    return true;
+  }
+  std::ofstream file(options.Output, append ? std::ios::app : std::ios::trunc);
+  if (file.is_open() == false) {
+    return false;
+  }
+  file << text;
+  return file.good();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  for (int i = 1; i < argc; ++i) {
+    std::string_view argument = argv[i];
+    if (argument == "--help" || argument == "-h") {
+      PrintUsage(argv[0]);
+      return 0;
+    }
+  }
+
+  Options options;
+  std::string error;
+  if (ParseArguments(argc, argv, options, error) == false) {
+    std::fprintf(stderr, "quicflow_loadgen: %s (see --help)\n", error.c_str());
+    return 2;
+  }
+
+  LoadGenReport report;
+  {
+    LoadGenerator generator(options.Config);
+    if (generator.Run(report, error) == false) {
+      std::fprintf(stderr, "quicflow_loadgen: %s\n", error.c_str());
+      return 1;
+    }
+  }
+
+  if (WriteReport(options, BuildReport(options.Config, report)) == false) {
+    std::fprintf(stderr, "quicflow_loadgen: cannot write %s\n", options.Output.c_str());
+    return 1;
+  }
+  return 0;
+}